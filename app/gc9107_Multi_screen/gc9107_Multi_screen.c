@@ -47,11 +47,14 @@
 
 #include <rtthread.h>
 #include "string.h"
+#include <stdlib.h>
 #include "board.h"
 #include "drv_io.h"
 #include "drv_lcd.h"
 
 #include "log.h"
+#include "frame_profiler.h"
+#include "panel_grid.h"
 
 #define ROW_OFFSET  (0)
 
@@ -107,9 +110,6 @@
     #define DEBUG_PRINTF(...)
 #endif
 
-/* 定义液晶分辨率 */
-#define USE_HORIZONTAL 0 // 设置横屏或者竖屏显示 0或1为竖屏 2或3为横屏
-
 // 定义MAX/MIN宏（如果尚未定义）
 #ifndef MAX
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
@@ -119,10 +119,6 @@
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #endif
 
-// 三连屏引脚定义 - 更新为新的引脚配置
-#define LCD_CS_PIN_1  03  // PA01
-#define LCD_CS_PIN_2  02  // PA02
-#define LCD_CS_PIN_3  01  // PA03
 #define LCD_RST_PIN   00  // PA00 复位引脚
 
 // 屏幕配置结构体
@@ -130,36 +126,80 @@ typedef struct {
     uint8_t cs_pin;
     uint8_t col;
     uint8_t row;
+    uint8_t madctl;     // 按旋转角度换算的扫描方向（0x36参数）
 } ScreenConfig;
 
-#define LCD_SCREEN_NUM 3   // 屏幕数量 - 从6个改为3个
+#define LCD_SCREEN_NUM LCD_PANEL_NUM   // 屏幕数量，由Kconfig的网格行列决定
+
+#if LCD_PANEL_GRID_WIDTH > LCD_HOR_RES_MAX || LCD_PANEL_GRID_HEIGHT > LCD_VER_RES_MAX
+#error "LCD panel grid is larger than LCD_HOR_RES_MAX x LCD_VER_RES_MAX"
+#endif
 
-// 屏幕CS引脚数组 - 更新为新的引脚
-static uint16_t lcd_cs_pins[LCD_SCREEN_NUM] = {LCD_CS_PIN_1, LCD_CS_PIN_2, LCD_CS_PIN_3};
+// 屏幕CS引脚数组，初始化时从LCD_PANEL_CS_PINS解析
+static uint16_t lcd_cs_pins[LCD_SCREEN_NUM];
 
-// 屏幕CS引脚对应的GPIO和PAD配置 - 更新为新的引脚
+// PA引脚编号对应的PAD和GPIO功能
+#define LCD_PA(n, m)  {PAD_PA##n, GPIO_A##m}
 static const struct {
     uint8_t pad;
     uint8_t gpio;
-} lcd_cs_pad_gpio[LCD_SCREEN_NUM] = {
-    {PAD_PA01, GPIO_A1},   // 更新：PA01
-    {PAD_PA02, GPIO_A2},   // 更新：PA02
-    {PAD_PA03, GPIO_A3},   // 更新：PA03
+} lcd_pa_pad_gpio[] = {
+    LCD_PA(00, 0),  LCD_PA(01, 1),  LCD_PA(02, 2),  LCD_PA(03, 3),  LCD_PA(04, 4),
+    LCD_PA(05, 5),  LCD_PA(06, 6),  LCD_PA(07, 7),  LCD_PA(08, 8),  LCD_PA(09, 9),
+    LCD_PA(10, 10), LCD_PA(11, 11), LCD_PA(12, 12), LCD_PA(13, 13), LCD_PA(14, 14),
+    LCD_PA(15, 15), LCD_PA(16, 16), LCD_PA(17, 17), LCD_PA(18, 18), LCD_PA(19, 19),
+    LCD_PA(20, 20), LCD_PA(21, 21), LCD_PA(22, 22), LCD_PA(23, 23), LCD_PA(24, 24),
+    LCD_PA(25, 25), LCD_PA(26, 26), LCD_PA(27, 27), LCD_PA(28, 28), LCD_PA(29, 29),
+    LCD_PA(30, 30), LCD_PA(31, 31), LCD_PA(32, 32), LCD_PA(33, 33), LCD_PA(34, 34),
+    LCD_PA(35, 35), LCD_PA(36, 36), LCD_PA(37, 37), LCD_PA(38, 38), LCD_PA(39, 39),
+    LCD_PA(40, 40), LCD_PA(41, 41), LCD_PA(42, 42), LCD_PA(43, 43), LCD_PA(44, 44),
 };
 
-// 屏幕映射配置 - 更新为单排三连屏布局
-static const ScreenConfig screen_map[LCD_SCREEN_NUM] = {
-    {LCD_CS_PIN_1, 0, 0},  // 第1块屏：第0行，第0列
-    {LCD_CS_PIN_2, 1, 0},  // 第2块屏：第0行，第1列
-    {LCD_CS_PIN_3, 2, 0},  // 第3块屏：第0行，第2列
-    // 删除：第二排的三个屏幕配置
-};
+#define LCD_PA_NUM (sizeof(lcd_pa_pad_gpio) / sizeof(lcd_pa_pad_gpio[0]))
+
+// 屏幕映射配置，按行优先由网格生成
+static ScreenConfig screen_map[LCD_SCREEN_NUM];
 
 static void LCD_WriteReg(LCDC_HandleTypeDef *hlcdc, uint16_t LCD_Reg, uint8_t *Parameters, uint32_t NbParameters);
 static uint32_t LCD_ReadData(LCDC_HandleTypeDef *hlcdc, uint16_t RegValue, uint8_t ReadSize);
 static void LCD_WriteReg_More(LCDC_HandleTypeDef *hlcdc, uint16_t LCD_Reg, uint8_t *Parameters, uint32_t NbParameters);
 static uint16_t current_lcd_cs_pin;
 static uint16_t Region_Xpos0, Region_Ypos0, Region_Xpos1, Region_Ypos1;
+static void LCD_PanelSleepInit(LCDC_HandleTypeDef *hlcdc);
+
+/*
+ * LCDC总线锁：寄存器访问序列（初始化、读ID、开关显示、亮度、颜色模式、单点读写）、
+ * 面板睡眠的每一步和一次完整的刷屏互相排斥。刷屏在写窗口前取得，最后一块屏的
+ * DMA完成后在中断里释放，所以用信号量而不是互斥量。寄存器读写函数本身不加锁，
+ * 由调用它们的驱动接口持有。
+ */
+static struct rt_semaphore lcd_bus_sem;
+static bool lcd_bus_ready = false;
+
+static void LCD_BusLock(void)
+{
+    if (lcd_bus_ready)
+    {
+        rt_sem_take(&lcd_bus_sem, RT_WAITING_FOREVER);
+    }
+}
+
+static bool LCD_BusTryLock(void)
+{
+    return !lcd_bus_ready || rt_sem_trytake(&lcd_bus_sem) == RT_EOK;
+}
+
+static void LCD_BusUnlock(void)
+{
+    if (lcd_bus_ready)
+    {
+        rt_sem_release(&lcd_bus_sem);
+    }
+}
+
+#ifdef LCD_GC9107_TE_SYNC
+static void LCD_TE_Init(LCDC_HandleTypeDef *hlcdc);
+#endif
 
 static LCDC_InitTypeDef lcdc_int_cfg =
 {
@@ -319,20 +359,89 @@ static void LCD_Drv_Init(LCDC_HandleTypeDef *hlcdc)
     parameter[1] = 0xFF;
     LCD_WriteReg_More(hlcdc, 0xBA, parameter, 2);
 
-    if(USE_HORIZONTAL==0)parameter[0] = 0x00;
-    else if(USE_HORIZONTAL==1)parameter[0] = (0xC0);
-    else if(USE_HORIZONTAL==2)parameter[0] = (0x60);
-    else parameter[0] = (0xA0); 
-    LCD_WriteReg_More(hlcdc, 0x36, parameter, 1);
+    // 扫描方向按各屏的旋转角度分别设置
+    for (int i = 0; i < LCD_SCREEN_NUM; i++) {
+        current_lcd_cs_pin = screen_map[i].cs_pin;
+        parameter[0] = screen_map[i].madctl;
+        LCD_WriteReg(hlcdc, 0x36, parameter, 1);
+    }
 
     LCD_WriteReg_More(hlcdc, 0x11, parameter, 0); 
 }
 
+// 解析Kconfig中逗号分隔的整数列表，返回解析出的个数
+static int LCD_ParseList(const char *str, int32_t *out, int max)
+{
+    int cnt = 0;
+
+    while (*str && cnt < max) {
+        char *end;
+        long v = strtol(str, &end, 10);
+        if (end == str) {
+            break;
+        }
+        out[cnt++] = (int32_t)v;
+        str = end;
+        while (*str == ',' || *str == ' ') {
+            str++;
+        }
+    }
+    return cnt;
+}
+
+static uint8_t LCD_RotationToMadctl(int32_t rotation)
+{
+    switch (rotation) {
+    case 90:  return 0x60;
+    case 180: return 0xC0;
+    case 270: return 0xA0;
+    default:  return 0x00;
+    }
+}
+
+// 按网格配置生成各屏的CS引脚、位置和扫描方向
+static int LCD_BuildScreenMap(void)
+{
+    int32_t pins[LCD_SCREEN_NUM];
+    int32_t rotations[LCD_SCREEN_NUM] = {0};
+
+    if (LCD_ParseList(LCD_PANEL_CS_PINS, pins, LCD_SCREEN_NUM) != LCD_SCREEN_NUM) {
+        LOG_E("LCD_PANEL_CS_PINS \"%s\" needs %d pins", LCD_PANEL_CS_PINS, LCD_SCREEN_NUM);
+        return -RT_EINVAL;
+    }
+    LCD_ParseList(LCD_PANEL_ROTATIONS, rotations, LCD_SCREEN_NUM);
+
+    for (int i = 0; i < LCD_SCREEN_NUM; i++) {
+        if (pins[i] < 0 || pins[i] >= (int32_t)LCD_PA_NUM) {
+            LOG_E("panel %d: invalid CS pin PA%02d", i + 1, (int)pins[i]);
+            return -RT_EINVAL;
+        }
+        lcd_cs_pins[i] = pins[i];
+        screen_map[i].cs_pin = pins[i];
+        screen_map[i].col = i % LCD_PANEL_COLS;
+        screen_map[i].row = i / LCD_PANEL_COLS;
+        screen_map[i].madctl = LCD_RotationToMadctl(rotations[i]);
+    }
+    return 0;
+}
+
 static void LCD_Init(LCDC_HandleTypeDef *hlcdc)
 {
-    // 初始化CS引脚 - 只初始化3个引脚
+    // 网格配置错误属于编译配置问题，直接断言
+    int err = LCD_BuildScreenMap();
+    RT_ASSERT(err == 0);
+
+    if (!lcd_bus_ready)
+    {
+        rt_sem_init(&lcd_bus_sem, "lcd_bus", 1, RT_IPC_FLAG_PRIO);
+        lcd_bus_ready = true;
+    }
+    // 重新初始化时等正在进行的刷屏和睡眠步骤结束
+    LCD_BusLock();
+
+    // 初始化各屏CS引脚
     for (int i = 0; i < LCD_SCREEN_NUM; i++) {
-        HAL_PIN_Set(lcd_cs_pad_gpio[i].pad, lcd_cs_pad_gpio[i].gpio, PIN_NOPULL, 1);
+        HAL_PIN_Set(lcd_pa_pad_gpio[lcd_cs_pins[i]].pad, lcd_pa_pad_gpio[lcd_cs_pins[i]].gpio, PIN_NOPULL, 1);
         rt_pin_mode(lcd_cs_pins[i], PIN_MODE_OUTPUT);
         rt_pin_write(lcd_cs_pins[i], PIN_HIGH);
     }
@@ -347,6 +456,11 @@ static void LCD_Init(LCDC_HandleTypeDef *hlcdc)
     HAL_LCDC_Init(hlcdc);
 
     LCD_Drv_Init(hlcdc);
+    LCD_PanelSleepInit(hlcdc);
+#ifdef LCD_GC9107_TE_SYNC
+    LCD_TE_Init(hlcdc);
+#endif
+    LCD_BusUnlock();
 }
 
 /**
@@ -358,12 +472,16 @@ static uint32_t LCD_ReadID(LCDC_HandleTypeDef *hlcdc)
 {
     uint32_t lcd_data[LCD_SCREEN_NUM];
 
-    // 遍历三个屏幕读取ID - 从6个改为3个
+    // 遍历各屏读取ID
+    LCD_BusLock();
     for (int i = 0; i < LCD_SCREEN_NUM; i++) {
         current_lcd_cs_pin = lcd_cs_pins[i];
         lcd_data[i] = LCD_ReadData(hlcdc, REG_LCD_ID, 4);
         lcd_data[i] = ((lcd_data[i] << 1) >> 8) & 0xFFFFFF;
-        rt_kprintf("\nLCD%d ReadID 0x%x \n", (i + 1), lcd_data[i]);        
+    }
+    LCD_BusUnlock();
+    for (int i = 0; i < LCD_SCREEN_NUM; i++) {
+        rt_kprintf("\nLCD%d ReadID 0x%x \n", (i + 1), lcd_data[i]);
     }
     return THE_LCD_ID;
 }
@@ -376,7 +494,9 @@ static uint32_t LCD_ReadID(LCDC_HandleTypeDef *hlcdc)
 static void LCD_DisplayOn(LCDC_HandleTypeDef *hlcdc)
 {
     /* Display On */
+    LCD_BusLock();
     LCD_WriteReg_More(hlcdc, REG_DISPLAY_ON, (uint8_t *)NULL, 0);
+    LCD_BusUnlock();
 }
 
 /**
@@ -387,7 +507,9 @@ static void LCD_DisplayOn(LCDC_HandleTypeDef *hlcdc)
 static void LCD_DisplayOff(LCDC_HandleTypeDef *hlcdc)
 {
     /* Display Off */
+    LCD_BusLock();
     LCD_WriteReg_More(hlcdc, REG_DISPLAY_OFF, (uint8_t *)NULL, 0);
+    LCD_BusUnlock();
 }
 
 /**
@@ -406,118 +528,678 @@ static void LCD_SetRegion(LCDC_HandleTypeDef *hlcdc, uint16_t Xpos0, uint16_t Yp
     Region_Ypos1 = Ypos1;
 }
 
-static bool LCDC_SetROIArea(LCDC_HandleTypeDef *hlcdc)
+/**
+  * @brief  Writes pixel.
+  * @param  Xpos: specifies the X position.
+  * @param  Ypos: specifies the Y position.
+  * @param  RGBCode: the RGB pixel color
+  * @retval None
+  */
+static void LCD_WritePixel(LCDC_HandleTypeDef *hlcdc, uint16_t Xpos, uint16_t Ypos, const uint8_t *RGBCode)
 {
-    uint8_t parameter[4];
-    uint8_t col = 0, row = 0;
-    bool found = false;
-    
-    // 查找当前CS引脚对应的屏幕位置
-    for (size_t i = 0; i < sizeof(screen_map)/sizeof(screen_map[0]); i++) {
-        if (screen_map[i].cs_pin == current_lcd_cs_pin) {
-            col = screen_map[i].col;
-            row = screen_map[i].row;
-            found = true;
-            break;
+    uint8_t data = 0;
+    /* Set Cursor */
+    LCD_SetRegion(hlcdc, Xpos, Ypos, Xpos, Ypos);
+    LCD_BusLock();
+    LCD_WriteReg(hlcdc, REG_WRITE_RAM, (uint8_t *)RGBCode, 2);
+    LCD_BusUnlock();
+}
+
+static void (* Ori_XferCpltCallback)(struct __LCDC_HandleTypeDef *lcdc);
+
+static void HAL_GPIO_Set(uint16_t pin, int value)
+{
+    rt_pin_write(pin, (value != 0) ? PIN_HIGH : PIN_LOW);
+}
+
+// 一次刷新中某块屏的发送参数，启动DMA前一次算好
+typedef struct {
+    uint8_t index;              // 屏序号
+    uint16_t cs_pin;
+    uint8_t caset[4];           // 屏内局部窗口
+    uint8_t raset[4];
+    uint16_t x0, y0, x1, y1;    // LCDC ROI，全局坐标
+    uint32_t bytes;
+} PanelFlush;
+
+static PanelFlush flush_plan[LCD_SCREEN_NUM];
+static int flush_plan_cnt = 0;
+static int flush_plan_pos = 0;
+
+static void LCD_SendLayerDataCpltCbk(LCDC_HandleTypeDef *hlcdc);
+
+/*
+ * 面板睡眠：应用层只设置请求掩码，由独立的软定时器按步执行。每一步在取得
+ * 总线锁后才写命令，SLEEP IN/OUT之后的等待和刚唤醒的屏的保持时间
+ * 都由定时器重新定时，不占用刷屏路径，也不依赖后续是否还有刷屏。
+ * 睡眠和唤醒中的屏不进入刷屏计划，开显示后由上层重画。
+ */
+#define LCD_SLEEP_CMD_DELAY_MS  5       // SLEEP IN/OUT后到下一条命令的间隔
+#define LCD_SLEEP_OUT_HOLD_MS   120     // SLEEP OUT后至少间隔这么久才能再次SLEEP IN
+
+static volatile uint32_t panel_sleep_req = 0;
+static volatile uint32_t panel_sleep_mask = 0;      // 已SLEEP IN或尚未重新开显示的屏
+static uint32_t panel_waking = 0;                   // 已SLEEP OUT、等待开显示的屏
+static rt_tick_t panel_sleep_tick[LCD_SCREEN_NUM];  // 每屏最近一次SLEEP IN/OUT的时刻
+static struct rt_timer panel_sleep_timer;
+static LCDC_HandleTypeDef *panel_sleep_hlcdc = NULL;
+
+static void LCD_PanelSleepArm(rt_tick_t ticks)
+{
+    ticks = MAX(ticks, 1);
+    rt_timer_control(&panel_sleep_timer, RT_TIMER_CTRL_SET_TIME, &ticks);
+    rt_timer_start(&panel_sleep_timer);
+}
+
+void lcd_panel_set_sleep_mask(uint32_t mask)
+{
+    panel_sleep_req = mask & LCD_PANEL_ALL_MASK;
+    if (panel_sleep_hlcdc)
+    {
+        LCD_PanelSleepArm(1);
+    }
+}
+
+uint32_t lcd_panel_get_sleep_mask(void)
+{
+    return panel_sleep_mask;
+}
+
+// 直接按屏选CS，调用方持有总线锁
+static void LCD_PanelCmd(LCDC_HandleTypeDef *hlcdc, int panel, uint16_t reg)
+{
+    HAL_GPIO_Set(screen_map[panel].cs_pin, 0);
+    HAL_LCDC_WriteU8Reg(hlcdc, reg, (uint8_t *)NULL, 0);
+    HAL_GPIO_Set(screen_map[panel].cs_pin, 1);
+}
+
+// 每块屏最多前进一步，返回距下一步的节拍数，0表示全部到位
+static rt_tick_t LCD_PanelSleepStep(LCDC_HandleTypeDef *hlcdc)
+{
+    const rt_tick_t now = rt_tick_get();
+    const rt_tick_t cmd_delay = rt_tick_from_millisecond(LCD_SLEEP_CMD_DELAY_MS);
+    const rt_tick_t hold = rt_tick_from_millisecond(LCD_SLEEP_OUT_HOLD_MS);
+    const uint32_t req = panel_sleep_req;
+    rt_tick_t wait = 0;
+
+    for (int i = 0; i < LCD_SCREEN_NUM; i++)
+    {
+        const uint32_t bit = 1u << i;
+        const rt_tick_t since = now - panel_sleep_tick[i];
+        rt_tick_t left = 0;
+
+        if (panel_waking & bit)
+        {
+            // 显存保留了睡前的内容，开显示后由上层重画
+            if (since < cmd_delay)
+            {
+                left = cmd_delay - since;
+            }
+            else
+            {
+                LCD_PanelCmd(hlcdc, i, REG_DISPLAY_ON);
+                panel_waking &= ~bit;
+                panel_sleep_mask &= ~bit;
+            }
+        }
+        else if ((req & bit) && !(panel_sleep_mask & bit))
+        {
+            // 刚唤醒不久的屏按剩余的保持时间再来
+            if (since < hold)
+            {
+                left = hold - since;
+            }
+            else
+            {
+                LCD_PanelCmd(hlcdc, i, REG_DISPLAY_OFF);
+                LCD_PanelCmd(hlcdc, i, REG_SLEEP_IN);
+                panel_sleep_tick[i] = now;
+                panel_sleep_mask |= bit;
+            }
+        }
+        else if (!(req & bit) && (panel_sleep_mask & bit))
+        {
+            if (since < cmd_delay)
+            {
+                left = cmd_delay - since;
+            }
+            else
+            {
+                LCD_PanelCmd(hlcdc, i, REG_SLEEP_OUT);
+                panel_sleep_tick[i] = now;
+                panel_waking |= bit;
+                left = cmd_delay;
+            }
+        }
+
+        if (left && (wait == 0 || left < wait))
+        {
+            wait = left;
+        }
+    }
+    return wait;
+}
+
+// 软定时器线程上下文；总线被刷屏或其他寄存器访问占用时下一个节拍再试
+static void LCD_PanelSleepTimeout(void *args)
+{
+    rt_tick_t wait = 1;
+    if (LCD_BusTryLock())
+    {
+        wait = LCD_PanelSleepStep(panel_sleep_hlcdc);
+        LCD_BusUnlock();
+    }
+    if (wait)
+    {
+        LCD_PanelSleepArm(wait);
+    }
+}
+
+// LCD_Drv_Init刚唤醒并打开了全部屏，重新初始化时也从这里重新开始
+static void LCD_PanelSleepInit(LCDC_HandleTypeDef *hlcdc)
+{
+    if (!panel_sleep_hlcdc)
+    {
+        rt_timer_init(&panel_sleep_timer, "lcd_slp", LCD_PanelSleepTimeout, RT_NULL, 1,
+                      RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_SOFT_TIMER);
+    }
+    rt_timer_stop(&panel_sleep_timer);
+    panel_sleep_mask = 0;
+    panel_waking = 0;
+    for (int i = 0; i < LCD_SCREEN_NUM; i++)
+    {
+        panel_sleep_tick[i] = rt_tick_get();
+    }
+    panel_sleep_hlcdc = hlcdc;
+    if (panel_sleep_req)
+    {
+        LCD_PanelSleepArm(1);
+    }
+}
+
+// 按当前区域生成各屏的发送计划，跳过与区域没有交集的屏和睡眠的屏
+static int LCD_BuildFlushPlan(void)
+{
+    const uint32_t bpp = (lcdc_int_cfg.color_mode == LCDC_PIXEL_FORMAT_RGB565) ? 2 : 3;
+    int cnt = 0;
+
+    for (int i = 0; i < LCD_SCREEN_NUM; i++) {
+        if ((panel_sleep_mask | panel_sleep_req) & (1u << i)) {
+            continue;
+        }
+
+        // 计算当前屏幕的物理边界
+        const uint16_t screen_x0 = screen_map[i].col * THE_LCD_PIXEL_WIDTH;
+        const uint16_t screen_y0 = screen_map[i].row * THE_LCD_PIXEL_HEIGHT;
+        const uint16_t screen_x1 = screen_x0 + THE_LCD_PIXEL_WIDTH - 1;
+        const uint16_t screen_y1 = screen_y0 + THE_LCD_PIXEL_HEIGHT - 1;
+
+        if (Region_Xpos0 > screen_x1 || Region_Xpos1 < screen_x0 ||
+            Region_Ypos0 > screen_y1 || Region_Ypos1 < screen_y0 ||
+            Region_Xpos0 > Region_Xpos1 || Region_Ypos0 > Region_Ypos1)
+        {
+            continue;
+        }
+
+        // ROI在当前屏幕内的局部坐标
+        const uint16_t local_x0 = MAX(Region_Xpos0, screen_x0) - screen_x0;
+        const uint16_t local_y0 = MAX(Region_Ypos0, screen_y0) - screen_y0;
+        const uint16_t local_x1 = MIN(Region_Xpos1, screen_x1) - screen_x0;
+        const uint16_t local_y1 = MIN(Region_Ypos1, screen_y1) - screen_y0;
+
+        PanelFlush *p = &flush_plan[cnt++];
+        p->index = i;
+        p->cs_pin = screen_map[i].cs_pin;
+        p->caset[0] = local_x0 >> 8;
+        p->caset[1] = local_x0 & 0xFF;
+        p->caset[2] = local_x1 >> 8;
+        p->caset[3] = local_x1 & 0xFF;
+        p->raset[0] = local_y0 >> 8;
+        p->raset[1] = local_y0 & 0xFF;
+        p->raset[2] = local_y1 >> 8;
+        p->raset[3] = local_y1 & 0xFF;
+        p->x0 = screen_x0 + local_x0;
+        p->y0 = screen_y0 + local_y0;
+        p->x1 = screen_x0 + local_x1;
+        p->y1 = screen_y0 + local_y1;
+        p->bytes = (uint32_t)(local_x1 - local_x0 + 1) * (local_y1 - local_y0 + 1) * bpp;
+    }
+    return cnt;
+}
+
+// 在启动DMA前把所有屏的窗口写好，窗口相同的屏同时拉低CS只写一次。
+// 各屏控制器独立保存窗口，中断里切到下一块屏时只需切CS、设ROI并启动DMA，
+// 不再在中断里做阻塞的寄存器写入
+static void LCD_SendFlushWindows(LCDC_HandleTypeDef *hlcdc)
+{
+    uint32_t sent = 0;
+
+    for (int i = 0; i < flush_plan_cnt; i++) {
+        if (sent & (1u << i)) {
+            continue;
+        }
+
+        uint32_t group = 0;
+        for (int j = i; j < flush_plan_cnt; j++) {
+            if (memcmp(flush_plan[j].caset, flush_plan[i].caset, 4) == 0 &&
+                memcmp(flush_plan[j].raset, flush_plan[i].raset, 4) == 0) {
+                group |= 1u << j;
+                HAL_GPIO_Set(flush_plan[j].cs_pin, 0);
+            }
+        }
+        HAL_LCDC_WriteU8Reg(hlcdc, REG_CASET, flush_plan[i].caset, 4);
+        HAL_LCDC_WriteU8Reg(hlcdc, REG_RASET, flush_plan[i].raset, 4);
+        for (int j = i; j < flush_plan_cnt; j++) {
+            if (group & (1u << j)) {
+                HAL_GPIO_Set(flush_plan[j].cs_pin, 1);
+            }
         }
+        sent |= group;
     }
-    if (!found) {
-        rt_kprintf("Error: Invalid CS pin %d\n", current_lcd_cs_pin);
-        return RT_FALSE;
+}
+
+static void LCD_StartPanelFlush(LCDC_HandleTypeDef *hlcdc, const PanelFlush *p)
+{
+    current_lcd_cs_pin = p->cs_pin;
+    HAL_GPIO_Set(p->cs_pin, 0);
+    HAL_LCDC_SetROIArea(hlcdc, p->x0, p->y0, p->x1, p->y1);
+    hlcdc->XferCpltCallback = LCD_SendLayerDataCpltCbk;
+    frame_profiler_dma_begin(p->index, p->bytes);
+    HAL_LCDC_SendLayerData2Reg_IT(hlcdc, REG_WRITE_RAM, 1);
+}
+
+#ifdef LCD_GC9107_TE_SYNC
+/*
+ * TE同步刷屏：TE上升沿表示该屏进入消隐期，此后扫描从第0行开始。DMA写入比
+ * 扫描快，在沿后的窗口内启动就始终走在扫描线前面，不会撕裂。
+ * 每屏一根TE线时由各自的沿启动；只接第1块屏的TE时，其余屏的沿按固定相位差推算，
+ * 第1块屏睡眠后TE停止，其余屏不再等沿直接刷。
+ */
+#define LCD_TE_TIMEOUT_MS       50      // 收不到TE时的兜底，约3个刷新周期
+#define LCD_TE_PERIOD_MIN_US    5000
+#define LCD_TE_PERIOD_MAX_US    50000
+
+#ifndef LCD_GC9107_TE_WINDOW_US
+#define LCD_GC9107_TE_WINDOW_US 2000
+#endif
+#ifndef LCD_GC9107_TE_PINS
+#define LCD_GC9107_TE_PINS      "6,8,9"
+#endif
+#ifndef LCD_GC9107_TE_OFFSETS_US
+#define LCD_GC9107_TE_OFFSETS_US "0"
+#endif
+#ifndef LCD_GC9107_TE_HWTIMER
+#define LCD_GC9107_TE_HWTIMER   "btim1"
+#endif
+#define LCD_TE_SPIN_MAX_US      100     // 没有硬件定时器时，短于此的相位差在TE中断里按DWT忙等
+
+#ifdef LCD_GC9107_TE_PER_PANEL
+#define LCD_TE_LINE_NUM LCD_SCREEN_NUM
+#else
+#define LCD_TE_LINE_NUM 1
+#endif
+
+// TE引脚（PA编号），初始化时从LCD_GC9107_TE_PINS解析
+static uint16_t lcd_te_pins[LCD_TE_LINE_NUM];
+
+// 主TE模式下各屏相对第1块屏的相位差
+static uint32_t lcd_te_offset_us[LCD_SCREEN_NUM];
+
+typedef struct {
+    uint32_t flushes;       // 请求启动的屏刷新次数
+    uint32_t immediate;     // 请求时已在窗口内，直接启动
+    uint32_t waited;        // 等到TE沿后启动
+    uint32_t late;          // 启动时已过窗口（定时器延迟或超时兜底）
+    uint32_t timeouts;      // 没有等到TE沿
+    uint32_t overruns;      // 传输跨过了下一个TE沿
+    uint32_t wait_us_sum;
+    uint32_t wait_us_max;
+    uint32_t offset_starts;     // 主TE模式下按相位差启动的次数
+    uint32_t offset_err_us_sum; // 启动时刻晚于推算沿的时间
+    uint32_t offset_err_us_max;
+    uint32_t unpaced;           // 主TE屏睡眠，不等沿直接启动
+} LCD_TE_Stats;
+
+static struct {
+    LCDC_HandleTypeDef *hlcdc;
+    uint32_t cycles_per_us;
+    uint32_t edge[LCD_TE_LINE_NUM];         // 最近一次沿，DWT周期数
+    bool edge_valid[LCD_TE_LINE_NUM];
+    uint32_t period;                        // 刷新周期，DWT周期数，0为未知
+    uint32_t start[LCD_SCREEN_NUM];         // 各屏DMA启动时刻
+    const PanelFlush *pending;
+    uint32_t pending_since;
+    struct rt_timer timeout_timer;
+    struct rt_timer offset_timer;           // 没有硬件定时器时的兜底，按系统节拍向上取整
+    rt_device_t hwtimer;                    // 相位差定时，微秒精度
+    bool enabled;                           // TE引脚配置有误时不等待，直接刷屏
+    LCD_TE_Stats stats;
+} lcd_te;
+
+static inline uint32_t LCD_TE_Now(void)
+{
+    return DWT->CYCCNT;
+}
+
+// 距该屏最近一次TE沿的时间（周期数），沿未知时返回UINT32_MAX
+static uint32_t LCD_TE_Phase(int panel, uint32_t now)
+{
+    int line = (LCD_TE_LINE_NUM > 1) ? panel : 0;
+    uint32_t offset = (LCD_TE_LINE_NUM > 1) ? 0 : lcd_te_offset_us[panel] * lcd_te.cycles_per_us;
+
+    if (!lcd_te.edge_valid[line] || lcd_te.period == 0)
+    {
+        return UINT32_MAX;
     }
 
-    // 计算当前屏幕的物理边界
-    const uint16_t screen_x0 = col * THE_LCD_PIXEL_WIDTH;
-    const uint16_t screen_y0 = row * THE_LCD_PIXEL_HEIGHT;
-    const uint16_t screen_x1 = screen_x0 + THE_LCD_PIXEL_WIDTH - 1;
-    const uint16_t screen_y1 = screen_y0 + THE_LCD_PIXEL_HEIGHT - 1;
+    int32_t since = (int32_t)(now - lcd_te.edge[line] - offset);
+    if (since > (int32_t)(lcd_te.period * 4))
+    {
+        return UINT32_MAX;  // TE已停，推算不可信
+    }
+    since %= (int32_t)lcd_te.period;
+    if (since < 0)
+    {
+        since += lcd_te.period;
+    }
+    return (uint32_t)since;
+}
 
-    // 检查ROI是否与当前屏幕有交集
-    if (Region_Xpos0 > screen_x1 || Region_Xpos1 < screen_x0 ||
-        Region_Ypos0 > screen_y1 || Region_Ypos1 < screen_y0) 
+static void LCD_TE_Start(const PanelFlush *p, uint32_t now)
+{
+    if (LCD_TE_Phase(p->index, now) >= LCD_GC9107_TE_WINDOW_US * lcd_te.cycles_per_us)
     {
-        return RT_FALSE;
+        lcd_te.stats.late++;
     }
+    lcd_te.start[p->index] = now;
+    LCD_StartPanelFlush(lcd_te.hlcdc, p);
+}
+
+// 启动等待中的屏刷新，须在关中断或中断上下文中调用
+static void LCD_TE_StartPending(uint32_t now)
+{
+    const PanelFlush *p = lcd_te.pending;
+    uint32_t wait_us = (now - lcd_te.pending_since) / lcd_te.cycles_per_us;
+
+    lcd_te.pending = NULL;
+    rt_timer_stop(&lcd_te.timeout_timer);
+    lcd_te.stats.waited++;
+    lcd_te.stats.wait_us_sum += wait_us;
+    lcd_te.stats.wait_us_max = MAX(lcd_te.stats.wait_us_max, wait_us);
+    LCD_TE_Start(p, now);
+}
 
-    // 计算ROI在当前屏幕内的局部坐标（使用MAX/MIN处理边界）
-    const uint16_t local_x0 = MAX(Region_Xpos0, screen_x0) - screen_x0;
-    const uint16_t local_y0 = MAX(Region_Ypos0, screen_y0) - screen_y0;
-    const uint16_t local_x1 = MIN(Region_Xpos1, screen_x1) - screen_x0;
-    const uint16_t local_y1 = MIN(Region_Ypos1, screen_y1) - screen_y0;
+// 主TE模式：到达推算出的该屏沿，启动并记录相对推算沿的误差
+static void LCD_TE_StartOffset(uint32_t now)
+{
+    uint32_t phase = LCD_TE_Phase(lcd_te.pending->index, now);
+    uint32_t err_us = (phase == UINT32_MAX) ? 0 : phase / lcd_te.cycles_per_us;
 
-    // 验证局部坐标有效性
-    if (local_x0 >= THE_LCD_PIXEL_WIDTH || local_y0 >= THE_LCD_PIXEL_HEIGHT ||
-        local_x1 >= THE_LCD_PIXEL_WIDTH || local_y1 >= THE_LCD_PIXEL_HEIGHT ||
-        local_x0 > local_x1 || local_y0 > local_y1) 
+    lcd_te.stats.offset_starts++;
+    lcd_te.stats.offset_err_us_sum += err_us;
+    lcd_te.stats.offset_err_us_max = MAX(lcd_te.stats.offset_err_us_max, err_us);
+    LCD_TE_StartPending(now);
+}
+
+static void LCD_TE_IrqHandler(void *args)
+{
+    int line = (int)(rt_ubase_t)args;
+    uint32_t now = LCD_TE_Now();
+
+    if (lcd_te.edge_valid[line])
     {
-        return RT_FALSE;
+        uint32_t d = now - lcd_te.edge[line];
+        if (d >= LCD_TE_PERIOD_MIN_US * lcd_te.cycles_per_us &&
+            d <= LCD_TE_PERIOD_MAX_US * lcd_te.cycles_per_us)
+        {
+            lcd_te.period = lcd_te.period ? lcd_te.period - lcd_te.period / 8 + d / 8 : d;
+        }
     }
+    lcd_te.edge[line] = now;
+    lcd_te.edge_valid[line] = true;
 
-    // 设置列地址 (CASET)
-    parameter[0] = local_x0 >> 8;
-    parameter[1] = local_x0 & 0xFF;
-    parameter[2] = local_x1 >> 8;
-    parameter[3] = local_x1 & 0xFF;
-    LCD_WriteReg(hlcdc, REG_CASET, parameter, 4);
+    const PanelFlush *p = lcd_te.pending;
+    if (!p)
+    {
+        return;
+    }
+    if (LCD_TE_LINE_NUM > 1)
+    {
+        if (p->index == line)
+        {
+            LCD_TE_StartPending(now);
+        }
+        return;
+    }
 
-    // 设置行地址 (RASET)
-    parameter[0] = local_y0 >> 8;
-    parameter[1] = local_y0 & 0xFF;
-    parameter[2] = local_y1 >> 8;
-    parameter[3] = local_y1 & 0xFF;
-    LCD_WriteReg(hlcdc, REG_RASET, parameter, 4);
+    // 主TE：等到推算出的该屏沿再启动
+    uint32_t offset_us = lcd_te_offset_us[p->index];
+    if (offset_us == 0)
+    {
+        LCD_TE_StartPending(now);
+        return;
+    }
+#ifdef RT_USING_HWTIMER
+    if (lcd_te.hwtimer)
+    {
+        rt_hwtimerval_t tv = { .sec = 0, .usec = (rt_int32_t)offset_us };
+        rt_device_write(lcd_te.hwtimer, 0, &tv, sizeof(tv));
+        return;
+    }
+#endif
+    // 没有硬件定时器：很短的相位差在中断里忙等，其余按系统节拍定时，至少要等到下一个节拍
+    if (offset_us < LCD_TE_SPIN_MAX_US)
+    {
+        uint32_t target = offset_us * lcd_te.cycles_per_us;
+        while (LCD_TE_Now() - now < target)
+        {
+        }
+        LCD_TE_StartOffset(LCD_TE_Now());
+        return;
+    }
+    rt_tick_t ticks = rt_tick_from_millisecond((offset_us + 999) / 1000);
+    rt_timer_control(&lcd_te.offset_timer, RT_TIMER_CTRL_SET_TIME, &ticks);
+    rt_timer_start(&lcd_te.offset_timer);
+}
 
-    // 设置硬件ROI（使用全局坐标）
-    HAL_LCDC_SetROIArea(hlcdc, 
-        screen_x0 + local_x0, screen_y0 + local_y0,
-        screen_x0 + local_x1, screen_y0 + local_y1
-    );
-              
-    return RT_TRUE;
+static void LCD_TE_OffsetTimeout(void *args)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    if (lcd_te.pending)
+    {
+        LCD_TE_StartOffset(LCD_TE_Now());
+    }
+    rt_hw_interrupt_enable(level);
 }
 
-/**
-  * @brief  Writes pixel.
-  * @param  Xpos: specifies the X position.
-  * @param  Ypos: specifies the Y position.
-  * @param  RGBCode: the RGB pixel color
-  * @retval None
-  */
-static void LCD_WritePixel(LCDC_HandleTypeDef *hlcdc, uint16_t Xpos, uint16_t Ypos, const uint8_t *RGBCode)
+#if defined(LCD_GC9107_TE_MASTER) && defined(RT_USING_HWTIMER)
+static rt_err_t LCD_TE_HwtimerTimeout(rt_device_t dev, rt_size_t size)
 {
-    uint8_t data = 0;
-    /* Set Cursor */
-    LCD_SetRegion(hlcdc, Xpos, Ypos, Xpos, Ypos);
-    LCD_WriteReg(hlcdc, REG_WRITE_RAM, (uint8_t *)RGBCode, 2);
+    LCD_TE_OffsetTimeout(RT_NULL);
+    return RT_EOK;
 }
 
-static void (* Ori_XferCpltCallback)(struct __LCDC_HandleTypeDef *lcdc);
+// 打开相位差用的硬件定时器，失败时相位差按系统节拍定时
+static void LCD_TE_HwtimerInit(void)
+{
+    rt_device_t dev = rt_device_find(LCD_GC9107_TE_HWTIMER);
+    if (!dev || rt_device_open(dev, RT_DEVICE_OFLAG_RDWR) != RT_EOK)
+    {
+        LOG_W("hwtimer %s not available, TE phase offsets rounded to ticks", LCD_GC9107_TE_HWTIMER);
+        return;
+    }
+    rt_hwtimer_mode_t mode = HWTIMER_MODE_ONESHOT;
+    rt_uint32_t freq = 1000000;
+    rt_device_control(dev, HWTIMER_CTRL_FREQ_SET, &freq);
+    rt_device_control(dev, HWTIMER_CTRL_MODE_SET, &mode);
+    rt_device_set_rx_indicate(dev, LCD_TE_HwtimerTimeout);
+    lcd_te.hwtimer = dev;
+}
+#endif
 
-static void HAL_GPIO_Set(uint16_t pin, int value)
+static void LCD_TE_Timeout(void *args)
 {
-    rt_pin_write(pin, (value != 0) ? PIN_HIGH : PIN_LOW);
+    rt_base_t level = rt_hw_interrupt_disable();
+    if (lcd_te.pending)
+    {
+        lcd_te.stats.timeouts++;
+        LCD_TE_StartPending(LCD_TE_Now());
+    }
+    rt_hw_interrupt_enable(level);
 }
 
-static int current_screen_index = 0;
+// 在窗口内则立即启动，否则挂起到该屏的下一个TE沿
+static void LCD_RequestPanelFlush(LCDC_HandleTypeDef *hlcdc, const PanelFlush *p)
+{
+    uint32_t now = LCD_TE_Now();
 
-static void LCD_SendLayerDataCpltCbk(LCDC_HandleTypeDef *hlcdc)
+    lcd_te.hlcdc = hlcdc;
+    if (!lcd_te.enabled)
+    {
+        LCD_StartPanelFlush(hlcdc, p);
+        return;
+    }
+    lcd_te.stats.flushes++;
+    // 主TE屏睡眠时没有TE可等，醒着的屏不再每次等到超时
+    if (LCD_TE_LINE_NUM == 1 && (panel_sleep_mask & 1u))
+    {
+        lcd_te.stats.unpaced++;
+        lcd_te.start[p->index] = now;
+        LCD_StartPanelFlush(hlcdc, p);
+        return;
+    }
+    if (LCD_TE_Phase(p->index, now) < LCD_GC9107_TE_WINDOW_US * lcd_te.cycles_per_us)
+    {
+        lcd_te.stats.immediate++;
+        LCD_TE_Start(p, now);
+        return;
+    }
+
+    lcd_te.pending = p;
+    lcd_te.pending_since = now;
+    rt_timer_start(&lcd_te.timeout_timer);
+}
+
+static void LCD_TE_PanelDone(int panel)
 {
-    HAL_GPIO_Set(current_lcd_cs_pin, 1);
-    current_screen_index++;
-    while (current_screen_index < LCD_SCREEN_NUM) // 使用3个屏幕而不是6个
+    if (lcd_te.period && LCD_TE_Now() - lcd_te.start[panel] > lcd_te.period)
     {
-        current_lcd_cs_pin = lcd_cs_pins[current_screen_index];
-        if (LCDC_SetROIArea(hlcdc))
+        lcd_te.stats.overruns++;
+    }
+}
+
+static void LCD_TE_Init(LCDC_HandleTypeDef *hlcdc)
+{
+    uint8_t parameter[1];
+    int32_t list[LCD_SCREEN_NUM] = {0};
+
+    if (LCD_ParseList(LCD_GC9107_TE_PINS, list, LCD_TE_LINE_NUM) != LCD_TE_LINE_NUM)
+    {
+        LOG_E("LCD_GC9107_TE_PINS \"%s\" needs %d pins, TE sync disabled", LCD_GC9107_TE_PINS, LCD_TE_LINE_NUM);
+        return;
+    }
+    for (int i = 0; i < LCD_TE_LINE_NUM; i++)
+    {
+        if (list[i] < 0 || list[i] >= (int32_t)LCD_PA_NUM)
         {
-            HAL_GPIO_Set(current_lcd_cs_pin, 0);
-            hlcdc->XferCpltCallback = LCD_SendLayerDataCpltCbk;
-            HAL_LCDC_SendLayerData2Reg_IT(hlcdc, REG_WRITE_RAM, 1);
+            LOG_E("invalid TE pin PA%02d, TE sync disabled", (int)list[i]);
             return;
         }
-        current_screen_index++;
+        lcd_te_pins[i] = list[i];
+    }
+    memset(list, 0, sizeof(list));
+    LCD_ParseList(LCD_GC9107_TE_OFFSETS_US, list, LCD_SCREEN_NUM);
+    for (int i = 0; i < LCD_SCREEN_NUM; i++)
+    {
+        lcd_te_offset_us[i] = MAX(list[i], 0);
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    lcd_te.cycles_per_us = MAX(HAL_RCC_GetHCLKFreq(CORE_ID_DEFAULT) / 1000000, 1);
+    lcd_te.hlcdc = hlcdc;
+
+    rt_timer_init(&lcd_te.timeout_timer, "lcd_te", LCD_TE_Timeout, RT_NULL,
+                  rt_tick_from_millisecond(LCD_TE_TIMEOUT_MS),
+                  RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER);
+    rt_timer_init(&lcd_te.offset_timer, "lcd_teo", LCD_TE_OffsetTimeout, RT_NULL, 1,
+                  RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER);
+#if defined(LCD_GC9107_TE_MASTER) && defined(RT_USING_HWTIMER)
+    LCD_TE_HwtimerInit();
+#endif
+
+    // TE输出只在垂直消隐期有效
+    parameter[0] = 0x00;
+    LCD_WriteReg_More(hlcdc, REG_TEARING_EFFECT, parameter, 1);
+
+    for (int i = 0; i < LCD_TE_LINE_NUM; i++) {
+        HAL_PIN_Set(lcd_pa_pad_gpio[lcd_te_pins[i]].pad, lcd_pa_pad_gpio[lcd_te_pins[i]].gpio, PIN_PULLDOWN, 1);
+        rt_pin_mode(lcd_te_pins[i], PIN_MODE_INPUT);
+        rt_pin_attach_irq(lcd_te_pins[i], PIN_IRQ_MODE_RISING, LCD_TE_IrqHandler, (void *)(rt_ubase_t)i);
+        rt_pin_irq_enable(lcd_te_pins[i], PIN_IRQ_ENABLE);
+    }
+    lcd_te.enabled = true;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void lcd_te_stats(int argc, char **argv)
+{
+    LCD_TE_Stats s;
+    rt_base_t level = rt_hw_interrupt_disable();
+    s = lcd_te.stats;
+    uint32_t period_us = lcd_te.period / lcd_te.cycles_per_us;
+    if (argc > 1 && strcmp(argv[1], "reset") == 0)
+    {
+        memset(&lcd_te.stats, 0, sizeof(lcd_te.stats));
     }
-    // 全部完成，恢复原始回调
-    current_screen_index = 0;
+    rt_hw_interrupt_enable(level);
+
+    uint32_t missed = s.late + s.overruns;
+    rt_kprintf("TE period %u us, window %u us, %u TE line(s)\n",
+               period_us, LCD_GC9107_TE_WINDOW_US, (unsigned)LCD_TE_LINE_NUM);
+    rt_kprintf("flushes %u: immediate %u, waited %u (avg %u us, max %u us)\n",
+               s.flushes, s.immediate, s.waited,
+               s.waited ? s.wait_us_sum / s.waited : 0, s.wait_us_max);
+    rt_kprintf("missed window %u (%u%%): late start %u, timeout %u, overrun %u\n",
+               missed, s.flushes ? missed * 100 / s.flushes : 0, s.late, s.timeouts, s.overruns);
+    if (LCD_TE_LINE_NUM == 1)
+    {
+        rt_kprintf("phase offset starts %u, error avg %u us max %u us (%s)\n",
+                   s.offset_starts, s.offset_starts ? s.offset_err_us_sum / s.offset_starts : 0,
+                   s.offset_err_us_max, lcd_te.hwtimer ? "hwtimer" : "tick timer");
+        rt_kprintf("unpaced while panel 1 sleeps %u\n", s.unpaced);
+    }
+}
+MSH_CMD_EXPORT(lcd_te_stats, GC9107 TE sync pacing stats: lcd_te_stats [reset]);
+#endif /* RT_USING_FINSH */
+
+#else
+
+static inline void LCD_RequestPanelFlush(LCDC_HandleTypeDef *hlcdc, const PanelFlush *p)
+{
+    LCD_StartPanelFlush(hlcdc, p);
+}
+
+#endif /* LCD_GC9107_TE_SYNC */
+
+static void LCD_SendLayerDataCpltCbk(LCDC_HandleTypeDef *hlcdc)
+{
+    const PanelFlush *done = &flush_plan[flush_plan_pos];
+
+    HAL_GPIO_Set(done->cs_pin, 1);
+    frame_profiler_dma_end(done->index);
+#ifdef LCD_GC9107_TE_SYNC
+    LCD_TE_PanelDone(done->index);
+#endif
+    if (++flush_plan_pos < flush_plan_cnt)
+    {
+        LCD_RequestPanelFlush(hlcdc, &flush_plan[flush_plan_pos]);
+        return;
+    }
+    // 全部完成，释放总线并恢复原始回调
+    LCD_BusUnlock();
     hlcdc->XferCpltCallback = Ori_XferCpltCallback;
     if (Ori_XferCpltCallback)
         Ori_XferCpltCallback(hlcdc);
@@ -525,26 +1207,27 @@ static void LCD_SendLayerDataCpltCbk(LCDC_HandleTypeDef *hlcdc)
 
 static void LCD_WriteMultiplePixels(LCDC_HandleTypeDef *hlcdc, const uint8_t *RGBCode, uint16_t Xpos0, uint16_t Ypos0, uint16_t Xpos1, uint16_t Ypos1)
 {
+    LCD_BusLock();
+    frame_profiler_flush_begin();
     HAL_LCDC_LayerSetData(hlcdc, HAL_LCDC_LAYER_DEFAULT, (uint8_t *)RGBCode, Xpos0, Ypos0, Xpos1, Ypos1);
     Ori_XferCpltCallback = hlcdc->XferCpltCallback;
-    current_screen_index = 0;
-    while (current_screen_index < LCD_SCREEN_NUM) // 使用3个屏幕而不是6个
+    flush_plan_cnt = LCD_BuildFlushPlan();
+    flush_plan_pos = 0;
+    if (flush_plan_cnt == 0)
     {
-        current_lcd_cs_pin = lcd_cs_pins[current_screen_index];
-        if (LCDC_SetROIArea(hlcdc))
-        {
-            HAL_GPIO_Set(current_lcd_cs_pin, 0);
-            hlcdc->XferCpltCallback = LCD_SendLayerDataCpltCbk;
-            rt_base_t level = rt_hw_interrupt_disable(); //禁用中断
-            HAL_LCDC_SendLayerData2Reg_IT(hlcdc, REG_WRITE_RAM, 1);
-            rt_hw_interrupt_enable(level); //恢复中断
-            return;
-        }
-        current_screen_index++;
+        // 区域不在任何醒着的屏上
+        LCD_BusUnlock();
+        frame_profiler_flush_end();
+        if (Ori_XferCpltCallback)
+            Ori_XferCpltCallback(hlcdc);
+        return;
     }
-    // 全部失败
-    if (Ori_XferCpltCallback)
-        Ori_XferCpltCallback(hlcdc);
+
+    LCD_SendFlushWindows(hlcdc);
+    rt_base_t level = rt_hw_interrupt_disable(); //禁用中断
+    LCD_RequestPanelFlush(hlcdc, &flush_plan[0]);
+    rt_hw_interrupt_enable(level); //恢复中断
+    frame_profiler_flush_end();
 }
 
 /**
@@ -561,12 +1244,12 @@ static void LCD_WriteReg(LCDC_HandleTypeDef *hlcdc, uint16_t LCD_Reg, uint8_t *P
 
 static void LCD_WriteReg_More(LCDC_HandleTypeDef *hlcdc, uint16_t LCD_Reg, uint8_t *Parameters, uint32_t NbParameters)
 {
-    // 全部CS拉低 - 只操作3个引脚
+    // 全部CS拉低
     for (int i = 0; i < LCD_SCREEN_NUM; i++) {
         HAL_GPIO_Set(lcd_cs_pins[i], 0);
     }
     HAL_LCDC_WriteU8Reg(hlcdc, LCD_Reg, Parameters, NbParameters);
-    // 全部CS拉高 - 只操作3个引脚
+    // 全部CS拉高
     for (int i = 0; i < LCD_SCREEN_NUM; i++) {
         HAL_GPIO_Set(lcd_cs_pins[i], 1);
     }
@@ -599,6 +1282,7 @@ static uint32_t LCD_ReadPixel(LCDC_HandleTypeDef *hlcdc, uint16_t Xpos, uint16_t
     uint32_t ret_v;
 
     parameter[0] = 0x55;
+    LCD_BusLock();
     LCD_WriteReg(hlcdc, REG_COLOR_MODE, parameter, 1);
 
     LCD_SetRegion(hlcdc, Xpos, Ypos, Xpos, Ypos);
@@ -627,6 +1311,7 @@ static uint32_t LCD_ReadPixel(LCDC_HandleTypeDef *hlcdc, uint16_t Xpos, uint16_t
         break;
     }
     LCD_WriteReg(hlcdc, REG_COLOR_MODE, parameter, 1);
+    LCD_BusUnlock();
 
     return ret_v;
 }
@@ -655,14 +1340,18 @@ static void LCD_SetColorMode(LCDC_HandleTypeDef *hlcdc, uint16_t color_mode)
         break;
     }
 
+    LCD_BusLock();
     LCD_WriteReg_More(hlcdc, REG_COLOR_MODE, parameter, 1);
     HAL_LCDC_SetOutFormat(hlcdc, lcdc_int_cfg.color_mode);
+    LCD_BusUnlock();
 }
 
 static void LCD_SetBrightness(LCDC_HandleTypeDef *hlcdc, uint8_t br)
 {
     uint8_t bright = (uint8_t)((int)UINT8_MAX * br / 100);
+    LCD_BusLock();
     LCD_WriteReg_More(hlcdc, REG_WBRIGHT, &br, 1);
+    LCD_BusUnlock();
 }
 
 static const LCD_DrvOpsDef GC9107_drv =
@@ -1,32 +1,192 @@
 #include "data_manager.h"
 #include <string.h>
 #include <stdbool.h>
+#include <time.h>
 #include "event_bus.h"
+#include "stock_watchlist.h"
+#include "data_snapshot.h"
+#include "sht30_controller.h"
+#include "flash_worker.h"
+
+/* 过期截止时间队列：每个数据槽一个截止时间，共用一个单次定时器按最早的截止时间触发。
+ * 定时器为软定时器，回调取lock把数据置为无效后才发出过期事件；
+ * deadline/generation/armed用关中断保护，live只在持有lock时访问 */
+typedef enum {
+    DATA_SLOT_WEATHER = 0,
+    DATA_SLOT_STOCK,
+    DATA_SLOT_SYSTEM,
+    DATA_SLOT_COUNT
+} data_slot_t;
+
+typedef struct {
+    rt_tick_t deadline;
+    uint32_t generation;    /* 每次布置/撤销截止时间递增 */
+    bool armed;             /* 定时器尚未处理该截止时间 */
+    bool live;              /* 当前数据未过期且需要过期处理 */
+} data_deadline_t;
+
+static const event_type_t g_expired_events[DATA_SLOT_COUNT] = {
+    EVENT_DATA_WEATHER_EXPIRED,
+    EVENT_DATA_STOCK_EXPIRED,
+    EVENT_DATA_SYSTEM_EXPIRED,
+};
+
+static void expire_slot_locked(data_slot_t slot);
 
 static struct {
     weather_data_t weather;
-    stock_data_t stock;
+    /* 自选股列表，stock_cursor指向当前显示的股票 */
+    stock_data_t stocks[STOCK_WATCHLIST_SIZE];
+    uint8_t stock_count;
+    uint8_t stock_cursor;
     system_monitor_data_t system;
     
     rt_tick_t weather_update_tick;
     rt_tick_t stock_update_tick;
     rt_tick_t system_update_tick;
     
+    /* 自上次被UI取走以来累积的脏字段掩码 */
+    uint32_t weather_dirty;
+    uint32_t stock_dirty;
+    uint32_t system_dirty;
+    
+    /* 脏掩码非零的数据更新次数，不随UI取数清零，供空闲检测等旁路观察者比较 */
+    uint32_t weather_changes;
+    uint32_t stock_changes;
+    uint32_t system_changes;
+    
     uint32_t cleanup_count;
     rt_tick_t last_cleanup_tick;
     
+    data_deadline_t deadlines[DATA_SLOT_COUNT];
+    rt_timer_t expiry_timer;
+    bool expiry_timer_active;
+    
+    /* 最后一次有效数据的快照；stale_mask为当前显示快照数据的部分（DATA_SNAPSHOT_HAS_*） */
+    data_snapshot_t last_known;
+    data_snapshot_store_t snapshot_store;
+    bool snapshot_storage_ready;
+    uint8_t stale_mask;
+    uint32_t last_saved_crc;
+    rt_tick_t last_persist_tick;
+    uint32_t persist_count;
+    bool persist_busy;          /* 有一次保存已交给flash_worker，尚未写完 */
+    data_snapshot_t persist_snap;   /* 待写入的快照，persist_busy期间只由flash_worker访问 */
+    uint32_t persist_crc;
+    
     rt_mutex_t lock;
     
     bool initialized;
 } g_data_store = {0};
 
-static bool is_data_expired(rt_tick_t last_update_tick)
+/* 按最早的截止时间重新布置定时器，需在关中断时调用 */
+static void schedule_expiry_timer(void)
+{
+    rt_tick_t now = rt_tick_get();
+    rt_int32_t earliest = 0;
+    bool any = false;
+    
+    for (int i = 0; i < DATA_SLOT_COUNT; i++) {
+        const data_deadline_t *d = &g_data_store.deadlines[i];
+        if (!d->armed) {
+            continue;
+        }
+        rt_int32_t remaining = (rt_int32_t)(d->deadline - now);
+        if (!any || remaining < earliest) {
+            earliest = remaining;
+            any = true;
+        }
+    }
+    
+    if (!g_data_store.expiry_timer || !any) {
+        return;
+    }
+    
+    rt_tick_t delay = (earliest > 0) ? (rt_tick_t)earliest : 1;
+    rt_timer_stop(g_data_store.expiry_timer);
+    rt_timer_control(g_data_store.expiry_timer, RT_TIMER_CTRL_SET_TIME, &delay);
+    rt_timer_start(g_data_store.expiry_timer);
+    g_data_store.expiry_timer_active = true;
+}
+
+/* 数据更新时推迟截止时间。截止时间只会后移，定时器已在运行时不必重设，
+ * 提前触发时回调会按剩余的截止时间重新布置 */
+static void arm_deadline_locked(data_slot_t slot)
 {
-    if (last_update_tick == 0) return true;
+    data_deadline_t *d = &g_data_store.deadlines[slot];
     
+    rt_base_t level = rt_hw_interrupt_disable();
+    d->deadline = rt_tick_get() + rt_tick_from_millisecond(DATA_TIMEOUT_MS);
+    d->generation++;
+    d->armed = true;
+    if (!g_data_store.expiry_timer_active) {
+        schedule_expiry_timer();
+    }
+    rt_hw_interrupt_enable(level);
+    
+    d->live = true;
+}
+
+static void disarm_deadline_locked(data_slot_t slot)
+{
+    data_deadline_t *d = &g_data_store.deadlines[slot];
+    
+    rt_base_t level = rt_hw_interrupt_disable();
+    d->generation++;
+    d->armed = false;
+    rt_hw_interrupt_enable(level);
+    
+    d->live = false;
+}
+
+static void expiry_timer_callback(void *parameter)
+{
+    (void)parameter;
+    
+    uint32_t generations[DATA_SLOT_COUNT];
+    uint8_t due_mask = 0;
+    
+    rt_base_t level = rt_hw_interrupt_disable();
+    g_data_store.expiry_timer_active = false;
     rt_tick_t now = rt_tick_get();
-    rt_tick_t timeout_ticks = rt_tick_from_millisecond(DATA_TIMEOUT_MS);
-    return (now - last_update_tick) > timeout_ticks;
+    for (int i = 0; i < DATA_SLOT_COUNT; i++) {
+        data_deadline_t *d = &g_data_store.deadlines[i];
+        if (d->armed && (rt_int32_t)(now - d->deadline) >= 0) {
+            d->armed = false;
+            generations[i] = d->generation;
+            due_mask |= (1u << i);
+        }
+    }
+    schedule_expiry_timer();
+    rt_hw_interrupt_enable(level);
+    
+    if (!due_mask) {
+        return;
+    }
+    
+    /* 先置为无效再发事件，订阅者收到时读到的已是过期状态；
+     * 其间收到新数据时generation不再匹配，不过期 */
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    for (int i = 0; i < DATA_SLOT_COUNT; i++) {
+        data_deadline_t *d = &g_data_store.deadlines[i];
+        if (!(due_mask & (1u << i))) {
+            continue;
+        }
+        if (d->live && d->generation == generations[i]) {
+            expire_slot_locked((data_slot_t)i);
+        } else {
+            due_mask &= ~(1u << i);
+        }
+    }
+    rt_mutex_release(g_data_store.lock);
+    
+    for (int i = 0; i < DATA_SLOT_COUNT; i++) {
+        if (due_mask & (1u << i)) {
+            event_data_expired_t expired = { .generation = generations[i] };
+            event_bus_publish(g_expired_events[i], &expired, sizeof(expired),
+                              EVENT_PRIORITY_NORMAL, MODULE_ID_DATA_MANAGER);
+        }
+    }
 }
 
 static uint32_t get_data_age_seconds(rt_tick_t last_update_tick)
@@ -38,17 +198,358 @@ static uint32_t get_data_age_seconds(rt_tick_t last_update_tick)
     return age_ticks / RT_TICK_PER_SECOND;
 }
 
-int data_manager_update_weather(const weather_data_t *data)
+/* 按显示精度量化（scale=10对应%.1f，100对应%.2f），四舍五入到整数 */
+static int32_t quantize_for_display(float value, int32_t scale)
 {
-    if (!data || !g_data_store.initialized) {
-        return -RT_ERROR;
+    float scaled = value * (float)scale;
+    return (int32_t)(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+static bool display_changed(float old_value, float new_value, int32_t scale)
+{
+    return quantize_for_display(old_value, scale) != quantize_for_display(new_value, scale);
+}
+
+static uint32_t diff_weather(const weather_data_t *old, const weather_data_t *cur)
+{
+    if (old->valid != cur->valid) {
+        return WEATHER_FIELD_ALL;
     }
     
-    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    uint32_t mask = 0;
+    if (strcmp(old->city, cur->city) != 0)                      mask |= WEATHER_FIELD_CITY;
+    if (strcmp(old->weather, cur->weather) != 0)                mask |= WEATHER_FIELD_WEATHER;
+    if (display_changed(old->temperature, cur->temperature, 10)) mask |= WEATHER_FIELD_TEMPERATURE;
+    if (display_changed(old->humidity, cur->humidity, 1))       mask |= WEATHER_FIELD_HUMIDITY;
+    if (old->pressure != cur->pressure)                         mask |= WEATHER_FIELD_PRESSURE;
+    if (old->weather_code != cur->weather_code)                 mask |= WEATHER_FIELD_CODE;
+    if (old->stale != cur->stale)                               mask |= WEATHER_FIELD_STALE;
+    return mask;
+}
+
+static uint32_t diff_stock(const stock_data_t *old, const stock_data_t *cur)
+{
+    if (old->valid != cur->valid) {
+        return STOCK_FIELD_ALL;
+    }
+    
+    uint32_t mask = 0;
+    /* 已是×100定点数，与显示精度一致，直接比较 */
+    if (old->name_id != cur->name_id)                           mask |= STOCK_FIELD_NAME;
+    if (old->price_x100 != cur->price_x100)                     mask |= STOCK_FIELD_PRICE;
+    if (old->price_x100 != cur->price_x100 ||
+        old->change_x100 != cur->change_x100) {
+        mask |= STOCK_FIELD_CHANGE;                             /* 涨跌幅由价格和涨跌额导出 */
+    }
+    if (old->update_time != cur->update_time)                   mask |= STOCK_FIELD_UPDATE_TIME;
+    if (old->stale != cur->stale)                               mask |= STOCK_FIELD_STALE;
+    return mask;
+}
+
+static uint32_t diff_system(const system_monitor_data_t *old, const system_monitor_data_t *cur)
+{
+    if (old->valid != cur->valid) {
+        return SYS_FIELD_ALL;
+    }
     
+    uint32_t mask = 0;
+    if (display_changed(old->cpu_usage, cur->cpu_usage, 10))    mask |= SYS_FIELD_CPU_USAGE;
+    if (display_changed(old->cpu_temp, cur->cpu_temp, 10))      mask |= SYS_FIELD_CPU_TEMP;
+    if (display_changed(old->gpu_usage, cur->gpu_usage, 10))    mask |= SYS_FIELD_GPU_USAGE;
+    if (display_changed(old->gpu_temp, cur->gpu_temp, 10))      mask |= SYS_FIELD_GPU_TEMP;
+    if (display_changed(old->ram_usage, cur->ram_usage, 10))    mask |= SYS_FIELD_RAM_USAGE;
+    if (display_changed(old->net_upload_speed, cur->net_upload_speed, 100))     mask |= SYS_FIELD_NET_UPLOAD;
+    if (display_changed(old->net_download_speed, cur->net_download_speed, 100)) mask |= SYS_FIELD_NET_DOWNLOAD;
+    if (old->stale != cur->stale)                               mask |= SYS_FIELD_STALE;
+    return mask;
+}
+
+/* 以下store_*_locked需在持有lock时调用 */
+static void store_weather_locked(const weather_data_t *data)
+{
+    uint32_t dirty = diff_weather(&g_data_store.weather, data);
+    if (dirty) {
+        g_data_store.weather_dirty |= dirty;
+        g_data_store.weather_changes++;
+    }
     g_data_store.weather = *data;
     g_data_store.weather_update_tick = rt_tick_get();
+    g_data_store.stale_mask &= ~DATA_SNAPSHOT_HAS_WEATHER;
+    arm_deadline_locked(DATA_SLOT_WEATHER);
+}
+
+static const stock_data_t *current_stock_locked(void)
+{
+    static const stock_data_t empty = {0};
+    if (g_data_store.stock_cursor >= g_data_store.stock_count) {
+        return &empty;
+    }
+    return &g_data_store.stocks[g_data_store.stock_cursor];
+}
+
+static int find_stock_locked(uint8_t name_id)
+{
+    for (int i = 0; i < g_data_store.stock_count; i++) {
+        if (g_data_store.stocks[i].name_id == name_id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* 自选表条目释放对名称ID的引用，条目本身由调用方清除 */
+static void release_stock_names_locked(void)
+{
+    for (uint8_t i = 0; i < g_data_store.stock_count; i++) {
+        stock_name_release(g_data_store.stocks[i].name_id);
+    }
+}
+
+/* 单只股票按名称ID插入或更新 */
+static int store_stock_locked(const stock_data_t *data)
+{
+    if (data->name_id == STOCK_NAME_INVALID) {
+        return -RT_EINVAL;
+    }
+    
+    int index = find_stock_locked(data->name_id);
+    if (index < 0) {
+        if (g_data_store.stock_count >= STOCK_WATCHLIST_SIZE) {
+            return -RT_EFULL;
+        }
+        index = g_data_store.stock_count++;
+        memset(&g_data_store.stocks[index], 0, sizeof(stock_data_t));
+        stock_name_retain(data->name_id);
+        g_data_store.stock_dirty |= STOCK_FIELD_PAGE;
+    }
+    
+    if (index == g_data_store.stock_cursor) {
+        uint32_t dirty = diff_stock(&g_data_store.stocks[index], data);
+        if (dirty) {
+            g_data_store.stock_dirty |= dirty;
+            g_data_store.stock_changes++;
+        }
+    }
+    g_data_store.stocks[index] = *data;
+    g_data_store.stock_update_tick = rt_tick_get();
+    g_data_store.stale_mask &= ~DATA_SNAPSHOT_HAS_STOCK;
+    arm_deadline_locked(DATA_SLOT_STOCK);
+    return 0;
+}
+
+/* 整表替换：尽量保持当前显示的股票不变 */
+static int store_stock_batch_locked(const stock_data_t *list, uint8_t count)
+{
+    if (count > STOCK_WATCHLIST_SIZE) {
+        count = STOCK_WATCHLIST_SIZE;
+    }
+    
+    stock_data_t shown = *current_stock_locked();
+    uint8_t old_count = g_data_store.stock_count;
+    uint8_t old_cursor = g_data_store.stock_cursor;
+    
+    /* 先引用新表再释放旧表，两表共有的名称不会被复用 */
+    for (uint8_t i = 0; i < count; i++) {
+        stock_name_retain(list[i].name_id);
+    }
+    release_stock_names_locked();
+    
+    memcpy(g_data_store.stocks, list, count * sizeof(stock_data_t));
+    g_data_store.stock_count = count;
     
+    int index = find_stock_locked(shown.name_id);
+    g_data_store.stock_cursor = (index >= 0) ? (uint8_t)index : 0;
+    
+    uint32_t dirty = diff_stock(&shown, current_stock_locked());
+    if (old_count != count || old_cursor != g_data_store.stock_cursor) {
+        dirty |= STOCK_FIELD_PAGE;
+    }
+    if (dirty) {
+        g_data_store.stock_dirty |= dirty;
+        g_data_store.stock_changes++;
+    }
+    g_data_store.stock_update_tick = rt_tick_get();
+    g_data_store.stale_mask &= ~DATA_SNAPSHOT_HAS_STOCK;
+    arm_deadline_locked(DATA_SLOT_STOCK);
+    return 0;
+}
+
+static void store_system_locked(const system_monitor_data_t *data)
+{
+    uint32_t dirty = diff_system(&g_data_store.system, data);
+    if (dirty) {
+        g_data_store.system_dirty |= dirty;
+        g_data_store.system_changes++;
+    }
+    g_data_store.system = *data;
+    g_data_store.system_update_tick = rt_tick_get();
+    g_data_store.stale_mask &= ~DATA_SNAPSHOT_HAS_SYSTEM;
+    arm_deadline_locked(DATA_SLOT_SYSTEM);
+}
+
+static void copy_text(char *dest, const char *src, size_t dest_size)
+{
+    strncpy(dest, src, dest_size - 1);
+    dest[dest_size - 1] = '\0';
+}
+
+/* 用当前有效且非快照恢复的数据刷新last_known，其余部分保留上一次的值 */
+static void capture_snapshot_locked(void)
+{
+    data_snapshot_t *snap = &g_data_store.last_known;
+    
+    if (g_data_store.weather.valid && !(g_data_store.stale_mask & DATA_SNAPSHOT_HAS_WEATHER)) {
+        const weather_data_t *w = &g_data_store.weather;
+        memset(&snap->weather, 0, sizeof(snap->weather));
+        copy_text(snap->weather.city, w->city, sizeof(snap->weather.city));
+        copy_text(snap->weather.weather, w->weather, sizeof(snap->weather.weather));
+        snap->weather.temperature_x10 = (int16_t)quantize_for_display(w->temperature, 10);
+        snap->weather.humidity = (uint16_t)quantize_for_display(w->humidity, 1);
+        snap->weather.pressure = (uint16_t)w->pressure;
+        snap->weather.weather_code = (uint16_t)w->weather_code;
+        snap->weather.city_code = (uint16_t)w->city_code;
+        snap->valid_mask |= DATA_SNAPSHOT_HAS_WEATHER;
+    }
+    
+    if (g_data_store.stock_count > 0 && !(g_data_store.stale_mask & DATA_SNAPSHOT_HAS_STOCK)) {
+        memset(snap->stocks, 0, sizeof(snap->stocks));
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < g_data_store.stock_count; i++) {
+            const stock_data_t *stock = &g_data_store.stocks[i];
+            if (!stock->valid) {
+                continue;
+            }
+            copy_text(snap->stocks[n].name, stock_name_lookup(stock->name_id),
+                      sizeof(snap->stocks[n].name));
+            snap->stocks[n].price_x100 = stock->price_x100;
+            snap->stocks[n].change_x100 = stock->change_x100;
+            n++;
+        }
+        snap->stock_count = n;
+        if (n > 0) {
+            snap->valid_mask |= DATA_SNAPSHOT_HAS_STOCK;
+        }
+    }
+    
+    if (g_data_store.system.valid && !(g_data_store.stale_mask & DATA_SNAPSHOT_HAS_SYSTEM)) {
+        const system_monitor_data_t *sys = &g_data_store.system;
+        snap->system.cpu_usage_x10 = (int16_t)quantize_for_display(sys->cpu_usage, 10);
+        snap->system.cpu_temp_x10 = (int16_t)quantize_for_display(sys->cpu_temp, 10);
+        snap->system.gpu_usage_x10 = (int16_t)quantize_for_display(sys->gpu_usage, 10);
+        snap->system.gpu_temp_x10 = (int16_t)quantize_for_display(sys->gpu_temp, 10);
+        snap->system.ram_usage_x10 = (int16_t)quantize_for_display(sys->ram_usage, 10);
+        snap->system.net_upload_x100 = quantize_for_display(sys->net_upload_speed, 100);
+        snap->system.net_download_x100 = quantize_for_display(sys->net_download_speed, 100);
+        snap->valid_mask |= DATA_SNAPSHOT_HAS_SYSTEM;
+    }
+}
+
+/* 把快照中当前无效的部分恢复为stale数据，已有有效数据的部分不覆盖 */
+static void restore_snapshot_locked(const data_snapshot_t *snap)
+{
+    if ((snap->valid_mask & DATA_SNAPSHOT_HAS_WEATHER) && !g_data_store.weather.valid) {
+        weather_data_t weather = {0};
+        copy_text(weather.city, snap->weather.city, sizeof(weather.city));
+        copy_text(weather.weather, snap->weather.weather, sizeof(weather.weather));
+        weather.temperature = snap->weather.temperature_x10 / 10.0f;
+        weather.humidity = (float)snap->weather.humidity;
+        weather.pressure = snap->weather.pressure;
+        weather.weather_code = snap->weather.weather_code;
+        weather.city_code = snap->weather.city_code;
+        weather.valid = true;
+        weather.stale = true;
+        store_weather_locked(&weather);
+        disarm_deadline_locked(DATA_SLOT_WEATHER);  /* 快照数据不参与过期 */
+        g_data_store.stale_mask |= DATA_SNAPSHOT_HAS_WEATHER;
+    }
+    
+    if ((snap->valid_mask & DATA_SNAPSHOT_HAS_STOCK) && g_data_store.stock_count == 0) {
+        stock_data_t list[STOCK_WATCHLIST_SIZE];
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < snap->stock_count && i < STOCK_WATCHLIST_SIZE; i++) {
+            char name[DATA_SNAPSHOT_TEXT_LEN];
+            copy_text(name, snap->stocks[i].name, sizeof(name));
+            memset(&list[n], 0, sizeof(stock_data_t));
+            list[n].name_id = stock_name_intern(name);
+            if (list[n].name_id == STOCK_NAME_INVALID) {
+                continue;
+            }
+            list[n].price_x100 = snap->stocks[i].price_x100;
+            list[n].change_x100 = snap->stocks[i].change_x100;
+            list[n].update_time = snap->saved_time;
+            list[n].valid = true;
+            list[n].stale = true;
+            n++;
+        }
+        if (n > 0) {
+            store_stock_batch_locked(list, n);
+            disarm_deadline_locked(DATA_SLOT_STOCK);
+            g_data_store.stale_mask |= DATA_SNAPSHOT_HAS_STOCK;
+        }
+        stock_name_release_list(list, n);   /* 自选表已持有自己的引用 */
+    }
+    
+    if ((snap->valid_mask & DATA_SNAPSHOT_HAS_SYSTEM) && !g_data_store.system.valid) {
+        system_monitor_data_t sys = {0};
+        sys.cpu_usage = snap->system.cpu_usage_x10 / 10.0f;
+        sys.cpu_temp = snap->system.cpu_temp_x10 / 10.0f;
+        sys.gpu_usage = snap->system.gpu_usage_x10 / 10.0f;
+        sys.gpu_temp = snap->system.gpu_temp_x10 / 10.0f;
+        sys.ram_usage = snap->system.ram_usage_x10 / 10.0f;
+        sys.net_upload_speed = snap->system.net_upload_x100 / 100.0f;
+        sys.net_download_speed = snap->system.net_download_x100 / 100.0f;
+        sys.valid = true;
+        sys.stale = true;
+        store_system_locked(&sys);
+        disarm_deadline_locked(DATA_SLOT_SYSTEM);
+        g_data_store.stale_mask |= DATA_SNAPSHOT_HAS_SYSTEM;
+    }
+}
+
+/* 数据过期：置为无效并标记全部字段脏，UI据此灰显；过期只处理一次 */
+static void expire_slot_locked(data_slot_t slot)
+{
+    disarm_deadline_locked(slot);
+    
+    /* 置无效前先记入last_known，快照只保存有效数据 */
+    capture_snapshot_locked();
+    
+    switch (slot) {
+    case DATA_SLOT_WEATHER: {
+        weather_data_t old = g_data_store.weather;
+        g_data_store.weather.valid = false;
+        g_data_store.weather_dirty |= diff_weather(&old, &g_data_store.weather);
+        break;
+    }
+    case DATA_SLOT_STOCK: {
+        stock_data_t shown = *current_stock_locked();
+        for (uint8_t i = 0; i < g_data_store.stock_count; i++) {
+            g_data_store.stocks[i].valid = false;
+        }
+        g_data_store.stock_dirty |= diff_stock(&shown, current_stock_locked());
+        break;
+    }
+    case DATA_SLOT_SYSTEM: {
+        system_monitor_data_t old = g_data_store.system;
+        g_data_store.system.valid = false;
+        g_data_store.system_dirty |= diff_system(&old, &g_data_store.system);
+        break;
+    }
+    default:
+        return;
+    }
+    
+    g_data_store.cleanup_count++;
+}
+
+int data_manager_update_weather(const weather_data_t *data)
+{
+    if (!data || !g_data_store.initialized) {
+        return -RT_ERROR;
+    }
+    
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    store_weather_locked(data);
     rt_mutex_release(g_data_store.lock);
     return 0;
 }
@@ -60,10 +561,50 @@ int data_manager_update_stock(const stock_data_t *data)
     }
     
     rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    int ret = store_stock_locked(data);
+    rt_mutex_release(g_data_store.lock);
+    return ret;
+}
+
+int data_manager_update_stock_batch(const stock_data_t *list, uint8_t count)
+{
+    if ((!list && count > 0) || !g_data_store.initialized) {
+        return -RT_ERROR;
+    }
     
-    g_data_store.stock = *data;
-    g_data_store.stock_update_tick = rt_tick_get();
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    int ret = store_stock_batch_locked(list, count);
+    rt_mutex_release(g_data_store.lock);
+    return ret;
+}
+
+int data_manager_next_stock(void)
+{
+    if (!g_data_store.initialized) {
+        return -RT_ERROR;
+    }
+    
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    
+    if (g_data_store.stock_count > 1) {
+        stock_data_t shown = *current_stock_locked();
+        g_data_store.stock_cursor = (g_data_store.stock_cursor + 1) % g_data_store.stock_count;
+        g_data_store.stock_dirty |= diff_stock(&shown, current_stock_locked()) | STOCK_FIELD_PAGE;
+    }
+    
+    rt_mutex_release(g_data_store.lock);
+    return 0;
+}
+
+int data_manager_get_stock_position(uint8_t *index, uint8_t *count)
+{
+    if (!g_data_store.initialized) {
+        return -RT_ERROR;
+    }
     
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    if (index) *index = g_data_store.stock_cursor;
+    if (count) *count = g_data_store.stock_count;
     rt_mutex_release(g_data_store.lock);
     return 0;
 }
@@ -75,10 +616,7 @@ int data_manager_update_system(const system_monitor_data_t *data)
     }
     
     rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
-    
-    g_data_store.system = *data;
-    g_data_store.system_update_tick = rt_tick_get();
-    
+    store_system_locked(data);
     rt_mutex_release(g_data_store.lock);
     return 0;
 }
@@ -90,53 +628,90 @@ int data_manager_get_weather(weather_data_t *data)
     }
     
     rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    *data = g_data_store.weather;
+    rt_mutex_release(g_data_store.lock);
     
-    if (is_data_expired(g_data_store.weather_update_tick)) {
-        g_data_store.weather.valid = false;
+    return data->valid ? 0 : -RT_EEMPTY;
+}
+
+int data_manager_get_stock(stock_data_t *data)
+{
+    if (!data || !g_data_store.initialized) {
+        return -RT_ERROR;
     }
     
-    *data = g_data_store.weather;
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    *data = *current_stock_locked();
     rt_mutex_release(g_data_store.lock);
     
     return data->valid ? 0 : -RT_EEMPTY;
 }
 
-int data_manager_get_stock(stock_data_t *data)
+int data_manager_get_system(system_monitor_data_t *data)
 {
     if (!data || !g_data_store.initialized) {
         return -RT_ERROR;
     }
     
     rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    *data = g_data_store.system;
+    rt_mutex_release(g_data_store.lock);
     
-    if (is_data_expired(g_data_store.stock_update_tick)) {
-        g_data_store.stock.valid = false;
+    return data->valid ? 0 : -RT_EEMPTY;
+}
+
+int data_manager_take_weather(weather_data_t *data, uint32_t *dirty_mask)
+{
+    if (!data || !g_data_store.initialized) {
+        return -RT_ERROR;
     }
     
-    *data = g_data_store.stock;
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    *data = g_data_store.weather;
+    if (dirty_mask) {
+        *dirty_mask = g_data_store.weather_dirty;
+    }
+    g_data_store.weather_dirty = 0;
     rt_mutex_release(g_data_store.lock);
     
     return data->valid ? 0 : -RT_EEMPTY;
 }
 
-int data_manager_get_system(system_monitor_data_t *data)
+int data_manager_take_stock(stock_data_t *data, uint32_t *dirty_mask)
 {
     if (!data || !g_data_store.initialized) {
         return -RT_ERROR;
     }
     
     rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    *data = *current_stock_locked();
+    if (dirty_mask) {
+        *dirty_mask = g_data_store.stock_dirty;
+    }
+    g_data_store.stock_dirty = 0;
+    rt_mutex_release(g_data_store.lock);
     
-    if (is_data_expired(g_data_store.system_update_tick)) {
-        g_data_store.system.valid = false;
+    return data->valid ? 0 : -RT_EEMPTY;
+}
+
+int data_manager_take_system(system_monitor_data_t *data, uint32_t *dirty_mask)
+{
+    if (!data || !g_data_store.initialized) {
+        return -RT_ERROR;
     }
     
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
     *data = g_data_store.system;
+    if (dirty_mask) {
+        *dirty_mask = g_data_store.system_dirty;
+    }
+    g_data_store.system_dirty = 0;
     rt_mutex_release(g_data_store.lock);
     
     return data->valid ? 0 : -RT_EEMPTY;
 }
 
+/* 定时器发出的过期事件可能因事件队列满而丢失，这里按截止时间补做过期处理 */
 int data_manager_cleanup_expired_data(void)
 {
     if (!g_data_store.initialized) {
@@ -148,23 +723,17 @@ int data_manager_cleanup_expired_data(void)
     int cleaned = 0;
     rt_tick_t now = rt_tick_get();
     
-    if (is_data_expired(g_data_store.weather_update_tick) && g_data_store.weather.valid) {
-        g_data_store.weather.valid = false;
-        cleaned++;
-    }
-    
-    if (is_data_expired(g_data_store.stock_update_tick) && g_data_store.stock.valid) {
-        g_data_store.stock.valid = false;
-        cleaned++;
-    }
-    
-    if (is_data_expired(g_data_store.system_update_tick) && g_data_store.system.valid) {
-        g_data_store.system.valid = false;
-        cleaned++;
-    }
-    
-    if (cleaned > 0) {
-        g_data_store.cleanup_count += cleaned;
+    for (int i = 0; i < DATA_SLOT_COUNT; i++) {
+        data_deadline_t *d = &g_data_store.deadlines[i];
+        
+        rt_base_t level = rt_hw_interrupt_disable();
+        bool due = d->live && (rt_int32_t)(now - d->deadline) >= 0;
+        rt_hw_interrupt_enable(level);
+        
+        if (due) {
+            expire_slot_locked((data_slot_t)i);
+            cleaned++;
+        }
     }
     
     g_data_store.last_cleanup_tick = now;
@@ -181,22 +750,131 @@ int data_manager_reset_all_data(void)
     
     rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
     
+    /* 清空前先记下最后的有效数据，清空后以stale状态恢复，避免界面回到占位符 */
+    capture_snapshot_locked();
+    for (int i = 0; i < DATA_SLOT_COUNT; i++) {
+        disarm_deadline_locked((data_slot_t)i);
+    }
+    
+    release_stock_names_locked();
     memset(&g_data_store.weather, 0, sizeof(weather_data_t));
-    memset(&g_data_store.stock, 0, sizeof(stock_data_t));
+    memset(g_data_store.stocks, 0, sizeof(g_data_store.stocks));
     memset(&g_data_store.system, 0, sizeof(system_monitor_data_t));
     
     g_data_store.weather.valid = false;
-    g_data_store.stock.valid = false;
+    g_data_store.stock_count = 0;
+    g_data_store.stock_cursor = 0;
     g_data_store.system.valid = false;
+    g_data_store.stale_mask = 0;
     
     g_data_store.weather_update_tick = 0;
     g_data_store.stock_update_tick = 0;
     g_data_store.system_update_tick = 0;
     
+    g_data_store.weather_dirty = WEATHER_FIELD_ALL;
+    g_data_store.stock_dirty = STOCK_FIELD_ALL;
+    g_data_store.system_dirty = SYS_FIELD_ALL;
+    
+    restore_snapshot_locked(&g_data_store.last_known);
+    
+    rt_mutex_release(g_data_store.lock);
+    return 0;
+}
+
+int data_manager_persist_snapshot(bool force)
+{
+    if (!g_data_store.initialized) {
+        return -RT_ERROR;
+    }
+    
+    sht30_data_t sensor = {0};
+    bool sensor_valid = (sht30_controller_get_latest(&sensor) == RT_EOK && sensor.valid);
+    
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    
+    if (g_data_store.persist_busy) {
+        rt_mutex_release(g_data_store.lock);
+        return -RT_EBUSY;
+    }
+    
+    capture_snapshot_locked();
+    if (sensor_valid) {
+        g_data_store.last_known.sensor.temperature_x10 =
+            (int16_t)quantize_for_display(sensor.temperature_c, 10);
+        g_data_store.last_known.sensor.humidity_x10 =
+            (uint16_t)quantize_for_display(sensor.humidity_rh, 10);
+        g_data_store.last_known.valid_mask |= DATA_SNAPSHOT_HAS_SENSOR;
+    }
+    
+    rt_tick_t now = rt_tick_get();
+    uint32_t crc = data_snapshot_content_crc(&g_data_store.last_known);
+    bool rate_limited = !force && g_data_store.last_persist_tick != 0 &&
+        (now - g_data_store.last_persist_tick) <
+            rt_tick_from_millisecond(DATA_SNAPSHOT_MIN_INTERVAL_S * 1000);
+    
+    if (!g_data_store.snapshot_storage_ready || g_data_store.last_known.valid_mask == 0 ||
+        crc == g_data_store.last_saved_crc || rate_limited) {
+        rt_mutex_release(g_data_store.lock);
+        return 0;
+    }
+    
+    time_t saved_time = time(NULL);
+    g_data_store.last_known.saved_time = (saved_time == (time_t)-1) ? 0 : (uint32_t)saved_time;
+    
+    /* 扇区擦除要几十毫秒，拷贝出来交给flash_worker线程写入，调用方（GUI线程）不等待 */
+    g_data_store.persist_snap = g_data_store.last_known;
+    g_data_store.persist_crc = crc;
+    g_data_store.persist_busy = true;
     rt_mutex_release(g_data_store.lock);
+    
+    int ret = flash_worker_post(FLASH_JOB_DATA_SNAPSHOT, 0);
+    if (ret != 0) {
+        rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+        g_data_store.persist_busy = false;
+        rt_mutex_release(g_data_store.lock);
+        return ret;
+    }
     return 0;
 }
 
+/* flash_worker线程中执行，persist_snap在persist_busy清除前不会被改写 */
+static void persist_snapshot_job(void)
+{
+    int ret = data_snapshot_save(&g_data_store.snapshot_store, &g_data_store.persist_snap);
+    
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    g_data_store.persist_busy = false;
+    if (ret == DATA_SNAPSHOT_OK) {
+        g_data_store.last_saved_crc = g_data_store.persist_crc;
+        g_data_store.last_persist_tick = rt_tick_get();
+        g_data_store.persist_count++;
+    }
+    rt_mutex_release(g_data_store.lock);
+    
+    if (ret != DATA_SNAPSHOT_OK) {
+        rt_kprintf("[DataMgr] snapshot save failed: %d\n", ret);
+    }
+}
+
+int data_manager_get_last_known_sensor(float *temperature, float *humidity)
+{
+    if (!g_data_store.initialized) {
+        return -RT_ERROR;
+    }
+    
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    
+    int ret = -RT_EEMPTY;
+    if (g_data_store.last_known.valid_mask & DATA_SNAPSHOT_HAS_SENSOR) {
+        if (temperature) *temperature = g_data_store.last_known.sensor.temperature_x10 / 10.0f;
+        if (humidity) *humidity = g_data_store.last_known.sensor.humidity_x10 / 10.0f;
+        ret = 0;
+    }
+    
+    rt_mutex_release(g_data_store.lock);
+    return ret;
+}
+
 int data_manager_get_data_status(char *status_buf, size_t buf_size)
 {
     if (!status_buf || buf_size < 200 || !g_data_store.initialized) {
@@ -220,13 +898,14 @@ bool data_manager_is_data_fresh(const char *type)
     
     rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
     
+    /* 快照恢复的数据不算新鲜 */
     bool fresh = false;
     if (strcmp(type, "weather") == 0) {
-        fresh = !is_data_expired(g_data_store.weather_update_tick) && g_data_store.weather.valid;
+        fresh = !(g_data_store.stale_mask & DATA_SNAPSHOT_HAS_WEATHER) && g_data_store.weather.valid;
     } else if (strcmp(type, "stock") == 0) {
-        fresh = !is_data_expired(g_data_store.stock_update_tick) && g_data_store.stock.valid;
+        fresh = !(g_data_store.stale_mask & DATA_SNAPSHOT_HAS_STOCK) && current_stock_locked()->valid;
     } else if (strcmp(type, "system") == 0) {
-        fresh = !is_data_expired(g_data_store.system_update_tick) && g_data_store.system.valid;
+        fresh = !(g_data_store.stale_mask & DATA_SNAPSHOT_HAS_SYSTEM) && g_data_store.system.valid;
     }
     
     rt_mutex_release(g_data_store.lock);
@@ -254,6 +933,27 @@ rt_tick_t data_manager_get_last_update(const char *type)
     return tick;
 }
 
+uint32_t data_manager_get_change_count(const char *type)
+{
+    if (!type || !g_data_store.initialized) {
+        return 0;
+    }
+    
+    rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+    
+    uint32_t count = 0;
+    if (strcmp(type, "weather") == 0) {
+        count = g_data_store.weather_changes;
+    } else if (strcmp(type, "stock") == 0) {
+        count = g_data_store.stock_changes;
+    } else if (strcmp(type, "system") == 0) {
+        count = g_data_store.system_changes;
+    }
+    
+    rt_mutex_release(g_data_store.lock);
+    return count;
+}
+
 static int data_manager_weather_event_handler(const event_t *event, void *user_data)
 {
     (void)user_data;
@@ -262,8 +962,7 @@ static int data_manager_weather_event_handler(const event_t *event, void *user_d
         const weather_data_t *weather = &event->data.weather.weather;
         
         rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
-        g_data_store.weather = *weather;
-        g_data_store.weather_update_tick = rt_tick_get();
+        store_weather_locked(weather);
         rt_mutex_release(g_data_store.lock);
         
         return 0;
@@ -277,11 +976,16 @@ static int data_manager_stock_event_handler(const event_t *event, void *user_dat
     (void)user_data;
     
     if (event->type == EVENT_DATA_STOCK_UPDATED) {
-        const stock_data_t *stock = &event->data.stock.stock;
+        const event_data_stock_t *stock = &event->data.stock;
         
         rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
-        g_data_store.stock = *stock;
-        g_data_store.stock_update_tick = rt_tick_get();
+        if (stock->replace) {
+            store_stock_batch_locked(stock->stocks, stock->count);
+        } else {
+            for (uint8_t i = 0; i < stock->count && i < STOCK_WATCHLIST_SIZE; i++) {
+                store_stock_locked(&stock->stocks[i]);
+            }
+        }
         rt_mutex_release(g_data_store.lock);
         
         return 0;
@@ -297,8 +1001,7 @@ static int data_manager_system_event_handler(const event_t *event, void *user_da
     if (event->type == EVENT_DATA_SYSTEM_UPDATED) {
         const system_monitor_data_t *system = &event->data.system.system;
         rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
-        g_data_store.system = *system;
-        g_data_store.system_update_tick = rt_tick_get();
+        store_system_locked(system);
         rt_mutex_release(g_data_store.lock);
         return 0;
     }
@@ -317,20 +1020,68 @@ int data_manager_init(void)
         return -RT_ENOMEM;
     }
     
+    if (stock_watchlist_init() != 0) {
+        rt_mutex_delete(g_data_store.lock);
+        g_data_store.lock = NULL;
+        return -RT_ENOMEM;
+    }
+    
+    memset(g_data_store.deadlines, 0, sizeof(g_data_store.deadlines));
+    g_data_store.expiry_timer_active = false;
+    g_data_store.expiry_timer = rt_timer_create("data_expiry",
+                                                expiry_timer_callback,
+                                                RT_NULL,
+                                                rt_tick_from_millisecond(DATA_TIMEOUT_MS),
+                                                RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_SOFT_TIMER);
+    if (!g_data_store.expiry_timer) {
+        rt_mutex_delete(g_data_store.lock);
+        g_data_store.lock = NULL;
+        return -RT_ENOMEM;
+    }
+    
     memset(&g_data_store.weather, 0, sizeof(weather_data_t));
-    memset(&g_data_store.stock, 0, sizeof(stock_data_t));
+    memset(g_data_store.stocks, 0, sizeof(g_data_store.stocks));
     memset(&g_data_store.system, 0, sizeof(system_monitor_data_t));
     
     g_data_store.weather.valid = false;
-    g_data_store.stock.valid = false;
+    g_data_store.stock_count = 0;
+    g_data_store.stock_cursor = 0;
     g_data_store.system.valid = false;
     
     g_data_store.weather_update_tick = 0;
     g_data_store.stock_update_tick = 0;
     g_data_store.system_update_tick = 0;
+    g_data_store.weather_dirty = WEATHER_FIELD_ALL;
+    g_data_store.stock_dirty = STOCK_FIELD_ALL;
+    g_data_store.system_dirty = SYS_FIELD_ALL;
     g_data_store.last_cleanup_tick = rt_tick_get();
     g_data_store.cleanup_count = 0;
     
+    /* 读取上次保存的快照，以stale状态先行显示 */
+    memset(&g_data_store.last_known, 0, sizeof(data_snapshot_t));
+    g_data_store.stale_mask = 0;
+    g_data_store.last_persist_tick = 0;
+    g_data_store.persist_count = 0;
+    g_data_store.persist_busy = false;
+    g_data_store.snapshot_storage_ready = false;
+    
+    const data_snapshot_storage_t *storage = data_snapshot_flash_storage();
+    if (storage && data_snapshot_open(&g_data_store.snapshot_store, storage) == DATA_SNAPSHOT_OK &&
+        flash_worker_init() == 0 &&
+        flash_worker_register(FLASH_JOB_DATA_SNAPSHOT, persist_snapshot_job) == 0) {
+        g_data_store.snapshot_storage_ready = true;
+        
+        data_snapshot_t *snap = &g_data_store.last_known;
+        if (data_snapshot_load(&g_data_store.snapshot_store, snap) == DATA_SNAPSHOT_OK) {
+            g_data_store.last_saved_crc = data_snapshot_content_crc(snap);
+            rt_mutex_take(g_data_store.lock, RT_WAITING_FOREVER);
+            restore_snapshot_locked(snap);
+            rt_mutex_release(g_data_store.lock);
+        } else {
+            memset(snap, 0, sizeof(data_snapshot_t));
+        }
+    }
+    
     event_bus_subscribe(EVENT_DATA_WEATHER_UPDATED, data_manager_weather_event_handler, 
                        NULL, EVENT_PRIORITY_NORMAL);
     event_bus_subscribe(EVENT_DATA_STOCK_UPDATED, data_manager_stock_event_handler, 
@@ -352,6 +1103,12 @@ int data_manager_deinit(void)
     event_bus_unsubscribe(EVENT_DATA_STOCK_UPDATED, data_manager_stock_event_handler);
     event_bus_unsubscribe(EVENT_DATA_SYSTEM_UPDATED, data_manager_system_event_handler);
     
+    if (g_data_store.expiry_timer) {
+        rt_timer_stop(g_data_store.expiry_timer);
+        rt_timer_delete(g_data_store.expiry_timer);
+        g_data_store.expiry_timer = NULL;
+    }
+    
     if (g_data_store.lock) {
         rt_mutex_delete(g_data_store.lock);
         g_data_store.lock = NULL;
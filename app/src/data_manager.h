@@ -7,6 +7,45 @@
 #define DATA_TIMEOUT_MS         (60000)
 #define CLEANUP_INTERVAL_MS     (30000)
 
+/* 快照写入最小间隔，可通过Kconfig的DATA_SNAPSHOT_MIN_INTERVAL_S配置 */
+#ifndef DATA_SNAPSHOT_MIN_INTERVAL_S
+#define DATA_SNAPSHOT_MIN_INTERVAL_S    600
+#endif
+
+/* 字段级脏标记：按显示精度量化后比较，只有显示内容变化的字段才置位 */
+typedef enum {
+    WEATHER_FIELD_CITY          = (1u << 0),
+    WEATHER_FIELD_WEATHER       = (1u << 1),
+    WEATHER_FIELD_TEMPERATURE   = (1u << 2),   /* %.1f */
+    WEATHER_FIELD_HUMIDITY      = (1u << 3),   /* %.0f */
+    WEATHER_FIELD_PRESSURE      = (1u << 4),
+    WEATHER_FIELD_CODE          = (1u << 5),
+    WEATHER_FIELD_STALE         = (1u << 6),   /* 快照缓存标记 */
+    WEATHER_FIELD_ALL           = 0x7Fu
+} weather_field_t;
+
+typedef enum {
+    STOCK_FIELD_NAME            = (1u << 0),
+    STOCK_FIELD_PRICE           = (1u << 1),   /* %.2f */
+    STOCK_FIELD_CHANGE          = (1u << 2),   /* 涨跌额/涨跌幅 %.2f */
+    STOCK_FIELD_UPDATE_TIME     = (1u << 3),
+    STOCK_FIELD_PAGE            = (1u << 4),   /* 自选股序号/数量 */
+    STOCK_FIELD_STALE           = (1u << 5),   /* 快照缓存标记 */
+    STOCK_FIELD_ALL             = 0x3Fu
+} stock_field_t;
+
+typedef enum {
+    SYS_FIELD_CPU_USAGE         = (1u << 0),   /* %.1f */
+    SYS_FIELD_CPU_TEMP          = (1u << 1),   /* %.1f */
+    SYS_FIELD_GPU_USAGE         = (1u << 2),   /* %.1f */
+    SYS_FIELD_GPU_TEMP          = (1u << 3),   /* %.1f */
+    SYS_FIELD_RAM_USAGE         = (1u << 4),   /* %.1f */
+    SYS_FIELD_NET_UPLOAD        = (1u << 5),   /* %.2f */
+    SYS_FIELD_NET_DOWNLOAD      = (1u << 6),   /* %.2f */
+    SYS_FIELD_STALE             = (1u << 7),   /* 快照缓存标记 */
+    SYS_FIELD_ALL               = 0xFFu
+} system_field_t;
+
 int data_manager_init(void);
 
 int data_manager_deinit(void);
@@ -19,8 +58,49 @@ int data_manager_update_weather(const weather_data_t *data);
 int data_manager_update_stock(const stock_data_t *data);
 int data_manager_update_system(const system_monitor_data_t *data);
 
+/* 自选股：按名称ID插入/更新单只，或整表替换；next切换当前显示的股票 */
+int data_manager_update_stock_batch(const stock_data_t *list, uint8_t count);
+int data_manager_next_stock(void);
+int data_manager_get_stock_position(uint8_t *index, uint8_t *count);
+
+/**
+ * @brief 获取最新数据及自上次获取以来累积的脏字段掩码，并清除掩码
+ * @param dirty_mask 输出 *_FIELD_* 位组合，可为NULL
+ */
+int data_manager_take_weather(weather_data_t *data, uint32_t *dirty_mask);
+int data_manager_take_stock(stock_data_t *data, uint32_t *dirty_mask);
+int data_manager_take_system(system_monitor_data_t *data, uint32_t *dirty_mask);
+
 rt_tick_t data_manager_get_last_update(const char *type);
 
+/**
+ * @brief 获取收到的数据中脏字段掩码非零（显示内容有变化）的更新次数
+ * @note 不清除脏掩码，与UI的take_*互不影响；比较两次读数即可判断期间数据是否变化。
+ *       自选股只统计当前显示的股票和序号/数量，过期和快照恢复不计入
+ */
+uint32_t data_manager_get_change_count(const char *type);
+
+/**
+ * @brief 保存最后一次有效数据的快照
+ * @param force false时受DATA_SNAPSHOT_MIN_INTERVAL_S限速；内容未变化时总是跳过写入
+ * @return 0已交给flash_worker或无需写入，-RT_EBUSY上一次保存还没写完，其他负值为错误
+ * @note 未启用flash存储时只更新内存中的快照，reset_all_data后仍可恢复。
+ *       flash擦写在flash_worker线程中、数据锁外进行，调用方不等待，
+ *       期间数据更新、界面取数和渲染都不受影响
+ */
+int data_manager_persist_snapshot(bool force);
+
+/**
+ * @brief 获取快照中的板载传感器读数，用于传感器数据过期时的显示
+ * @return 0成功，-RT_EEMPTY无快照
+ */
+int data_manager_get_last_known_sensor(float *temperature, float *humidity);
+
+/**
+ * @brief 补做已到截止时间但定时器尚未处理的过期
+ * @note 过期由截止时间定时器驱动：到期时先将数据置为无效，再发出EVENT_DATA_*_EXPIRED，
+ *       读取接口不再做超时判断
+ */
 int data_manager_cleanup_expired_data(void);
 int data_manager_reset_all_data(void);
 int data_manager_get_data_status(char *status_buf, size_t buf_size);
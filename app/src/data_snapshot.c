@@ -0,0 +1,131 @@
+#include "data_snapshot.h"
+#include <string.h>
+
+#define SNAPSHOT_CRC_LEN    offsetof(data_snapshot_t, crc32)
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+static bool snapshot_is_valid(const data_snapshot_t *snapshot)
+{
+    return snapshot->magic == DATA_SNAPSHOT_MAGIC &&
+           snapshot->version == DATA_SNAPSHOT_VERSION &&
+           snapshot->length == sizeof(data_snapshot_t) &&
+           snapshot->crc32 == crc32_update(0, (const uint8_t *)snapshot, SNAPSHOT_CRC_LEN);
+}
+
+/* 槽位不跨扇区边界，扇区尾部不足一个槽位的空间不使用 */
+static uint32_t slot_offset(const data_snapshot_store_t *store, uint32_t slot)
+{
+    uint32_t slots_per_sector = store->storage->sector_size / store->slot_size;
+    return (slot / slots_per_sector) * store->storage->sector_size +
+           (slot % slots_per_sector) * store->slot_size;
+}
+
+int data_snapshot_open(data_snapshot_store_t *store, const data_snapshot_storage_t *storage)
+{
+    if (!store || !storage || !storage->read || !storage->write || !storage->erase) {
+        return DATA_SNAPSHOT_ERR_PARAM;
+    }
+
+    memset(store, 0, sizeof(*store));
+    store->storage = storage;
+    store->slot_size = (sizeof(data_snapshot_t) + DATA_SNAPSHOT_SLOT_ALIGN - 1) &
+                       ~(uint32_t)(DATA_SNAPSHOT_SLOT_ALIGN - 1);
+    if (storage->sector_size < store->slot_size || storage->sector_count == 0) {
+        return DATA_SNAPSHOT_ERR_LAYOUT;
+    }
+    store->slot_count = (storage->sector_size / store->slot_size) * storage->sector_count;
+
+    data_snapshot_t snapshot;
+    for (uint32_t slot = 0; slot < store->slot_count; slot++) {
+        if (storage->read(slot_offset(store, slot), &snapshot, sizeof(snapshot)) != 0) {
+            return DATA_SNAPSHOT_ERR_IO;
+        }
+        if (!snapshot_is_valid(&snapshot)) {
+            continue;
+        }
+        /* 序号回绕时用差值比较 */
+        if (!store->has_record || (int32_t)(snapshot.sequence - store->last_sequence) > 0) {
+            store->has_record = true;
+            store->last_sequence = snapshot.sequence;
+            store->next_slot = (slot + 1) % store->slot_count;
+        }
+    }
+
+    return DATA_SNAPSHOT_OK;
+}
+
+int data_snapshot_load(data_snapshot_store_t *store, data_snapshot_t *snapshot)
+{
+    if (!store || !store->storage || !snapshot) {
+        return DATA_SNAPSHOT_ERR_PARAM;
+    }
+    if (!store->has_record) {
+        return DATA_SNAPSHOT_ERR_EMPTY;
+    }
+
+    uint32_t slot = (store->next_slot + store->slot_count - 1) % store->slot_count;
+    if (store->storage->read(slot_offset(store, slot), snapshot, sizeof(*snapshot)) != 0) {
+        return DATA_SNAPSHOT_ERR_IO;
+    }
+    return snapshot_is_valid(snapshot) ? DATA_SNAPSHOT_OK : DATA_SNAPSHOT_ERR_EMPTY;
+}
+
+int data_snapshot_save(data_snapshot_store_t *store, data_snapshot_t *snapshot)
+{
+    if (!store || !store->storage || !snapshot) {
+        return DATA_SNAPSHOT_ERR_PARAM;
+    }
+
+    const data_snapshot_storage_t *storage = store->storage;
+
+    snapshot->magic = DATA_SNAPSHOT_MAGIC;
+    snapshot->version = DATA_SNAPSHOT_VERSION;
+    snapshot->length = sizeof(data_snapshot_t);
+    snapshot->sequence = store->has_record ? store->last_sequence + 1 : 1;
+    snapshot->crc32 = crc32_update(0, (const uint8_t *)snapshot, SNAPSHOT_CRC_LEN);
+
+    /* 掉电时写了一半的槽位不是擦除状态，写入后回读，不一致就换下一个槽位。
+     * 最多试一个扇区的槽位数，不会绕回去擦掉最新的有效记录 */
+    data_snapshot_t readback;
+    uint32_t attempts = storage->sector_size / store->slot_size;
+    for (uint32_t i = 0; i < attempts; i++) {
+        uint32_t offset = slot_offset(store, store->next_slot);
+        store->next_slot = (store->next_slot + 1) % store->slot_count;
+
+        /* 进入新扇区时先擦除，旧扇区中的记录在此之前一直可读 */
+        if (offset % storage->sector_size == 0 &&
+            storage->erase(offset, storage->sector_size) != 0) {
+            return DATA_SNAPSHOT_ERR_IO;
+        }
+        if (storage->write(offset, snapshot, sizeof(*snapshot)) != 0 ||
+            storage->read(offset, &readback, sizeof(readback)) != 0) {
+            return DATA_SNAPSHOT_ERR_IO;
+        }
+        if (memcmp(&readback, snapshot, sizeof(readback)) == 0) {
+            store->has_record = true;
+            store->last_sequence = snapshot->sequence;
+            return DATA_SNAPSHOT_OK;
+        }
+    }
+    return DATA_SNAPSHOT_ERR_IO;
+}
+
+uint32_t data_snapshot_content_crc(const data_snapshot_t *snapshot)
+{
+    if (!snapshot) {
+        return 0;
+    }
+    size_t start = offsetof(data_snapshot_t, valid_mask);
+    return crc32_update(0, (const uint8_t *)snapshot + start, SNAPSHOT_CRC_LEN - start);
+}
@@ -0,0 +1,137 @@
+#ifndef DATA_SNAPSHOT_H
+#define DATA_SNAPSHOT_H
+
+/**
+ * @file data_snapshot.h
+ * @brief 最后一次有效数据的持久化快照
+ *
+ * 记录格式带魔数、版本号、序号和CRC32。存储区由若干扇区组成，每个扇区划分为
+ * 固定大小的槽位，新记录总是追加到最新记录之后的槽位，进入新扇区时才擦除该扇区，
+ * 从而把擦写均摊到整个存储区。本模块只依赖标准C库，存储访问通过
+ * data_snapshot_storage_t回调完成，设备上对接flash，主机上可对接文件。
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "screen_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DATA_SNAPSHOT_MAGIC         0x50414E53u     /* "SNAP" */
+#define DATA_SNAPSHOT_VERSION       1
+#define DATA_SNAPSHOT_TEXT_LEN      24
+#define DATA_SNAPSHOT_SLOT_ALIGN    256             /* 槽位按flash页对齐 */
+
+/* 错误码 */
+#define DATA_SNAPSHOT_OK            0
+#define DATA_SNAPSHOT_ERR_PARAM     (-1)
+#define DATA_SNAPSHOT_ERR_IO        (-2)
+#define DATA_SNAPSHOT_ERR_EMPTY     (-3)
+#define DATA_SNAPSHOT_ERR_LAYOUT    (-4)
+
+/* valid_mask位 */
+#define DATA_SNAPSHOT_HAS_WEATHER   (1u << 0)
+#define DATA_SNAPSHOT_HAS_STOCK     (1u << 1)
+#define DATA_SNAPSHOT_HAS_SYSTEM    (1u << 2)
+#define DATA_SNAPSHOT_HAS_SENSOR    (1u << 3)
+
+/* 快照记录 - 数值统一按显示精度存为定点数 */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;            /* 记录字节数，用于校验布局 */
+    uint32_t sequence;          /* 单调递增，扫描时取最大者 */
+    uint32_t saved_time;        /* 保存时刻（time_t秒） */
+    uint8_t valid_mask;         /* DATA_SNAPSHOT_HAS_* */
+    uint8_t stock_count;
+    uint16_t reserved;
+
+    struct {
+        char city[DATA_SNAPSHOT_TEXT_LEN];
+        char weather[DATA_SNAPSHOT_TEXT_LEN];
+        int16_t temperature_x10;
+        uint16_t humidity;
+        uint16_t pressure;
+        uint16_t weather_code;
+        uint16_t city_code;
+        uint16_t reserved;
+    } weather;
+
+    struct {
+        int16_t cpu_usage_x10;
+        int16_t cpu_temp_x10;
+        int16_t gpu_usage_x10;
+        int16_t gpu_temp_x10;
+        int16_t ram_usage_x10;
+        int16_t reserved;
+        int32_t net_upload_x100;
+        int32_t net_download_x100;
+    } system;
+
+    struct {
+        int16_t temperature_x10;
+        uint16_t humidity_x10;
+    } sensor;
+
+    struct {
+        char name[DATA_SNAPSHOT_TEXT_LEN];
+        int32_t price_x100;
+        int32_t change_x100;
+    } stocks[STOCK_WATCHLIST_SIZE];
+
+    uint32_t crc32;             /* 覆盖crc32之前的全部字节 */
+} data_snapshot_t;
+
+/* 存储后端 - offset为存储区内偏移 */
+typedef struct {
+    int (*read)(uint32_t offset, void *buf, uint32_t len);
+    int (*write)(uint32_t offset, const void *buf, uint32_t len);
+    int (*erase)(uint32_t offset, uint32_t len);
+    uint32_t sector_size;
+    uint32_t sector_count;
+} data_snapshot_storage_t;
+
+/* 存储区上下文 */
+typedef struct {
+    const data_snapshot_storage_t *storage;
+    uint32_t slot_size;
+    uint32_t slot_count;
+    uint32_t next_slot;         /* 下一次写入的槽位 */
+    uint32_t last_sequence;
+    bool has_record;
+} data_snapshot_store_t;
+
+/**
+ * @brief 绑定存储后端并扫描出最新记录的位置
+ */
+int data_snapshot_open(data_snapshot_store_t *store, const data_snapshot_storage_t *storage);
+
+/**
+ * @brief 读取最新的有效记录
+ * @return DATA_SNAPSHOT_OK，或无记录时DATA_SNAPSHOT_ERR_EMPTY
+ */
+int data_snapshot_load(data_snapshot_store_t *store, data_snapshot_t *snapshot);
+
+/**
+ * @brief 追加写入一条记录（自动填写头部、序号和CRC）
+ */
+int data_snapshot_save(data_snapshot_store_t *store, data_snapshot_t *snapshot);
+
+/**
+ * @brief 计算记录内容的CRC32（不含头部序号/时间，用于判断内容是否变化）
+ */
+uint32_t data_snapshot_content_crc(const data_snapshot_t *snapshot);
+
+/**
+ * @brief 设备flash后端，未启用DATA_SNAPSHOT_USING_FLASH时返回NULL
+ */
+const data_snapshot_storage_t *data_snapshot_flash_storage(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DATA_SNAPSHOT_H */
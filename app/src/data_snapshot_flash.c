@@ -0,0 +1,48 @@
+#include <rtthread.h>
+#include "data_snapshot.h"
+
+#ifdef DATA_SNAPSHOT_USING_FLASH
+#include "drv_flash.h"
+
+/* 快照区起始地址和大小由Kconfig配置，须与板级分区表中预留的区域一致 */
+#define SNAPSHOT_FLASH_ADDR         (DATA_SNAPSHOT_FLASH_ADDR)
+#define SNAPSHOT_FLASH_SECTOR_SIZE  (4096)
+
+static int snapshot_flash_read(uint32_t offset, void *buf, uint32_t len)
+{
+    int ret = rt_flash_read(SNAPSHOT_FLASH_ADDR + offset, (uint8_t *)buf, len);
+    return (ret == (int)len) ? 0 : -RT_EIO;
+}
+
+static int snapshot_flash_write(uint32_t offset, const void *buf, uint32_t len)
+{
+    int ret = rt_flash_write(SNAPSHOT_FLASH_ADDR + offset, (const uint8_t *)buf, len);
+    return (ret == (int)len) ? 0 : -RT_EIO;
+}
+
+static int snapshot_flash_erase(uint32_t offset, uint32_t len)
+{
+    return (rt_flash_erase(SNAPSHOT_FLASH_ADDR + offset, len) == 0) ? 0 : -RT_EIO;
+}
+
+static const data_snapshot_storage_t g_snapshot_flash = {
+    .read = snapshot_flash_read,
+    .write = snapshot_flash_write,
+    .erase = snapshot_flash_erase,
+    .sector_size = SNAPSHOT_FLASH_SECTOR_SIZE,
+    .sector_count = DATA_SNAPSHOT_SECTOR_COUNT,
+};
+
+const data_snapshot_storage_t *data_snapshot_flash_storage(void)
+{
+    return &g_snapshot_flash;
+}
+
+#else
+
+const data_snapshot_storage_t *data_snapshot_flash_storage(void)
+{
+    return NULL;
+}
+
+#endif /* DATA_SNAPSHOT_USING_FLASH */
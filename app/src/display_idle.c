@@ -0,0 +1,303 @@
+#include "display_idle.h"
+
+#ifdef DISPLAY_IDLE
+#include "lvgl.h"
+#include "panel_grid.h"
+#include "data_manager.h"
+#include "screen.h"
+#include "screen_core.h"
+#include "screen_ui_manager.h"
+#include "serial_data_handler.h"
+#include <string.h>
+
+/* 等待驱动唤醒面板时轮询睡眠掩码的周期，驱动从SLEEP OUT到开显示约5ms */
+#define DISPLAY_IDLE_REDRAW_POLL_MS 5
+
+static struct {
+    bool initialized;
+    display_idle_state_t state;
+    rt_tick_t state_since;
+    volatile rt_tick_t last_activity;
+    volatile bool wake_req;
+    volatile int force_req;         /* finsh强制的状态+1，0为无 */
+    lv_obj_t *dim_mask[LCD_PANEL_NUM];
+    uint32_t sleep_mask;            /* 最近一次请求驱动睡眠的屏 */
+    uint32_t redraw_mask;           /* 已请求唤醒、等驱动重新开显示后重画的屏 */
+    lv_timer_t *redraw_timer;
+    uint32_t data_changes[3];       /* 按g_data_types顺序 */
+    rt_tick_t state_ticks[DISPLAY_IDLE_STATE_MAX];
+    display_idle_stats_t stats;
+} g_idle = {0};
+
+/* 各数据类型上次看到的变化计数，见data_manager_get_change_count */
+static const char *const g_data_types[] = {"weather", "stock", "system"};
+#define DATA_TYPE_COUNT (sizeof(g_data_types) / sizeof(g_data_types[0]))
+
+/* 当前页面是否显示该类数据：系统监控在第2组，天气和股票在第1组 */
+static bool data_type_shown(const char *type)
+{
+    if (screen_get_current_level() != SCREEN_LEVEL_1) {
+        return false;
+    }
+    screen_group_t group = screen_get_current_group();
+    return (strcmp(type, "system") == 0) ? (group == SCREEN_GROUP_2)
+                                         : (group == SCREEN_GROUP_1);
+}
+
+/*
+ * 只有当前页面显示的数据内容真正变化（脏掩码非零）才算活动。数值不变的
+ * 周期性上报和传感器读数的抖动不推迟空闲，静态页面照常进入空闲。
+ */
+static void poll_data_changes(rt_tick_t now)
+{
+    for (size_t i = 0; i < DATA_TYPE_COUNT; i++) {
+        uint32_t count = data_manager_get_change_count(g_data_types[i]);
+        if (count != g_idle.data_changes[i]) {
+            g_idle.data_changes[i] = count;
+            if (data_type_shown(g_data_types[i])) {
+                g_idle.last_activity = now;
+            }
+        }
+    }
+}
+
+/*
+ * 驱动按自己的定时器让屏退出睡眠，期间的刷屏会被跳过。轮询驱动的睡眠掩码，
+ * 屏重新开显示后再把它整块重画一遍。
+ */
+static void redraw_timer_cb(lv_timer_t *timer)
+{
+    uint32_t ready = g_idle.redraw_mask & ~lcd_panel_get_sleep_mask();
+
+    for (int i = 0; i < LCD_PANEL_NUM; i++) {
+        lv_obj_t *panel = screen_ui_get_panel(i);
+        if ((ready & (1u << i)) && panel) {
+            lv_obj_invalidate(panel);
+        }
+    }
+    g_idle.redraw_mask &= ~ready;
+    if (!g_idle.redraw_mask) {
+        lv_timer_pause(timer);
+    }
+}
+
+static void apply_state(display_idle_state_t state)
+{
+    uint32_t sleep_mask = 0;
+    rt_tick_t now = rt_tick_get();
+
+    g_idle.state_ticks[g_idle.state] += now - g_idle.state_since;
+    g_idle.state_since = now;
+
+    for (int i = 0; i < LCD_PANEL_NUM; i++) {
+        display_idle_state_t ps = state;
+        if (ps == DISPLAY_IDLE_SLEEP && (DISPLAY_IDLE_KEEP_PANELS & (1u << i))) {
+            ps = DISPLAY_IDLE_DIM;
+        }
+
+        /* 隐藏的面板不再产生无效区域，LVGL不为睡眠的屏渲染 */
+        lv_obj_t *panel = screen_ui_get_panel(i);
+        if (panel) {
+            if (ps == DISPLAY_IDLE_SLEEP) {
+                lv_obj_add_flag(panel, LV_OBJ_FLAG_HIDDEN);
+            } else {
+                lv_obj_clear_flag(panel, LV_OBJ_FLAG_HIDDEN);
+            }
+        }
+        if (g_idle.dim_mask[i]) {
+            if (ps == DISPLAY_IDLE_DIM) {
+                lv_obj_clear_flag(g_idle.dim_mask[i], LV_OBJ_FLAG_HIDDEN);
+            } else {
+                lv_obj_add_flag(g_idle.dim_mask[i], LV_OBJ_FLAG_HIDDEN);
+            }
+        }
+        if (ps == DISPLAY_IDLE_SLEEP) {
+            sleep_mask |= 1u << i;
+        }
+    }
+    lcd_panel_set_sleep_mask(sleep_mask);
+    if (g_idle.sleep_mask & ~sleep_mask) {
+        g_idle.redraw_mask |= g_idle.sleep_mask & ~sleep_mask;
+        lv_timer_resume(g_idle.redraw_timer);
+    }
+    g_idle.redraw_mask &= ~sleep_mask;
+    g_idle.sleep_mask = sleep_mask;
+
+    if (state == DISPLAY_IDLE_DIM && g_idle.state == DISPLAY_IDLE_ON) {
+        g_idle.stats.dims++;
+    } else if (state == DISPLAY_IDLE_SLEEP) {
+        g_idle.stats.sleeps++;
+    }
+    g_idle.state = state;
+}
+
+static display_idle_state_t target_state(rt_tick_t now)
+{
+    uint32_t sleep_s = DISPLAY_IDLE_SLEEP_S;
+    rt_tick_t idle = now - g_idle.last_activity;
+
+    if (!serial_data_handler_is_connected() && DISPLAY_IDLE_HOST_GONE_S < sleep_s) {
+        sleep_s = DISPLAY_IDLE_HOST_GONE_S;
+    }
+    if (idle >= rt_tick_from_millisecond(sleep_s * 1000)) {
+        return DISPLAY_IDLE_SLEEP;
+    }
+    if (idle >= rt_tick_from_millisecond(DISPLAY_IDLE_DIM_S * 1000)) {
+        return DISPLAY_IDLE_DIM;
+    }
+    return DISPLAY_IDLE_ON;
+}
+
+int display_idle_init(void)
+{
+    lv_obj_t *top = lv_layer_top();
+    if (!top) {
+        return -RT_ERROR;
+    }
+
+    for (int i = 0; i < LCD_PANEL_NUM; i++) {
+        lv_obj_t *mask = lv_obj_create(top);
+        if (!mask) {
+            return -RT_ENOMEM;
+        }
+        lv_obj_remove_style_all(mask);
+        lv_obj_set_size(mask, LCD_PANEL_WIDTH, LCD_PANEL_HEIGHT);
+        lv_obj_set_pos(mask, LCD_PANEL_X(i), LCD_PANEL_Y(i));
+        lv_obj_set_style_bg_color(mask, lv_color_black(), 0);
+        lv_obj_set_style_bg_opa(mask, DISPLAY_IDLE_DIM_OPA, 0);
+        lv_obj_clear_flag(mask, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_flag(mask, LV_OBJ_FLAG_HIDDEN);
+        g_idle.dim_mask[i] = mask;
+    }
+
+    g_idle.redraw_timer = lv_timer_create(redraw_timer_cb, DISPLAY_IDLE_REDRAW_POLL_MS, NULL);
+    if (!g_idle.redraw_timer) {
+        return -RT_ENOMEM;
+    }
+    lv_timer_pause(g_idle.redraw_timer);
+
+    for (size_t i = 0; i < DATA_TYPE_COUNT; i++) {
+        g_idle.data_changes[i] = data_manager_get_change_count(g_data_types[i]);
+    }
+
+    g_idle.state = DISPLAY_IDLE_ON;
+    g_idle.state_since = rt_tick_get();
+    g_idle.last_activity = g_idle.state_since;
+    g_idle.initialized = true;
+    return 0;
+}
+
+void display_idle_process(void)
+{
+    if (!g_idle.initialized) {
+        return;
+    }
+
+    rt_tick_t now = rt_tick_get();
+
+    if (g_idle.wake_req) {
+        g_idle.wake_req = false;
+        if (g_idle.state != DISPLAY_IDLE_ON) {
+            if (g_idle.state == DISPLAY_IDLE_SLEEP) {
+                g_idle.stats.wakes++;
+            }
+            /* 醒着的屏撤掉遮罩后本帧内画回来，睡眠的屏等驱动开显示后由redraw_timer重画 */
+            apply_state(DISPLAY_IDLE_ON);
+            lv_refr_now(NULL);
+        }
+        return;
+    }
+
+    if (g_idle.force_req) {
+        display_idle_state_t forced = (display_idle_state_t)(g_idle.force_req - 1);
+        g_idle.force_req = 0;
+        if (forced == DISPLAY_IDLE_DIM) {
+            /* 否则下一次轮询又按空闲时长恢复 */
+            g_idle.last_activity = now - rt_tick_from_millisecond(DISPLAY_IDLE_DIM_S * 1000);
+        }
+        apply_state(forced);
+        return;
+    }
+
+    poll_data_changes(now);
+    display_idle_state_t target = target_state(now);
+    if (target > g_idle.state) {
+        apply_state(target);
+    } else if (target == DISPLAY_IDLE_ON && g_idle.state == DISPLAY_IDLE_DIM) {
+        /* 页面数据有变化时取消调暗，睡眠只由输入唤醒 */
+        apply_state(DISPLAY_IDLE_ON);
+    }
+}
+
+bool display_idle_note_input(void)
+{
+    bool was_sleeping = (g_idle.state == DISPLAY_IDLE_SLEEP);
+
+    g_idle.last_activity = rt_tick_get();
+    if (g_idle.state != DISPLAY_IDLE_ON) {
+        g_idle.wake_req = true;
+        screen_core_wakeup(SCREEN_WAKE_DISPLAY);
+    }
+    return was_sleeping;
+}
+
+display_idle_state_t display_idle_get_state(void)
+{
+    return g_idle.state;
+}
+
+void display_idle_get_stats(display_idle_stats_t *stats)
+{
+    rt_enter_critical();
+    *stats = g_idle.stats;
+    for (int i = 0; i < DISPLAY_IDLE_STATE_MAX; i++) {
+        rt_tick_t ticks = g_idle.state_ticks[i];
+        if (i == (int)g_idle.state) {
+            ticks += rt_tick_get() - g_idle.state_since;
+        }
+        stats->state_s[i] = ticks / RT_TICK_PER_SECOND;
+    }
+    rt_exit_critical();
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void display_idle(int argc, char **argv)
+{
+    static const char *const names[DISPLAY_IDLE_STATE_MAX] = {"on", "dim", "sleep"};
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "wake") == 0) {
+            display_idle_note_input();
+            return;
+        }
+        for (int i = DISPLAY_IDLE_DIM; i < DISPLAY_IDLE_STATE_MAX; i++) {
+            if (strcmp(argv[1], names[i]) == 0) {
+                g_idle.force_req = i + 1;
+                screen_core_wakeup(SCREEN_WAKE_DISPLAY);
+                return;
+            }
+        }
+        rt_kprintf("usage: display_idle [wake | dim | sleep]\n");
+        return;
+    }
+
+    display_idle_stats_t s;
+    display_idle_get_stats(&s);
+    rt_tick_t idle = rt_tick_get() - g_idle.last_activity;
+    rt_kprintf("state %s, idle %u s, host %s, panel sleep mask 0x%x\n",
+               names[g_idle.state], (unsigned)(idle / RT_TICK_PER_SECOND),
+               serial_data_handler_is_connected() ? "connected" : "gone",
+               (unsigned)lcd_panel_get_sleep_mask());
+    rt_kprintf("dim after %u s, sleep after %u s (host gone %u s), keep mask 0x%x\n",
+               DISPLAY_IDLE_DIM_S, DISPLAY_IDLE_SLEEP_S, DISPLAY_IDLE_HOST_GONE_S,
+               DISPLAY_IDLE_KEEP_PANELS);
+    rt_kprintf("dims %u, sleeps %u, wakes %u; time on %u s, dim %u s, sleep %u s\n",
+               s.dims, s.sleeps, s.wakes,
+               s.state_s[DISPLAY_IDLE_ON], s.state_s[DISPLAY_IDLE_DIM], s.state_s[DISPLAY_IDLE_SLEEP]);
+}
+MSH_CMD_EXPORT(display_idle, panel idle dimming and sleep: display_idle [wake | dim | sleep]);
+#endif /* RT_USING_FINSH */
+
+#endif /* DISPLAY_IDLE */
@@ -0,0 +1,94 @@
+#ifndef DISPLAY_IDLE_H
+#define DISPLAY_IDLE_H
+
+/**
+ * @file display_idle.h
+ * @brief 面板空闲调暗与熄屏
+ *
+ * 没有按键/编码器输入、当前页面显示的数据也没有变化时，DISPLAY_IDLE_DIM_S
+ * 秒后调暗各屏，DISPLAY_IDLE_SLEEP_S秒后让各屏进入睡眠（上位机断开时
+ * 改用更短的DISPLAY_IDLE_HOST_GONE_S）。DISPLAY_IDLE_KEEP_PANELS中的屏
+ * 只调暗不睡眠。
+ *
+ * 面板没有背光控制，调暗用一层半透明黑色遮罩实现。睡眠的屏隐藏其面板容器，
+ * LVGL不再为它渲染，驱动随后关显示并进入SLEEP IN。输入会立即唤醒全部面板，
+ * 驱动重新开显示（约5ms）后整块重画；只有当前页面显示的数据内容变化才推迟
+ * 空闲计时和取消调暗，不唤醒已睡眠的屏。
+ */
+
+#include <rtthread.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef DISPLAY_IDLE_DIM_S
+#define DISPLAY_IDLE_DIM_S          60
+#endif
+
+#ifndef DISPLAY_IDLE_SLEEP_S
+#define DISPLAY_IDLE_SLEEP_S        300
+#endif
+
+#ifndef DISPLAY_IDLE_HOST_GONE_S
+#define DISPLAY_IDLE_HOST_GONE_S    60
+#endif
+
+#ifndef DISPLAY_IDLE_KEEP_PANELS
+#define DISPLAY_IDLE_KEEP_PANELS    0x0
+#endif
+
+#ifndef DISPLAY_IDLE_DIM_OPA
+#define DISPLAY_IDLE_DIM_OPA        160
+#endif
+
+typedef enum {
+    DISPLAY_IDLE_ON = 0,
+    DISPLAY_IDLE_DIM,
+    DISPLAY_IDLE_SLEEP,
+    DISPLAY_IDLE_STATE_MAX
+} display_idle_state_t;
+
+typedef struct {
+    uint32_t dims;
+    uint32_t sleeps;
+    uint32_t wakes;                             /* 由输入唤醒的次数 */
+    uint32_t state_s[DISPLAY_IDLE_STATE_MAX];   /* 各状态累计时长 */
+} display_idle_stats_t;
+
+#ifdef DISPLAY_IDLE
+
+/**
+ * @brief 创建调暗遮罩并记录数据变化计数的起点，须在界面和data_manager初始化之后调用
+ */
+int display_idle_init(void);
+
+/**
+ * @brief 在GUI线程中轮询：处理唤醒请求、检查当前页面数据是否变化、按空闲时长切换状态
+ */
+void display_idle_process(void);
+
+/**
+ * @brief 记录一次用户输入，任意线程可调用
+ * @return 面板此前处于睡眠时返回true，调用者可据此丢弃仅用于唤醒的输入
+ */
+bool display_idle_note_input(void);
+
+display_idle_state_t display_idle_get_state(void);
+void display_idle_get_stats(display_idle_stats_t *stats);
+
+#else
+
+#define display_idle_init()
+#define display_idle_process()
+static inline bool display_idle_note_input(void) { return false; }
+
+#endif /* DISPLAY_IDLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DISPLAY_IDLE_H */
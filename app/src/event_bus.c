@@ -1,6 +1,7 @@
 // event_bus.c - 完整重新设计版本
 
 #include "event_bus.h"
+#include "stock_watchlist.h"
 #include <string.h>
 #include <stdlib.h>
 
@@ -41,6 +42,15 @@ static bool is_in_interrupt_context(void);
 static void event_bus_health_check(void);
 static void event_bus_emergency_cleanup(void);
 
+/* 股票事件里的名称ID在驻留时已替事件引用，分发完或丢弃时释放 */
+static void release_event_refs(event_type_t type, const void *data)
+{
+    if (type == EVENT_DATA_STOCK_UPDATED && data) {
+        const event_data_stock_t *stock = (const event_data_stock_t *)data;
+        stock_name_release_list(stock->stocks, stock->count);
+    }
+}
+
 /* 检查是否在中断上下文中 */
 static bool is_in_interrupt_context(void)
 {
@@ -157,6 +167,7 @@ static void event_processing_thread(void *parameter)
                 } else {
                     update_stats(&g_event_bus.dropped_count);
                 }
+                release_event_refs(event.type, &event.data);
             }
             
         } else if (result == -RT_ETIMEOUT) {
@@ -206,6 +217,7 @@ static void event_bus_health_check(void)
             int cleaned = 0;
             while (cleaned < 5 && rt_mq_recv(g_event_bus.event_queue, &dummy_event, 
                                             sizeof(event_t), 0) == RT_EOK) {
+                release_event_refs(dummy_event.type, &dummy_event.data);
                 cleaned++;
             }
             
@@ -236,6 +248,7 @@ static void event_bus_emergency_cleanup(void)
         event_t dummy_event;
         int cleaned = 0;
         while (rt_mq_recv(g_event_bus.event_queue, &dummy_event, sizeof(event_t), 0) == RT_EOK) {
+            release_event_refs(dummy_event.type, &dummy_event.data);
             cleaned++;
             if (cleaned > 50) break;  // 避免无限循环
         }
@@ -387,6 +400,10 @@ int event_bus_deinit(void)
     }
     
     if (g_event_bus.event_queue) {
+        event_t dummy_event;
+        while (rt_mq_recv(g_event_bus.event_queue, &dummy_event, sizeof(event_t), 0) == RT_EOK) {
+            release_event_refs(dummy_event.type, &dummy_event.data);
+        }
         rt_mq_delete(g_event_bus.event_queue);
         g_event_bus.event_queue = NULL;
     }
@@ -400,6 +417,7 @@ int event_bus_publish(event_type_t type, const void *event_data, size_t data_siz
                      event_priority_t priority, uint32_t source_module_id)
 {
     if (!g_event_bus.initialized || !g_event_bus.running) {
+        release_event_refs(type, event_data);
         return -RT_ERROR;
     }
     
@@ -441,6 +459,9 @@ int event_bus_publish(event_type_t type, const void *event_data, size_t data_siz
         }
     }
     
+    if (result != RT_EOK) {
+        release_event_refs(type, &event.data);
+    }
     return (result == RT_EOK) ? 0 : -RT_ERROR;
 }
 
@@ -449,6 +470,7 @@ int event_bus_publish_sync(event_type_t type, const void *event_data, size_t dat
                           event_priority_t priority, uint32_t source_module_id)
 {
     if (!g_event_bus.initialized) {
+        release_event_refs(type, event_data);
         return -RT_ERROR;
     }
     
@@ -469,6 +491,7 @@ int event_bus_publish_sync(event_type_t type, const void *event_data, size_t dat
     
     // 使用短超时获取锁
     if (rt_mutex_take(g_event_bus.subscribers_lock, 1000) != RT_EOK) {
+        release_event_refs(event.type, &event.data);
         return -RT_ETIMEOUT;
     }
     
@@ -497,6 +520,7 @@ int event_bus_publish_sync(event_type_t type, const void *event_data, size_t dat
     }
     
     rt_mutex_release(g_event_bus.subscribers_lock);
+    release_event_refs(event.type, &event.data);
     
     update_stats(&g_event_bus.published_count);
     if (handled) {
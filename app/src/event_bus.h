@@ -17,6 +17,9 @@ typedef enum {
     EVENT_DATA_STOCK_UPDATED,
     EVENT_DATA_SYSTEM_UPDATED,
     EVENT_DATA_SENSOR_UPDATED,
+    EVENT_DATA_WEATHER_EXPIRED,     /* 超过DATA_TIMEOUT_MS未更新，每次过期只发一次 */
+    EVENT_DATA_STOCK_EXPIRED,
+    EVENT_DATA_SYSTEM_EXPIRED,
     
     EVENT_SCREEN_SWITCH_REQUEST = 0x2000,
     EVENT_SCREEN_REFRESH_REQUEST,
@@ -63,14 +66,22 @@ typedef struct {
     weather_data_t weather;
 } event_data_weather_t;
 
+/* 股票更新：replace为true时整表替换自选股，否则按名称逐只插入/更新 */
 typedef struct {
-    stock_data_t stock;
+    uint8_t count;
+    bool replace;
+    stock_data_t stocks[STOCK_WATCHLIST_SIZE];
 } event_data_stock_t;
 
 typedef struct {
     system_monitor_data_t system;
 } event_data_system_t;
 
+/* 数据过期：发出时data_manager已将数据置为无效，generation为过期时截止时间的代数 */
+typedef struct {
+    uint32_t generation;
+} event_data_expired_t;
+
 typedef struct {
     screen_group_t target_group;
     screen_group_t current_group;
@@ -106,6 +117,7 @@ typedef struct {
         event_data_weather_t weather;
         event_data_stock_t stock;
         event_data_system_t system;
+        event_data_expired_t expired;
         event_data_screen_switch_t screen_switch;
         event_data_encoder_t encoder;
         event_data_error_t error;
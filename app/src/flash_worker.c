@@ -0,0 +1,89 @@
+#include "flash_worker.h"
+
+#define FLASH_WORKER_STACK_SIZE     2048
+#define FLASH_WORKER_PRIORITY       25      // 低于GUI、串口和LED线程
+#define FLASH_WORKER_ALL            ((1u << FLASH_JOB_MAX) - 1)
+
+static struct {
+    rt_thread_t thread;
+    rt_event_t event;               // 每个任务一位
+    flash_job_fn_t fn[FLASH_JOB_MAX];
+    rt_timer_t timer[FLASH_JOB_MAX];
+} g_worker = {0};
+
+static void flash_worker_timeout(void *parameter)
+{
+    rt_event_send(g_worker.event, 1u << (uint32_t)(uintptr_t)parameter);
+}
+
+static void flash_worker_thread_entry(void *parameter)
+{
+    (void)parameter;
+
+    while (1) {
+        rt_uint32_t set = 0;
+        if (rt_event_recv(g_worker.event, FLASH_WORKER_ALL, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                          RT_WAITING_FOREVER, &set) != RT_EOK) {
+            continue;
+        }
+        for (int job = 0; job < FLASH_JOB_MAX; job++) {
+            if ((set & (1u << job)) && g_worker.fn[job]) {
+                g_worker.fn[job]();
+            }
+        }
+    }
+}
+
+int flash_worker_init(void)
+{
+    if (g_worker.thread) {
+        return 0;
+    }
+
+    g_worker.event = rt_event_create("flash_wk", RT_IPC_FLAG_PRIO);
+    if (!g_worker.event) {
+        return -RT_ENOMEM;
+    }
+    g_worker.thread = rt_thread_create("flash_wk", flash_worker_thread_entry, RT_NULL,
+                                       FLASH_WORKER_STACK_SIZE, FLASH_WORKER_PRIORITY, 10);
+    if (!g_worker.thread) {
+        rt_event_delete(g_worker.event);
+        g_worker.event = RT_NULL;
+        return -RT_ENOMEM;
+    }
+    rt_thread_startup(g_worker.thread);
+    return 0;
+}
+
+int flash_worker_register(flash_job_t job, flash_job_fn_t fn)
+{
+    if (!g_worker.thread || job >= FLASH_JOB_MAX || !fn) {
+        return -RT_EINVAL;
+    }
+    if (!g_worker.timer[job]) {
+        g_worker.timer[job] = rt_timer_create("flash_wk", flash_worker_timeout,
+                                              (void *)(uintptr_t)job, 1,
+                                              RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_SOFT_TIMER);
+        if (!g_worker.timer[job]) {
+            return -RT_ENOMEM;
+        }
+    }
+    g_worker.fn[job] = fn;
+    return 0;
+}
+
+int flash_worker_post(flash_job_t job, uint32_t delay_ms)
+{
+    if (job >= FLASH_JOB_MAX || !g_worker.fn[job]) {
+        return -RT_EINVAL;
+    }
+    if (delay_ms == 0) {
+        return rt_event_send(g_worker.event, 1u << job);
+    }
+
+    /* 重新启动即重新计时 */
+    rt_tick_t ticks = rt_tick_from_millisecond(delay_ms);
+    rt_timer_stop(g_worker.timer[job]);
+    rt_timer_control(g_worker.timer[job], RT_TIMER_CTRL_SET_TIME, &ticks);
+    return rt_timer_start(g_worker.timer[job]);
+}
@@ -0,0 +1,50 @@
+#ifndef FLASH_WORKER_H
+#define FLASH_WORKER_H
+
+/**
+ * @file flash_worker.h
+ * @brief flash擦写后台线程
+ *
+ * 扇区擦除要几十毫秒，不能放在GUI、串口或LED线程里做。各模块按固定任务号
+ * 登记一个保存回调，需要保存时只调用flash_worker_post，回调在低优先级的
+ * 后台线程中串行执行。带延时的post用于去抖：延时内再次post重新计时，
+ * 多次修改合并为一次写入。
+ */
+
+#include <rtthread.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    FLASH_JOB_DATA_SNAPSHOT = 0,
+    FLASH_JOB_LED_TIMELINE,
+    FLASH_JOB_MAX
+} flash_job_t;
+
+typedef void (*flash_job_fn_t)(void);
+
+/**
+ * @brief 创建后台线程，可重复调用
+ */
+int flash_worker_init(void);
+
+/**
+ * @brief 登记任务回调，须在flash_worker_init之后、第一次post之前调用
+ */
+int flash_worker_register(flash_job_t job, flash_job_fn_t fn);
+
+/**
+ * @brief 请求执行一次任务，不等待，任意线程可调用
+ * @param delay_ms 0立即执行；否则从本次调用起延时执行，期间再次post重新计时
+ * @note 执行前多次post只执行一次，回调自己判断是否还有要保存的内容
+ */
+int flash_worker_post(flash_job_t job, uint32_t delay_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLASH_WORKER_H */
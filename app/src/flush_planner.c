@@ -0,0 +1,225 @@
+#include "flush_planner.h"
+#include "lvgl.h"
+#include <string.h>
+
+#define PLANNER_AREAS_PER_PANEL     16
+#define PLANNER_RIGHT               (FLUSH_PLANNER_PANEL_COLS * FLUSH_PLANNER_PANEL_WIDTH - 1)
+#define PLANNER_BOTTOM              (FLUSH_PLANNER_PANEL_ROWS * FLUSH_PLANNER_PANEL_HEIGHT - 1)
+
+/* 本帧已提交到LVGL、落在某块屏上的区域 */
+typedef struct {
+    lv_area_t areas[PLANNER_AREAS_PER_PANEL];
+    uint8_t count;
+} panel_plan_t;
+
+static struct {
+    lv_display_t *disp;
+    panel_plan_t panels[FLUSH_PLANNER_PANELS];
+    uint8_t depth;                  /* 拆分时嵌套调用lv_inv_area的层数 */
+    flush_planner_stats_t stats;
+} g_planner = {0};
+
+static uint32_t area_px(const lv_area_t *a)
+{
+    return (uint32_t)lv_area_get_width(a) * (uint32_t)lv_area_get_height(a);
+}
+
+static void area_union(lv_area_t *out, const lv_area_t *a, const lv_area_t *b)
+{
+    out->x1 = LV_MIN(a->x1, b->x1);
+    out->y1 = LV_MIN(a->y1, b->y1);
+    out->x2 = LV_MAX(a->x2, b->x2);
+    out->y2 = LV_MAX(a->y2, b->y2);
+}
+
+/* 与同屏已有区域反复合并，直到再合并不划算 */
+static void plan_area(int panel, lv_area_t *area)
+{
+    panel_plan_t *pp = &g_planner.panels[panel];
+
+    for (;;) {
+        int best = -1;
+        int32_t best_gain = 0;
+
+        for (int i = 0; i < pp->count; i++) {
+            lv_area_t u;
+            area_union(&u, area, &pp->areas[i]);
+            int32_t gain = (int32_t)(area_px(area) + area_px(&pp->areas[i]) + FLUSH_PLANNER_OVERHEAD_PX) -
+                           (int32_t)area_px(&u);
+            if (gain > best_gain) {
+                best_gain = gain;
+                best = i;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+
+        /* 扩成包围盒，旧区域被包含后由LVGL在合并阶段去掉 */
+        area_union(area, area, &pp->areas[best]);
+        pp->areas[best] = pp->areas[--pp->count];
+        g_planner.stats.merges++;
+    }
+
+    /* 记录表满时把这块屏上的区域全部并成一个包围盒，统计仍然完整 */
+    if (pp->count >= PLANNER_AREAS_PER_PANEL) {
+        for (int i = 0; i < pp->count; i++) {
+            area_union(area, area, &pp->areas[i]);
+        }
+        pp->count = 0;
+        g_planner.stats.overflows++;
+    }
+    pp->areas[pp->count++] = *area;
+}
+
+/* 面板外的区域不能改成空区域：LVGL分块渲染时按区域宽度做除法。改成本帧已规划的
+ * 某个区域，LVGL发现它已被包含就直接丢弃；本帧还没有区域时改成第一块屏左上角的
+ * 一个像素，之后提交的区域会把它包含进去 */
+static void drop_area(lv_area_t *area)
+{
+    g_planner.stats.dropped++;
+
+    for (int p = 0; p < FLUSH_PLANNER_PANELS; p++) {
+        if (g_planner.panels[p].count > 0) {
+            *area = g_planner.panels[p].areas[0];
+            return;
+        }
+    }
+
+    lv_area_set(area, 0, 0, 0, 0);
+    plan_area(0, area);
+}
+
+static void invalidate_event_cb(lv_event_t *e)
+{
+    lv_area_t *area = lv_event_get_param(e);
+
+    if (g_planner.depth == 0) {
+        g_planner.stats.areas_in++;
+    }
+
+    /* 完全在面板外（显示缓冲的下半部分），不让LVGL渲染 */
+    if (area->x1 > PLANNER_RIGHT || area->y1 > PLANNER_BOTTOM) {
+        drop_area(area);
+        return;
+    }
+    area->x2 = LV_MIN(area->x2, PLANNER_RIGHT);
+    area->y2 = LV_MIN(area->y2, PLANNER_BOTTOM);
+
+    int col1 = area->x1 / FLUSH_PLANNER_PANEL_WIDTH;
+    int col2 = area->x2 / FLUSH_PLANNER_PANEL_WIDTH;
+    int row1 = area->y1 / FLUSH_PLANNER_PANEL_HEIGHT;
+    int row2 = area->y2 / FLUSH_PLANNER_PANEL_HEIGHT;
+
+    /* 跨屏时其余部分作为新区域提交，本区域只保留第一块屏上的部分 */
+    if (col1 != col2 || row1 != row2) {
+        lv_area_t whole = *area;
+
+        g_planner.depth++;
+        for (int row = row1; row <= row2; row++) {
+            for (int col = col1; col <= col2; col++) {
+                if (row == row1 && col == col1) {
+                    continue;
+                }
+                lv_area_t piece = {
+                    .x1 = LV_MAX(whole.x1, col * FLUSH_PLANNER_PANEL_WIDTH),
+                    .y1 = LV_MAX(whole.y1, row * FLUSH_PLANNER_PANEL_HEIGHT),
+                    .x2 = LV_MIN(whole.x2, (col + 1) * FLUSH_PLANNER_PANEL_WIDTH - 1),
+                    .y2 = LV_MIN(whole.y2, (row + 1) * FLUSH_PLANNER_PANEL_HEIGHT - 1),
+                };
+                g_planner.stats.splits++;
+                lv_inv_area(g_planner.disp, &piece);
+            }
+        }
+        g_planner.depth--;
+
+        area->x2 = LV_MIN(whole.x2, (col1 + 1) * FLUSH_PLANNER_PANEL_WIDTH - 1);
+        area->y2 = LV_MIN(whole.y2, (row1 + 1) * FLUSH_PLANNER_PANEL_HEIGHT - 1);
+    }
+
+    plan_area(row1 * FLUSH_PLANNER_PANEL_COLS + col1, area);
+}
+
+static void refr_ready_event_cb(lv_event_t *e)
+{
+    uint32_t flushes = 0;
+    uint32_t bytes = 0;
+
+    for (int p = 0; p < FLUSH_PLANNER_PANELS; p++) {
+        panel_plan_t *pp = &g_planner.panels[p];
+        for (int i = 0; i < pp->count; i++) {
+            bytes += area_px(&pp->areas[i]) * (LV_COLOR_DEPTH / 8);
+        }
+        flushes += pp->count;
+        pp->count = 0;
+    }
+    if (flushes == 0) {
+        return;
+    }
+
+    rt_enter_critical();
+    g_planner.stats.frames++;
+    g_planner.stats.flushes += flushes;
+    g_planner.stats.bytes += bytes;
+    g_planner.stats.last_flushes = flushes;
+    g_planner.stats.last_bytes = bytes;
+    if (flushes > g_planner.stats.max_flushes) {
+        g_planner.stats.max_flushes = flushes;
+    }
+    rt_exit_critical();
+}
+
+int flush_planner_init(void)
+{
+    g_planner.disp = lv_display_get_default();
+    if (!g_planner.disp) {
+        return -RT_ERROR;
+    }
+
+    lv_display_add_event_cb(g_planner.disp, invalidate_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_add_event_cb(g_planner.disp, refr_ready_event_cb, LV_EVENT_REFR_READY, NULL);
+    return 0;
+}
+
+void flush_planner_get_stats(flush_planner_stats_t *stats)
+{
+    rt_enter_critical();
+    *stats = g_planner.stats;
+    rt_exit_critical();
+}
+
+void flush_planner_reset_stats(void)
+{
+    rt_enter_critical();
+    memset(&g_planner.stats, 0, sizeof(g_planner.stats));
+    rt_exit_critical();
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void flush_plan(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        flush_planner_reset_stats();
+        rt_kprintf("flush planner stats reset\n");
+        return;
+    }
+
+    flush_planner_stats_t s;
+    flush_planner_get_stats(&s);
+    if (s.frames == 0) {
+        rt_kprintf("no frames yet\n");
+        return;
+    }
+
+    uint32_t flushes_x10 = (uint32_t)((uint64_t)s.flushes * 10 / s.frames);
+    rt_kprintf("frames %u, areas in %u, splits %u, merges %u, off-panel %u, overflows %u\n",
+               s.frames, s.areas_in, s.splits, s.merges, s.dropped, s.overflows);
+    rt_kprintf("flushes/frame avg %u.%u max %u last %u\n",
+               flushes_x10 / 10, flushes_x10 % 10, s.max_flushes, s.last_flushes);
+    rt_kprintf("bytes/frame avg %u last %u\n",
+               (uint32_t)(s.bytes / s.frames), s.last_bytes);
+}
+MSH_CMD_EXPORT(flush_plan, panel flush planner stats: flush_plan [reset]);
+#endif /* RT_USING_FINSH */
@@ -0,0 +1,63 @@
+#ifndef FLUSH_PLANNER_H
+#define FLUSH_PLANNER_H
+
+/**
+ * @file flush_planner.h
+ * @brief 按面板边界规划LVGL的无效区域
+ *
+ * 画布实际是按panel_grid.h拼成的多块128x128 GC9107，每次刷屏都有固定的
+ * CS切换、窗口设置和中断开销。规划器挂在显示的LV_EVENT_INVALIDATE_AREA上：
+ * 1. 把区域裁到面板范围内（显示缓冲比面板高，下半部分不必渲染），完全在面板外的
+ *    区域改成已被包含的区域，由LVGL丢弃
+ * 2. 跨面板的区域在面板边界处拆开，每块只落在一块屏上
+ * 3. 同一块屏上的区域，合并后的像素代价加上省掉的一次刷屏开销更小时，
+ *    扩成包围盒，由LVGL的区域合并吸收被包含的旧区域
+ * 每帧统计规划出的刷屏次数和字节数，用finsh命令flush_plan查看。
+ */
+
+#include <rtthread.h>
+#include <stdint.h>
+#include "panel_grid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FLUSH_PLANNER_PANEL_WIDTH   LCD_PANEL_WIDTH
+#define FLUSH_PLANNER_PANEL_HEIGHT  LCD_PANEL_HEIGHT
+#define FLUSH_PLANNER_PANEL_COLS    LCD_PANEL_COLS
+#define FLUSH_PLANNER_PANEL_ROWS    LCD_PANEL_ROWS
+#define FLUSH_PLANNER_PANELS        LCD_PANEL_NUM
+
+/* 一次刷屏的固定开销折算成的像素数（48MHz单线SPI约3像素/微秒） */
+#ifndef FLUSH_PLANNER_OVERHEAD_PX
+#define FLUSH_PLANNER_OVERHEAD_PX   256
+#endif
+
+typedef struct {
+    uint32_t frames;
+    uint32_t areas_in;          /* LVGL提交的原始区域数 */
+    uint32_t splits;            /* 在面板边界处拆出的区域数 */
+    uint32_t merges;            /* 合并次数 */
+    uint32_t dropped;           /* 完全在面板外、不再渲染的区域数 */
+    uint32_t overflows;         /* 同屏区域超出记录表、并成整屏包围盒的次数 */
+    uint32_t flushes;           /* 规划后的刷屏次数 */
+    uint64_t bytes;             /* 规划后的刷屏字节数 */
+    uint32_t last_flushes;
+    uint32_t last_bytes;
+    uint32_t max_flushes;
+} flush_planner_stats_t;
+
+/**
+ * @brief 挂到默认显示上，须在LVGL显示初始化之后、创建界面之前调用
+ */
+int flush_planner_init(void);
+
+void flush_planner_get_stats(flush_planner_stats_t *stats);
+void flush_planner_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLUSH_PLANNER_H */
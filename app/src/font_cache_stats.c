@@ -0,0 +1,204 @@
+#include "font_cache_stats.h"
+#include <string.h>
+
+typedef const void *(*glyph_bitmap_cb_t)(lv_font_glyph_dsc_t *, lv_draw_buf_t *);
+
+typedef struct {
+    lv_font_t *font;
+    glyph_bitmap_cb_t orig_get_bitmap;
+    uint32_t *keys;             /* 影子LRU：字形号 */
+    uint32_t *stamps;           /* 最近使用序号 */
+    uint16_t used;
+    uint32_t use_seq;
+    font_cache_stats_t stats;
+} font_cache_record_t;
+
+static struct {
+    font_cache_record_t records[FONT_CACHE_STATS_MAX_FONTS];
+    int count;
+} g_font_stats = {0};
+
+static font_cache_record_t *find_record(const lv_font_t *font)
+{
+    for (int i = 0; i < g_font_stats.count; i++) {
+        if (g_font_stats.records[i].font == font) {
+            return &g_font_stats.records[i];
+        }
+    }
+    return NULL;
+}
+
+/* 查影子表，命中返回true；未命中时插入，表满则淘汰最久未用的字形 */
+static bool shadow_lookup(font_cache_record_t *rec, uint32_t key)
+{
+    uint16_t victim = 0;
+
+    rec->use_seq++;
+    for (uint16_t i = 0; i < rec->used; i++) {
+        if (rec->keys[i] == key) {
+            rec->stamps[i] = rec->use_seq;
+            return true;
+        }
+        if ((int32_t)(rec->stamps[i] - rec->stamps[victim]) < 0) {
+            victim = i;
+        }
+    }
+
+    if (rec->used < rec->stats.cache_size) {
+        victim = rec->used++;
+    } else {
+        rec->stats.evictions++;
+    }
+    rec->keys[victim] = key;
+    rec->stamps[victim] = rec->use_seq;
+    return false;
+}
+
+static const void *stats_get_glyph_bitmap(lv_font_glyph_dsc_t *g_dsc, lv_draw_buf_t *draw_buf)
+{
+    font_cache_record_t *rec = find_record(g_dsc->resolved_font);
+    if (!rec) {
+        return NULL;
+    }
+
+    if (shadow_lookup(rec, g_dsc->gid.index)) {
+        rec->stats.hits++;
+        return rec->orig_get_bitmap(g_dsc, draw_buf);
+    }
+
+    rt_tick_t start = rt_tick_get();
+    const void *bitmap = rec->orig_get_bitmap(g_dsc, draw_buf);
+    uint32_t ms = (rt_tick_get() - start) * 1000 / RT_TICK_PER_SECOND;
+
+    rec->stats.misses++;
+    rec->stats.raster_ms += ms;
+    if (ms > rec->stats.raster_max_ms) {
+        rec->stats.raster_max_ms = ms;
+    }
+    return bitmap;
+}
+
+int font_cache_stats_attach(lv_font_t *font, const char *name,
+                            uint16_t font_size, uint16_t cache_size)
+{
+    if (!font || !font->get_glyph_bitmap || cache_size == 0) {
+        return -RT_EINVAL;
+    }
+    if (find_record(font)) {
+        return 0;
+    }
+    if (g_font_stats.count >= FONT_CACHE_STATS_MAX_FONTS) {
+        return -RT_EFULL;
+    }
+
+    font_cache_record_t *rec = &g_font_stats.records[g_font_stats.count];
+    memset(rec, 0, sizeof(*rec));
+    rec->keys = rt_malloc(cache_size * sizeof(uint32_t));
+    rec->stamps = rt_malloc(cache_size * sizeof(uint32_t));
+    if (!rec->keys || !rec->stamps) {
+        rt_free(rec->keys);
+        rt_free(rec->stamps);
+        rec->keys = NULL;
+        rec->stamps = NULL;
+        return -RT_ENOMEM;
+    }
+
+    rec->font = font;
+    rec->orig_get_bitmap = font->get_glyph_bitmap;
+    rec->stats.name = name;
+    rec->stats.font_size = font_size;
+    rec->stats.cache_size = cache_size;
+    font->get_glyph_bitmap = stats_get_glyph_bitmap;
+    g_font_stats.count++;
+    return 0;
+}
+
+void font_cache_stats_detach(lv_font_t *font)
+{
+    font_cache_record_t *rec = find_record(font);
+    if (!rec) {
+        return;
+    }
+
+    font->get_glyph_bitmap = rec->orig_get_bitmap;
+    rt_free(rec->keys);
+    rt_free(rec->stamps);
+
+    /* 用最后一条记录填补空位 */
+    rt_enter_critical();
+    int last = g_font_stats.count - 1;
+    if (rec != &g_font_stats.records[last]) {
+        *rec = g_font_stats.records[last];
+    }
+    memset(&g_font_stats.records[last], 0, sizeof(g_font_stats.records[last]));
+    g_font_stats.count--;
+    rt_exit_critical();
+}
+
+int font_cache_stats_count(void)
+{
+    return g_font_stats.count;
+}
+
+int font_cache_stats_get(int index, font_cache_stats_t *stats)
+{
+    if (!stats || index < 0) {
+        return -RT_EINVAL;
+    }
+
+    rt_enter_critical();
+    if (index >= g_font_stats.count) {
+        rt_exit_critical();
+        return -RT_EINVAL;
+    }
+    *stats = g_font_stats.records[index].stats;
+    rt_exit_critical();
+    return 0;
+}
+
+void font_cache_stats_reset(void)
+{
+    rt_enter_critical();
+    for (int i = 0; i < g_font_stats.count; i++) {
+        font_cache_stats_t *s = &g_font_stats.records[i].stats;
+        s->hits = 0;
+        s->misses = 0;
+        s->evictions = 0;
+        s->raster_ms = 0;
+        s->raster_max_ms = 0;
+    }
+    rt_exit_critical();
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void font_stats(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        font_cache_stats_reset();
+        rt_kprintf("font cache stats reset\n");
+        return;
+    }
+
+    if (font_cache_stats_count() == 0) {
+        rt_kprintf("no TTF fallback fonts\n");
+        return;
+    }
+
+    rt_kprintf("%-8s %4s %5s %8s %8s %6s %5s %8s %6s\n",
+               "font", "px", "cache", "hits", "misses", "evict", "hit%", "rast_ms", "max_ms");
+    for (int i = 0; i < font_cache_stats_count(); i++) {
+        font_cache_stats_t s;
+        if (font_cache_stats_get(i, &s) != 0) {
+            continue;
+        }
+        uint32_t total = s.hits + s.misses;
+        uint32_t hit_pct = total ? (uint32_t)((uint64_t)s.hits * 100 / total) : 0;
+        rt_kprintf("%-8s %4u %5u %8u %8u %6u %4u%% %8u %6u\n",
+                   s.name ? s.name : "?", s.font_size, s.cache_size, s.hits, s.misses,
+                   s.evictions, hit_pct, s.raster_ms, s.raster_max_ms);
+    }
+}
+MSH_CMD_EXPORT(font_stats, show TTF glyph cache stats: font_stats [reset]);
+#endif /* RT_USING_FINSH */
@@ -0,0 +1,54 @@
+#ifndef FONT_CACHE_STATS_H
+#define FONT_CACHE_STATS_H
+
+/**
+ * @file font_cache_stats.h
+ * @brief TTF回退字体的字形缓存统计
+ *
+ * 包装tiny_ttf字体的取位图回调，用与tiny_ttf相同容量的LRU影子表按字形号
+ * 记录命中、未命中和淘汰，并统计未命中时的光栅化耗时，用于按实际字形工作集
+ * 调整各字号的FONT_TTF_CACHE_CNT_*。只在GUI线程中调用attach/detach。
+ */
+
+#include <rtthread.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FONT_CACHE_STATS_MAX_FONTS  6
+
+typedef struct {
+    const char *name;
+    uint16_t font_size;
+    uint16_t cache_size;        /* 配置的缓存字形数 */
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t raster_ms;         /* 未命中时光栅化累计耗时，精度为一个系统节拍 */
+    uint32_t raster_max_ms;
+} font_cache_stats_t;
+
+/**
+ * @brief 开始统计字体，cache_size须与创建tiny_ttf时的缓存大小一致
+ * @return 0成功，-RT_EFULL统计槽已满，-RT_ENOMEM影子表分配失败
+ */
+int font_cache_stats_attach(lv_font_t *font, const char *name,
+                            uint16_t font_size, uint16_t cache_size);
+
+/**
+ * @brief 停止统计并恢复原回调，须在销毁字体前调用
+ */
+void font_cache_stats_detach(lv_font_t *font);
+
+int font_cache_stats_count(void);
+int font_cache_stats_get(int index, font_cache_stats_t *stats);
+void font_cache_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FONT_CACHE_STATS_H */
@@ -0,0 +1,420 @@
+#include "frame_profiler.h"
+
+#ifdef FRAME_PROFILER
+#include "bf0_hal.h"
+#include "lvgl.h"
+#include <stddef.h>
+#include <string.h>
+
+#define OVERLAY_UPDATE_MS       1000
+#define OVERLAY_BOTTOM_Y        LCD_PANEL_GRID_HEIGHT   /* 叠加显示贴在面板底边 */
+
+typedef struct {
+    uint32_t frame_us;
+    uint32_t render_us;
+    uint32_t handler_us;
+    uint32_t flush_us;
+    uint32_t dma_total_us;
+    uint32_t dma_us[FRAME_PROFILER_PANELS];
+    uint32_t bytes[FRAME_PROFILER_PANELS];
+} frame_record_t;
+
+static struct {
+    bool initialized;
+    uint32_t cycles_per_us;
+
+    frame_record_t records[FRAME_PROFILER_WINDOW];
+    uint16_t head;
+    uint16_t count;
+
+    /* 正在统计的帧，DMA字段在中断中累加 */
+    frame_record_t cur;
+    uint32_t refr_start;
+    uint32_t dma_in_refr_us;        /* 刷新结束前已完成的DMA耗时 */
+    bool cur_ready;
+    uint32_t flush_start;
+    uint32_t dma_start[FRAME_PROFILER_PANELS];
+    volatile uint32_t dma_inflight;  /* 按屏的位图 */
+
+    uint32_t handler_start;
+    uint64_t busy_us;
+    rt_tick_t reset_tick;
+
+    volatile bool overlay_req;
+    lv_obj_t *overlay;
+    rt_tick_t overlay_tick;
+} g_frame_prof = {0};
+
+/* DWT周期计数器，约18秒回绕一次，只用于计算差值 */
+static inline uint32_t now_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+static inline uint32_t elapsed_us(uint32_t start)
+{
+    return (now_cycles() - start) / g_frame_prof.cycles_per_us;
+}
+
+/* 把当前帧写入环形窗口，须在GUI线程中调用 */
+static void commit_frame(void)
+{
+    frame_record_t rec;
+    rt_base_t level = rt_hw_interrupt_disable();
+    rec = g_frame_prof.cur;
+    uint32_t dma_in_refr = g_frame_prof.dma_in_refr_us;
+    memset(&g_frame_prof.cur, 0, sizeof(g_frame_prof.cur));
+    g_frame_prof.dma_in_refr_us = 0;
+    g_frame_prof.cur_ready = false;
+    rt_hw_interrupt_enable(level);
+
+    for (int i = 0; i < FRAME_PROFILER_PANELS; i++) {
+        rec.dma_total_us += rec.dma_us[i];
+    }
+    rec.render_us = (rec.frame_us > dma_in_refr) ? rec.frame_us - dma_in_refr : 0;
+
+    rt_enter_critical();
+    g_frame_prof.records[g_frame_prof.head] = rec;
+    g_frame_prof.head = (g_frame_prof.head + 1) % FRAME_PROFILER_WINDOW;
+    if (g_frame_prof.count < FRAME_PROFILER_WINDOW) {
+        g_frame_prof.count++;
+    }
+    rt_exit_critical();
+}
+
+static void refr_event_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_REFR_START) {
+        /* 上一帧还没提交（DMA尾巴未结束）时直接提交，不与本帧混在一起 */
+        if (g_frame_prof.cur_ready) {
+            commit_frame();
+        }
+        g_frame_prof.refr_start = now_cycles();
+        return;
+    }
+
+    g_frame_prof.cur.frame_us = elapsed_us(g_frame_prof.refr_start);
+    rt_base_t level = rt_hw_interrupt_disable();
+    uint32_t done = 0;
+    for (int i = 0; i < FRAME_PROFILER_PANELS; i++) {
+        done += g_frame_prof.cur.dma_us[i];
+    }
+    g_frame_prof.dma_in_refr_us = done;
+    g_frame_prof.cur_ready = true;
+    rt_hw_interrupt_enable(level);
+}
+
+int frame_profiler_init(void)
+{
+    lv_display_t *disp = lv_display_get_default();
+    if (!disp) {
+        return -RT_ERROR;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    g_frame_prof.cycles_per_us = HAL_RCC_GetHCLKFreq(CORE_ID_DEFAULT) / 1000000;
+    if (g_frame_prof.cycles_per_us == 0) {
+        g_frame_prof.cycles_per_us = 1;
+    }
+
+    lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, refr_event_cb, LV_EVENT_REFR_READY, NULL);
+    g_frame_prof.reset_tick = rt_tick_get();
+    g_frame_prof.initialized = true;
+    return 0;
+}
+
+void frame_profiler_handler_begin(void)
+{
+    g_frame_prof.handler_start = now_cycles();
+}
+
+void frame_profiler_handler_end(void)
+{
+    if (!g_frame_prof.initialized) {
+        return;
+    }
+
+    uint32_t us = elapsed_us(g_frame_prof.handler_start);
+    g_frame_prof.busy_us += us;
+    if (g_frame_prof.cur_ready && g_frame_prof.cur.handler_us == 0) {
+        g_frame_prof.cur.handler_us = us;
+    }
+}
+
+void frame_profiler_flush_begin(void)
+{
+    g_frame_prof.flush_start = now_cycles();
+}
+
+void frame_profiler_flush_end(void)
+{
+    if (!g_frame_prof.initialized) {
+        return;
+    }
+
+    uint32_t us = elapsed_us(g_frame_prof.flush_start);
+    rt_base_t level = rt_hw_interrupt_disable();
+    g_frame_prof.cur.flush_us += us;
+    rt_hw_interrupt_enable(level);
+}
+
+void frame_profiler_dma_begin(int panel, uint32_t bytes)
+{
+    if (panel < 0 || panel >= FRAME_PROFILER_PANELS) {
+        return;
+    }
+    g_frame_prof.dma_start[panel] = now_cycles();
+    g_frame_prof.cur.bytes[panel] += bytes;
+    g_frame_prof.dma_inflight |= 1u << panel;
+}
+
+void frame_profiler_dma_end(int panel)
+{
+    if (panel < 0 || panel >= FRAME_PROFILER_PANELS || !g_frame_prof.initialized) {
+        return;
+    }
+    g_frame_prof.cur.dma_us[panel] += elapsed_us(g_frame_prof.dma_start[panel]);
+    g_frame_prof.dma_inflight &= ~(1u << panel);
+}
+
+/*********************
+ *  分位数
+ *********************/
+
+/* 取窗口内某一字段，调用者持有调度锁 */
+static int copy_column(size_t offset, uint32_t *out)
+{
+    for (int i = 0; i < g_frame_prof.count; i++) {
+        out[i] = *(const uint32_t *)((const uint8_t *)&g_frame_prof.records[i] + offset);
+    }
+    return g_frame_prof.count;
+}
+
+static void sort_values(uint32_t *v, int n)
+{
+    for (int i = 1; i < n; i++) {
+        uint32_t x = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > x) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+}
+
+/* 最近秩法 */
+static uint32_t rank(const uint32_t *sorted, int n, int pct)
+{
+    int idx = (pct * n + 99) / 100 - 1;
+    if (idx < 0) {
+        idx = 0;
+    }
+    return sorted[idx];
+}
+
+static void column_percentiles(size_t offset, frame_prof_pct_t *pct)
+{
+    uint32_t values[FRAME_PROFILER_WINDOW];
+
+    rt_enter_critical();
+    int n = copy_column(offset, values);
+    rt_exit_critical();
+
+    memset(pct, 0, sizeof(*pct));
+    if (n == 0) {
+        return;
+    }
+    sort_values(values, n);
+    pct->p50 = rank(values, n, 50);
+    pct->p90 = rank(values, n, 90);
+    pct->p99 = rank(values, n, 99);
+    pct->max = values[n - 1];
+}
+
+int frame_profiler_get_summary(frame_prof_summary_t *summary)
+{
+    if (!summary) {
+        return -RT_EINVAL;
+    }
+    if (!g_frame_prof.initialized) {
+        return -RT_ERROR;
+    }
+
+    memset(summary, 0, sizeof(*summary));
+    column_percentiles(offsetof(frame_record_t, frame_us), &summary->frame_us);
+    column_percentiles(offsetof(frame_record_t, render_us), &summary->render_us);
+    column_percentiles(offsetof(frame_record_t, handler_us), &summary->handler_us);
+    column_percentiles(offsetof(frame_record_t, flush_us), &summary->flush_us);
+    column_percentiles(offsetof(frame_record_t, dma_total_us), &summary->dma_us);
+    for (int p = 0; p < FRAME_PROFILER_PANELS; p++) {
+        column_percentiles(offsetof(frame_record_t, dma_us) + p * sizeof(uint32_t),
+                           &summary->panel_dma_us[p]);
+    }
+
+    uint64_t bytes[FRAME_PROFILER_PANELS] = {0};
+    uint64_t dma_us[FRAME_PROFILER_PANELS] = {0};
+
+    rt_enter_critical();
+    summary->frames = g_frame_prof.count;
+    for (int i = 0; i < g_frame_prof.count; i++) {
+        const frame_record_t *rec = &g_frame_prof.records[i];
+        if (rec->render_us >= rec->dma_total_us) {
+            summary->cpu_bound++;
+        }
+        for (int p = 0; p < FRAME_PROFILER_PANELS; p++) {
+            bytes[p] += rec->bytes[p];
+            dma_us[p] += rec->dma_us[p];
+        }
+    }
+    uint64_t busy_us = g_frame_prof.busy_us;
+    rt_tick_t elapsed = rt_tick_get() - g_frame_prof.reset_tick;
+    rt_exit_critical();
+
+    for (int p = 0; p < FRAME_PROFILER_PANELS; p++) {
+        if (summary->frames) {
+            summary->panel_bytes_avg[p] = (uint32_t)(bytes[p] / summary->frames);
+        }
+        if (dma_us[p]) {
+            /* 字节/微秒 * 1000000 / 1024 */
+            summary->panel_kbps[p] = (uint32_t)(bytes[p] * 1000000 / 1024 / dma_us[p]);
+        }
+    }
+
+    uint64_t elapsed_us_total = (uint64_t)elapsed * 1000000 / RT_TICK_PER_SECOND;
+    if (elapsed_us_total) {
+        summary->load_pct = (uint32_t)(busy_us * 100 / elapsed_us_total);
+    }
+    return 0;
+}
+
+void frame_profiler_reset(void)
+{
+    rt_enter_critical();
+    g_frame_prof.head = 0;
+    g_frame_prof.count = 0;
+    g_frame_prof.busy_us = 0;
+    g_frame_prof.reset_tick = rt_tick_get();
+    rt_exit_critical();
+}
+
+/*********************
+ *  叠加显示
+ *********************/
+
+void frame_profiler_set_overlay(bool enable)
+{
+    g_frame_prof.overlay_req = enable;
+}
+
+static void overlay_update(void)
+{
+    frame_prof_summary_t s;
+
+    if (frame_profiler_get_summary(&s) != 0) {
+        return;
+    }
+
+    lv_label_set_text_fmt(g_frame_prof.overlay,
+                          "frm %lu/%lu us\ncpu %lu spi %lu us\nload %lu%% cpu-bound %u/%u",
+                          (unsigned long)s.frame_us.p50, (unsigned long)s.frame_us.p90,
+                          (unsigned long)s.render_us.p50, (unsigned long)s.dma_us.p50,
+                          (unsigned long)s.load_pct, s.cpu_bound, s.frames);
+    lv_obj_update_layout(g_frame_prof.overlay);
+    lv_obj_set_y(g_frame_prof.overlay, OVERLAY_BOTTOM_Y - lv_obj_get_height(g_frame_prof.overlay));
+}
+
+/* 叠加显示每秒自身也会引起一次局部刷新，测量时注意扣除 */
+static void overlay_process(void)
+{
+    if (g_frame_prof.overlay_req && !g_frame_prof.overlay) {
+        g_frame_prof.overlay = lv_label_create(lv_layer_top());
+        if (!g_frame_prof.overlay) {
+            g_frame_prof.overlay_req = false;
+            return;
+        }
+        lv_obj_set_style_bg_color(g_frame_prof.overlay, lv_color_black(), 0);
+        lv_obj_set_style_bg_opa(g_frame_prof.overlay, LV_OPA_70, 0);
+        lv_obj_set_style_text_color(g_frame_prof.overlay, lv_color_make(0x00, 0xFF, 0x00), 0);
+        lv_obj_set_pos(g_frame_prof.overlay, 0, 0);
+        g_frame_prof.overlay_tick = rt_tick_get();
+        overlay_update();
+        return;
+    }
+
+    if (!g_frame_prof.overlay_req && g_frame_prof.overlay) {
+        lv_obj_del(g_frame_prof.overlay);
+        g_frame_prof.overlay = NULL;
+        return;
+    }
+
+    if (g_frame_prof.overlay &&
+        rt_tick_get() - g_frame_prof.overlay_tick >= rt_tick_from_millisecond(OVERLAY_UPDATE_MS)) {
+        g_frame_prof.overlay_tick = rt_tick_get();
+        overlay_update();
+    }
+}
+
+void frame_profiler_process(void)
+{
+    if (!g_frame_prof.initialized) {
+        return;
+    }
+
+    if (g_frame_prof.cur_ready && g_frame_prof.dma_inflight == 0) {
+        commit_frame();
+    }
+    overlay_process();
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void print_pct(const char *name, const frame_prof_pct_t *p)
+{
+    rt_kprintf("%-8s %7u %7u %7u %7u\n", name, p->p50, p->p90, p->p99, p->max);
+}
+
+static void frame_prof(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        frame_profiler_reset();
+        rt_kprintf("frame profiler reset\n");
+        return;
+    }
+    if (argc > 2 && strcmp(argv[1], "overlay") == 0) {
+        frame_profiler_set_overlay(strcmp(argv[2], "on") == 0);
+        return;
+    }
+
+    frame_prof_summary_t s;
+    if (frame_profiler_get_summary(&s) != 0) {
+        rt_kprintf("frame profiler not initialized\n");
+        return;
+    }
+
+    rt_kprintf("frames %u (cpu-bound %u, spi-bound %u), gui load %u%%\n",
+               s.frames, s.cpu_bound, s.frames - s.cpu_bound, s.load_pct);
+    rt_kprintf("%-8s %7s %7s %7s %7s\n", "us", "p50", "p90", "p99", "max");
+    print_pct("frame", &s.frame_us);
+    print_pct("render", &s.render_us);
+    print_pct("handler", &s.handler_us);
+    print_pct("flush", &s.flush_us);
+    print_pct("dma", &s.dma_us);
+    for (int p = 0; p < FRAME_PROFILER_PANELS; p++) {
+        char name[8];
+        rt_snprintf(name, sizeof(name), "dma%d", p);
+        print_pct(name, &s.panel_dma_us[p]);
+    }
+
+    rt_kprintf("%-8s %9s %7s\n", "panel", "bytes/fr", "KB/s");
+    for (int p = 0; p < FRAME_PROFILER_PANELS; p++) {
+        rt_kprintf("%-8d %9u %7u\n", p, s.panel_bytes_avg[p], s.panel_kbps[p]);
+    }
+}
+MSH_CMD_EXPORT(frame_prof, GUI frame timing: frame_prof [reset | overlay on|off]);
+#endif /* RT_USING_FINSH */
+
+#endif /* FRAME_PROFILER */
@@ -0,0 +1,99 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+/**
+ * @file frame_profiler.h
+ * @brief GUI帧耗时统计
+ *
+ * 记录每帧LVGL刷新耗时、lv_timer_handler耗时、刷屏路径的CPU耗时，以及各块
+ * 屏各自的DMA耗时和发送字节数，保留最近FRAME_PROFILER_WINDOW帧，按需计算
+ * 分位数。渲染耗时按“刷新耗时减去DMA耗时”估算（部分刷新时CPU等待刷屏完成
+ * 才绘制下一块），据此区分CPU瓶颈和SPI瓶颈的帧。
+ *
+ * 通过finsh命令frame_prof查看，也可打开屏上的叠加显示。DMA钩子可在中断中调用。
+ */
+
+#include <rtthread.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "panel_grid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRAME_PROFILER_PANELS       LCD_PANEL_NUM
+
+#ifndef FRAME_PROFILER_WINDOW
+#define FRAME_PROFILER_WINDOW       64
+#endif
+
+typedef struct {
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+} frame_prof_pct_t;
+
+typedef struct {
+    uint16_t frames;                        /* 窗口内帧数 */
+    uint16_t cpu_bound;                     /* 渲染耗时不小于DMA耗时的帧数 */
+    uint32_t load_pct;                      /* 自上次复位以来GUI处理占用时间比例 */
+    frame_prof_pct_t frame_us;              /* 一次LVGL刷新的总耗时 */
+    frame_prof_pct_t render_us;             /* 估算的渲染耗时 */
+    frame_prof_pct_t handler_us;            /* 包含该帧的lv_timer_handler/lv_refr_now耗时 */
+    frame_prof_pct_t flush_us;              /* 刷屏函数本身的CPU耗时 */
+    frame_prof_pct_t dma_us;                /* 三块屏DMA耗时之和 */
+    frame_prof_pct_t panel_dma_us[FRAME_PROFILER_PANELS];
+    uint32_t panel_bytes_avg[FRAME_PROFILER_PANELS];
+    uint32_t panel_kbps[FRAME_PROFILER_PANELS];  /* DMA期间的有效速率，KB/s */
+} frame_prof_summary_t;
+
+#ifdef FRAME_PROFILER
+
+/**
+ * @brief 挂到默认显示的刷新事件上，须在LVGL显示初始化之后调用
+ */
+int frame_profiler_init(void);
+
+/* 主循环中包住lv_timer_handler()和lv_refr_now() */
+void frame_profiler_handler_begin(void);
+void frame_profiler_handler_end(void);
+
+/**
+ * @brief 在GUI线程中轮询：提交已完成的帧、处理叠加显示的开关和刷新
+ */
+void frame_profiler_process(void);
+
+/* LCD驱动钩子，panel为屏序号，bytes为本次发送到该屏的字节数 */
+void frame_profiler_flush_begin(void);
+void frame_profiler_flush_end(void);
+void frame_profiler_dma_begin(int panel, uint32_t bytes);
+void frame_profiler_dma_end(int panel);
+
+int frame_profiler_get_summary(frame_prof_summary_t *summary);
+void frame_profiler_reset(void);
+
+/**
+ * @brief 请求打开或关闭叠加显示，任意线程可调用，在下一次process时生效
+ */
+void frame_profiler_set_overlay(bool enable);
+
+#else
+
+#define frame_profiler_init()
+#define frame_profiler_handler_begin()
+#define frame_profiler_handler_end()
+#define frame_profiler_process()
+#define frame_profiler_flush_begin()
+#define frame_profiler_flush_end()
+#define frame_profiler_dma_begin(panel, bytes)
+#define frame_profiler_dma_end(panel)
+
+#endif /* FRAME_PROFILER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAME_PROFILER_H */
@@ -0,0 +1,269 @@
+#include "image_cache.h"
+#include <string.h>
+
+typedef struct {
+    const lv_image_dsc_t *src;  /* 原压缩图片，作为查找键 */
+    lv_image_dsc_t dsc;         /* 指向解码结果的图片描述 */
+    lv_draw_buf_t *buf;
+    uint32_t bytes;
+    uint32_t last_used;
+    uint16_t refcnt;            /* 引用该条目的图片对象数 */
+    bool pinned;
+    bool used;
+} image_cache_entry_t;
+
+static struct {
+    image_cache_entry_t entries[IMAGE_CACHE_MAX_ENTRIES];
+    image_cache_stats_t stats;
+    uint32_t use_seq;
+    bool initialized;
+} g_img_cache = {0};
+
+static image_cache_entry_t *find_by_src(const void *src)
+{
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        image_cache_entry_t *e = &g_img_cache.entries[i];
+        if (e->used && e->src == src) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static image_cache_entry_t *find_by_decoded(const void *dsc)
+{
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        image_cache_entry_t *e = &g_img_cache.entries[i];
+        if (e->used && dsc == &e->dsc) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void free_entry(image_cache_entry_t *e)
+{
+    if (e->buf) {
+        lv_draw_buf_destroy(e->buf);
+    }
+    g_img_cache.stats.bytes_used -= e->bytes;
+    g_img_cache.stats.entries--;
+    if (e->pinned) {
+        g_img_cache.stats.pinned--;
+    }
+    memset(e, 0, sizeof(*e));
+}
+
+/* 释放最久未使用的空闲条目，直到容得下need字节 */
+static bool make_room(uint32_t need)
+{
+    const uint32_t budget = IMAGE_CACHE_BUDGET_KB * 1024u;
+
+    while (g_img_cache.stats.bytes_used + need > budget) {
+        image_cache_entry_t *victim = NULL;
+        for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+            image_cache_entry_t *e = &g_img_cache.entries[i];
+            if (!e->used || e->refcnt > 0 || e->pinned) {
+                continue;
+            }
+            if (!victim || (int32_t)(e->last_used - victim->last_used) < 0) {
+                victim = e;
+            }
+        }
+        if (!victim) {
+            return false;
+        }
+        free_entry(victim);
+        g_img_cache.stats.evictions++;
+    }
+    return true;
+}
+
+static image_cache_entry_t *alloc_slot(void)
+{
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        if (!g_img_cache.entries[i].used) {
+            return &g_img_cache.entries[i];
+        }
+    }
+
+    /* 槽位用完时复用最久未使用的空闲条目 */
+    image_cache_entry_t *victim = NULL;
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        image_cache_entry_t *e = &g_img_cache.entries[i];
+        if (e->refcnt == 0 && !e->pinned &&
+            (!victim || (int32_t)(e->last_used - victim->last_used) < 0)) {
+            victim = e;
+        }
+    }
+    if (victim) {
+        free_entry(victim);
+        g_img_cache.stats.evictions++;
+    }
+    return victim;
+}
+
+/* 查找或解码，返回NULL表示无法缓存（调用方直接使用原图） */
+static image_cache_entry_t *lookup(const lv_image_dsc_t *src)
+{
+    image_cache_entry_t *e = find_by_src(src);
+    if (e) {
+        g_img_cache.stats.hits++;
+        e->last_used = ++g_img_cache.use_seq;
+        return e;
+    }
+
+    g_img_cache.stats.misses++;
+
+    lv_image_decoder_dsc_t dec;
+    if (lv_image_decoder_open(&dec, src, NULL) != LV_RESULT_OK) {
+        g_img_cache.stats.bypasses++;
+        return NULL;
+    }
+
+    lv_draw_buf_t *buf = NULL;
+    if (dec.decoded && make_room(dec.decoded->data_size)) {
+        buf = lv_draw_buf_dup(dec.decoded);
+    }
+    lv_image_decoder_close(&dec);
+
+    e = buf ? alloc_slot() : NULL;
+    if (!e) {
+        if (buf) {
+            lv_draw_buf_destroy(buf);
+        }
+        g_img_cache.stats.bypasses++;
+        return NULL;
+    }
+
+    e->src = src;
+    e->buf = buf;
+    e->bytes = buf->data_size;
+    e->dsc.header = buf->header;
+    e->dsc.data_size = buf->data_size;
+    e->dsc.data = buf->data;
+    e->last_used = ++g_img_cache.use_seq;
+    e->used = true;
+
+    g_img_cache.stats.bytes_used += e->bytes;
+    g_img_cache.stats.entries++;
+    return e;
+}
+
+static void image_delete_cb(lv_event_t *event)
+{
+    image_cache_entry_t *e = lv_event_get_user_data(event);
+    if (e && e->refcnt > 0) {
+        e->refcnt--;
+    }
+}
+
+int image_cache_init(void)
+{
+    if (g_img_cache.initialized) {
+        return 0;
+    }
+
+    memset(&g_img_cache, 0, sizeof(g_img_cache));
+    g_img_cache.initialized = true;
+    return 0;
+}
+
+void image_cache_deinit(void)
+{
+    if (!g_img_cache.initialized) {
+        return;
+    }
+
+    for (int i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        if (g_img_cache.entries[i].used) {
+            free_entry(&g_img_cache.entries[i]);
+        }
+    }
+    g_img_cache.initialized = false;
+}
+
+void image_cache_set_src(lv_obj_t *img, const lv_image_dsc_t *src)
+{
+    if (!img || !src) {
+        return;
+    }
+    if (!g_img_cache.initialized) {
+        lv_image_set_src(img, src);
+        return;
+    }
+
+    image_cache_entry_t *old = find_by_decoded(lv_image_get_src(img));
+
+    /* 先引用新条目再释放旧条目，重复设置同一图片时不会被淘汰 */
+    image_cache_entry_t *e = lookup(src);
+    if (e) {
+        e->refcnt++;
+    }
+
+    lv_image_set_src(img, e ? (const void *)&e->dsc : (const void *)src);
+
+    if (old) {
+        lv_obj_remove_event_cb_with_user_data(img, image_delete_cb, old);
+        if (old->refcnt > 0) {
+            old->refcnt--;
+        }
+    }
+    if (e) {
+        lv_obj_add_event_cb(img, image_delete_cb, LV_EVENT_DELETE, e);
+    }
+}
+
+int image_cache_pin(const lv_image_dsc_t *src, bool pinned)
+{
+    if (!g_img_cache.initialized || !src) {
+        return -RT_EINVAL;
+    }
+
+    image_cache_entry_t *e = pinned ? lookup(src) : find_by_src(src);
+    if (!e) {
+        return pinned ? -RT_ENOMEM : 0;
+    }
+
+    if (e->pinned != pinned) {
+        e->pinned = pinned;
+        if (pinned) {
+            g_img_cache.stats.pinned++;
+        } else {
+            g_img_cache.stats.pinned--;
+        }
+    }
+    return 0;
+}
+
+int image_cache_get_stats(image_cache_stats_t *stats)
+{
+    if (!stats) {
+        return -RT_EINVAL;
+    }
+
+    /* 统计在GUI线程更新，shell读取时整体拷贝 */
+    rt_enter_critical();
+    *stats = g_img_cache.stats;
+    rt_exit_critical();
+    return 0;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void img_cache(int argc, char **argv)
+{
+    image_cache_stats_t s;
+    image_cache_get_stats(&s);
+
+    uint32_t total = s.hits + s.misses;
+    uint32_t hit_pct = total ? (uint32_t)((uint64_t)s.hits * 100 / total) : 0;
+    rt_kprintf("hits %u, misses %u (%u%% hit), evictions %u, bypasses %u\n",
+               s.hits, s.misses, hit_pct, s.evictions, s.bypasses);
+    rt_kprintf("bytes %u / %u, entries %u / %u, pinned %u\n",
+               s.bytes_used, IMAGE_CACHE_BUDGET_KB * 1024u,
+               s.entries, IMAGE_CACHE_MAX_ENTRIES, s.pinned);
+}
+MSH_CMD_EXPORT(img_cache, decoded image cache stats);
+#endif /* RT_USING_FINSH */
@@ -0,0 +1,63 @@
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+/**
+ * @file image_cache.h
+ * @brief EZIP图片解码缓存
+ *
+ * 压缩图片首次显示时解码到RAM，之后图片对象直接引用解码结果，重绘只是普通的
+ * 拷贝。被图片对象引用或被固定的条目不会淘汰；超出预算时按LRU释放空闲条目，
+ * 仍放不下时退回使用原压缩图片。只能在GUI线程中调用。
+ */
+
+#include <rtthread.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef IMAGE_CACHE_BUDGET_KB
+#define IMAGE_CACHE_BUDGET_KB   256     /* 解码结果占用的RAM预算 */
+#endif
+
+#define IMAGE_CACHE_MAX_ENTRIES 48
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;            /* 需要解码的次数 */
+    uint32_t evictions;
+    uint32_t bypasses;          /* 预算不足、直接使用压缩图片的次数 */
+    uint32_t bytes_used;
+    uint16_t entries;
+    uint16_t pinned;
+} image_cache_stats_t;
+
+int image_cache_init(void);
+
+/**
+ * @brief 释放全部条目，调用前应已删除引用缓存的图片对象
+ */
+void image_cache_deinit(void);
+
+/**
+ * @brief 为图片对象设置图片源，经过缓存
+ * @note 对象删除或换图时自动释放对旧条目的引用
+ */
+void image_cache_set_src(lv_obj_t *img, const lv_image_dsc_t *src);
+
+/**
+ * @brief 固定/取消固定图片，固定的图片预先解码且不参与淘汰
+ * @return 0成功，-RT_ENOMEM解码失败或预算不足
+ */
+int image_cache_pin(const lv_image_dsc_t *src, bool pinned);
+
+int image_cache_get_stats(image_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IMAGE_CACHE_H */
@@ -6,6 +6,7 @@
 #include <string.h>
 #include "led_compat.h"
 #include "led_effects_manager.h"
+#include "display_idle.h"
 #define MAX_CONTEXT_STACK_DEPTH 4
 #define KEY_THREAD_STACK_SIZE   4096
 #define KEY_THREAD_PRIORITY     10
@@ -117,6 +118,9 @@ static void key_process_message(const key_message_t *msg)
                 int key_idx = msg->data.button_event.key_idx;
                 button_action_t action = msg->data.button_event.action;
                 
+                // 按键同时唤醒熄屏的面板，但仍照常处理（HID快捷键不能丢）
+                display_idle_note_input();
+                
                 // 处理按键事件
                 if (g_key_mgr.current_ctx != KEY_CTX_NONE && 
                     g_key_mgr.current_ctx < KEY_CTX_MAX) {
@@ -1,105 +1,125 @@
 // led_effects_manager.c - 完整重新设计版本（修复编译错误）
 
 #include "led_effects_manager.h"
+#include "led_engine.h"
 #include "drv_rgbled.h"
 #include "event_bus.h"
 #include "bf0_hal.h"
+#include "led_math.h"
+#include "led_timeline.h"
 #include <string.h>
-#include <math.h>
+#include <stdlib.h>
 
-#define MAX_CONCURRENT_EFFECTS  4
 #define MAX_CUSTOM_EFFECTS      8
-#define LED_UPDATE_INTERVAL_MS  20
 #define LED_THREAD_STACK_SIZE   2048
 #define LED_THREAD_PRIORITY     12
 
-/* LED更新消息类型 */
+/* 命令环：每个调用线程第一次调用API时认领一个，之后只有它写入，LED线程读取 */
+#ifndef LED_CMD_RINGS
+#define LED_CMD_RINGS           6
+#endif
+#define LED_CMD_RING_SIZE       16      // 2的幂
+#define LED_CMD_SHARED_RING     LED_CMD_RINGS   // 中断上下文和没认领到环的线程共用，关中断写入
+
+/* 效果句柄表：调用方直接分配，效果结束后由LED线程归还 */
+#define LED_HANDLE_SLOTS        (LED_EFFECT_POOL_SIZE * 2)
+#define LED_HANDLE_GEN_MASK     0xFFFFFFu
+
+/* LED线程唤醒原因 */
+#define LED_WAKE_CMD            0x01    // 命令环有新命令
+#define LED_WAKE_TICK           0x02    // 定时器到期，渲染下一帧
+#define LED_WAKE_ALL            (LED_WAKE_CMD | LED_WAKE_TICK)
+
+#if LED_HANDLE_SLOTS > 255
+#error "LED handle index must fit in 8 bits"
+#endif
+
+/* LED命令类型 */
 typedef enum {
-    LED_MSG_UPDATE_TICK,        // 定时更新
-    LED_MSG_SET_LED,           // 设置单个LED
-    LED_MSG_SET_ALL_LEDS,      // 设置所有LED
-    LED_MSG_START_EFFECT,      // 启动效果
-    LED_MSG_STOP_EFFECT,       // 停止效果
-    LED_MSG_SET_BRIGHTNESS,    // 设置亮度
-    LED_MSG_LED_FEEDBACK,      // LED反馈闪烁
-    LED_MSG_SHUTDOWN           // 关闭管理器
-} led_msg_type_t;
-
-/* LED消息结构体 */
+    LED_CMD_SET_LED = 0,        // 设置单个LED
+    LED_CMD_SET_ALL_LEDS,       // 设置所有LED
+    LED_CMD_START_EFFECT,       // 启动效果，参数在句柄槽中
+    LED_CMD_STOP_EFFECT,        // 停止效果
+    LED_CMD_STOP_ALL,           // 停止所有效果（按键反馈除外）
+    LED_CMD_SET_BRIGHTNESS,     // 设置亮度
+    LED_CMD_LED_FEEDBACK        // LED反馈闪烁
+} led_cmd_type_t;
+
+/* LED命令，定长12字节 */
 typedef struct {
-    led_msg_type_t type;
-    union {
-        struct {
-            uint8_t led_index;
-            uint32_t color;
-        } set_led;
-        struct {
-            uint32_t color;
-        } set_all;
-        struct {
-            led_effect_config_t config;
-            int *effect_id_out;  // 用于返回效果ID
-            rt_sem_t done_sem;   // 用于同步（直接使用信号量）
-        } start_effect;
-        struct {
-            int effect_id;
-        } stop_effect;
-        struct {
-            uint8_t brightness;
-        } set_brightness;
-        struct {
-            int led_index;
-            uint32_t color;
-            uint32_t duration_ms;
-        } led_feedback;
-    } data;
-} led_message_t;
-
-/* 内部效果句柄结构体 */
-typedef struct led_effect_handle {
-    led_effect_config_t config;
-    led_effect_state_t state;
-    uint32_t start_tick;
-    uint32_t last_update_tick;
-    uint32_t effect_tick;
-    bool active;
-    int id;
-} led_effect_handle_internal_t;
-
-/* LED效果管理器全局状态 */
+    uint8_t type;
+    uint8_t led_index;
+    uint32_t arg;               // 颜色、亮度或句柄
+    uint32_t duration_ms;
+} led_cmd_t;
+
+/* 单生产者单消费者命令环，head只由生产者写，tail只由LED线程写 */
+typedef struct {
+    rt_thread_t owner;
+    uint16_t head;
+    uint16_t tail;
+    led_cmd_t cmd[LED_CMD_RING_SIZE];
+} led_cmd_ring_t;
+
+/* 句柄槽。tag为代数<<1|占用位，句柄为代数<<8|槽号，停止或结束后代数加一，
+ * 旧句柄随之失效，不会误停同一槽里后来启动的效果 */
+typedef struct {
+    uint32_t tag;
+    int engine_id;              // LED线程写入，-1表示未启动或已归还
+    led_effect_config_t config; // 调用方在发布启动命令前写入
+} led_handle_slot_t;
+
+/* LED效果管理器全局状态：效果引擎加上硬件输出和线程 */
 static struct {
     rt_device_t rgb_device;
-    led_effect_handle_internal_t effects[MAX_CONCURRENT_EFFECTS];
-    uint32_t *led_buffer;
-    uint32_t *manual_led_buffer;
-    bool *manual_led_mask;
+    led_engine_t engine;
     uint32_t actual_led_count;
-    uint8_t global_brightness;
+
+    // 输出帧：back为本次渲染的帧，front为上次写入硬件的帧
+    uint32_t out_frame[2][LED_MAX_COUNT];
+    uint8_t out_front;
+    bool out_valid;                     // front是否与硬件一致
+    uint32_t hw_writes;
+    uint32_t hw_skips;
+    
+    // 引擎的毫秒时钟，由节拍差累加
+    rt_tick_t clock_tick;
+    uint32_t clock_ms;
+    
+    // 命令环和句柄表
+    led_cmd_ring_t rings[LED_CMD_RINGS + 1];
+    led_handle_slot_t handles[LED_HANDLE_SLOTS];
+    uint32_t cmd_count;
+    uint32_t cmd_batches;
+    uint32_t cmd_max_batch;
+    uint32_t cmd_dropped;               // 环满丢弃的命令数，生产者原子累加
     
     // 线程和通信
     rt_thread_t led_thread;
-    rt_mq_t led_msg_queue;
-    rt_timer_t update_timer;
+    rt_event_t wake_event;
+    rt_timer_t update_timer;            // 单次定时器，只在下一次输出变化时触发
+    bool timer_armed;
+    rt_tick_t timer_deadline;
+    uint32_t frames;
     rt_sem_t shutdown_sem;
     
-    int next_effect_id;
     bool initialized;
-    bool running;
+    volatile bool running;
 } g_led_mgr = {0};
 
 /* 完整的前向声明 - 确保所有函数都在使用前声明 */
 static void led_update_timer_callback(void *parameter);
 static void led_effects_thread_entry(void *parameter);
-static int led_send_message(const led_message_t *msg, bool sync);
-static void led_process_message(const led_message_t *msg);
-static void led_do_update_effects(void);
+static int led_cmd_push(const led_cmd_t *cmd);
+static bool led_cmd_drain(void);
+static bool led_cmd_apply(const led_cmd_t *cmd);
+static void led_handles_reclaim(void);
 static void led_do_update_hardware(void);
+static void led_render_frame(void);
+static void led_schedule_next_frame(void);
+static uint32_t led_now_ms(void);
 static int led_effects_hardware_init(void);
 static void led_effects_configure_pins(void);
-static int apply_effect_static(const led_effect_handle_internal_t *effect, uint32_t *buffer);
-static int apply_effect_breathing(const led_effect_handle_internal_t *effect, uint32_t *buffer);
-static int apply_effect_flowing(const led_effect_handle_internal_t *effect, uint32_t *buffer);
-static int apply_effect_blink(const led_effect_handle_internal_t *effect, uint32_t *buffer);
 static int led_feedback_event_handler(const event_t *event, void *user_data);
 
 /* 硬件初始化函数实现 */
@@ -125,17 +145,7 @@ static int led_feedback_event_handler(const event_t *event, void *user_data)
     }
     
     const event_data_led_t *led_data = &event->data.led;
-    
-    led_message_t msg = {
-        .type = LED_MSG_LED_FEEDBACK,
-        .data.led_feedback = {
-            .led_index = led_data->led_index,
-            .color = led_data->color,
-            .duration_ms = led_data->duration_ms
-        }
-    };
-    
-    return led_send_message(&msg, false);
+    return led_effects_feedback(led_data->led_index, led_data->color, led_data->duration_ms);
 }
 
 
@@ -145,294 +155,333 @@ static void led_effects_configure_pins(void)
     HAL_PIN_Set(PAD_PA10, GPTIM2_CH1, PIN_NOPULL, 1);
 }
 
-/* 定时器回调 - 只在中断上下文中发送消息 */
+/* 定时器回调 - 只唤醒LED线程 */
 static void led_update_timer_callback(void *parameter)
 {
     (void)parameter;
-    
-    // 在中断上下文中只发送非阻塞消息
-    led_message_t msg = {.type = LED_MSG_UPDATE_TICK};
-    rt_mq_send(g_led_mgr.led_msg_queue, &msg, sizeof(msg));
+    rt_event_send(g_led_mgr.wake_event, LED_WAKE_TICK);
 }
 
-/* LED效果处理线程 */
+/* LED效果处理线程：每次唤醒把所有环里的命令成批处理完，再渲染一帧 */
 static void led_effects_thread_entry(void *parameter)
 {
     (void)parameter;
-    led_message_t msg;
-    rt_err_t result;
+    rt_uint32_t reason;
     
     while (g_led_mgr.running) {
-        // 等待消息，超时时间为100ms
-        result = rt_mq_recv(g_led_mgr.led_msg_queue, &msg, sizeof(msg), 100);
-        
-        if (result == RT_EOK) {
-            led_process_message(&msg);
-        } else if (result == -RT_ETIMEOUT) {
-            // 超时是正常的，继续循环
-            continue;
-        } else {
+        // 没有效果在变化时不布置定时器，线程一直睡到有新命令
+        reason = 0;
+        if (rt_event_recv(g_led_mgr.wake_event, LED_WAKE_ALL, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                          RT_WAITING_FOREVER, &reason) != RT_EOK) {
             rt_thread_mdelay(10);
+            continue;
         }
+        if (!g_led_mgr.running) {
+            break;
+        }
+        
+        bool dirty = led_cmd_drain();
+        if (reason & LED_WAKE_TICK) {
+            g_led_mgr.timer_armed = false;
+            dirty = true;
+        }
+        if (dirty) {
+            led_render_frame();
+        }
+        led_handles_reclaim();
+        led_schedule_next_frame();
     }
     rt_sem_release(g_led_mgr.shutdown_sem);
 }
 
-/* 处理LED消息 */
-static void led_process_message(const led_message_t *msg)
+/* 句柄编解码 */
+static inline led_effect_handle_t led_handle_make(uint32_t index, uint32_t tag)
 {
-    switch (msg->type) {
-        case LED_MSG_UPDATE_TICK:
-            led_do_update_effects();
-            led_do_update_hardware();
-            break;
-            
-        case LED_MSG_SET_LED:
-            if (msg->data.set_led.led_index < g_led_mgr.actual_led_count) {
-                g_led_mgr.manual_led_buffer[msg->data.set_led.led_index] = msg->data.set_led.color;
-                g_led_mgr.manual_led_mask[msg->data.set_led.led_index] = true;
-                led_do_update_hardware();
-            }
-            break;
-            
-        case LED_MSG_SET_ALL_LEDS:
-            for (uint32_t i = 0; i < g_led_mgr.actual_led_count; i++) {
-                g_led_mgr.manual_led_buffer[i] = msg->data.set_all.color;
-                g_led_mgr.manual_led_mask[i] = true;
-            }
-            led_do_update_hardware();
-            break;
-            
-        case LED_MSG_START_EFFECT:
-            {
-                // 查找空闲的效果槽
-                int slot = -1;
-                for (int i = 0; i < MAX_CONCURRENT_EFFECTS; i++) {
-                    if (!g_led_mgr.effects[i].active) {
-                        slot = i;
-                        break;
-                    }
-                }
-                
-                int effect_id = -1;
-                if (slot >= 0) {
-                    led_effect_handle_internal_t *effect = &g_led_mgr.effects[slot];
-                    effect->config = msg->data.start_effect.config;
-                    effect->state = LED_EFFECT_STATE_RUNNING;
-                    effect->start_tick = rt_tick_get();
-                    effect->last_update_tick = effect->start_tick;
-                    effect->effect_tick = 0;
-                    effect->active = true;
-                    effect->id = g_led_mgr.next_effect_id++;
-                    effect_id = effect->id;
-                    
-                    // 参数检查和修正
-                    if (effect->config.led_start >= g_led_mgr.actual_led_count) {
-                        effect->config.led_start = 0;
-                    }
-                    if (effect->config.led_start + effect->config.led_count > g_led_mgr.actual_led_count) {
-                        effect->config.led_count = g_led_mgr.actual_led_count - effect->config.led_start;
-                    }
-                    if (effect->config.led_count == 0) {
-                        effect->config.led_count = g_led_mgr.actual_led_count;
-                    }
-                }
-                
-                // 返回效果ID
-                if (msg->data.start_effect.effect_id_out) {
-                    *msg->data.start_effect.effect_id_out = effect_id;
-                }
-                
-                // 发送完成信号
-                if (msg->data.start_effect.done_sem) {
-                    rt_sem_release(msg->data.start_effect.done_sem);
-                }
-            }
-            break;
-            
-        case LED_MSG_STOP_EFFECT:
-            for (int i = 0; i < MAX_CONCURRENT_EFFECTS; i++) {
-                if (g_led_mgr.effects[i].active && 
-                    g_led_mgr.effects[i].id == msg->data.stop_effect.effect_id) {
-                    g_led_mgr.effects[i].state = LED_EFFECT_STATE_STOPPED;
-                    g_led_mgr.effects[i].active = false;
-                    break;
-                }
-            }
-            break;
-            
-        case LED_MSG_SET_BRIGHTNESS:
-            g_led_mgr.global_brightness = msg->data.set_brightness.brightness;
-            led_do_update_hardware();
-            break;
-            
-        case LED_MSG_LED_FEEDBACK:
-            {
-                int led_index = msg->data.led_feedback.led_index;
-                uint32_t color = msg->data.led_feedback.color;
-                uint32_t duration_ms = msg->data.led_feedback.duration_ms;
-                
-                if (led_index >= 0 && led_index < (int)g_led_mgr.actual_led_count) {
-                    g_led_mgr.manual_led_mask[led_index] = false;
-                    for (int i = 0; i < MAX_CONCURRENT_EFFECTS; i++) {
-                        if (!g_led_mgr.effects[i].active) {
-                            led_effect_handle_internal_t *effect = &g_led_mgr.effects[i];
-                            effect->config.type = LED_EFFECT_STATIC;
-                            effect->config.duration_ms = duration_ms;
-                            effect->config.period_ms = 100;
-                            effect->config.brightness = 255;
-                            effect->config.colors[0] = color;
-                            effect->config.color_count = 1;
-                            effect->config.led_start = led_index;
-                            effect->config.led_count = 1;
-                            
-                            effect->state = LED_EFFECT_STATE_RUNNING;
-                            effect->start_tick = rt_tick_get();
-                            effect->last_update_tick = effect->start_tick;
-                            effect->effect_tick = 0;
-                            effect->active = true;
-                            effect->id = g_led_mgr.next_effect_id++;
-                            break;
-                        }
-                    }
-                }
-            }
-            break;
-                    
-                case LED_MSG_SHUTDOWN:
-                    g_led_mgr.running = false;
-                    break;
-                    
-                default:
-                    break;
-            }
+    return (led_effect_handle_t)(uintptr_t)((((tag >> 1) & LED_HANDLE_GEN_MASK) << 8) | index);
+}
+
+/* 句柄仍指向占用中的同代槽位时返回该槽 */
+static led_handle_slot_t *led_handle_lookup(uint32_t handle)
+{
+    uint32_t index = handle & 0xFF;
+    
+    if (index >= LED_HANDLE_SLOTS) {
+        return RT_NULL;
+    }
+    led_handle_slot_t *slot = &g_led_mgr.handles[index];
+    uint32_t tag = __atomic_load_n(&slot->tag, __ATOMIC_ACQUIRE);
+    if (!(tag & 1) || ((tag >> 1) & LED_HANDLE_GEN_MASK) != (handle >> 8)) {
+        return RT_NULL;
+    }
+    return slot;
+}
+
+/* 调用方分配句柄槽：无锁地把一个空闲槽的占用位置1 */
+static led_handle_slot_t *led_handle_alloc(uint32_t *tag_out)
+{
+    for (uint32_t i = 0; i < LED_HANDLE_SLOTS; i++) {
+        led_handle_slot_t *slot = &g_led_mgr.handles[i];
+        uint32_t tag = __atomic_load_n(&slot->tag, __ATOMIC_RELAXED);
+        if (!(tag & 1) &&
+            __atomic_compare_exchange_n(&slot->tag, &tag, tag | 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            *tag_out = tag | 1;
+            return slot;
         }
+    }
+    return RT_NULL;
+}
 
-/* 发送LED消息 */
-static int led_send_message(const led_message_t *msg, bool sync)
+/* 归还句柄槽，代数加一（跳过0，句柄永不为RT_NULL） */
+static void led_handle_free(led_handle_slot_t *slot)
 {
-    if (!g_led_mgr.led_msg_queue) {
-        return -RT_ERROR;
+    uint32_t gen = (slot->tag >> 1) + 1;
+    
+    if ((gen & LED_HANDLE_GEN_MASK) == 0) {
+        gen++;
+    }
+    slot->engine_id = -1;
+    __atomic_store_n(&slot->tag, gen << 1, __ATOMIC_RELEASE);
+}
+
+/* 引擎里已经结束（到时、被挤掉、启动被拒）的效果归还句柄 */
+static void led_handles_reclaim(void)
+{
+    for (uint32_t i = 0; i < LED_HANDLE_SLOTS; i++) {
+        led_handle_slot_t *slot = &g_led_mgr.handles[i];
+        if (slot->engine_id >= 0 && !led_engine_is_running(&g_led_mgr.engine, slot->engine_id)) {
+            led_handle_free(slot);
+        }
+    }
+}
+
+/* 调用线程的命令环，第一次调用时认领。中断上下文和环已认领完时返回共享环 */
+static led_cmd_ring_t *led_cmd_ring_for_caller(void)
+{
+    if (rt_interrupt_get_nest() > 0) {
+        return &g_led_mgr.rings[LED_CMD_SHARED_RING];
     }
     
-    rt_err_t result;
-    if (sync) {
-        // RT-Thread中没有rt_mq_send_wait，使用循环尝试
-        int retry_count = 100; // 最多重试100次，总共1秒
-        do {
-            result = rt_mq_send(g_led_mgr.led_msg_queue, (void*)msg, sizeof(*msg));
-            if (result == RT_EOK) {
-                break;
-            }
-            rt_thread_mdelay(10);
-            retry_count--;
-        } while (retry_count > 0);
-    } else {
-        result = rt_mq_send(g_led_mgr.led_msg_queue, (void*)msg, sizeof(*msg));
+    rt_thread_t self = rt_thread_self();
+    for (int i = 0; i < LED_CMD_RINGS; i++) {
+        if (__atomic_load_n(&g_led_mgr.rings[i].owner, __ATOMIC_RELAXED) == self) {
+            return &g_led_mgr.rings[i];
+        }
+    }
+    for (int i = 0; i < LED_CMD_RINGS; i++) {
+        rt_thread_t expected = RT_NULL;
+        if (__atomic_compare_exchange_n(&g_led_mgr.rings[i].owner, &expected, self, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            return &g_led_mgr.rings[i];
+        }
     }
+    return &g_led_mgr.rings[LED_CMD_SHARED_RING];
+}
+
+static int led_cmd_ring_put(led_cmd_ring_t *ring, const led_cmd_t *cmd)
+{
+    uint16_t head = ring->head;
+    uint16_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
     
-    return (result == RT_EOK) ? 0 : -RT_ERROR;
+    if ((uint16_t)(head - tail) >= LED_CMD_RING_SIZE) {
+        return -RT_EFULL;
+    }
+    ring->cmd[head & (LED_CMD_RING_SIZE - 1)] = *cmd;
+    __atomic_store_n(&ring->head, (uint16_t)(head + 1), __ATOMIC_RELEASE);
+    return 0;
 }
 
-static void led_do_update_effects(void)
+/* 写入调用方的命令环并唤醒LED线程，从不等待 */
+static int led_cmd_push(const led_cmd_t *cmd)
 {
-    // 清空LED缓冲区
-    memset(g_led_mgr.led_buffer, 0, g_led_mgr.actual_led_count * sizeof(uint32_t));
+    led_cmd_ring_t *ring = led_cmd_ring_for_caller();
+    int ret;
+    
+    if (ring == &g_led_mgr.rings[LED_CMD_SHARED_RING]) {
+        // 共享环有多个生产者，关中断保证写入互斥，临界区只有一次拷贝
+        rt_base_t level = rt_hw_interrupt_disable();
+        ret = led_cmd_ring_put(ring, cmd);
+        rt_hw_interrupt_enable(level);
+    } else {
+        ret = led_cmd_ring_put(ring, cmd);
+    }
     
-    uint32_t current_tick = rt_tick_get();
+    if (ret != 0) {
+        __atomic_fetch_add(&g_led_mgr.cmd_dropped, 1, __ATOMIC_RELAXED);
+        return ret;
+    }
+    rt_event_send(g_led_mgr.wake_event, LED_WAKE_CMD);
+    return 0;
+}
+
+/* 取出各环中已发布的全部命令。返回是否需要重新渲染 */
+static bool led_cmd_drain(void)
+{
+    bool dirty = false;
+    uint32_t batch = 0;
     
-    // 处理所有活动效果
-    for (int i = 0; i < MAX_CONCURRENT_EFFECTS; i++) {
-        led_effect_handle_internal_t *effect = &g_led_mgr.effects[i];
+    for (int i = 0; i <= LED_CMD_RINGS; i++) {
+        led_cmd_ring_t *ring = &g_led_mgr.rings[i];
+        uint16_t tail = ring->tail;
+        uint16_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
         
-        if (!effect->active || effect->state != LED_EFFECT_STATE_RUNNING) {
-            continue;
+        while (tail != head) {
+            dirty |= led_cmd_apply(&ring->cmd[tail & (LED_CMD_RING_SIZE - 1)]);
+            tail++;
+            batch++;
         }
-        
-        // 检查效果是否超时
-        if (effect->config.duration_ms > 0) {
-            uint32_t elapsed_ms = (current_tick - effect->start_tick) * 1000 / RT_TICK_PER_SECOND;
-            if (elapsed_ms >= effect->config.duration_ms) {
-                effect->state = LED_EFFECT_STATE_FINISHED;
-                effect->active = false;
-                continue;
-            }
-        }
-        
-        // 更新效果内部计时器
-        uint32_t delta_ms = (current_tick - effect->last_update_tick) * 1000 / RT_TICK_PER_SECOND;
-        effect->effect_tick += delta_ms;
-        effect->last_update_tick = current_tick;
-        
-        // 应用效果
-        switch (effect->config.type) {
-            case LED_EFFECT_STATIC:
-                apply_effect_static(effect, g_led_mgr.led_buffer);
-                break;
-            case LED_EFFECT_BREATHING:
-                apply_effect_breathing(effect, g_led_mgr.led_buffer);
-                break;
-            case LED_EFFECT_FLOWING:
-                apply_effect_flowing(effect, g_led_mgr.led_buffer);
-                break;
-            case LED_EFFECT_BLINK:
-                apply_effect_blink(effect, g_led_mgr.led_buffer);
-                break;
-            default:
-                break;
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    }
+    
+    if (batch > 0) {
+        g_led_mgr.cmd_count += batch;
+        g_led_mgr.cmd_batches++;
+        if (batch > g_led_mgr.cmd_max_batch) {
+            g_led_mgr.cmd_max_batch = batch;
         }
     }
+    return dirty;
+}
+
+/* 在LED线程中执行一条命令，返回输出是否可能变化 */
+static bool led_cmd_apply(const led_cmd_t *cmd)
+{
+    led_engine_t *engine = &g_led_mgr.engine;
     
-    // 应用手动设置的LED（但允许LED反馈效果覆盖）
-    for (uint32_t i = 0; i < g_led_mgr.actual_led_count; i++) {
-        if (g_led_mgr.manual_led_mask[i]) {
-            // 检查是否有LED反馈效果正在运行
-            bool has_feedback_effect = false;
-            for (int j = 0; j < MAX_CONCURRENT_EFFECTS; j++) {
-                led_effect_handle_internal_t *effect = &g_led_mgr.effects[j];
-                if (effect->active && 
-                    effect->config.led_start <= i && 
-                    effect->config.led_start + effect->config.led_count > i &&
-                    effect->config.duration_ms > 0 && 
-                    effect->config.duration_ms <= 1000) { // 短时效果优先
-                    has_feedback_effect = true;
-                    break;
+    switch (cmd->type) {
+        case LED_CMD_SET_LED:
+            return led_engine_set_manual(engine, cmd->led_index, cmd->arg);
+            
+        case LED_CMD_SET_ALL_LEDS:
+            led_engine_set_manual_all(engine, cmd->arg);
+            return true;
+            
+        case LED_CMD_START_EFFECT:
+            {
+                led_handle_slot_t *slot = led_handle_lookup(cmd->arg);
+                if (!slot) {
+                    return false;
+                }
+                int effect_id = led_engine_start(engine, &slot->config, led_now_ms());
+                if (effect_id < 0) {
+                    // 池满被拒绝，句柄立即失效
+                    led_handle_free(slot);
+                    return false;
                 }
+                slot->engine_id = effect_id;
             }
+            return true;
             
-            // 只有没有LED反馈效果时才应用手动设置
-            if (!has_feedback_effect) {
-                g_led_mgr.led_buffer[i] = g_led_mgr.manual_led_buffer[i];
+        case LED_CMD_STOP_EFFECT:
+            {
+                // 旧代的句柄在这里被忽略；启动命令还没处理时归还句柄即取消启动
+                led_handle_slot_t *slot = led_handle_lookup(cmd->arg);
+                if (!slot) {
+                    return false;
+                }
+                if (slot->engine_id >= 0) {
+                    led_engine_stop(engine, slot->engine_id);
+                }
+                led_handle_free(slot);
             }
-        }
+            return true;
+            
+        case LED_CMD_STOP_ALL:
+            led_engine_stop_all(engine);
+            return true;
+            
+        case LED_CMD_SET_BRIGHTNESS:
+            led_engine_set_brightness(engine, (uint8_t)cmd->arg);
+            return true;
+            
+        case LED_CMD_LED_FEEDBACK:
+            return led_engine_feedback(engine, cmd->led_index, cmd->arg, cmd->duration_ms, led_now_ms()) >= 0;
+            
+        default:
+            return false;
     }
 }
 
-/* 更新硬件 - 在线程上下文中执行 */
-static void led_do_update_hardware(void)
+/* 引擎的毫秒时钟：按节拍差累加，节拍计数回绕时保持连续，未换算掉的节拍留到下次 */
+static uint32_t led_now_ms(void)
 {
-    if (!g_led_mgr.rgb_device) {
+    rt_tick_t elapsed = rt_tick_get() - g_led_mgr.clock_tick;
+    uint32_t ms = (uint32_t)((uint64_t)elapsed * 1000 / RT_TICK_PER_SECOND);
+    
+    g_led_mgr.clock_ms += ms;
+    g_led_mgr.clock_tick += (rt_tick_t)((uint64_t)ms * RT_TICK_PER_SECOND / 1000);
+    return g_led_mgr.clock_ms;
+}
+
+/* 渲染一帧并写入硬件 */
+static void led_render_frame(void)
+{
+    led_engine_render(&g_led_mgr.engine, led_now_ms(), g_led_mgr.out_frame[g_led_mgr.out_front ^ 1]);
+    led_do_update_hardware();
+    g_led_mgr.frames++;
+}
+
+/* 按最早的输出变化时间重新布置单次定时器，空闲时停掉定时器 */
+static void led_schedule_next_frame(void)
+{
+    uint32_t earliest = led_engine_next_change_ms(&g_led_mgr.engine, led_now_ms());
+    
+    if (earliest == LED_NO_DEADLINE) {
+        if (g_led_mgr.timer_armed) {
+            rt_timer_stop(g_led_mgr.update_timer);
+            g_led_mgr.timer_armed = false;
+        }
         return;
     }
     
-    // 应用全局亮度
-    uint32_t *brightness_buffer = (uint32_t *)rt_malloc(g_led_mgr.actual_led_count * sizeof(uint32_t));
-    if (!brightness_buffer) {
-        return;
+    rt_tick_t delay = rt_tick_from_millisecond(earliest);
+    if (delay == 0) {
+        delay = 1;
     }
+    rt_tick_t deadline = rt_tick_get() + delay;
     
-    for (uint32_t i = 0; i < g_led_mgr.actual_led_count; i++) {
-        brightness_buffer[i] = led_effects_apply_brightness(g_led_mgr.led_buffer[i], g_led_mgr.global_brightness);
+    // 已布置的定时器会在这之前触发时不必重设，触发后会重新计算
+    if (g_led_mgr.timer_armed && (rt_int32_t)(g_led_mgr.timer_deadline - deadline) <= 0) {
+        return;
     }
     
+    rt_timer_stop(g_led_mgr.update_timer);
+    rt_timer_control(g_led_mgr.update_timer, RT_TIMER_CTRL_SET_TIME, &delay);
+    rt_timer_start(g_led_mgr.update_timer);
+    g_led_mgr.timer_armed = true;
+    g_led_mgr.timer_deadline = deadline;
+}
+
+/* 把引擎渲染到back的帧写入硬件 - 在线程上下文中执行 */
+static void led_do_update_hardware(void)
+{
+    if (!g_led_mgr.rgb_device) {
+        return;
+    }
+
+    uint32_t *front = g_led_mgr.out_frame[g_led_mgr.out_front];
+    uint32_t *back = g_led_mgr.out_frame[g_led_mgr.out_front ^ 1];
+    uint32_t count = g_led_mgr.actual_led_count;
+
+    // 与上次写入的帧相同则不再启动PWM DMA
+    if (g_led_mgr.out_valid && memcmp(front, back, count * sizeof(uint32_t)) == 0) {
+        g_led_mgr.hw_skips++;
+        return;
+    }
+
     // 使用drv_rgbled的多LED控制API
     struct rt_rgbled_multi_configuration multi_config = {
-        .led_count = g_led_mgr.actual_led_count,
-        .color_array = brightness_buffer
+        .led_count = count,
+        .color_array = back
     };
-    
-    rt_device_control(g_led_mgr.rgb_device, RGB_CMD_SET_MULTI_COLOR, &multi_config);
-    rt_free(brightness_buffer);
+
+    if (rt_device_control(g_led_mgr.rgb_device, RGB_CMD_SET_MULTI_COLOR, &multi_config) == RT_EOK) {
+        g_led_mgr.out_front ^= 1;
+        g_led_mgr.out_valid = true;
+        g_led_mgr.hw_writes++;
+    } else {
+        // 写入失败时下一帧无条件重发
+        g_led_mgr.out_valid = false;
+    }
 }
 
 /* LED效果管理器初始化 */
@@ -455,31 +504,32 @@ int led_effects_manager_init(void)
     // 3. 获取LED数量
     uint32_t max_led_count = 0;
     rt_err_t result = rt_device_control(g_led_mgr.rgb_device, RGB_CMD_GET_CAPABILITY, &max_led_count);
-    g_led_mgr.actual_led_count = (result == RT_EOK) ? max_led_count : 3;
+    g_led_mgr.actual_led_count = (result == RT_EOK) ? max_led_count : LED_MAX_COUNT;
     
-    // 4. 分配缓冲区
-    g_led_mgr.led_buffer = (uint32_t *)rt_malloc(g_led_mgr.actual_led_count * sizeof(uint32_t));
-    g_led_mgr.manual_led_buffer = (uint32_t *)rt_malloc(g_led_mgr.actual_led_count * sizeof(uint32_t));
-    g_led_mgr.manual_led_mask = (bool *)rt_malloc(g_led_mgr.actual_led_count * sizeof(bool));
+    // 4. 缓冲区按BSP_RGB_LED_COUNT静态分配，驱动报告更多LED时只驱动前面的
+    if (g_led_mgr.actual_led_count == 0 || g_led_mgr.actual_led_count > LED_MAX_COUNT) {
+        g_led_mgr.actual_led_count = LED_MAX_COUNT;
+    }
     
-    if (!g_led_mgr.led_buffer || !g_led_mgr.manual_led_buffer || !g_led_mgr.manual_led_mask) {
+    // 5. 时间线槽位，开启flash保存时恢复上次加载的时间线
+    if (led_timeline_slots_init() != 0) {
         return -RT_ENOMEM;
     }
     
-    // 5. 创建消息队列
-    g_led_mgr.led_msg_queue = rt_mq_create("led_mq", sizeof(led_message_t), 16, RT_IPC_FLAG_PRIO);
-    if (!g_led_mgr.led_msg_queue) {
+    // 6. 创建LED线程唤醒事件
+    g_led_mgr.wake_event = rt_event_create("led_wake", RT_IPC_FLAG_PRIO);
+    if (!g_led_mgr.wake_event) {
         return -RT_ENOMEM;
     }
     
-    // 6. 创建关闭信号量
+    // 7. 创建关闭信号量
     g_led_mgr.shutdown_sem = rt_sem_create("led_shutdown", 0, RT_IPC_FLAG_PRIO);
     if (!g_led_mgr.shutdown_sem) {
-        rt_mq_delete(g_led_mgr.led_msg_queue);
+        rt_event_delete(g_led_mgr.wake_event);
         return -RT_ENOMEM;
     }
     
-    // 7. 创建LED处理线程
+    // 8. 创建LED处理线程
     g_led_mgr.led_thread = rt_thread_create("led_effects",
                                            led_effects_thread_entry,
                                            RT_NULL,
@@ -488,36 +538,40 @@ int led_effects_manager_init(void)
                                            10);
     if (!g_led_mgr.led_thread) {
         rt_sem_delete(g_led_mgr.shutdown_sem);
-        rt_mq_delete(g_led_mgr.led_msg_queue);
+        rt_event_delete(g_led_mgr.wake_event);
         return -RT_ENOMEM;
     }
     
-    // 8. 创建定时器
+    // 9. 创建定时器，由LED线程按下一次输出变化的时间布置
     g_led_mgr.update_timer = rt_timer_create("led_timer",
                                              led_update_timer_callback,
                                              RT_NULL,
-                                             rt_tick_from_millisecond(LED_UPDATE_INTERVAL_MS),
-                                             RT_TIMER_FLAG_PERIODIC);
+                                             rt_tick_from_millisecond(LED_SMOOTH_FRAME_MS),
+                                             RT_TIMER_FLAG_ONE_SHOT);
     if (!g_led_mgr.update_timer) {
         return -RT_ENOMEM;
     }
     
-    // 9. 初始化状态
-    memset(g_led_mgr.effects, 0, sizeof(g_led_mgr.effects));
-    memset(g_led_mgr.led_buffer, 0, g_led_mgr.actual_led_count * sizeof(uint32_t));
-    memset(g_led_mgr.manual_led_buffer, 0, g_led_mgr.actual_led_count * sizeof(uint32_t));
-    memset(g_led_mgr.manual_led_mask, false, g_led_mgr.actual_led_count * sizeof(bool));
-    
-    g_led_mgr.global_brightness = 255;
-    g_led_mgr.next_effect_id = 1;
+    // 10. 初始化状态，句柄槽从第1代开始，句柄永不为RT_NULL
+    led_engine_init(&g_led_mgr.engine, g_led_mgr.actual_led_count);
+    memset(g_led_mgr.rings, 0, sizeof(g_led_mgr.rings));
+    for (int i = 0; i < LED_HANDLE_SLOTS; i++) {
+        if (g_led_mgr.handles[i].tag == 0) {
+            g_led_mgr.handles[i].tag = 1 << 1;  // 重新初始化时沿用deinit换过的代数
+        }
+        g_led_mgr.handles[i].engine_id = -1;
+    }
+    g_led_mgr.clock_tick = rt_tick_get();
+    g_led_mgr.clock_ms = 0;
+    g_led_mgr.out_valid = false;
+    g_led_mgr.timer_armed = false;
     g_led_mgr.running = true;
     g_led_mgr.initialized = true;
     
-    // 10. 启动线程和定时器
+    // 11. 启动线程，定时器在第一个效果启动时布置
     rt_thread_startup(g_led_mgr.led_thread);
-    rt_timer_start(g_led_mgr.update_timer);
     
-    // 11. 订阅LED反馈事件
+    // 12. 订阅LED反馈事件
     event_bus_subscribe(EVENT_LED_FEEDBACK_REQUEST, led_feedback_event_handler, 
                        NULL, EVENT_PRIORITY_NORMAL);
     return 0;
@@ -530,54 +584,50 @@ int led_effects_manager_deinit(void)
         return 0;
     }
     
-    // 1. 取消事件订阅
+    // 1. 取消事件订阅，之后的API调用直接返回错误，不再写入命令环
     event_bus_unsubscribe(EVENT_LED_FEEDBACK_REQUEST, led_feedback_event_handler);
+    g_led_mgr.initialized = false;
     
-    // 2. 停止定时器
+    // 2. 通知线程退出并等待；线程还可能布置定时器，所以先于定时器处理
+    g_led_mgr.running = false;
+    rt_event_send(g_led_mgr.wake_event, LED_WAKE_CMD);
+    if (rt_sem_take(g_led_mgr.shutdown_sem, 5000) != RT_EOK) {
+        // 线程仍在使用定时器和命令环，保留全部资源
+        rt_kprintf("[LED] thread did not exit, resources kept\n");
+        return -RT_ETIMEOUT;
+    }
+    g_led_mgr.led_thread = RT_NULL;
+    
+    // 3. 停止并删除定时器，此后不会再有回调向wake_event发送事件
     if (g_led_mgr.update_timer) {
         rt_timer_stop(g_led_mgr.update_timer);
         rt_timer_delete(g_led_mgr.update_timer);
         g_led_mgr.update_timer = RT_NULL;
     }
+    g_led_mgr.timer_armed = false;
     
-    // 2. 发送关闭消息给线程
-    led_message_t shutdown_msg = {.type = LED_MSG_SHUTDOWN};
-    led_send_message(&shutdown_msg, false);
-    
-    // 3. 等待线程结束
-    rt_sem_take(g_led_mgr.shutdown_sem, 5000);
+    // 4. 释放命令环和句柄表：未处理的命令丢弃，旧句柄换代后失效
+    memset(g_led_mgr.rings, 0, sizeof(g_led_mgr.rings));
+    for (int i = 0; i < LED_HANDLE_SLOTS; i++) {
+        g_led_mgr.handles[i].tag = ((g_led_mgr.handles[i].tag >> 1) + 1) << 1;
+        g_led_mgr.handles[i].engine_id = -1;
+    }
     
-    // 4. 清理资源
+    // 5. 删除线程通信对象
     if (g_led_mgr.shutdown_sem) {
         rt_sem_delete(g_led_mgr.shutdown_sem);
         g_led_mgr.shutdown_sem = RT_NULL;
     }
     
-    if (g_led_mgr.led_msg_queue) {
-        rt_mq_delete(g_led_mgr.led_msg_queue);
-        g_led_mgr.led_msg_queue = RT_NULL;
+    if (g_led_mgr.wake_event) {
+        rt_event_delete(g_led_mgr.wake_event);
+        g_led_mgr.wake_event = RT_NULL;
     }
     
-    if (g_led_mgr.led_buffer) {
-        rt_free(g_led_mgr.led_buffer);
-        g_led_mgr.led_buffer = RT_NULL;
-    }
-    
-    if (g_led_mgr.manual_led_buffer) {
-        rt_free(g_led_mgr.manual_led_buffer);
-        g_led_mgr.manual_led_buffer = RT_NULL;
-    }
-    
-    if (g_led_mgr.manual_led_mask) {
-        rt_free(g_led_mgr.manual_led_mask);
-        g_led_mgr.manual_led_mask = RT_NULL;
-    }
-    
-    g_led_mgr.initialized = false;
     return 0;
 }
 
-/* 公共API函数 - 通过消息队列与线程通信 */
+/* 公共API函数 - 写入调用线程的命令环，不等待LED线程 */
 
 int led_effects_set_led(uint8_t led_index, uint32_t color)
 {
@@ -585,15 +635,12 @@ int led_effects_set_led(uint8_t led_index, uint32_t color)
         return -RT_ERROR;
     }
     
-    led_message_t msg = {
-        .type = LED_MSG_SET_LED,
-        .data.set_led = {
-            .led_index = led_index,
-            .color = color
-        }
+    led_cmd_t cmd = {
+        .type = LED_CMD_SET_LED,
+        .led_index = led_index,
+        .arg = color
     };
-    
-    return led_send_message(&msg, false);
+    return led_cmd_push(&cmd);
 }
 
 int led_effects_set_all_leds(uint32_t color)
@@ -602,14 +649,11 @@ int led_effects_set_all_leds(uint32_t color)
         return -RT_ERROR;
     }
     
-    led_message_t msg = {
-        .type = LED_MSG_SET_ALL_LEDS,
-        .data.set_all = {
-            .color = color
-        }
+    led_cmd_t cmd = {
+        .type = LED_CMD_SET_ALL_LEDS,
+        .arg = color
     };
-    
-    return led_send_message(&msg, false);
+    return led_cmd_push(&cmd);
 }
 
 int led_effects_set_global_brightness(uint8_t brightness)
@@ -618,130 +662,61 @@ int led_effects_set_global_brightness(uint8_t brightness)
         return -RT_ERROR;
     }
     
-    led_message_t msg = {
-        .type = LED_MSG_SET_BRIGHTNESS,
-        .data.set_brightness = {
-            .brightness = brightness
-        }
+    led_cmd_t cmd = {
+        .type = LED_CMD_SET_BRIGHTNESS,
+        .arg = brightness
     };
-    
-    return led_send_message(&msg, false);
+    return led_cmd_push(&cmd);
 }
 
-led_effect_handle_t led_effects_start_effect(const led_effect_config_t *config)
+int led_effects_feedback(int led_index, uint32_t color, uint32_t duration_ms)
 {
-    if (!g_led_mgr.initialized || !config) {
-        return RT_NULL;
-    }
-    
-    int effect_id = -1;
-    rt_sem_t done_sem = rt_sem_create("led_sync", 0, RT_IPC_FLAG_PRIO);
-    if (!done_sem) {
-        return RT_NULL;
+    if (!g_led_mgr.initialized || led_index < 0 || led_index > 255) {
+        return -RT_ERROR;
     }
     
-    led_message_t msg = {
-        .type = LED_MSG_START_EFFECT,
-        .data.start_effect = {
-            .config = *config,
-            .effect_id_out = &effect_id,
-            .done_sem = done_sem
-        }
+    led_cmd_t cmd = {
+        .type = LED_CMD_LED_FEEDBACK,
+        .led_index = (uint8_t)led_index,
+        .arg = color,
+        .duration_ms = duration_ms
     };
-    
-    if (led_send_message(&msg, true) == 0) {
-        // 等待处理完成
-        rt_sem_take(done_sem, 1000);
-    }
-    
-    rt_sem_delete(done_sem);
-    
-    return (effect_id >= 0) ? (led_effect_handle_t)(uintptr_t)effect_id : RT_NULL;
+    return led_cmd_push(&cmd);
 }
 
-/* LED效果渲染函数实现 */
-
-/* 静态效果 */
-static int apply_effect_static(const led_effect_handle_internal_t *effect, uint32_t *buffer)
+led_effect_handle_t led_effects_start_effect(const led_effect_config_t *config)
 {
-    uint32_t color = effect->config.color_count > 0 ? effect->config.colors[0] : RGB_COLOR_WHITE;
-    color = led_effects_apply_brightness(color, effect->config.brightness);
-
-    for (int i = effect->config.led_start; i < effect->config.led_start + effect->config.led_count; i++) {
-        if (i < (int)g_led_mgr.actual_led_count) {
-            buffer[i] = color;
-        }
+    if (!g_led_mgr.initialized || !config) {
+        return RT_NULL;
     }
-    return 0;
-}
-
-/* 呼吸灯效果 */
-static int apply_effect_breathing(const led_effect_handle_internal_t *effect, uint32_t *buffer)
-{
-    if (effect->config.color_count < 1) return -1;
-
-    uint32_t cycle_pos = effect->effect_tick % effect->config.period_ms;
-    float phase = (float)cycle_pos / effect->config.period_ms * 2.0f * 3.14159f;
-    uint8_t intensity = (uint8_t)((sin(phase) + 1.0f) * 127.5f);
     
-    uint32_t color = led_effects_apply_brightness(effect->config.colors[0], intensity);
-    color = led_effects_apply_brightness(color, effect->config.brightness);
-
-    for (int i = effect->config.led_start; i < effect->config.led_start + effect->config.led_count; i++) {
-        if (i < (int)g_led_mgr.actual_led_count) {
-            buffer[i] = color;
-        }
+    // 句柄在调用方分配，参数放进句柄槽，命令里只带句柄
+    uint32_t tag;
+    led_handle_slot_t *slot = led_handle_alloc(&tag);
+    if (!slot) {
+        return RT_NULL;
     }
-    return 0;
-}
-
-/* 流水灯效果 */
-static int apply_effect_flowing(const led_effect_handle_internal_t *effect, uint32_t *buffer)
-{
-    if (effect->config.color_count < 1) return -1;
-
-    uint32_t cycle_pos = effect->effect_tick % effect->config.period_ms;
-    float progress = (float)cycle_pos / effect->config.period_ms;
+    slot->config = *config;
     
-    if (effect->config.reverse) {
-        progress = 1.0f - progress;
-    }
-
-    int active_led = (int)(progress * effect->config.led_count);
-    uint32_t color = led_effects_apply_brightness(effect->config.colors[0], effect->config.brightness);
-
-    // 清除范围内的LED
-    for (int i = effect->config.led_start; i < effect->config.led_start + effect->config.led_count; i++) {
-        if (i < (int)g_led_mgr.actual_led_count) {
-            buffer[i] = RGB_COLOR_BLACK;
-        }
-    }
-
-    // 点亮当前LED
-    int led_index = effect->config.led_start + active_led;
-    if (led_index < (int)g_led_mgr.actual_led_count && led_index >= effect->config.led_start) {
-        buffer[led_index] = color;
+    uint32_t index = (uint32_t)(slot - g_led_mgr.handles);
+    led_effect_handle_t handle = led_handle_make(index, tag);
+    led_cmd_t cmd = {
+        .type = LED_CMD_START_EFFECT,
+        .arg = (uint32_t)(uintptr_t)handle
+    };
+    if (led_cmd_push(&cmd) != 0) {
+        led_handle_free(slot);
+        return RT_NULL;
     }
-    return 0;
+    return handle;
 }
 
-/* 闪烁效果 */
-static int apply_effect_blink(const led_effect_handle_internal_t *effect, uint32_t *buffer)
+led_effect_state_t led_effects_get_effect_state(led_effect_handle_t handle)
 {
-    if (effect->config.color_count < 1) return -1;
-
-    uint32_t cycle_pos = effect->effect_tick % effect->config.period_ms;
-    bool is_on = cycle_pos < (effect->config.period_ms / 2);
-    
-    uint32_t color = is_on ? effect->config.colors[0] : RGB_COLOR_BLACK;
-    color = led_effects_apply_brightness(color, effect->config.brightness);
-
-    for (int i = effect->config.led_start; i < effect->config.led_start + effect->config.led_count; i++) {
-        if (i < (int)g_led_mgr.actual_led_count) {
-            buffer[i] = color;
-        }
+    if (!g_led_mgr.initialized || !handle) {
+        return LED_EFFECT_STATE_STOPPED;
     }
-    return 0;
+    return led_handle_lookup((uint32_t)(uintptr_t)handle) ? LED_EFFECT_STATE_RUNNING : LED_EFFECT_STATE_STOPPED;
 }
 
 int led_effects_stop_effect(led_effect_handle_t handle)
@@ -750,25 +725,21 @@ int led_effects_stop_effect(led_effect_handle_t handle)
         return -RT_EINVAL;
     }
     
-    int effect_id = (int)(uintptr_t)handle;
-    
-    led_message_t msg = {
-        .type = LED_MSG_STOP_EFFECT,
-        .data.stop_effect = {
-            .effect_id = effect_id
-        }
+    led_cmd_t cmd = {
+        .type = LED_CMD_STOP_EFFECT,
+        .arg = (uint32_t)(uintptr_t)handle
     };
-    
-    return led_send_message(&msg, false);
+    return led_cmd_push(&cmd);
 }
 
 int led_effects_stop_all_effects(void)
 {
-    // 停止所有效果的简单实现
-    for (int i = 1; i <= 10; i++) {
-        led_effects_stop_effect((led_effect_handle_t)(uintptr_t)i);
+    if (!g_led_mgr.initialized) {
+        return -RT_ERROR;
     }
-    return 0;
+    
+    led_cmd_t cmd = {.type = LED_CMD_STOP_ALL};
+    return led_cmd_push(&cmd);
 }
 
 int led_effects_turn_off_all_leds(void)
@@ -821,19 +792,128 @@ led_effect_handle_t led_effects_flowing(uint32_t color, uint32_t period_ms, uint
     return led_effects_start_effect(&config);
 }
 
+led_effect_handle_t led_effects_rainbow(uint32_t period_ms, uint8_t brightness, uint32_t duration_ms)
+{
+    if (!g_led_mgr.initialized) {
+        return RT_NULL;
+    }
+
+    led_effect_config_t config = {
+        .type = LED_EFFECT_RAINBOW,
+        .duration_ms = duration_ms,
+        .period_ms = period_ms,
+        .brightness = brightness,
+        .colors = {0},
+        .color_count = 0,
+        .reverse = false,
+        .led_start = 0,
+        .led_count = g_led_mgr.actual_led_count,
+        .custom_data = RT_NULL
+    };
+    
+    return led_effects_start_effect(&config);
+}
+
+led_effect_handle_t led_effects_play_timeline(uint8_t slot, uint32_t duration_ms)
+{
+    if (!g_led_mgr.initialized || !led_timeline_slot_info(slot, RT_NULL, RT_NULL, RT_NULL)) {
+        return RT_NULL;
+    }
+
+    led_effect_config_t config = {
+        .type = LED_EFFECT_TIMELINE,
+        .duration_ms = duration_ms,
+        .brightness = 255,
+        .led_start = 0,
+        .led_count = g_led_mgr.actual_led_count,
+        .layer = LED_LAYER_OVERLAY,
+        .timeline = slot
+    };
+    
+    return led_effects_start_effect(&config);
+}
+
 /* 工具函数 */
 uint32_t led_effects_apply_brightness(uint32_t color, uint8_t brightness)
 {
-    if (brightness == 0) return 0;
-    if (brightness == 255) return color;
+    return led_color_scale(color, brightness);
+}
+
+uint32_t led_effects_interpolate_color(uint32_t color1, uint32_t color2, uint8_t ratio)
+{
+    return led_color_lerp(color1, color2, ratio);
+}
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void led_stats(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    if (!g_led_mgr.initialized) {
+        rt_kprintf("led effects manager not initialized\n");
+        return;
+    }
+    rt_kprintf("leds %u, brightness %u, frames %u, hw writes %u, unchanged frames skipped %u\n",
+               (unsigned)g_led_mgr.actual_led_count, g_led_mgr.engine.brightness,
+               (unsigned)g_led_mgr.frames, (unsigned)g_led_mgr.hw_writes, (unsigned)g_led_mgr.hw_skips);
+    if (g_led_mgr.timer_armed) {
+        rt_int32_t left = (rt_int32_t)(g_led_mgr.timer_deadline - rt_tick_get());
+        rt_kprintf("next frame in %d ms\n", (int)(left > 0 ? left * 1000 / RT_TICK_PER_SECOND : 0));
+    } else {
+        rt_kprintf("idle, no frame scheduled\n");
+    }
     
-    uint8_t r = RGB_GET_RED(color);
-    uint8_t g = RGB_GET_GREEN(color);
-    uint8_t b = RGB_GET_BLUE(color);
+    int feedback;
+    int effects = led_engine_active_count(&g_led_mgr.engine, &feedback);
+    rt_kprintf("effect pool %d/%d (%d feedback, %d reserved), evictions %u, rejected %u\n",
+               effects, LED_EFFECT_POOL_SIZE, feedback, LED_FEEDBACK_SLOTS,
+               (unsigned)g_led_mgr.engine.evictions, (unsigned)g_led_mgr.engine.rejected);
     
-    r = (r * brightness) / 255;
-    g = (g * brightness) / 255;
-    b = (b * brightness) / 255;
+    int rings = 0;
+    for (int i = 0; i < LED_CMD_RINGS; i++) {
+        rings += g_led_mgr.rings[i].owner ? 1 : 0;
+    }
+    rt_kprintf("commands %u in %u batches (max %u), dropped %u, rings claimed %d/%d\n",
+               (unsigned)g_led_mgr.cmd_count, (unsigned)g_led_mgr.cmd_batches,
+               (unsigned)g_led_mgr.cmd_max_batch, (unsigned)g_led_mgr.cmd_dropped, rings, LED_CMD_RINGS);
+}
+MSH_CMD_EXPORT(led_stats, LED output statistics);
+
+static void led_tl(int argc, char **argv)
+{
+    int ret = 0;
+    
+    if (argc >= 4 && strcmp(argv[1], "load") == 0) {
+        ret = led_timeline_slot_compile((uint8_t)atoi(argv[2]), argv[3]);
+    } else if (argc >= 3 && strcmp(argv[1], "play") == 0) {
+        ret = led_effects_play_timeline((uint8_t)atoi(argv[2]), 0) ? 0 : -RT_ERROR;
+    } else if (argc >= 3 && strcmp(argv[1], "fb") == 0) {
+        ret = led_timeline_set_feedback_slot(atoi(argv[2]));
+    } else if (argc >= 3 && strcmp(argv[1], "clear") == 0) {
+        ret = led_timeline_slot_clear((uint8_t)atoi(argv[2]));
+    } else if (argc > 1) {
+        rt_kprintf("usage: led_tl [load <slot> <source> | play <slot> | fb <slot|-1> | clear <slot>]\n");
+        return;
+    } else {
+        for (int i = 0; i < LED_TIMELINE_SLOTS; i++) {
+            uint32_t len, duration_ms;
+            bool loop;
+            if (led_timeline_slot_info((uint8_t)i, &len, &duration_ms, &loop)) {
+                rt_kprintf("slot %d: %u bytes, %u ms%s\n", i, (unsigned)len, (unsigned)duration_ms,
+                           loop ? ", loop" : "");
+            } else {
+                rt_kprintf("slot %d: empty\n", i);
+            }
+        }
+        rt_kprintf("key feedback slot: %d\n", led_timeline_get_feedback_slot());
+        return;
+    }
     
-    return RGB_MAKE_COLOR(r, g, b);
-}
\ No newline at end of file
+    if (ret != 0) {
+        rt_kprintf("led_tl %s failed: %d\n", argv[1], ret);
+    }
+}
+MSH_CMD_EXPORT(led_tl, LED keyframe timelines: led_tl [load | play | fb | clear]);
+#endif /* RT_USING_FINSH */
@@ -22,6 +22,7 @@ typedef enum {
     LED_EFFECT_BLINK,           // 闪烁
     LED_EFFECT_WAVE,            // 波浪效果
     LED_EFFECT_CUSTOM,          // 自定义效果
+    LED_EFFECT_TIMELINE,        // 关键帧时间线，见led_timeline.h
     LED_EFFECT_MAX
 } led_effect_type_t;
 
@@ -33,6 +34,24 @@ typedef enum {
     LED_EFFECT_STATE_FINISHED
 } led_effect_state_t;
 
+/* 合成层，从低到高依次合成。手动设置的LED位于OVERLAY与FEEDBACK之间 */
+typedef enum {
+    LED_LAYER_BACKGROUND = 0,   // 背景效果（默认）
+    LED_LAYER_EFFECT,           // 普通效果
+    LED_LAYER_OVERLAY,          // 叠加提示
+    LED_LAYER_FEEDBACK,         // 按键反馈
+    LED_LAYER_MAX
+} led_layer_t;
+
+/* 效果与下层结果的混合方式 */
+typedef enum {
+    LED_BLEND_REPLACE = 0,      // 覆盖（默认）
+    LED_BLEND_ADD,              // 逐通道饱和相加
+    LED_BLEND_ALPHA,            // 按opacity与下层插值
+    LED_BLEND_LIGHTEN,          // 逐通道取最大值
+    LED_BLEND_MODE_MAX
+} led_blend_mode_t;
+
 /* LED效果参数结构体 */
 typedef struct {
     led_effect_type_t type;         // 效果类型
@@ -45,6 +64,12 @@ typedef struct {
     uint8_t led_start;              // 起始LED索引
     uint8_t led_count;              // 影响的LED数量
     void *custom_data;              // 自定义数据指针
+    led_layer_t layer;              // 合成层
+    led_blend_mode_t blend;         // 混合方式
+    uint8_t opacity;                // LED_BLEND_ALPHA的不透明度，0按255处理
+    int8_t priority;                // 同层内高优先级后合成；效果池满时可挤掉更低优先级的效果
+    uint32_t led_mask;              // 只影响置位的LED（bit i对应LED i），0表示不额外屏蔽
+    uint8_t timeline;               // LED_EFFECT_TIMELINE的槽位，时间线掩码bit n对应led_start+n
 } led_effect_config_t;
 
 /* LED效果句柄 - 修改为不透明指针 */
@@ -71,7 +96,10 @@ int led_effects_turn_on_led(uint8_t led_index, uint32_t color);
 int led_effects_set_all_leds(uint32_t color);
 int led_effects_turn_off_all_leds(void);
 
-/* LED效果控制 - 线程安全版本 */
+/* LED效果控制 - 线程安全版本
+ * 所有调用只写入调用线程的命令环，由LED线程在下一帧前成批执行，从不阻塞。
+ * 启动时句柄在调用方分配，返回时效果还未开始；效果池满被拒绝、到时结束或
+ * 被停止后句柄失效，对失效句柄的操作被忽略 */
 led_effect_handle_t led_effects_start_effect(const led_effect_config_t *config);
 int led_effects_stop_effect(led_effect_handle_t handle);
 int led_effects_pause_effect(led_effect_handle_t handle);
@@ -88,6 +116,13 @@ led_effect_handle_t led_effects_flowing(uint32_t color, uint32_t period_ms, uint
 led_effect_handle_t led_effects_rainbow(uint32_t period_ms, uint8_t brightness, uint32_t duration_ms);
 led_effect_handle_t led_effects_blink(uint32_t color, uint32_t period_ms, uint8_t brightness, uint32_t duration_ms);
 
+/* 按键反馈：在FEEDBACK层点亮一个LED，绑定了反馈时间线时播放时间线。
+ * 可在中断中调用，只写入命令环，几微秒内返回 */
+int led_effects_feedback(int led_index, uint32_t color, uint32_t duration_ms);
+
+/* 在OVERLAY层上播放时间线槽位，不循环的时间线播完自动结束 */
+led_effect_handle_t led_effects_play_timeline(uint8_t slot, uint32_t duration_ms);
+
 /* 自定义效果注册 */
 int led_effects_register_custom_effect(const char *name, led_custom_effect_func_t func);
 led_effect_handle_t led_effects_start_custom_effect(const char *name, const led_effect_config_t *config);
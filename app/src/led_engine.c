@@ -0,0 +1,602 @@
+#include "led_engine.h"
+#include "led_math.h"
+#include "led_timeline.h"
+#include <string.h>
+
+static int apply_effect_static(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer);
+static int apply_effect_breathing(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer);
+static int apply_effect_flowing(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer);
+static int apply_effect_blink(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer);
+static int apply_effect_rainbow(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer);
+static int apply_effect_wave(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer);
+static int apply_effect_timeline(led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer);
+
+void led_engine_init(led_engine_t *engine, uint32_t led_count)
+{
+    memset(engine, 0, sizeof(*engine));
+    engine->led_count = (led_count == 0 || led_count > LED_MAX_COUNT) ? LED_MAX_COUNT : led_count;
+    engine->next_effect_id = 1;
+    led_engine_set_brightness(engine, 255);
+}
+
+/* 为普通效果分配槽位。预留给按键反馈的槽不参与分配；池满时挤掉优先级
+ * 更低的效果中最早启动的一个，没有更低优先级的效果时启动失败 */
+static led_engine_effect_t *led_alloc_effect(led_engine_t *engine, const led_effect_config_t *config)
+{
+    led_engine_effect_t *free_slot = NULL;
+    led_engine_effect_t *victim = NULL;
+    int used = 0;
+
+    for (int i = 0; i < LED_EFFECT_POOL_SIZE; i++) {
+        led_engine_effect_t *effect = &engine->effects[i];
+        if (!effect->active) {
+            if (!free_slot) {
+                free_slot = effect;
+            }
+            continue;
+        }
+        if (effect->feedback) {
+            continue;
+        }
+        used++;
+        if (effect->config.priority < config->priority &&
+            (!victim || effect->config.priority < victim->config.priority ||
+             (effect->config.priority == victim->config.priority && effect->id < victim->id))) {
+            victim = effect;
+        }
+    }
+
+    // 普通效果不超过池大小减去反馈预留，此时一定有空槽
+    if (used < LED_EFFECT_POOL_SIZE - LED_FEEDBACK_SLOTS && free_slot) {
+        return free_slot;
+    }
+    if (victim) {
+        victim->state = LED_EFFECT_STATE_STOPPED;
+        victim->active = false;
+        engine->evictions++;
+        return victim;
+    }
+    engine->rejected++;
+    return NULL;
+}
+
+/* 为按键反馈分配槽位：同一LED上已有的反馈直接复用，否则取空槽。
+ * 每个LED最多一个反馈，普通效果又占不满预留，因此总能分配到 */
+static led_engine_effect_t *led_alloc_feedback(led_engine_t *engine, int led_index)
+{
+    led_engine_effect_t *free_slot = NULL;
+
+    for (int i = 0; i < LED_EFFECT_POOL_SIZE; i++) {
+        led_engine_effect_t *effect = &engine->effects[i];
+        if (effect->active && effect->feedback && effect->config.led_start == led_index) {
+            return effect;
+        }
+        if (!effect->active && !free_slot) {
+            free_slot = effect;
+        }
+    }
+    return free_slot;
+}
+
+static void led_effect_activate(led_engine_t *engine, led_engine_effect_t *effect,
+                                const led_effect_config_t *config, bool feedback, uint32_t now_ms)
+{
+    effect->config = *config;
+    effect->state = LED_EFFECT_STATE_RUNNING;
+    effect->start_ms = now_ms;
+    effect->last_update_ms = now_ms;
+    effect->effect_tick = 0;
+    effect->phase = 0;
+    effect->phase_step = led_phase_step(effect->config.period_ms);
+    effect->active = true;
+    effect->feedback = feedback;
+    effect->id = engine->next_effect_id++;
+
+    // 参数检查和修正
+    if (effect->config.led_start >= engine->led_count) {
+        effect->config.led_start = 0;
+    }
+    if (effect->config.led_start + effect->config.led_count > engine->led_count) {
+        effect->config.led_count = engine->led_count - effect->config.led_start;
+    }
+    if (effect->config.led_count == 0) {
+        effect->config.led_count = engine->led_count;
+    }
+    if (effect->config.layer >= LED_LAYER_MAX) {
+        effect->config.layer = LED_LAYER_MAX - 1;
+    }
+
+    // 不循环的时间线未指定时长时播完即结束
+    uint32_t timeline_ms;
+    bool loop;
+    if (effect->config.type == LED_EFFECT_TIMELINE && effect->config.duration_ms == 0 &&
+        led_timeline_slot_info(effect->config.timeline, NULL, &timeline_ms, &loop) && !loop) {
+        effect->config.duration_ms = timeline_ms > 0 ? timeline_ms : 1;
+    }
+}
+
+int led_engine_start(led_engine_t *engine, const led_effect_config_t *config, uint32_t now_ms)
+{
+    led_engine_effect_t *effect = led_alloc_effect(engine, config);
+    if (!effect) {
+        return -1;
+    }
+    led_effect_activate(engine, effect, config, false, now_ms);
+    return effect->id;
+}
+
+int led_engine_feedback(led_engine_t *engine, int led_index, uint32_t color,
+                        uint32_t duration_ms, uint32_t now_ms)
+{
+    if (led_index < 0 || led_index >= (int)engine->led_count) {
+        return -1;
+    }
+    engine->manual_led_mask[led_index] = false;
+
+    led_effect_config_t config = {
+        .type = LED_EFFECT_STATIC,
+        .duration_ms = duration_ms,
+        .period_ms = 100,
+        .brightness = 255,
+        .colors = {color},
+        .color_count = 1,
+        .led_start = led_index,
+        .led_count = 1,
+        .layer = LED_LAYER_FEEDBACK
+    };
+
+    // 绑定了时间线时播放时间线，不循环的按其自身长度结束
+    int tl = led_timeline_get_feedback_slot();
+    bool loop;
+    if (tl >= 0 && led_timeline_slot_info((uint8_t)tl, NULL, NULL, &loop)) {
+        config.type = LED_EFFECT_TIMELINE;
+        config.timeline = (uint8_t)tl;
+        if (!loop) {
+            config.duration_ms = 0;
+        }
+    }
+    // 预留槽保证总能拿到，同一LED上的反馈直接重新开始
+    led_engine_effect_t *effect = led_alloc_feedback(engine, led_index);
+    if (!effect) {
+        return -1;
+    }
+    led_effect_activate(engine, effect, &config, true, now_ms);
+    return effect->id;
+}
+
+bool led_engine_stop(led_engine_t *engine, int id)
+{
+    for (int i = 0; i < LED_EFFECT_POOL_SIZE; i++) {
+        led_engine_effect_t *effect = &engine->effects[i];
+        if (effect->active && effect->id == id) {
+            effect->state = LED_EFFECT_STATE_STOPPED;
+            effect->active = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool led_engine_is_running(const led_engine_t *engine, int id)
+{
+    for (int i = 0; i < LED_EFFECT_POOL_SIZE; i++) {
+        const led_engine_effect_t *effect = &engine->effects[i];
+        if (effect->active && effect->id == id) {
+            return effect->state == LED_EFFECT_STATE_RUNNING;
+        }
+    }
+    return false;
+}
+
+void led_engine_stop_all(led_engine_t *engine)
+{
+    for (int i = 0; i < LED_EFFECT_POOL_SIZE; i++) {
+        led_engine_effect_t *effect = &engine->effects[i];
+        if (effect->active && !effect->feedback) {
+            effect->state = LED_EFFECT_STATE_STOPPED;
+            effect->active = false;
+        }
+    }
+}
+
+bool led_engine_set_manual(led_engine_t *engine, uint32_t led_index, uint32_t color)
+{
+    if (led_index >= engine->led_count) {
+        return false;
+    }
+    engine->manual_led_buffer[led_index] = color;
+    engine->manual_led_mask[led_index] = true;
+    return true;
+}
+
+void led_engine_set_manual_all(led_engine_t *engine, uint32_t color)
+{
+    for (uint32_t i = 0; i < engine->led_count; i++) {
+        engine->manual_led_buffer[i] = color;
+        engine->manual_led_mask[i] = true;
+    }
+}
+
+/* 全局亮度变化时重算通道表，每帧输出只查表。效果在线性空间叠加，
+ * gamma校正只在这里做一次 */
+void led_engine_set_brightness(led_engine_t *engine, uint8_t brightness)
+{
+    for (uint32_t v = 0; v < 256; v++) {
+        uint8_t scaled = led_scale8((uint8_t)v, brightness);
+#ifdef LED_GAMMA_CORRECTION
+        scaled = led_gamma8_lut[scaled];
+#endif
+        engine->brightness_lut[v] = scaled;
+    }
+    engine->brightness = brightness;
+}
+
+/* 合成顺序：层、优先级、启动先后 */
+static bool led_effect_before(const led_engine_effect_t *a, const led_engine_effect_t *b)
+{
+    if (a->config.layer != b->config.layer) {
+        return a->config.layer < b->config.layer;
+    }
+    if (a->config.priority != b->config.priority) {
+        return a->config.priority < b->config.priority;
+    }
+    return a->id < b->id;
+}
+
+/* 渲染单个效果，再按其混合方式和LED掩码合成到led_buffer */
+static void led_compose_effect(led_engine_t *engine, const led_engine_effect_t *effect)
+{
+    uint32_t *layer = engine->layer_buffer;
+    int ret = -1;
+
+    switch (effect->config.type) {
+        case LED_EFFECT_STATIC:
+            ret = apply_effect_static(engine, effect, layer);
+            break;
+        case LED_EFFECT_BREATHING:
+            ret = apply_effect_breathing(engine, effect, layer);
+            break;
+        case LED_EFFECT_FLOWING:
+            ret = apply_effect_flowing(engine, effect, layer);
+            break;
+        case LED_EFFECT_BLINK:
+            ret = apply_effect_blink(engine, effect, layer);
+            break;
+        case LED_EFFECT_RAINBOW:
+            ret = apply_effect_rainbow(engine, effect, layer);
+            break;
+        case LED_EFFECT_WAVE:
+            ret = apply_effect_wave(engine, effect, layer);
+            break;
+        case LED_EFFECT_TIMELINE:
+            ret = apply_effect_timeline(engine, effect, layer);
+            break;
+        default:
+            break;
+    }
+    if (ret != 0) {
+        return;
+    }
+
+    uint32_t count = effect->config.led_count;
+    uint32_t mask = ((count >= 32) ? 0xFFFFFFFFu : ((1u << count) - 1)) << effect->config.led_start;
+    if (effect->config.led_mask) {
+        mask &= effect->config.led_mask;
+    }
+    if (effect->config.type == LED_EFFECT_TIMELINE) {
+        mask &= engine->layer_cover << effect->config.led_start;
+    }
+    uint8_t opacity = effect->config.opacity ? effect->config.opacity : 255;
+
+    for (uint32_t i = 0; i < engine->led_count; i++) {
+        if (!(mask & (1u << i))) {
+            continue;
+        }
+        uint32_t dst = engine->led_buffer[i];
+        switch (effect->config.blend) {
+            case LED_BLEND_ADD:
+                dst = led_color_add(dst, layer[i]);
+                break;
+            case LED_BLEND_ALPHA:
+                dst = led_color_lerp(dst, layer[i], opacity);
+                break;
+            case LED_BLEND_LIGHTEN:
+                dst = led_color_max(dst, layer[i]);
+                break;
+            default:
+                dst = layer[i];
+                break;
+        }
+        engine->led_buffer[i] = dst;
+    }
+}
+
+/* 手动设置的LED覆盖下方各层，按键反馈层在其之上 */
+static void led_compose_manual(led_engine_t *engine)
+{
+    for (uint32_t i = 0; i < engine->led_count; i++) {
+        if (engine->manual_led_mask[i]) {
+            engine->led_buffer[i] = engine->manual_led_buffer[i];
+        }
+    }
+}
+
+void led_engine_render(led_engine_t *engine, uint32_t now_ms, uint32_t *out)
+{
+    led_engine_effect_t *order[LED_EFFECT_POOL_SIZE];
+    int order_count = 0;
+
+    // 清空LED缓冲区
+    memset(engine->led_buffer, 0, engine->led_count * sizeof(uint32_t));
+
+    // 推进所有活动效果，并按合成顺序插入排序
+    for (int i = 0; i < LED_EFFECT_POOL_SIZE; i++) {
+        led_engine_effect_t *effect = &engine->effects[i];
+
+        if (!effect->active || effect->state != LED_EFFECT_STATE_RUNNING) {
+            continue;
+        }
+
+        // 检查效果是否超时
+        if (effect->config.duration_ms > 0 && now_ms - effect->start_ms >= effect->config.duration_ms) {
+            effect->state = LED_EFFECT_STATE_FINISHED;
+            effect->active = false;
+            continue;
+        }
+
+        // 更新效果内部计时器
+        uint32_t delta_ms = now_ms - effect->last_update_ms;
+        effect->effect_tick += delta_ms;
+        effect->phase += delta_ms * effect->phase_step;
+        effect->last_update_ms = now_ms;
+
+        int pos = order_count++;
+        while (pos > 0 && led_effect_before(effect, order[pos - 1])) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = effect;
+    }
+
+    // 从低层到高层合成，手动设置的LED插在OVERLAY层之后
+    bool manual_done = false;
+    for (int k = 0; k < order_count; k++) {
+        if (!manual_done && order[k]->config.layer > LED_LAYER_OVERLAY) {
+            led_compose_manual(engine);
+            manual_done = true;
+        }
+        led_compose_effect(engine, order[k]);
+    }
+    if (!manual_done) {
+        led_compose_manual(engine);
+    }
+
+    // 应用全局亮度
+    const uint8_t *lut = engine->brightness_lut;
+    for (uint32_t i = 0; i < engine->led_count; i++) {
+        uint32_t c = engine->led_buffer[i];
+        out[i] = RGB_MAKE_COLOR(lut[RGB_GET_RED(c)], lut[RGB_GET_GREEN(c)], lut[RGB_GET_BLUE(c)]);
+    }
+}
+
+/* 效果的输出下一次变化距now_ms的毫秒数，不会再变化时返回LED_NO_DEADLINE */
+static uint32_t led_effect_next_change_ms(const led_engine_effect_t *effect, uint32_t now_ms)
+{
+    uint32_t next = LED_NO_DEADLINE;
+    uint32_t period = effect->config.period_ms;
+
+    if (effect->config.duration_ms > 0) {
+        uint32_t elapsed_ms = now_ms - effect->start_ms;
+        next = (elapsed_ms < effect->config.duration_ms) ? effect->config.duration_ms - elapsed_ms : 0;
+    }
+
+    uint32_t change = LED_NO_DEADLINE;
+    switch (effect->config.type) {
+        case LED_EFFECT_STATIC:
+            break;
+        case LED_EFFECT_FLOWING:
+            // 点亮的LED在周期的led_count等分点上切换
+            if (period > 0 && effect->config.led_count > 0) {
+                uint32_t n = effect->config.led_count;
+                uint32_t pos = effect->effect_tick % period;
+                if (effect->config.reverse) {
+                    uint32_t left = period - 1 - pos;
+                    uint32_t step = left * n / period;
+                    change = left - (step * period + n - 1) / n + 1;
+                } else {
+                    uint32_t step = pos * n / period + 1;
+                    change = (step * period + n - 1) / n - pos;
+                }
+            }
+            break;
+        case LED_EFFECT_BLINK:
+            // 亮灭只在半周期和周期末切换
+            if (period > 0) {
+                uint32_t pos = effect->effect_tick % period;
+                change = (pos < period / 2) ? period / 2 - pos : period - pos;
+            }
+            break;
+        default:
+            // 呼吸、彩虹、波浪和自定义效果每帧都在变化
+            change = LED_SMOOTH_FRAME_MS;
+            break;
+    }
+
+    if (change == 0) {
+        change = 1;
+    }
+    return (change < next) ? change : next;
+}
+
+uint32_t led_engine_next_change_ms(const led_engine_t *engine, uint32_t now_ms)
+{
+    uint32_t earliest = LED_NO_DEADLINE;
+
+    for (int i = 0; i < LED_EFFECT_POOL_SIZE; i++) {
+        const led_engine_effect_t *effect = &engine->effects[i];
+        if (!effect->active || effect->state != LED_EFFECT_STATE_RUNNING) {
+            continue;
+        }
+        uint32_t next = led_effect_next_change_ms(effect, now_ms);
+        if (next < earliest) {
+            earliest = next;
+        }
+    }
+    return earliest;
+}
+
+int led_engine_active_count(const led_engine_t *engine, int *feedback)
+{
+    int effects = 0, fb = 0;
+
+    for (int i = 0; i < LED_EFFECT_POOL_SIZE; i++) {
+        if (engine->effects[i].active) {
+            effects++;
+            fb += engine->effects[i].feedback ? 1 : 0;
+        }
+    }
+    if (feedback) {
+        *feedback = fb;
+    }
+    return effects;
+}
+
+/* LED效果渲染函数实现 */
+
+/* 静态效果 */
+static int apply_effect_static(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer)
+{
+    uint32_t color = effect->config.color_count > 0 ? effect->config.colors[0] : RGB_COLOR_WHITE;
+    color = led_color_scale(color, effect->config.brightness);
+
+    for (int i = effect->config.led_start; i < effect->config.led_start + effect->config.led_count; i++) {
+        if (i < (int)engine->led_count) {
+            buffer[i] = color;
+        }
+    }
+    return 0;
+}
+
+/* 呼吸灯效果 */
+static int apply_effect_breathing(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer)
+{
+    if (effect->config.color_count < 1) return -1;
+
+    uint8_t intensity = led_sin8(effect->phase);
+    uint32_t color = led_color_scale(effect->config.colors[0],
+                                     led_scale8(intensity, effect->config.brightness));
+
+    for (int i = effect->config.led_start; i < effect->config.led_start + effect->config.led_count; i++) {
+        if (i < (int)engine->led_count) {
+            buffer[i] = color;
+        }
+    }
+    return 0;
+}
+
+/* 流水灯效果 */
+static int apply_effect_flowing(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer)
+{
+    uint32_t period = effect->config.period_ms;
+    if (effect->config.color_count < 1 || period == 0) return -1;
+
+    uint32_t cycle_pos = effect->effect_tick % period;
+
+    // 反向时从最后一个LED开始，周期起点落在范围内
+    if (effect->config.reverse) {
+        cycle_pos = period - 1 - cycle_pos;
+    }
+
+    int active_led = (int)(cycle_pos * effect->config.led_count / period);
+    uint32_t color = led_color_scale(effect->config.colors[0], effect->config.brightness);
+
+    // 清除范围内的LED
+    for (int i = effect->config.led_start; i < effect->config.led_start + effect->config.led_count; i++) {
+        if (i < (int)engine->led_count) {
+            buffer[i] = RGB_COLOR_BLACK;
+        }
+    }
+
+    // 点亮当前LED
+    int led_index = effect->config.led_start + active_led;
+    if (led_index < (int)engine->led_count && led_index >= effect->config.led_start) {
+        buffer[led_index] = color;
+    }
+    return 0;
+}
+
+/* 闪烁效果 */
+static int apply_effect_blink(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer)
+{
+    if (effect->config.color_count < 1 || effect->config.period_ms == 0) return -1;
+
+    uint32_t cycle_pos = effect->effect_tick % effect->config.period_ms;
+    bool is_on = cycle_pos < (effect->config.period_ms / 2);
+
+    uint32_t color = is_on ? led_color_scale(effect->config.colors[0], effect->config.brightness)
+                           : RGB_COLOR_BLACK;
+
+    for (int i = effect->config.led_start; i < effect->config.led_start + effect->config.led_count; i++) {
+        if (i < (int)engine->led_count) {
+            buffer[i] = color;
+        }
+    }
+    return 0;
+}
+
+/* 彩虹效果：色相随相位旋转，范围内的LED均分一圈色相 */
+static int apply_effect_rainbow(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer)
+{
+    uint32_t count = effect->config.led_count;
+    uint8_t base_hue = (uint8_t)(effect->phase >> 24);
+
+    for (uint32_t n = 0; n < count; n++) {
+        int i = effect->config.led_start + n;
+        if (i >= (int)engine->led_count) {
+            break;
+        }
+        uint8_t hue_offset = (uint8_t)(n * 256 / count);
+        uint8_t hue = effect->config.reverse ? (uint8_t)(base_hue - hue_offset) : (uint8_t)(base_hue + hue_offset);
+        buffer[i] = led_hsv_to_rgb(hue, 255, effect->config.brightness);
+    }
+    return 0;
+}
+
+/* 波浪效果：亮度按正弦沿LED传播，相邻LED相差一周的1/led_count */
+static int apply_effect_wave(const led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer)
+{
+    if (effect->config.color_count < 1) return -1;
+
+    uint32_t count = effect->config.led_count;
+    uint32_t spacing = (count > 0) ? (uint32_t)(((uint64_t)1 << 32) / count) : 0;
+
+    for (uint32_t n = 0; n < count; n++) {
+        int i = effect->config.led_start + n;
+        if (i >= (int)engine->led_count) {
+            break;
+        }
+        uint32_t offset = n * spacing;
+        uint32_t phase = effect->config.reverse ? effect->phase + offset : effect->phase - offset;
+        uint8_t intensity = led_scale8(led_sin8(phase), effect->config.brightness);
+        buffer[i] = led_color_scale(effect->config.colors[0], intensity);
+    }
+    return 0;
+}
+
+/* 时间线效果：由字节码解释器求各LED颜色，尚无关键帧涉及的LED保持透明 */
+static int apply_effect_timeline(led_engine_t *engine, const led_engine_effect_t *effect, uint32_t *buffer)
+{
+    uint32_t start = effect->config.led_start;
+
+    engine->layer_cover = led_timeline_slot_eval(effect->config.timeline, effect->effect_tick,
+                                                 effect->config.led_count, &buffer[start]);
+    if (!engine->layer_cover) {
+        return -1;
+    }
+
+    for (uint32_t m = engine->layer_cover; m; m &= m - 1) {
+        uint32_t n = __builtin_ctz(m);
+        buffer[start + n] = led_color_scale(buffer[start + n], effect->config.brightness);
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+#ifndef LED_ENGINE_H
+#define LED_ENGINE_H
+
+/**
+ * @file led_engine.h
+ * @brief LED效果引擎：效果池、效果内核、分层合成和下一帧时间计算
+ *
+ * 引擎只按调用方给的毫秒时间推进，渲染结果写到调用方的帧数组，不访问
+ * 硬件也不创建线程。固件里由led_effects_manager在LED线程中驱动并把帧
+ * 写入drv_rgbled；主机上led_render直接驱动它生成黄金帧和测量耗时。
+ * 所有函数都不是线程安全的，同一个引擎只能在一个线程中使用。
+ */
+
+#include "led_effects_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 板上LED数量，缓冲区按此静态分配 */
+#ifndef BSP_RGB_LED_COUNT
+#define BSP_RGB_LED_COUNT       3
+#endif
+#define LED_MAX_COUNT           BSP_RGB_LED_COUNT
+
+/* 效果池大小，所有效果槽都在引擎中静态分配 */
+#ifndef LED_EFFECT_POOL_SIZE
+#define LED_EFFECT_POOL_SIZE    8
+#endif
+
+/* 按键反馈每个LED最多占一个槽，这些槽预留出来，其他效果占满池子时反馈照样能启动 */
+#define LED_FEEDBACK_SLOTS      LED_MAX_COUNT
+
+#if LED_MAX_COUNT > 32
+#error "LED layer masks support at most 32 LEDs"
+#endif
+
+#if LED_EFFECT_POOL_SIZE <= LED_FEEDBACK_SLOTS
+#error "LED_EFFECT_POOL_SIZE must be larger than BSP_RGB_LED_COUNT"
+#endif
+
+#define LED_SMOOTH_FRAME_MS     15      // 连续变化效果（呼吸、彩虹等）的帧间隔，约66Hz
+#define LED_NO_DEADLINE         0xFFFFFFFFu
+
+/* 效果槽 */
+typedef struct {
+    led_effect_config_t config;
+    led_effect_state_t state;
+    uint32_t start_ms;
+    uint32_t last_update_ms;
+    uint32_t effect_tick;       // 效果已运行的毫秒数
+    uint32_t phase;             // 周期内相位，2^32为一周
+    uint32_t phase_step;        // 每毫秒的相位增量
+    bool active;
+    bool feedback;              // 占用预留的按键反馈槽
+    int id;
+} led_engine_effect_t;
+
+typedef struct {
+    led_engine_effect_t effects[LED_EFFECT_POOL_SIZE];
+    uint32_t led_buffer[LED_MAX_COUNT];     // 合成结果，全局亮度之前
+    uint32_t layer_buffer[LED_MAX_COUNT];   // 单个效果的渲染结果，按混合方式合成到led_buffer
+    uint32_t layer_cover;                   // 时间线已有关键帧涉及的LED，相对led_start
+    uint32_t manual_led_buffer[LED_MAX_COUNT];
+    bool manual_led_mask[LED_MAX_COUNT];
+    uint32_t led_count;
+    uint8_t brightness;
+    uint8_t brightness_lut[256];            // 全局亮度缩放与gamma校正合成的通道表
+    int next_effect_id;
+    uint32_t evictions;                     // 池满时被更高优先级挤掉的效果数
+    uint32_t rejected;                      // 池满且没有更低优先级效果而启动失败的次数
+} led_engine_t;
+
+/* led_count超过LED_MAX_COUNT或为0时按LED_MAX_COUNT处理，全局亮度为255 */
+void led_engine_init(led_engine_t *engine, uint32_t led_count);
+
+/**
+ * @brief 启动效果，参数超出LED范围时修正到范围内
+ * @return 效果ID，池满且没有可挤掉的效果时返回-1
+ */
+int led_engine_start(led_engine_t *engine, const led_effect_config_t *config, uint32_t now_ms);
+
+/**
+ * @brief 按键反馈：在FEEDBACK层闪烁一个LED，绑定了反馈时间线时播放时间线。
+ *        同一LED上的反馈重新开始，并清除该LED的手动设置
+ * @return 效果ID，led_index越界时返回-1
+ */
+int led_engine_feedback(led_engine_t *engine, int led_index, uint32_t color,
+                        uint32_t duration_ms, uint32_t now_ms);
+
+/* 效果不存在时返回false */
+bool led_engine_stop(led_engine_t *engine, int id);
+
+/* 效果还在运行时返回true，到时结束、被停止或被挤掉后返回false */
+bool led_engine_is_running(const led_engine_t *engine, int id);
+
+/* 停止按键反馈以外的所有效果 */
+void led_engine_stop_all(led_engine_t *engine);
+
+/* 手动设置LED，位于OVERLAY与FEEDBACK层之间。led_index越界时返回false */
+bool led_engine_set_manual(led_engine_t *engine, uint32_t led_index, uint32_t color);
+void led_engine_set_manual_all(led_engine_t *engine, uint32_t color);
+
+void led_engine_set_brightness(led_engine_t *engine, uint8_t brightness);
+
+/**
+ * @brief 推进到now_ms并渲染一帧
+ * @param out 输出led_count个颜色，已叠加全局亮度和gamma校正
+ */
+void led_engine_render(led_engine_t *engine, uint32_t now_ms, uint32_t *out);
+
+/* 输出下一次变化距now_ms的毫秒数，不会再变化时返回LED_NO_DEADLINE */
+uint32_t led_engine_next_change_ms(const led_engine_t *engine, uint32_t now_ms);
+
+/* 运行中的效果数，feedback输出其中按键反馈的个数，可为NULL */
+int led_engine_active_count(const led_engine_t *engine, int *feedback);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LED_ENGINE_H */
@@ -0,0 +1,74 @@
+#ifndef LED_MATH_H
+#define LED_MATH_H
+
+/**
+ * @file led_math.h
+ * @brief LED效果用的定点数学：正弦/三角波、8位缩放、颜色插值、HSV转RGB和gamma表
+ *
+ * 相位用32位无符号数表示一个周期（0..2^32对应0..360度），累加时自然回绕，
+ * 不需要取模。颜色格式与drv_rgbled一致，为0xRRGGBB。只依赖stdint，
+ * 主机工具可以直接编译。
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const uint8_t led_sin8_lut[256];
+extern const uint8_t led_gamma8_lut[256];
+
+/* 周期为period_ms时每毫秒的相位增量 */
+uint32_t led_phase_step(uint32_t period_ms);
+
+/* 0..255的正弦，相位0处为中值128附近，查表后在相邻两项间线性插值 */
+uint8_t led_sin8(uint32_t phase);
+
+/* 0..255..0的三角波，相位0处为0 */
+uint8_t led_tri8(uint32_t phase);
+
+/* 色相0..255一圈，饱和度和明度0..255 */
+uint32_t led_hsv_to_rgb(uint8_t h, uint8_t s, uint8_t v);
+
+/* ratio为0时得到color1，255时得到color2 */
+uint32_t led_color_lerp(uint32_t color1, uint32_t color2, uint8_t ratio);
+
+/* v * scale / 255，scale为255时不变、为0时为0 */
+static inline uint8_t led_scale8(uint8_t v, uint8_t scale)
+{
+    return (uint8_t)(((uint32_t)v * ((uint32_t)scale + 1)) >> 8);
+}
+
+static inline uint32_t led_color_scale(uint32_t color, uint8_t scale)
+{
+    return ((uint32_t)led_scale8((color >> 16) & 0xFF, scale) << 16) |
+           ((uint32_t)led_scale8((color >> 8) & 0xFF, scale) << 8) |
+           (uint32_t)led_scale8(color & 0xFF, scale);
+}
+
+/* 逐通道饱和相加 */
+static inline uint32_t led_color_add(uint32_t a, uint32_t b)
+{
+    uint32_t r = ((a >> 16) & 0xFF) + ((b >> 16) & 0xFF);
+    uint32_t g = ((a >> 8) & 0xFF) + ((b >> 8) & 0xFF);
+    uint32_t bl = (a & 0xFF) + (b & 0xFF);
+
+    return ((r > 255 ? 255 : r) << 16) | ((g > 255 ? 255 : g) << 8) | (bl > 255 ? 255 : bl);
+}
+
+/* 逐通道取最大值 */
+static inline uint32_t led_color_max(uint32_t a, uint32_t b)
+{
+    uint32_t r = ((a >> 16) & 0xFF) > ((b >> 16) & 0xFF) ? (a & 0xFF0000) : (b & 0xFF0000);
+    uint32_t g = ((a >> 8) & 0xFF) > ((b >> 8) & 0xFF) ? (a & 0x00FF00) : (b & 0x00FF00);
+    uint32_t bl = (a & 0xFF) > (b & 0xFF) ? (a & 0x0000FF) : (b & 0x0000FF);
+
+    return r | g | bl;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LED_MATH_H */
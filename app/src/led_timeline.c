@@ -0,0 +1,600 @@
+#include "led_timeline.h"
+#include "led_math.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define TIMELINE_OP_KEY         0x10
+#define TIMELINE_OP_KEY_SAME    0x20
+#define TIMELINE_OP_END         0x00
+#define TIMELINE_MAX_LEDS       32
+#define TIMELINE_ITEM_MAX_LEN   48
+
+static const char *const g_ease_names[LED_EASE_MAX] = {
+    "step", "linear", "in", "out", "inout", "sine"
+};
+
+static int put_varint(uint8_t *out, uint32_t size, uint32_t *pos, uint32_t v)
+{
+    do {
+        if (*pos >= size) {
+            return -RT_EFULL;
+        }
+        uint8_t b = v & 0x7F;
+        v >>= 7;
+        out[(*pos)++] = b | (v ? 0x80 : 0);
+    } while (v);
+    return 0;
+}
+
+static int get_varint(const uint8_t *code, uint32_t len, uint32_t *pos, uint32_t *v)
+{
+    uint32_t result = 0;
+
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*pos >= len) {
+            return -RT_EINVAL;
+        }
+        uint8_t b = code[(*pos)++];
+        result |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = result;
+            return 0;
+        }
+    }
+    return -RT_EINVAL;
+}
+
+/* 解析一个关键帧「时间,掩码,RRGGBB[,缓动]」 */
+static int parse_keyframe(const char *item, uint32_t *t, uint32_t *mask, uint32_t *color, uint8_t *ease)
+{
+    char *end;
+
+    *t = strtoul(item, &end, 10);
+    if (end == item || *end != ',') {
+        return -RT_EINVAL;
+    }
+    item = end + 1;
+    *mask = strtoul(item, &end, 0);
+    if (end == item || *end != ',' || *mask == 0) {
+        return -RT_EINVAL;
+    }
+    item = end + 1;
+    *color = strtoul(item, &end, 16);
+    if (end - item != 6) {
+        return -RT_EINVAL;
+    }
+
+    *ease = LED_EASE_LINEAR;
+    if (*end == ',') {
+        item = end + 1;
+        int i;
+        for (i = 0; i < LED_EASE_MAX; i++) {
+            if (strcmp(item, g_ease_names[i]) == 0) {
+                break;
+            }
+        }
+        if (i == LED_EASE_MAX) {
+            return -RT_EINVAL;
+        }
+        *ease = (uint8_t)i;
+    } else if (*end != '\0') {
+        return -RT_EINVAL;
+    }
+    return 0;
+}
+
+int led_timeline_compile(const char *src, uint8_t *out, uint32_t out_size)
+{
+    if (!src || !out || out_size < 3) {
+        return -RT_EINVAL;
+    }
+
+    while (*src == ' ') {
+        src++;
+    }
+
+    uint8_t flags;
+    if (strncmp(src, "once;", 5) == 0) {
+        flags = 0;
+    } else if (strncmp(src, "loop;", 5) == 0) {
+        flags = LED_TIMELINE_FLAG_LOOP;
+    } else {
+        return -RT_EINVAL;
+    }
+    src += 5;
+
+    uint32_t pos = 0;
+    out[pos++] = LED_TIMELINE_MAGIC;
+    out[pos++] = flags;
+
+    uint32_t last_t = 0;
+    uint32_t last_color = 0;
+    int count = 0;
+
+    while (*src) {
+        const char *sep = strchr(src, ';');
+        size_t item_len = sep ? (size_t)(sep - src) : strlen(src);
+        char item[TIMELINE_ITEM_MAX_LEN];
+
+        if (item_len >= sizeof(item)) {
+            return -RT_EINVAL;
+        }
+        if (item_len > 0) {
+            uint32_t t, mask, color;
+            uint8_t ease;
+
+            memcpy(item, src, item_len);
+            item[item_len] = '\0';
+            if (parse_keyframe(item, &t, &mask, &color, &ease) != 0 || t < last_t) {
+                return -RT_EINVAL;
+            }
+
+            bool same = (count > 0 && color == last_color);
+            if (pos >= out_size) {
+                return -RT_EFULL;
+            }
+            out[pos++] = (same ? TIMELINE_OP_KEY_SAME : TIMELINE_OP_KEY) | ease;
+            if (put_varint(out, out_size, &pos, t - last_t) != 0 ||
+                put_varint(out, out_size, &pos, mask) != 0) {
+                return -RT_EFULL;
+            }
+            if (!same) {
+                if (pos + 3 > out_size) {
+                    return -RT_EFULL;
+                }
+                out[pos++] = (color >> 16) & 0xFF;
+                out[pos++] = (color >> 8) & 0xFF;
+                out[pos++] = color & 0xFF;
+            }
+            last_t = t;
+            last_color = color;
+            count++;
+        }
+        if (!sep) {
+            break;
+        }
+        src = sep + 1;
+    }
+
+    if (count == 0) {
+        return -RT_EINVAL;
+    }
+    if (pos >= out_size) {
+        return -RT_EFULL;
+    }
+    out[pos++] = TIMELINE_OP_END;
+    return (int)pos;
+}
+
+/* 读一个关键帧，*t为累计时间，颜色只在带颜色的关键帧中更新 */
+static int read_keyframe(const uint8_t *code, uint32_t len, uint32_t *pos,
+                         uint32_t *t, uint32_t *mask, uint32_t *color, uint8_t *ease)
+{
+    uint8_t op = code[(*pos)++];
+    uint32_t dt;
+
+    *ease = op & 0x0F;
+    if (get_varint(code, len, pos, &dt) != 0 || get_varint(code, len, pos, mask) != 0) {
+        return -RT_EINVAL;
+    }
+    if ((op & 0xF0) == TIMELINE_OP_KEY) {
+        if (*pos + 3 > len) {
+            return -RT_EINVAL;
+        }
+        *color = ((uint32_t)code[*pos] << 16) | ((uint32_t)code[*pos + 1] << 8) | code[*pos + 2];
+        *pos += 3;
+    }
+    *t += dt;
+    return 0;
+}
+
+int led_timeline_validate(const uint8_t *code, uint32_t len, uint32_t *duration_ms)
+{
+    if (!code || len < 3 || code[0] != LED_TIMELINE_MAGIC) {
+        return -RT_EINVAL;
+    }
+
+    uint32_t pos = 2;
+    uint32_t t = 0, mask, color = 0;
+    uint8_t ease;
+    int count = 0;
+
+    while (pos < len) {
+        uint8_t op = code[pos];
+        if (op == TIMELINE_OP_END) {
+            if (count == 0) {
+                return -RT_EINVAL;
+            }
+            if (duration_ms) {
+                *duration_ms = t;
+            }
+            return 0;
+        }
+        if (((op & 0xF0) != TIMELINE_OP_KEY && (op & 0xF0) != TIMELINE_OP_KEY_SAME) ||
+            (op & 0x0F) >= LED_EASE_MAX ||
+            ((op & 0xF0) == TIMELINE_OP_KEY_SAME && count == 0)) {
+            return -RT_EINVAL;
+        }
+        uint32_t prev_t = t;
+        if (read_keyframe(code, len, &pos, &t, &mask, &color, &ease) != 0 || t < prev_t) {
+            return -RT_EINVAL;
+        }
+        count++;
+    }
+    return -RT_EINVAL;      // 缺少结束符
+}
+
+bool led_timeline_loops(const uint8_t *code)
+{
+    return (code[1] & LED_TIMELINE_FLAG_LOOP) != 0;
+}
+
+static uint8_t ease8(uint8_t ease, uint8_t x)
+{
+    uint32_t v = x;
+
+    switch (ease) {
+        case LED_EASE_STEP:
+            return 0;
+        case LED_EASE_IN:
+            return (uint8_t)(v * v / 255);
+        case LED_EASE_OUT:
+            return (uint8_t)(255 - (255 - v) * (255 - v) / 255);
+        case LED_EASE_IN_OUT:
+            return (uint8_t)(v * v * (765 - 2 * v) / 65025);
+        case LED_EASE_SINE:
+            return led_sin8((v << 23) - 0x40000000u);
+        default:
+            return x;
+    }
+}
+
+uint32_t led_timeline_eval(const uint8_t *code, uint32_t len, uint32_t duration_ms,
+                           uint32_t t_ms, uint32_t led_count, uint32_t *out)
+{
+    uint32_t prev_t[TIMELINE_MAX_LEDS];
+    uint32_t next_t[TIMELINE_MAX_LEDS];
+    uint32_t next_c[TIMELINE_MAX_LEDS];
+    uint8_t next_ease[TIMELINE_MAX_LEDS];
+    uint32_t have_prev = 0, have_next = 0;
+
+    if (led_count > TIMELINE_MAX_LEDS) {
+        led_count = TIMELINE_MAX_LEDS;
+    }
+    uint32_t all = (led_count >= 32) ? 0xFFFFFFFFu : ((1u << led_count) - 1);
+
+    if (led_timeline_loops(code) && duration_ms > 0) {
+        t_ms %= duration_ms;
+    }
+
+    uint32_t pos = 2;
+    uint32_t t = 0, mask, color = 0;
+    uint8_t ease;
+
+    while (pos < len && code[pos] != TIMELINE_OP_END) {
+        if (read_keyframe(code, len, &pos, &t, &mask, &color, &ease) != 0) {
+            break;
+        }
+        mask &= all;
+        if (t <= t_ms) {
+            for (uint32_t m = mask; m; m &= m - 1) {
+                int n = __builtin_ctz(m);
+                out[n] = color;
+                prev_t[n] = t;
+            }
+            have_prev |= mask;
+        } else {
+            for (uint32_t m = mask & ~have_next; m; m &= m - 1) {
+                int n = __builtin_ctz(m);
+                next_t[n] = t;
+                next_c[n] = color;
+                next_ease[n] = ease;
+            }
+            have_next |= mask;
+            if (have_next == all) {
+                break;      // 所有LED的终点都已找到
+            }
+        }
+    }
+
+    for (uint32_t m = have_prev & have_next; m; m &= m - 1) {
+        int n = __builtin_ctz(m);
+        uint32_t x = (t_ms - prev_t[n]) * 256 / (next_t[n] - prev_t[n]);
+        out[n] = led_color_lerp(out[n], next_c[n], ease8(next_ease[n], (uint8_t)x));
+    }
+    return have_prev;
+}
+
+/* ---- 槽位 ---- */
+
+/* 槽位内容和反馈绑定，整体复制到flash记录中 */
+typedef struct {
+    int8_t feedback_slot;
+    uint8_t reserved[3];
+    uint16_t len[LED_TIMELINE_SLOTS];
+    uint8_t code[LED_TIMELINE_SLOTS][LED_TIMELINE_MAX_BYTES];
+} led_timeline_store_t;
+
+static struct {
+    led_timeline_store_t store;
+    uint32_t duration_ms[LED_TIMELINE_SLOTS];
+    rt_mutex_t lock;
+} g_timeline = {0};
+
+#ifdef LED_TIMELINE_USING_FLASH
+#include "drv_flash.h"
+#include "flash_worker.h"
+
+/*
+ * 两个扇区轮流写入带序号和CRC的完整记录，上电时取序号较新的有效记录。
+ * 擦写时掉电只会损坏正在写的扇区，另一个扇区仍是上一次保存的内容。
+ * 修改只更新内存中的槽位并向flash_worker投递带延时的保存，在锁外合并写入，
+ * 连续上传只写一次，两次擦写之间至少间隔LED_TIMELINE_SAVE_MIN_INTERVAL_MS。
+ */
+#define TIMELINE_FLASH_SECTOR_SIZE          4096
+#define TIMELINE_RECORD_MAGIC               0x4C544C32      // "LTL2"
+#define LED_TIMELINE_SAVE_DELAY_MS          2000            // 最后一次修改后等待这么久再保存
+#define LED_TIMELINE_SAVE_MIN_INTERVAL_MS   10000
+
+#if LED_TIMELINE_SLOTS * (LED_TIMELINE_MAX_BYTES + 2) + 20 > TIMELINE_FLASH_SECTOR_SIZE
+#error "LED timeline slots do not fit in one flash sector"
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;
+    led_timeline_store_t store;
+    uint32_t crc32;             /* 覆盖crc32之前的全部字节 */
+} led_timeline_record_t;
+
+#define TIMELINE_RECORD_CRC_LEN     offsetof(led_timeline_record_t, crc32)
+
+static struct {
+    led_timeline_record_t record;   // 恢复和保存线程共用，保存时在锁外写flash
+    led_timeline_record_t verify;
+    uint32_t sequence;              // 最新有效记录的序号
+    uint8_t next_sector;            // 下一次写入的扇区，总是不含最新记录的那个
+    bool dirty;                     // 内存中有未保存的修改，受g_timeline.lock保护
+    rt_tick_t last_save_tick;
+    uint32_t saves;
+    uint32_t failures;
+} g_flash = {0};
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t sector_addr(uint8_t sector)
+{
+    return LED_TIMELINE_FLASH_ADDR + sector * TIMELINE_FLASH_SECTOR_SIZE;
+}
+
+static bool record_read(uint8_t sector, led_timeline_record_t *rec)
+{
+    return rt_flash_read(sector_addr(sector), (uint8_t *)rec, sizeof(*rec)) == (int)sizeof(*rec) &&
+           rec->magic == TIMELINE_RECORD_MAGIC &&
+           rec->crc32 == crc32_update(0, (const uint8_t *)rec, TIMELINE_RECORD_CRC_LEN);
+}
+
+static void timeline_flash_restore(void)
+{
+    led_timeline_record_t *rec = &g_flash.record;
+    bool valid[2];
+    uint32_t seq[2] = {0};
+
+    for (uint8_t i = 0; i < 2; i++) {
+        valid[i] = record_read(i, rec);
+        seq[i] = rec->sequence;
+    }
+    if (!valid[0] && !valid[1]) {
+        return;
+    }
+    uint8_t newest = (valid[0] && (!valid[1] || (int32_t)(seq[0] - seq[1]) > 0)) ? 0 : 1;
+    if (newest == 0 && !record_read(0, rec)) {
+        return;
+    }
+    g_flash.sequence = seq[newest];
+    g_flash.next_sector = newest ^ 1;
+
+    const led_timeline_store_t *stored = &rec->store;
+    for (int i = 0; i < LED_TIMELINE_SLOTS; i++) {
+        if (stored->len[i] > 0 && stored->len[i] <= LED_TIMELINE_MAX_BYTES &&
+            led_timeline_validate(stored->code[i], stored->len[i], &g_timeline.duration_ms[i]) == 0) {
+            g_timeline.store.len[i] = stored->len[i];
+            memcpy(g_timeline.store.code[i], stored->code[i], stored->len[i]);
+        }
+    }
+    if (stored->feedback_slot >= 0 && stored->feedback_slot < LED_TIMELINE_SLOTS) {
+        g_timeline.store.feedback_slot = stored->feedback_slot;
+    }
+}
+
+/* flash_worker线程中执行：持锁时复制一份，擦写在锁外进行，LED线程求值不受影响 */
+static void timeline_flash_save(void)
+{
+    led_timeline_record_t *rec = &g_flash.record;
+
+    // 距上次擦写不足最小间隔时推迟到间隔期满，期间的修改一并写入
+    rt_tick_t min_gap = rt_tick_from_millisecond(LED_TIMELINE_SAVE_MIN_INTERVAL_MS);
+    rt_tick_t since = rt_tick_get() - g_flash.last_save_tick;
+    if (g_flash.saves + g_flash.failures > 0 && since < min_gap) {
+        flash_worker_post(FLASH_JOB_LED_TIMELINE,
+                          (min_gap - since) * 1000 / RT_TICK_PER_SECOND + 1);
+        return;
+    }
+
+    rt_mutex_take(g_timeline.lock, RT_WAITING_FOREVER);
+    if (!g_flash.dirty) {
+        rt_mutex_release(g_timeline.lock);
+        return;
+    }
+    rec->store = g_timeline.store;
+    g_flash.dirty = false;
+    rt_mutex_release(g_timeline.lock);
+
+    rec->magic = TIMELINE_RECORD_MAGIC;
+    rec->sequence = g_flash.sequence + 1;
+    rec->crc32 = crc32_update(0, (const uint8_t *)rec, TIMELINE_RECORD_CRC_LEN);
+
+    uint32_t addr = sector_addr(g_flash.next_sector);
+    if (rt_flash_erase(addr, TIMELINE_FLASH_SECTOR_SIZE) != 0 ||
+        rt_flash_write(addr, (const uint8_t *)rec, sizeof(*rec)) != (int)sizeof(*rec) ||
+        rt_flash_read(addr, (uint8_t *)&g_flash.verify, sizeof(*rec)) != (int)sizeof(*rec) ||
+        memcmp(&g_flash.verify, rec, sizeof(*rec)) != 0) {
+        // 另一个扇区仍保留上一条记录，下次修改时再试
+        g_flash.failures++;
+        rt_kprintf("[led_tl] flash save failed\n");
+    } else {
+        g_flash.sequence = rec->sequence;
+        g_flash.next_sector ^= 1;
+        g_flash.saves++;
+    }
+    g_flash.last_save_tick = rt_tick_get();
+}
+
+static int timeline_flash_init(void)
+{
+    int ret = flash_worker_init();
+    if (ret == 0) {
+        ret = flash_worker_register(FLASH_JOB_LED_TIMELINE, timeline_flash_save);
+    }
+    return ret;
+}
+
+/* 持锁修改槽位后调用：只做标记，每次修改都把保存推迟LED_TIMELINE_SAVE_DELAY_MS */
+static void timeline_flash_mark_dirty(void)
+{
+    g_flash.dirty = true;
+    flash_worker_post(FLASH_JOB_LED_TIMELINE, LED_TIMELINE_SAVE_DELAY_MS);
+}
+#else
+#define timeline_flash_restore()
+#define timeline_flash_init()       0
+#define timeline_flash_mark_dirty()
+#endif /* LED_TIMELINE_USING_FLASH */
+
+int led_timeline_slots_init(void)
+{
+    if (g_timeline.lock) {
+        return 0;
+    }
+    g_timeline.lock = rt_mutex_create("led_tl", RT_IPC_FLAG_PRIO);
+    if (!g_timeline.lock) {
+        return -RT_ENOMEM;
+    }
+    g_timeline.store.feedback_slot = -1;
+    timeline_flash_restore();
+    return timeline_flash_init();
+}
+
+int led_timeline_slot_load(uint8_t slot, const uint8_t *code, uint32_t len)
+{
+    uint32_t duration_ms;
+
+    if (!g_timeline.lock || slot >= LED_TIMELINE_SLOTS || len > LED_TIMELINE_MAX_BYTES) {
+        return -RT_EINVAL;
+    }
+    if (led_timeline_validate(code, len, &duration_ms) != 0) {
+        return -RT_EINVAL;
+    }
+
+    rt_mutex_take(g_timeline.lock, RT_WAITING_FOREVER);
+    memcpy(g_timeline.store.code[slot], code, len);
+    g_timeline.store.len[slot] = (uint16_t)len;
+    g_timeline.duration_ms[slot] = duration_ms;
+    timeline_flash_mark_dirty();
+    rt_mutex_release(g_timeline.lock);
+    return 0;
+}
+
+int led_timeline_slot_compile(uint8_t slot, const char *src)
+{
+    uint8_t code[LED_TIMELINE_MAX_BYTES];
+    int len = led_timeline_compile(src, code, sizeof(code));
+
+    if (len < 0) {
+        return len;
+    }
+    return led_timeline_slot_load(slot, code, (uint32_t)len);
+}
+
+int led_timeline_slot_clear(uint8_t slot)
+{
+    if (!g_timeline.lock || slot >= LED_TIMELINE_SLOTS) {
+        return -RT_EINVAL;
+    }
+
+    rt_mutex_take(g_timeline.lock, RT_WAITING_FOREVER);
+    g_timeline.store.len[slot] = 0;
+    if (g_timeline.store.feedback_slot == slot) {
+        g_timeline.store.feedback_slot = -1;
+    }
+    timeline_flash_mark_dirty();
+    rt_mutex_release(g_timeline.lock);
+    return 0;
+}
+
+bool led_timeline_slot_info(uint8_t slot, uint32_t *len, uint32_t *duration_ms, bool *loop)
+{
+    if (!g_timeline.lock || slot >= LED_TIMELINE_SLOTS) {
+        return false;
+    }
+
+    rt_mutex_take(g_timeline.lock, RT_WAITING_FOREVER);
+    uint32_t l = g_timeline.store.len[slot];
+    if (len) {
+        *len = l;
+    }
+    if (duration_ms) {
+        *duration_ms = g_timeline.duration_ms[slot];
+    }
+    if (loop) {
+        *loop = l > 0 && led_timeline_loops(g_timeline.store.code[slot]);
+    }
+    rt_mutex_release(g_timeline.lock);
+    return l > 0;
+}
+
+uint32_t led_timeline_slot_eval(uint8_t slot, uint32_t t_ms, uint32_t led_count, uint32_t *out)
+{
+    uint32_t mask = 0;
+
+    if (!g_timeline.lock || slot >= LED_TIMELINE_SLOTS) {
+        return 0;
+    }
+
+    rt_mutex_take(g_timeline.lock, RT_WAITING_FOREVER);
+    if (g_timeline.store.len[slot] > 0) {
+        mask = led_timeline_eval(g_timeline.store.code[slot], g_timeline.store.len[slot],
+                                 g_timeline.duration_ms[slot], t_ms, led_count, out);
+    }
+    rt_mutex_release(g_timeline.lock);
+    return mask;
+}
+
+int led_timeline_get_feedback_slot(void)
+{
+    return g_timeline.lock ? g_timeline.store.feedback_slot : -1;
+}
+
+int led_timeline_set_feedback_slot(int slot)
+{
+    if (!g_timeline.lock || slot < -1 || slot >= LED_TIMELINE_SLOTS) {
+        return -RT_EINVAL;
+    }
+
+    rt_mutex_take(g_timeline.lock, RT_WAITING_FOREVER);
+    g_timeline.store.feedback_slot = (int8_t)slot;
+    timeline_flash_mark_dirty();
+    rt_mutex_release(g_timeline.lock);
+    return 0;
+}
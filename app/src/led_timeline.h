@@ -0,0 +1,106 @@
+#ifndef LED_TIMELINE_H
+#define LED_TIMELINE_H
+
+/**
+ * @file led_timeline.h
+ * @brief LED关键帧时间线：文本编译为紧凑字节码，按时间定点插值求值
+ *
+ * 源文本：「once|loop;关键帧;关键帧;...」，关键帧为「时间ms,LED掩码,RRGGBB[,缓动]」，
+ * 时间不能递减，掩码bit n对应效果范围内第n个LED，缓动为step/linear/in/out/
+ * inout/sine，缺省linear。例如按键反馈的白闪后淡出：
+ *
+ *     once;0,0x1,FFFFFF,step;300,0x1,000000,out
+ *
+ * 每个LED独立成轨：当前时间之前最后一个涉及它的关键帧为起点，之后第一个
+ * 为终点，按终点的缓动插值；还没有关键帧涉及的LED保持透明，不参与合成。
+ * 最后一个关键帧之后保持其颜色，循环的时间线按最后关键帧的时间取模。
+ *
+ * 字节码：
+ *   头      LED_TIMELINE_MAGIC, flags
+ *   关键帧  (0x10 | 缓动) varint时间增量 varint掩码 R G B
+ *           (0x20 | 缓动) varint时间增量 varint掩码            颜色同上一关键帧
+ *   结束    0x00
+ * varint为小端7位分组，最高位表示后面还有字节。
+ */
+
+#include <rtthread.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LED_TIMELINE_MAGIC      0xA7
+#define LED_TIMELINE_FLAG_LOOP  0x01
+
+#ifndef LED_TIMELINE_SLOTS
+#define LED_TIMELINE_SLOTS      4
+#endif
+
+#ifndef LED_TIMELINE_MAX_BYTES
+#define LED_TIMELINE_MAX_BYTES  128
+#endif
+
+typedef enum {
+    LED_EASE_STEP = 0,          // 保持起点颜色，到终点时间再跳变
+    LED_EASE_LINEAR,
+    LED_EASE_IN,                // 二次加速
+    LED_EASE_OUT,               // 二次减速
+    LED_EASE_IN_OUT,            // smoothstep
+    LED_EASE_SINE,              // 半周期余弦
+    LED_EASE_MAX
+} led_ease_t;
+
+/**
+ * @brief 把源文本编译成字节码
+ * @return 字节码长度，源文本有误或out_size不够时返回-RT_EINVAL/-RT_EFULL
+ */
+int led_timeline_compile(const char *src, uint8_t *out, uint32_t out_size);
+
+/**
+ * @brief 检查字节码格式，加载前调用，求值时不再重复检查
+ * @param duration_ms 输出最后一个关键帧的时间，可为NULL
+ */
+int led_timeline_validate(const uint8_t *code, uint32_t len, uint32_t *duration_ms);
+
+bool led_timeline_loops(const uint8_t *code);
+
+/**
+ * @brief 求t_ms时刻前led_count个LED的颜色
+ * @return 已有关键帧涉及的LED掩码，未置位的LED在out中的值无意义
+ */
+uint32_t led_timeline_eval(const uint8_t *code, uint32_t len, uint32_t duration_ms,
+                           uint32_t t_ms, uint32_t led_count, uint32_t *out);
+
+/*
+ * 时间线槽位：串口或finsh线程加载，LED线程按槽位号求值，槽位内容由互斥量保护。
+ * 开启LED_TIMELINE_USING_FLASH时加载的内容和反馈绑定在最后一次修改约2秒后
+ * 由后台线程写入flash，上电后恢复。
+ */
+
+int led_timeline_slots_init(void);
+
+/* 校验后复制到槽位，code可以直接指向flash中的常量 */
+int led_timeline_slot_load(uint8_t slot, const uint8_t *code, uint32_t len);
+
+/* 编译源文本后加载 */
+int led_timeline_slot_compile(uint8_t slot, const char *src);
+
+int led_timeline_slot_clear(uint8_t slot);
+
+/* 槽位已加载时返回true，各输出参数可为NULL */
+bool led_timeline_slot_info(uint8_t slot, uint32_t *len, uint32_t *duration_ms, bool *loop);
+
+/* 同led_timeline_eval，槽位为空时返回0 */
+uint32_t led_timeline_slot_eval(uint8_t slot, uint32_t t_ms, uint32_t led_count, uint32_t *out);
+
+/* 按键反馈使用的槽位，-1表示用固定颜色闪烁 */
+int led_timeline_get_feedback_slot(void);
+int led_timeline_set_feedback_slot(int slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LED_TIMELINE_H */
@@ -19,6 +19,9 @@
 #include <string.h>
 #include "led_effects_manager.h"
 #include "screen_context.h"
+#include "frame_profiler.h"
+#include "flush_planner.h"
+#include "display_idle.h"
 /* 系统线程优先级定义 */
 #define MAIN_THREAD_PRIORITY        20  // 主线程优先级最低
 #define EVENT_BUS_THREAD_PRIORITY   8   // 事件总线高优先级
@@ -62,7 +65,10 @@ static int init_sht30_sensor(void) {
     return -1;
 }
 static int init_screen_system(void) { 
+    flush_planner_init();
     create_triple_screen_display(); 
+    frame_profiler_init();
+    display_idle_init();
     rt_thread_mdelay(10);
     return 0; 
 }
@@ -216,16 +222,27 @@ int main(void)
     
     
     while (g_system_state.system_ready) {
-        // 1. 处理LVGL定时器
-        uint32_t ms = lv_timer_handler();
-        
-        // 2. 处理屏幕切换请求
-        screen_process_switch_request();
+        // 1. 处理屏幕消息和合并后的数据刷新（不阻塞）
+        int processed = screen_process_switch_request();
         screen_context_process_background_restore();
+        display_idle_process();
+        
+        // 2. 界面有变化时立即渲染，不等下一个刷新周期
+        if (processed > 0) {
+            frame_profiler_handler_begin();
+            lv_refr_now(NULL);
+            frame_profiler_handler_end();
+            screen_notify_frame_rendered();
+        }
+        
+        // 3. 处理LVGL定时器，返回距下一个定时器到期的毫秒数
+        frame_profiler_handler_begin();
+        uint32_t ms = lv_timer_handler();
+        frame_profiler_handler_end();
+        frame_profiler_process();
         
-        // 5. 控制主循环频率
-        uint32_t sleep_time = (ms > 0 && ms < 100) ? ms : 50;
-        rt_thread_mdelay(sleep_time);
+        // 4. 睡眠到下一个定时器到期，或被消息/输入提前唤醒
+        screen_wait_for_work(ms);
     }
     
     // 正常退出清理
@@ -0,0 +1,69 @@
+#ifndef PANEL_GRID_H
+#define PANEL_GRID_H
+
+/**
+ * @file panel_grid.h
+ * @brief 拼接屏的面板网格
+ *
+ * 画布由LCD_PANEL_COLS×LCD_PANEL_ROWS块128x128的GC9107按行优先拼成，
+ * 第i块屏位于第(i / COLS)行、第(i % COLS)列。网格形状、各屏CS引脚和旋转
+ * 都在Kconfig中配置，驱动的刷屏计划、界面的面板容器、刷屏规划器和帧统计
+ * 都从这里取面板几何，换更大的拼接屏不需要改代码。
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef LCD_PANEL_COLS
+#define LCD_PANEL_COLS          3
+#endif
+
+#ifndef LCD_PANEL_ROWS
+#define LCD_PANEL_ROWS          1
+#endif
+
+/* 各屏CS引脚（PA编号），按行优先逗号分隔 */
+#ifndef LCD_PANEL_CS_PINS
+#define LCD_PANEL_CS_PINS       "3,2,1"
+#endif
+
+/* 各屏旋转角度（0/90/180/270），未列出的屏为0 */
+#ifndef LCD_PANEL_ROTATIONS
+#define LCD_PANEL_ROTATIONS     "0"
+#endif
+
+#define LCD_PANEL_WIDTH         128
+#define LCD_PANEL_HEIGHT        128
+#define LCD_PANEL_NUM           (LCD_PANEL_COLS * LCD_PANEL_ROWS)
+#define LCD_PANEL_GRID_WIDTH    (LCD_PANEL_COLS * LCD_PANEL_WIDTH)
+#define LCD_PANEL_GRID_HEIGHT   (LCD_PANEL_ROWS * LCD_PANEL_HEIGHT)
+#define LCD_PANEL_ALL_MASK      (0xFFFFFFFFu >> (32 - LCD_PANEL_NUM))
+
+/* 第i块屏左上角在画布上的坐标 */
+#define LCD_PANEL_X(i)          (((i) % LCD_PANEL_COLS) * LCD_PANEL_WIDTH)
+#define LCD_PANEL_Y(i)          (((i) / LCD_PANEL_COLS) * LCD_PANEL_HEIGHT)
+
+#if LCD_PANEL_NUM > 32
+#error "LCD panel grid supports at most 32 panels"
+#endif
+
+/**
+ * @brief 设置面板睡眠掩码（由GC9107驱动实现）
+ *
+ * 驱动用自己的定时器在总线空闲时逐步执行：置位的屏关显示并进入SLEEP IN
+ * （刚唤醒不满120ms的屏到时再睡），清零的屏SLEEP OUT、5ms后重新开显示。
+ * 睡眠和唤醒中的屏不再发送像素，显存保留睡前的内容。任意线程可调用。
+ */
+void lcd_panel_set_sleep_mask(uint32_t mask);
+
+/* 睡眠中或尚未重新开显示的屏，清零后才能刷屏 */
+uint32_t lcd_panel_get_sleep_mask(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PANEL_GRID_H */
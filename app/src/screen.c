@@ -6,6 +6,7 @@
 #include "data_manager.h"
 #include "encoder_controller.h"
 #include "event_bus.h"
+#include "display_idle.h"
 #include <rtthread.h>
 #include <time.h>
 #include <string.h>  
@@ -20,6 +21,11 @@ static int screen_encoder_event_handler(const event_t *event, void *user_data)
     if (event->type == EVENT_ENCODER_ROTATED) {
         const event_data_encoder_t *encoder_data = &event->data.encoder;
         
+        // 熄屏时的旋转只用于唤醒，不切换屏幕组
+        if (display_idle_note_input()) {
+            return 0;
+        }
+        
         // 检查当前层级
         screen_level_t current_level = screen_core_get_current_level();
         
@@ -74,7 +80,7 @@ static int screen_data_event_handler(const event_t *event, void *user_data)
             break;
             
         case EVENT_DATA_STOCK_UPDATED:
-            screen_core_post_update_stock(&event->data.stock.stock);
+            screen_core_post_update_stock(NULL);
             break;
             
         case EVENT_DATA_SYSTEM_UPDATED:
@@ -86,6 +92,19 @@ static int screen_data_event_handler(const event_t *event, void *user_data)
             screen_core_post_update_weather(NULL);
             break;
             
+        /* 过期事件：data_manager发出前已置为无效，UI取数据时灰显 */
+        case EVENT_DATA_WEATHER_EXPIRED:
+            screen_core_post_update_weather(NULL);
+            break;
+            
+        case EVENT_DATA_STOCK_EXPIRED:
+            screen_core_post_update_stock(NULL);
+            break;
+            
+        case EVENT_DATA_SYSTEM_EXPIRED:
+            screen_core_post_update_system(NULL);
+            break;
+            
         default:
             return -1;
     }
@@ -129,6 +148,12 @@ void create_triple_screen_display(void)
                        NULL, EVENT_PRIORITY_NORMAL);
     event_bus_subscribe(EVENT_DATA_SENSOR_UPDATED, screen_data_event_handler, 
                        NULL, EVENT_PRIORITY_NORMAL);
+    event_bus_subscribe(EVENT_DATA_WEATHER_EXPIRED, screen_data_event_handler, 
+                       NULL, EVENT_PRIORITY_NORMAL);
+    event_bus_subscribe(EVENT_DATA_STOCK_EXPIRED, screen_data_event_handler, 
+                       NULL, EVENT_PRIORITY_NORMAL);
+    event_bus_subscribe(EVENT_DATA_SYSTEM_EXPIRED, screen_data_event_handler, 
+                       NULL, EVENT_PRIORITY_NORMAL);
     
     if (encoder_controller_is_ready()) {
         encoder_controller_stop_polling();
@@ -145,6 +170,9 @@ void create_triple_screen_display(void)
         cleanup_triple_screen_display();
         return;
     }
+    /* 立即显示data_manager中已有的数据（含启动时恢复的快照），不等定时器 */
+    screen_core_post_update_weather(NULL);
+    screen_core_post_update_stock(NULL);
     screen_timer_start_group1_timers();
     screen_context_activate_for_group(SCREEN_GROUP_1);
     g_screen_system_initialized = true;
@@ -162,6 +190,9 @@ void cleanup_triple_screen_display(void)
     event_bus_unsubscribe(EVENT_DATA_STOCK_UPDATED, screen_data_event_handler);
     event_bus_unsubscribe(EVENT_DATA_SYSTEM_UPDATED, screen_data_event_handler);
     event_bus_unsubscribe(EVENT_DATA_SENSOR_UPDATED, screen_data_event_handler);
+    event_bus_unsubscribe(EVENT_DATA_WEATHER_EXPIRED, screen_data_event_handler);
+    event_bus_unsubscribe(EVENT_DATA_STOCK_EXPIRED, screen_data_event_handler);
+    event_bus_unsubscribe(EVENT_DATA_SYSTEM_EXPIRED, screen_data_event_handler);
     
     screen_timer_manager_deinit();
 
@@ -203,13 +234,32 @@ void screen_next_group(void)
     screen_core_post_switch_group(next, false);
 }
 
-void screen_process_switch_request(void)
+int screen_process_switch_request(void)
+{
+    if (!g_screen_system_initialized) {
+        return 0;
+    }
+
+    int processed = screen_core_process_messages();
+    return (processed > 0) ? processed : 0;
+}
+
+void screen_notify_frame_rendered(void)
 {
     if (!g_screen_system_initialized) {
         return;
     }
 
-    screen_core_process_messages();
+    screen_ui_note_frame_rendered();
+}
+
+void screen_wait_for_work(uint32_t timeout_ms)
+{
+    /* 没有LVGL定时器时也定期醒来，主循环中的其他检查不至于停摆 */
+    if (timeout_ms > SCREEN_IDLE_WAIT_MAX_MS) {
+        timeout_ms = SCREEN_IDLE_WAIT_MAX_MS;
+    }
+    screen_core_wait(timeout_ms);
 }
 
 /**********************
@@ -244,7 +294,8 @@ int screen_update_stock(const stock_data_t *data)
     int ret = data_manager_update_stock(data);
     if (ret == 0) {
         // 发布事件通知屏幕更新
-        event_data_stock_t stock_event = { .stock = *data };
+        event_data_stock_t stock_event = { .count = 1, .replace = false };
+        stock_event.stocks[0] = *data;
         event_bus_publish(EVENT_DATA_STOCK_UPDATED, &stock_event, sizeof(stock_event),
                          EVENT_PRIORITY_NORMAL, MODULE_ID_SERIAL_COMM);
     }
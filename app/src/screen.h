@@ -5,6 +5,7 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
 #include "screen_types.h"
 
 void create_triple_screen_display(void);
@@ -17,7 +18,14 @@ screen_group_t screen_get_current_group(void);
 
 void screen_next_group(void);
 
-void screen_process_switch_request(void);
+/* 处理屏幕消息和数据刷新（不阻塞），返回处理的数量 */
+int screen_process_switch_request(void);
+
+/* 立即渲染完成后调用，用于统计页面切换耗时 */
+void screen_notify_frame_rendered(void);
+
+/* GUI线程空闲等待：直到timeout_ms（LVGL下一个定时器到期）或有新的消息/输入 */
+void screen_wait_for_work(uint32_t timeout_ms);
 
 int screen_update_weather(const weather_data_t *data);
 
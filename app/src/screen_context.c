@@ -47,8 +47,9 @@ static volatile bool g_need_restore_background = false;
 static void restore_background_timer_callback(void *parameter)
 {
     (void)parameter;
-    /* 在ISR中只设置标志位，不执行任何复杂操作 */
+    /* 在ISR中只设置标志位并唤醒主循环，不执行任何复杂操作 */
     g_need_restore_background = true;
+    screen_core_wakeup(SCREEN_WAKE_CONTEXT);
 }
 
 /* 检查并处理背景恢复 - 在主循环或非ISR上下文调用 */
@@ -192,9 +193,8 @@ static void trigger_key_led_effect(int key_idx, const key_led_binding_t *binding
         return;
     }
     
-    int led_index = binding->led_index;
-    
-    event_bus_publish_led_feedback(binding->led_index, binding->color, 1000);
+    // 直接写入LED命令环，不经过事件总线线程
+    led_effects_feedback(binding->led_index, binding->color, 1000);
 
 }
 
@@ -851,7 +851,7 @@ static int screen_l2_muyu_key_handler(int key_idx, button_action_t action, void
     }
     
     if (binding) {
-        event_bus_publish_led_feedback(binding->led_index, binding->color, 800);
+        led_effects_feedback(binding->led_index, binding->color, 800);
     }
     
     switch (key_idx) {
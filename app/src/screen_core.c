@@ -6,21 +6,24 @@
 #include <time.h>
 #include <string.h>
 
-#define MESSAGE_QUEUE_SIZE 32
-#define MESSAGE_TIMEOUT_MS 100
+#define MESSAGE_QUEUE_SIZE 16      /* 只承载控制消息 */
+#define MESSAGE_BATCH_MAX  10      /* 每次处理的控制消息上限 */
+
+#define UPDATE_BIT(type)   (1u << (type))
 
 /* 静态核心管理器实例 */
 static screen_core_t g_core = {0};
 
 /* 消息处理函数声明 */
 static int process_update_time_message(void);
-static int process_update_weather_message(const weather_data_t *data);
-static int process_update_stock_message(const stock_data_t *data);
-static int process_update_system_message(const system_monitor_data_t *data);
+static int process_update_weather_message(void);
+static int process_update_stock_message(void);
+static int process_update_system_message(void);
 static int process_switch_group_message(const screen_switch_msg_t *msg);
 static int process_enter_l2_message(const screen_l2_enter_msg_t *msg);
 static int process_return_l1_message(void);
 static int process_cleanup_message(void);
+static int process_rotate_stock_message(void);
 
 int screen_core_init(void)
 {
@@ -45,6 +48,16 @@ int screen_core_init(void)
         return -RT_ENOMEM;
     }
     
+    /* 创建GUI线程唤醒事件 */
+    g_core.wake_event = rt_event_create("screen_wake", RT_IPC_FLAG_PRIO);
+    if (!g_core.wake_event) {
+        rt_mutex_delete(g_core.state_lock);
+        g_core.state_lock = NULL;
+        rt_mq_delete(g_core.message_queue);
+        g_core.message_queue = NULL;
+        return -RT_ENOMEM;
+    }
+    
     /* 初始化状态 */
     g_core.current_group = SCREEN_GROUP_1;
     g_core.current_level = SCREEN_LEVEL_1;
@@ -52,7 +65,9 @@ int screen_core_init(void)
     g_core.l2_current_page = SCREEN_L2_TIME_DETAIL;
     g_core.ui_initialized = false;
     g_core.switching_in_progress = false;
+    g_core.pending_updates = 0;
     g_core.messages_processed = 0;
+    g_core.updates_coalesced = 0;
     g_core.switch_count = 0;
     g_core.last_cleanup_time = rt_tick_get();
     
@@ -71,9 +86,39 @@ int screen_core_deinit(void)
         g_core.state_lock = NULL;
     }
     
+    if (g_core.wake_event) {
+        rt_event_delete(g_core.wake_event);
+        g_core.wake_event = NULL;
+    }
+    
     return 0;
 }
 
+void screen_core_wakeup(uint32_t reason)
+{
+    if (g_core.wake_event) {
+        rt_event_send(g_core.wake_event, reason);
+    }
+}
+
+uint32_t screen_core_wait(uint32_t timeout_ms)
+{
+    if (!g_core.wake_event) {
+        rt_thread_mdelay(timeout_ms);
+        return 0;
+    }
+    
+    /* 处理期间到达的唤醒位保留在事件中，这里立即返回，不会丢失 */
+    rt_uint32_t reason = 0;
+    rt_int32_t timeout = (timeout_ms == 0) ? 0 : (rt_int32_t)rt_tick_from_millisecond(timeout_ms);
+    if (rt_event_recv(g_core.wake_event, SCREEN_WAKE_ALL,
+                      RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                      timeout, &reason) != RT_EOK) {
+        return 0;
+    }
+    return reason;
+}
+
 /* 线程安全的消息发送函数 */
 int screen_core_post_switch_group(screen_group_t target_group, bool force)
 {
@@ -92,6 +137,7 @@ int screen_core_post_switch_group(screen_group_t target_group, bool force)
         return -RT_ERROR;
     }
     
+    screen_core_wakeup(SCREEN_WAKE_MESSAGE);
     return 0;
 }
 
@@ -112,6 +158,7 @@ int screen_core_post_enter_l2(screen_l2_group_t l2_group, screen_l2_page_t l2_pa
         return -RT_ERROR;
     }
     
+    screen_core_wakeup(SCREEN_WAKE_MESSAGE);
     return 0;
 }
 
@@ -130,89 +177,69 @@ int screen_core_post_return_l1(void)
         return -RT_ERROR;
     }
     
+    screen_core_wakeup(SCREEN_WAKE_MESSAGE);
     return 0;
 }
 
-int screen_core_post_update_time(void)
+/* 数据刷新类请求只置位，GUI线程处理前的重复请求合并为一次；
+ * 调用方可能是硬件定时器回调，用关中断保护 */
+static int post_pending_update(screen_msg_type_t type)
 {
     if (!g_core.message_queue) {
         return -RT_ERROR;
     }
     
-    screen_message_t msg = {0};
-    msg.type = SCREEN_MSG_UPDATE_TIME;
-    msg.timestamp = rt_tick_get();
+    rt_base_t level = rt_hw_interrupt_disable();
+    if (g_core.pending_updates & UPDATE_BIT(type)) {
+        g_core.updates_coalesced++;
+    }
+    g_core.pending_updates |= UPDATE_BIT(type);
+    rt_hw_interrupt_enable(level);
     
-    rt_err_t result = rt_mq_send(g_core.message_queue, &msg, sizeof(msg));
-    return (result == RT_EOK) ? 0 : -RT_ERROR;
+    screen_core_wakeup(SCREEN_WAKE_UPDATE);
+    return 0;
+}
+
+int screen_core_post_update_time(void)
+{
+    return post_pending_update(SCREEN_MSG_UPDATE_TIME);
 }
 
 int screen_core_post_update_weather(const weather_data_t *data)
 {
-    if (!g_core.message_queue) {
-        return -RT_ERROR;
-    }
-    
-    screen_message_t msg = {0};
-    msg.type = SCREEN_MSG_UPDATE_WEATHER;
-    msg.timestamp = rt_tick_get();
-    
-    if (data) {
-        msg.data.weather_data = *data;
-    }
-    
-    rt_err_t result = rt_mq_send(g_core.message_queue, &msg, sizeof(msg));
-    return (result == RT_EOK) ? 0 : -RT_ERROR;
+    (void)data;
+    return post_pending_update(SCREEN_MSG_UPDATE_WEATHER);
 }
 
 int screen_core_post_update_stock(const stock_data_t *data)
 {
-    if (!g_core.message_queue) {
-        return -RT_ERROR;
-    }
-    
-    screen_message_t msg = {0};
-    msg.type = SCREEN_MSG_UPDATE_STOCK;
-    msg.timestamp = rt_tick_get();
-    
-    if (data) {
-        msg.data.stock_data = *data;
-    }
-    
-    rt_err_t result = rt_mq_send(g_core.message_queue, &msg, sizeof(msg));
-    return (result == RT_EOK) ? 0 : -RT_ERROR;
+    (void)data;
+    return post_pending_update(SCREEN_MSG_UPDATE_STOCK);
 }
 
 int screen_core_post_update_system(const system_monitor_data_t *data)
 {
-    if (!g_core.message_queue) {
-        return -RT_ERROR;
-    }
-    
-    screen_message_t msg = {0};
-    msg.type = SCREEN_MSG_UPDATE_SYSTEM;
-    msg.timestamp = rt_tick_get();
-    
-    if (data) {
-        msg.data.system_data = *data;
-    }
-    
-    rt_err_t result = rt_mq_send(g_core.message_queue, &msg, sizeof(msg));
-    return (result == RT_EOK) ? 0 : -RT_ERROR;
+    (void)data;
+    return post_pending_update(SCREEN_MSG_UPDATE_SYSTEM);
 }
 
 int screen_core_post_cleanup_request(void)
 {
-    if (!g_core.message_queue) {
-        return -RT_ERROR;
-    }
-    
-    screen_message_t msg = {0};
-    msg.type = SCREEN_MSG_CLEANUP_REQUEST;
-    msg.timestamp = rt_tick_get();
-    
-    rt_err_t result = rt_mq_send(g_core.message_queue, &msg, sizeof(msg));
-    return (result == RT_EOK) ? 0 : -RT_ERROR;
+    return post_pending_update(SCREEN_MSG_CLEANUP_REQUEST);
+}
+
+int screen_core_post_rotate_stock(void)
+{
+    return post_pending_update(SCREEN_MSG_ROTATE_STOCK);
+}
+
+static uint32_t take_pending_updates(void)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    uint32_t pending = g_core.pending_updates;
+    g_core.pending_updates = 0;
+    rt_hw_interrupt_enable(level);
+    return pending;
 }
 
 /* GUI线程消息处理 - 这是唯一可以调用LVGL的地方 */
@@ -225,32 +252,15 @@ int screen_core_process_messages(void)
     screen_message_t msg;
     int processed_count = 0;
     
-    /* 处理所有待处理消息，但限制处理数量防止阻塞 */
-    while (processed_count < 10) {
-        rt_err_t result = rt_mq_recv(g_core.message_queue, &msg, sizeof(msg), MESSAGE_TIMEOUT_MS);
+    /* 先处理控制消息（不阻塞），之后的数据刷新按切换后的状态渲染 */
+    while (processed_count < MESSAGE_BATCH_MAX) {
+        rt_err_t result = rt_mq_recv(g_core.message_queue, &msg, sizeof(msg), RT_WAITING_NO);
         
         if (result != RT_EOK) {
-            break; /* 没有更多消息或超时 */
+            break; /* 没有更多消息 */
         }
         
-        /* 处理消息 */
         switch (msg.type) {
-            case SCREEN_MSG_UPDATE_TIME:
-                process_update_time_message();
-                break;
-                
-            case SCREEN_MSG_UPDATE_WEATHER:
-                process_update_weather_message(&msg.data.weather_data);
-                break;
-                
-            case SCREEN_MSG_UPDATE_STOCK:
-                process_update_stock_message(&msg.data.stock_data);
-                break;
-                
-            case SCREEN_MSG_UPDATE_SYSTEM:
-                process_update_system_message(&msg.data.system_data);
-                break;
-                
             case SCREEN_MSG_SWITCH_GROUP:
                 process_switch_group_message(&msg.data.switch_msg);
                 break;
@@ -263,10 +273,61 @@ int screen_core_process_messages(void)
                 process_return_l1_message();
                 break;
                 
+            default:
+                break;
+        }
+        
+        processed_count++;
+        g_core.messages_processed++;
+    }
+
+    /* 一批处理满时队列里可能还有消息，重新置位唤醒事件，下一轮立即继续而不是等到超时。
+     * 恰好处理完时只多一次空转 */
+    if (processed_count >= MESSAGE_BATCH_MAX) {
+        screen_core_wakeup(SCREEN_WAKE_MESSAGE);
+    }
+
+    /* 合并后的数据刷新，每类最多处理一次 */
+    uint32_t pending = take_pending_updates();
+    if (pending == 0) {
+        return processed_count;
+    }
+    
+    static const screen_msg_type_t update_order[] = {
+        SCREEN_MSG_CLEANUP_REQUEST,
+        SCREEN_MSG_ROTATE_STOCK,
+        SCREEN_MSG_UPDATE_TIME,
+        SCREEN_MSG_UPDATE_WEATHER,
+        SCREEN_MSG_UPDATE_STOCK,
+        SCREEN_MSG_UPDATE_SYSTEM,
+    };
+    
+    for (size_t i = 0; i < sizeof(update_order) / sizeof(update_order[0]); i++) {
+        screen_msg_type_t type = update_order[i];
+        if (!(pending & UPDATE_BIT(type))) {
+            continue;
+        }
+        
+        switch (type) {
             case SCREEN_MSG_CLEANUP_REQUEST:
                 process_cleanup_message();
                 break;
-                
+            case SCREEN_MSG_ROTATE_STOCK:
+                process_rotate_stock_message();     /* 已包含股票刷新 */
+                pending &= ~UPDATE_BIT(SCREEN_MSG_UPDATE_STOCK);
+                break;
+            case SCREEN_MSG_UPDATE_TIME:
+                process_update_time_message();
+                break;
+            case SCREEN_MSG_UPDATE_WEATHER:
+                process_update_weather_message();
+                break;
+            case SCREEN_MSG_UPDATE_STOCK:
+                process_update_stock_message();
+                break;
+            case SCREEN_MSG_UPDATE_SYSTEM:
+                process_update_system_message();
+                break;
             default:
                 break;
         }
@@ -301,25 +362,22 @@ static int process_update_time_message(void)
     return 0;
 }
 
-static int process_update_weather_message(const weather_data_t *data)
+static int process_update_weather_message(void)
 {
     /* 只在Group 1显示时更新天气 */
     if (g_core.current_group != SCREEN_GROUP_1 || g_core.current_level != SCREEN_LEVEL_1) {
         return 0;
     }
     
+    /* 从数据管理器取最新数据和累积的脏字段掩码 */
     weather_data_t weather_data = {0};
-    
-    /* 如果消息中没有数据，从数据管理器获取 */
-    if (!data || !data->valid) {
-        if (data_manager_get_weather(&weather_data) == 0 && weather_data.valid) {
-            data = &weather_data;
-        } else {
-            return 0; /* 没有有效数据 */
-        }
+    uint32_t dirty_mask = 0;
+    /* 无效（含已过期）的数据也交给UI，由UI灰显 */
+    if (data_manager_take_weather(&weather_data, &dirty_mask) == -RT_ERROR) {
+        return 0;
     }
     
-    int ret = screen_ui_update_weather_display(data);
+    int ret = screen_ui_update_weather_display(&weather_data, dirty_mask);
     
     /* 同时更新传感器数据 */
     screen_ui_update_sensor_display();
@@ -327,46 +385,51 @@ static int process_update_weather_message(const weather_data_t *data)
     return ret;
 }
 
-static int process_update_stock_message(const stock_data_t *data)
+static int process_update_stock_message(void)
 {
     /* 只在Group 1显示时更新股票 */
     if (g_core.current_group != SCREEN_GROUP_1 || g_core.current_level != SCREEN_LEVEL_1) {
         return 0;
     }
     
+    /* 从数据管理器取最新数据和累积的脏字段掩码 */
     stock_data_t stock_data = {0};
-    
-    /* 如果消息中没有数据，从数据管理器获取 */
-    if (!data || !data->valid) {
-        if (data_manager_get_stock(&stock_data) == 0 && stock_data.valid) {
-            data = &stock_data;
-        } else {
-            return 0; /* 没有有效数据 */
-        }
+    uint32_t dirty_mask = 0;
+    /* 无效（含已过期）的数据也交给UI，由UI灰显 */
+    if (data_manager_take_stock(&stock_data, &dirty_mask) == -RT_ERROR) {
+        return 0;
     }
     
-    return screen_ui_update_stock_display(data);
+    return screen_ui_update_stock_display(&stock_data, dirty_mask);
 }
 
-static int process_update_system_message(const system_monitor_data_t *data)
+static int process_update_system_message(void)
 {
     /* 只在Group 2显示时更新系统监控 */
     if (g_core.current_group != SCREEN_GROUP_2 || g_core.current_level != SCREEN_LEVEL_1) {
         return 0;
     }
     
+    /* 从数据管理器取最新数据和累积的脏字段掩码 */
     system_monitor_data_t system_data = {0};
+    uint32_t dirty_mask = 0;
+    /* 无效（含已过期）的数据也交给UI，由UI灰显 */
+    if (data_manager_take_system(&system_data, &dirty_mask) == -RT_ERROR) {
+        return 0;
+    }
     
-    /* 如果消息中没有数据，从数据管理器获取 */
-    if (!data || !data->valid) {
-        if (data_manager_get_system(&system_data) == 0 && system_data.valid) {
-            data = &system_data;
-        } else {
-            return 0; /* 没有有效数据 */
-        }
+    return screen_ui_update_system_display(&system_data, dirty_mask);
+}
+
+static int process_rotate_stock_message(void)
+{
+    /* 只在Group 1显示时轮换自选股 */
+    if (g_core.current_group != SCREEN_GROUP_1 || g_core.current_level != SCREEN_LEVEL_1) {
+        return 0;
     }
     
-    return screen_ui_update_system_display(data);
+    data_manager_next_stock();
+    return process_update_stock_message();
 }
 
 /**
@@ -551,6 +614,9 @@ static int process_return_l1_message(void)
 
 static int process_cleanup_message(void)
 {
+    /* 保存最后有效数据的快照（内部限速，内容不变时不写flash） */
+    data_manager_persist_snapshot(false);
+    
     /* 清理过期数据 */
     data_manager_cleanup_expired_data();
     
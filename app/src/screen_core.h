@@ -21,9 +21,20 @@ typedef enum {
     SCREEN_MSG_ENTER_L2,
     SCREEN_MSG_RETURN_L1,
     SCREEN_MSG_CLEANUP_REQUEST,
+    SCREEN_MSG_ROTATE_STOCK,
     SCREEN_MSG_MAX
 } screen_msg_type_t;
 
+/* GUI线程唤醒事件位 - 主循环在同一个事件对象上睡眠 */
+#define SCREEN_WAKE_MESSAGE     (1u << 0)   /* 控制消息入队 */
+#define SCREEN_WAKE_UPDATE      (1u << 1)   /* 数据刷新请求 */
+#define SCREEN_WAKE_CONTEXT     (1u << 2)   /* screen_context中待主循环处理的标志 */
+#define SCREEN_WAKE_DISPLAY     (1u << 3)   /* 输入唤醒熄屏的面板 */
+#define SCREEN_WAKE_ALL         (SCREEN_WAKE_MESSAGE | SCREEN_WAKE_UPDATE | SCREEN_WAKE_CONTEXT | \
+                                 SCREEN_WAKE_DISPLAY)
+
+#define SCREEN_IDLE_WAIT_MAX_MS 500         /* 无LVGL定时器时的最长睡眠 */
+
 /* 屏幕切换消息 */
 typedef struct {
     screen_group_t target_group;
@@ -36,16 +47,14 @@ typedef struct {
     screen_l2_page_t l2_page;
 } screen_l2_enter_msg_t;
 
-/* 屏幕消息结构 */
+/* 屏幕消息结构 - 只有控制消息（切换组/进入L2/返回L1）经过队列；
+ * 数据刷新类消息合并为pending_updates中的位，最新数据始终从data_manager取 */
 typedef struct {
     screen_msg_type_t type;
     rt_tick_t timestamp;
     union {
         screen_switch_msg_t switch_msg;
         screen_l2_enter_msg_t l2_enter_msg;
-        weather_data_t weather_data;
-        stock_data_t stock_data;
-        system_monitor_data_t system_data;
     } data;
 } screen_message_t;
 
@@ -66,6 +75,7 @@ screen_l2_group_t screen_core_get_current_l2_group(void);
 typedef struct {
     /* 消息系统 */
     rt_mq_t message_queue;
+    rt_event_t wake_event;          /* GUI线程唤醒 */
     rt_mutex_t state_lock;
     
     /* 当前状态 */
@@ -78,8 +88,12 @@ typedef struct {
     bool ui_initialized;
     bool switching_in_progress;
     
+    /* 待处理的数据刷新，按(1 << screen_msg_type_t)置位，可在中断上下文中置位 */
+    volatile uint32_t pending_updates;
+    
     /* 统计信息 */
     uint32_t messages_processed;
+    uint32_t updates_coalesced;    /* 与尚未处理的同类刷新合并掉的请求数 */
     uint32_t switch_count;
     uint32_t last_cleanup_time;
     
@@ -89,7 +103,8 @@ typedef struct {
 int screen_core_init(void);
 int screen_core_deinit(void);
 
-/* 消息发送接口 - 线程安全 */
+/* 消息发送接口 - 线程安全；update/cleanup/rotate类请求在处理前重复发送只生效一次，
+ * 数据参数仅为兼容保留，处理时从data_manager取最新数据 */
 int screen_core_post_switch_group(screen_group_t target_group, bool force);
 int screen_core_post_enter_l2(screen_l2_group_t l2_group, screen_l2_page_t l2_page);
 int screen_core_post_return_l1(void);
@@ -98,10 +113,17 @@ int screen_core_post_update_weather(const weather_data_t *data);
 int screen_core_post_update_stock(const stock_data_t *data);
 int screen_core_post_update_system(const system_monitor_data_t *data);
 int screen_core_post_cleanup_request(void);
+int screen_core_post_rotate_stock(void);
 
-/* 消息处理 - 仅在GUI线程调用 */
+/* 消息处理 - 仅在GUI线程调用，不阻塞 */
 int screen_core_process_messages(void);
 
+/* 唤醒GUI线程，可在中断上下文调用 */
+void screen_core_wakeup(uint32_t reason);
+
+/* GUI线程睡眠，直到超时或被唤醒；返回唤醒原因（SCREEN_WAKE_*），超时返回0 */
+uint32_t screen_core_wait(uint32_t timeout_ms);
+
 /* 状态查询 - 线程安全 */
 screen_group_t screen_core_get_current_group(void);
 screen_level_t screen_core_get_current_level(void);
@@ -38,7 +38,7 @@ static void safe_timer_callback(void *parameter)
             break;
             
         case SCREEN_TIMER_STOCK:
-            screen_core_post_update_stock(NULL);
+            screen_core_post_rotate_stock();    /* 轮换自选股并刷新 */
             break;
             
         case SCREEN_TIMER_SYSTEM:
@@ -122,21 +122,28 @@ typedef struct {
     int pressure;            /* 气压(hPa) ，来自pressure字段 */
     char update_time[32];    /* 更新时间 */
     bool valid;              /* 数据有效性 */
+    bool stale;              /* 来自上次保存的快照，尚未收到新数据 */
     
     /* 内部字段，用于映射 */
     int weather_code;        /* 天气代码 */
     int city_code;           /* 城市代码 */
 } weather_data_t;
 
-/* 简化版股票数据结构 - 仅包含finsh协议支持的字段 */
+/* 自选股最大数量，可通过Kconfig的STOCK_WATCHLIST_SIZE配置 */
+#ifndef STOCK_WATCHLIST_SIZE
+#define STOCK_WATCHLIST_SIZE 8
+#endif
+
+/* 紧凑股票数据结构（16字节）- 名称驻留在stock_watchlist名称池中，
+ * 价格为×100定点数，时间为秒级时间戳，显示字符串在渲染时生成 */
 typedef struct {
-    char symbol[16];         /* 股票代码（默认值） */
-    char name[64];           /* 股票名称 - 来自stock_name字段 */
-    float current_price;     /* 当前价格 - 来自stock_price字段 */
-    float change_value;      /* 涨跌额 - 来自stock_change字段 */
-    float change_percent;    /* 涨跌幅(%) - 自动计算 */
-    char update_time[32];    /* 更新时间 */
+    uint8_t name_id;         /* 股票名称ID - stock_name_lookup()取名称 */
     bool valid;              /* 数据有效性 */
+    bool stale;              /* 来自上次保存的快照 */
+    uint8_t reserved;
+    int32_t price_x100;      /* 当前价格×100 - 来自stock_price字段 */
+    int32_t change_x100;     /* 涨跌额×100 - 来自stock_change字段 */
+    uint32_t update_time;    /* 更新时间（time_t秒） */
 } stock_data_t;
 
 /* 简化版系统监控数据结构 - 仅包含finsh协议支持的字段 */
@@ -158,6 +165,7 @@ typedef struct {
     
     char update_time[32];   /* 更新时间 */
     bool valid;             /* 数据有效性 */
+    bool stale;             /* 来自上次保存的快照，尚未收到新数据 */
 } system_monitor_data_t;
 
 #ifdef __cplusplus
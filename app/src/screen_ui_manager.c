@@ -6,8 +6,11 @@
 #include "screen_ui_manager.h"
 #include "screen_core.h"
 #include "data_manager.h"
+#include "stock_watchlist.h"
 #include "sht30_controller.h"
 #include "screen_context.h"
+#include "image_cache.h"
+#include "font_cache_stats.h"
 #include "lv_tiny_ttf.h"
 #include <rtthread.h>
 #include <time.h>
@@ -16,18 +19,35 @@
 /*********************
  *      DEFINES
  *********************/
-#define SCREEN_WIDTH   128
-#define SCREEN_HEIGHT  128
-#define TOTAL_WIDTH    (SCREEN_WIDTH * 3)
+#define SCREEN_WIDTH   LCD_PANEL_WIDTH
+#define SCREEN_HEIGHT  LCD_PANEL_HEIGHT
+#define TOTAL_WIDTH    LCD_PANEL_GRID_WIDTH
+#define TOTAL_HEIGHT   LCD_PANEL_GRID_HEIGHT
 
-#define LEFT_X         0
-#define MID_X          SCREEN_WIDTH  
-#define RIGHT_X        (SCREEN_WIDTH * 2)
+/* 界面内容按左中右三块屏设计，放在网格的前三块屏上 */
+#define LEFT_PANEL     0
+#define MID_PANEL      1
+#define RIGHT_PANEL    2
+
+#if LCD_PANEL_NUM < 3
+#error "screen UI needs at least 3 LCD panels"
+#endif
 
 #define BASE_WIDTH     390
 #define BASE_HEIGHT    450
 #define SCALE_DPX(val) LV_DPX((val) * g_ui_mgr.scale_factor)
 
+/* pending_full_refresh位：页面重新显示后首次更新忽略脏掩码 */
+#define UI_REFRESH_WEATHER  (1u << 0)
+#define UI_REFRESH_STOCK    (1u << 1)
+#define UI_REFRESH_SYSTEM   (1u << 2)
+
+#define UI_PANEL_COUNT          3
+#define UI_OBJ_MEM_ESTIMATE     96      /* 无内存池统计时每个对象的估算字节数 */
+
+/* 页面构建函数，三个参数为该页面在左/中/右面板下的容器 */
+typedef void (*ui_page_builder_t)(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right);
+
 /* 中文月份和星期数组 */
 static const char* chinese_months[] = {
     "一月", "二月", "三月", "四月", "五月", "六月",
@@ -38,9 +58,26 @@ static const char* chinese_weekdays[] = {
     "周日", "周一", "周二", "周三", "周四", "周五", "周六"
 };
 
-/* 外部字体数据声明 */
+/* 构建时预渲染的位图字体（font/xiaozhi_font_bitmap.c），只含源码中出现的字符 */
+extern const lv_font_t *const xiaozhi_font_bitmap_fonts[];
+extern const uint8_t xiaozhi_font_bitmap_sizes[];
+extern const int xiaozhi_font_bitmap_count;
+
+#ifdef FONT_TTF_FALLBACK
+/* 外部字体数据声明，用于位图未收录的动态文本（如股票名称） */
 extern const unsigned char xiaozhi_font[];
 extern const int xiaozhi_font_size;
+#endif
+
+#define UI_FONT_SLOT_COUNT 6
+
+/* 位图字体需要各自的fallback，故复制一份描述而不是直接修改常量 */
+typedef struct {
+    lv_font_t bitmap;
+    lv_font_t *ttf;
+} ui_font_slot_t;
+
+static ui_font_slot_t g_font_slots[UI_FONT_SLOT_COUNT];
 
 /* 数字图片资源声明 */
 extern const lv_image_dsc_t t0;  // 数字0图片
@@ -146,6 +183,7 @@ extern const lv_image_dsc_t media;   // 媒体控制图片
 extern const lv_image_dsc_t web;     // 网页控制图片  
 extern const lv_image_dsc_t shortcut; // 快捷键图片
 extern const lv_image_dsc_t muyu;  // 木鱼图片资源
+extern const lv_image_dsc_t muyu_l2;        // L2木鱼展示图片
 extern const lv_image_dsc_t tomatolock;     // 番茄钟图片资源
 extern const lv_image_dsc_t calculagraph;   // 计时器图片资源
 extern const lv_image_dsc_t volup;      // 音量+图片
@@ -172,6 +210,7 @@ static struct {
     uint8_t cpu_index;
     uint8_t gpu_index;
 } chart_history = {0};
+static const lv_image_dsc_t *g_pinned_weather_icon = NULL;   /* 当前天气图标常驻解码缓存 */
 /*********************
  *  STATIC PROTOTYPES
  *********************/
@@ -201,6 +240,7 @@ static void build_right_shortcut_panel(lv_obj_t *parent);
 
 /* 图片资源获取函数 */
 static const lv_image_dsc_t* get_muyu_image(void);
+static const lv_image_dsc_t* get_muyu_l2_image(void);
 static const lv_image_dsc_t* get_tomato_image(void);
 static const lv_image_dsc_t* get_calculagraph_image(void);
 static const lv_image_dsc_t* get_media_image(void); 
@@ -229,15 +269,22 @@ static lv_obj_t* create_memory_chart(lv_obj_t *parent, lv_color_t color);
 static const lv_image_dsc_t* get_digit_image(int digit);
 static lv_obj_t* create_digit_image(lv_obj_t *parent, int digit, lv_coord_t x_offset, lv_coord_t y_offset);
 static void update_digit_image(lv_obj_t *img_obj, int digit);
-static void build_l2_time_detail_page(void);
+static void set_weather_icon(lv_obj_t *icon_obj, const lv_image_dsc_t *icon);
+static void build_l2_time_detail_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right);
 static int screen_ui_update_l2_digital_clock(void);
 
-static void build_l2_media_control_page(void);
-static void build_l2_web_control_page(void);
-static void build_l2_shortcut_control_page(void);
+static void build_l2_media_control_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right);
+static void build_l2_web_control_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right);
+static void build_l2_shortcut_control_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right);
+
+/* Group 4 及其L2页面构建 */
+static void build_group4_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right);
+static void build_l2_muyu_main_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right);
+static void build_l2_tomato_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right);
+static void build_l2_gallery_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right);
 
-/* 安全清理 */
-static void safe_cleanup_ui_objects(void);
+/* 常驻页面管理 */
+static void release_page(screen_ui_page_id_t page);
 
 /**
  * 根据天气代码获取对应的天气图标
@@ -255,6 +302,7 @@ static const lv_image_dsc_t* get_weather_icon_by_code(int weather_code)
 
 /**
  * 获取当前屏幕尺寸并计算缩放因子
+ * @note 图片在构建时按同样的公式预缩放（asset/SConscript），修改时需同步
  */
 static float get_scale_factor(void)
 {
@@ -269,7 +317,63 @@ static float get_scale_factor(void)
 }
 
 /**
- * 创建动态字体
+ * 查找指定字号的位图字体，exact为false时返回最接近的字号
+ */
+static const lv_font_t *find_bitmap_font(int size, bool exact)
+{
+    const lv_font_t *best = NULL;
+    int best_diff = 0;
+
+    for (int i = 0; i < xiaozhi_font_bitmap_count; i++) {
+        int diff = xiaozhi_font_bitmap_sizes[i] - size;
+        if (diff < 0) {
+            diff = -diff;
+        }
+        if (!best || diff < best_diff) {
+            best = xiaozhi_font_bitmap_fonts[i];
+            best_diff = diff;
+        }
+    }
+
+    return (best && (!exact || best_diff == 0)) ? best : NULL;
+}
+
+/**
+ * 创建一个字号的字体：优先使用预渲染位图，TTF仅作回退
+ * cache_cnt为TTF的字形缓存数，name用于font_stats统计输出
+ */
+static lv_font_t *create_font(ui_font_slot_t *slot, const char *name, int size, uint16_t cache_cnt)
+{
+    const lv_font_t *bitmap = find_bitmap_font(size, true);
+
+    slot->ttf = NULL;
+#ifdef FONT_TTF_FALLBACK
+    slot->ttf = lv_tiny_ttf_create_data_ex(xiaozhi_font, xiaozhi_font_size, size,
+                                           LV_FONT_KERNING_NORMAL, cache_cnt);
+    if (slot->ttf) {
+        font_cache_stats_attach(slot->ttf, name, size, cache_cnt);
+    }
+#endif
+
+    if (!bitmap) {
+        /* 字号与构建时不一致（分辨率配置变化），直接用TTF或最接近的位图 */
+        rt_kprintf("[UI] No bitmap font for %dpx\n", size);
+        if (slot->ttf) {
+            return slot->ttf;
+        }
+        bitmap = find_bitmap_font(size, false);
+        if (!bitmap) {
+            return NULL;
+        }
+    }
+
+    slot->bitmap = *bitmap;
+    slot->bitmap.fallback = slot->ttf;
+    return &slot->bitmap;
+}
+
+/**
+ * 创建字体
  */
 static int create_fonts(void)
 {
@@ -288,12 +392,18 @@ static int create_fonts(void)
     const int font_size_xxlarge = (int)(base_font_xxlarge * g_ui_mgr.scale_factor + 0.5f);
 
     /* 创建字体 */
-    g_ui_mgr.handles.font_xsmall = lv_tiny_ttf_create_data(xiaozhi_font, xiaozhi_font_size, font_size_xsmall);
-    g_ui_mgr.handles.font_small = lv_tiny_ttf_create_data(xiaozhi_font, xiaozhi_font_size, font_size_small);
-    g_ui_mgr.handles.font_medium = lv_tiny_ttf_create_data(xiaozhi_font, xiaozhi_font_size, font_size_medium);
-    g_ui_mgr.handles.font_large = lv_tiny_ttf_create_data(xiaozhi_font, xiaozhi_font_size, font_size_large);
-    g_ui_mgr.handles.font_xlarge = lv_tiny_ttf_create_data(xiaozhi_font, xiaozhi_font_size, font_size_xlarge);
-    g_ui_mgr.handles.font_xxlarge = lv_tiny_ttf_create_data(xiaozhi_font, xiaozhi_font_size, font_size_xxlarge);
+    g_ui_mgr.handles.font_xsmall = create_font(&g_font_slots[0], "xsmall", font_size_xsmall,
+                                            FONT_TTF_CACHE_CNT_XSMALL);
+    g_ui_mgr.handles.font_small = create_font(&g_font_slots[1], "small", font_size_small,
+                                            FONT_TTF_CACHE_CNT_SMALL);
+    g_ui_mgr.handles.font_medium = create_font(&g_font_slots[2], "medium", font_size_medium,
+                                            FONT_TTF_CACHE_CNT_MEDIUM);
+    g_ui_mgr.handles.font_large = create_font(&g_font_slots[3], "large", font_size_large,
+                                            FONT_TTF_CACHE_CNT_LARGE);
+    g_ui_mgr.handles.font_xlarge = create_font(&g_font_slots[4], "xlarge", font_size_xlarge,
+                                            FONT_TTF_CACHE_CNT_XLARGE);
+    g_ui_mgr.handles.font_xxlarge = create_font(&g_font_slots[5], "xxlarge", font_size_xxlarge,
+                                            FONT_TTF_CACHE_CNT_XXLARGE);
 
     if (!g_ui_mgr.handles.font_small || !g_ui_mgr.handles.font_medium || 
         !g_ui_mgr.handles.font_large || !g_ui_mgr.handles.font_xlarge) {
@@ -334,34 +444,24 @@ static int create_fonts(void)
 }
 
 /**
- * 清理字体资源
+ * 清理字体资源，位图字体为常量，只需销毁TTF回退
  */
 static void cleanup_fonts(void)
 {
-    if (g_ui_mgr.handles.font_xsmall) {
-        lv_tiny_ttf_destroy(g_ui_mgr.handles.font_xsmall);
-        g_ui_mgr.handles.font_xsmall = NULL;
-    }
-    if (g_ui_mgr.handles.font_small) {
-        lv_tiny_ttf_destroy(g_ui_mgr.handles.font_small);
-        g_ui_mgr.handles.font_small = NULL;
-    }
-    if (g_ui_mgr.handles.font_medium) {
-        lv_tiny_ttf_destroy(g_ui_mgr.handles.font_medium);
-        g_ui_mgr.handles.font_medium = NULL;
-    }
-    if (g_ui_mgr.handles.font_large) {
-        lv_tiny_ttf_destroy(g_ui_mgr.handles.font_large);
-        g_ui_mgr.handles.font_large = NULL;
-    }
-    if (g_ui_mgr.handles.font_xlarge) {
-        lv_tiny_ttf_destroy(g_ui_mgr.handles.font_xlarge);
-        g_ui_mgr.handles.font_xlarge = NULL;
-    }
-    if (g_ui_mgr.handles.font_xxlarge) {
-        lv_tiny_ttf_destroy(g_ui_mgr.handles.font_xxlarge);
-        g_ui_mgr.handles.font_xxlarge = NULL;
+    for (int i = 0; i < UI_FONT_SLOT_COUNT; i++) {
+        if (g_font_slots[i].ttf) {
+            font_cache_stats_detach(g_font_slots[i].ttf);
+            lv_tiny_ttf_destroy(g_font_slots[i].ttf);
+        }
     }
+    memset(g_font_slots, 0, sizeof(g_font_slots));
+
+    g_ui_mgr.handles.font_xsmall = NULL;
+    g_ui_mgr.handles.font_small = NULL;
+    g_ui_mgr.handles.font_medium = NULL;
+    g_ui_mgr.handles.font_large = NULL;
+    g_ui_mgr.handles.font_xlarge = NULL;
+    g_ui_mgr.handles.font_xxlarge = NULL;
 }
 
 /**
@@ -385,40 +485,28 @@ static int create_base_ui(void)
         return -RT_ERROR;
     }
     lv_obj_remove_style_all(g_ui_mgr.handles.root);
-    lv_obj_set_size(g_ui_mgr.handles.root, TOTAL_WIDTH, SCREEN_HEIGHT);
+    lv_obj_set_size(g_ui_mgr.handles.root, TOTAL_WIDTH, TOTAL_HEIGHT);
     lv_obj_set_pos(g_ui_mgr.handles.root, 0, 0);
     lv_obj_set_style_bg_color(g_ui_mgr.handles.root, lv_color_black(), 0);
     lv_obj_set_style_bg_opa(g_ui_mgr.handles.root, LV_OPA_COVER, 0);
 
-    /* 创建三个面板 */
-    g_ui_mgr.handles.left_panel = lv_obj_create(g_ui_mgr.handles.root);
-    g_ui_mgr.handles.middle_panel = lv_obj_create(g_ui_mgr.handles.root);
-    g_ui_mgr.handles.right_panel = lv_obj_create(g_ui_mgr.handles.root);
-
-    if (!g_ui_mgr.handles.left_panel || !g_ui_mgr.handles.middle_panel || !g_ui_mgr.handles.right_panel) {
-        return -RT_ERROR;
+    /* 按面板网格为每块屏创建一个面板 */
+    for (int i = 0; i < LCD_PANEL_NUM; i++) {
+        lv_obj_t *panel = lv_obj_create(g_ui_mgr.handles.root);
+        if (!panel) {
+            return -RT_ERROR;
+        }
+        lv_obj_remove_style_all(panel);
+        lv_obj_set_size(panel, SCREEN_WIDTH, SCREEN_HEIGHT);
+        lv_obj_set_pos(panel, LCD_PANEL_X(i), LCD_PANEL_Y(i));
+        lv_obj_set_style_bg_color(panel, lv_color_black(), 0);
+        lv_obj_set_style_bg_opa(panel, LV_OPA_COVER, 0);
+        g_ui_mgr.handles.panels[i] = panel;
     }
 
-    /* 配置左屏面板 */
-    lv_obj_remove_style_all(g_ui_mgr.handles.left_panel);
-    lv_obj_set_size(g_ui_mgr.handles.left_panel, SCREEN_WIDTH, SCREEN_HEIGHT);
-    lv_obj_set_pos(g_ui_mgr.handles.left_panel, LEFT_X, 0);
-    lv_obj_set_style_bg_color(g_ui_mgr.handles.left_panel, lv_color_black(), 0);
-    lv_obj_set_style_bg_opa(g_ui_mgr.handles.left_panel, LV_OPA_COVER, 0);
-
-    /* 配置中屏面板 */
-    lv_obj_remove_style_all(g_ui_mgr.handles.middle_panel);
-    lv_obj_set_size(g_ui_mgr.handles.middle_panel, SCREEN_WIDTH, SCREEN_HEIGHT);
-    lv_obj_set_pos(g_ui_mgr.handles.middle_panel, MID_X, 0);
-    lv_obj_set_style_bg_color(g_ui_mgr.handles.middle_panel, lv_color_black(), 0);
-    lv_obj_set_style_bg_opa(g_ui_mgr.handles.middle_panel, LV_OPA_COVER, 0);
-
-    /* 配置右屏面板 */
-    lv_obj_remove_style_all(g_ui_mgr.handles.right_panel);
-    lv_obj_set_size(g_ui_mgr.handles.right_panel, SCREEN_WIDTH, SCREEN_HEIGHT);
-    lv_obj_set_pos(g_ui_mgr.handles.right_panel, RIGHT_X, 0);
-    lv_obj_set_style_bg_color(g_ui_mgr.handles.right_panel, lv_color_black(), 0);
-    lv_obj_set_style_bg_opa(g_ui_mgr.handles.right_panel, LV_OPA_COVER, 0);
+    g_ui_mgr.handles.left_panel = g_ui_mgr.handles.panels[LEFT_PANEL];
+    g_ui_mgr.handles.middle_panel = g_ui_mgr.handles.panels[MID_PANEL];
+    g_ui_mgr.handles.right_panel = g_ui_mgr.handles.panels[RIGHT_PANEL];
     return 0;
 }
 
@@ -431,39 +519,12 @@ static void cleanup_base_ui(void)
         lv_obj_del(g_ui_mgr.handles.root);
     }
     
-    /* 清空所有句柄 */
+    /* 清空所有句柄，页面容器随根容器一起删除 */
     memset(&g_ui_mgr.handles, 0, sizeof(screen_ui_handles_t));
-}
-
-/**
- * 安全清理UI对象
- */
-static void safe_cleanup_ui_objects(void)
-{
-
-    /* 清理面板内容，但保留面板本身 */
-    if (g_ui_mgr.handles.left_panel && lv_obj_is_valid(g_ui_mgr.handles.left_panel)) {
-        lv_obj_clean(g_ui_mgr.handles.left_panel);
-    }
-    if (g_ui_mgr.handles.middle_panel && lv_obj_is_valid(g_ui_mgr.handles.middle_panel)) {
-        lv_obj_clean(g_ui_mgr.handles.middle_panel);
-    }
-    if (g_ui_mgr.handles.right_panel && lv_obj_is_valid(g_ui_mgr.handles.right_panel)) {
-        lv_obj_clean(g_ui_mgr.handles.right_panel);
-    }
-
-    /* 清空组件句柄（但保留面板和根容器） */
-    memset(&g_ui_mgr.handles.group1_time, 0, sizeof(g_ui_mgr.handles.group1_time));
-    memset(&g_ui_mgr.handles.group1_weather, 0, sizeof(g_ui_mgr.handles.group1_weather));
-    memset(&g_ui_mgr.handles.group1_stock, 0, sizeof(g_ui_mgr.handles.group1_stock));
-    memset(&g_ui_mgr.handles.group2_cpu_gpu, 0, sizeof(g_ui_mgr.handles.group2_cpu_gpu));
-    memset(&g_ui_mgr.handles.group2_memory, 0, sizeof(g_ui_mgr.handles.group2_memory));
-    memset(&g_ui_mgr.handles.group2_network, 0, sizeof(g_ui_mgr.handles.group2_network));
-    
-    // 清空L2数字时钟句柄
-    memset(&g_ui_mgr.handles.l2_digital_clock, 0, sizeof(g_ui_mgr.handles.l2_digital_clock));
-
-    lv_timer_handler(); /* 处理清理操作 */
+    memset(g_ui_mgr.pages, 0, sizeof(g_ui_mgr.pages));
+    g_ui_mgr.current_page = UI_PAGE_NONE;
+    g_ui_mgr.switch_stats.retained_bytes = 0;
+    g_ui_mgr.switch_stats.retained_pages = 0;
 }
 
 /*********************
@@ -553,26 +614,19 @@ static void build_middle_weather_panel(lv_obj_t *parent)
 
     /* ⭐ 天气图标 - 在温度下方，靠右边缘 */
     g_ui_mgr.handles.group1_weather.weather_icon = lv_img_create(parent);
-    lv_img_set_src(g_ui_mgr.handles.group1_weather.weather_icon, &w999); // 默认显示未知图标
-    
-    // 设置图标大小和缩放
-    lv_coord_t icon_size = (lv_coord_t)(SCREEN_WIDTH * 1.0f);  // 图标占屏幕宽度100%
-    lv_obj_set_size(g_ui_mgr.handles.group1_weather.weather_icon, icon_size, icon_size);
+    set_weather_icon(g_ui_mgr.handles.group1_weather.weather_icon, &w999); // 默认显示未知图标
     
-    float scale = g_ui_mgr.scale_factor * 0.4f;  // 适中的缩放比例
-    
-    lv_img_set_zoom(g_ui_mgr.handles.group1_weather.weather_icon, (int)(LV_IMG_ZOOM_NONE * scale));
-    lv_img_set_antialias(g_ui_mgr.handles.group1_weather.weather_icon, true);
+    // 图标构建时已预缩放，原尺寸绘制；所有天气图标尺寸相同
+    lv_obj_set_size(g_ui_mgr.handles.group1_weather.weather_icon, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     
     // 移除所有边距和边框并允许溢出显示
     lv_obj_set_style_pad_all(g_ui_mgr.handles.group1_weather.weather_icon, 0, 0);
     lv_obj_set_style_border_width(g_ui_mgr.handles.group1_weather.weather_icon, 0, 0);
     lv_obj_add_flag(g_ui_mgr.handles.group1_weather.weather_icon, LV_OBJ_FLAG_OVERFLOW_VISIBLE);
-    // 位置：在温度下方，靠右边缘
-    lv_obj_align(g_ui_mgr.handles.group1_weather.weather_icon, 
-                LV_ALIGN_TOP_RIGHT, 
-                35,
-                10);  
+    // 位置：在温度下方，靠右边缘（图标中心在面板中心右移35、下移10处）
+    lv_obj_set_pos(g_ui_mgr.handles.group1_weather.weather_icon,
+                   SCREEN_WIDTH / 2 + 35 - (lv_coord_t)w999.header.w / 2,
+                   SCREEN_HEIGHT / 2 + 10 - (lv_coord_t)w999.header.h / 2);
 
     /* 湿度 - 天气描述下方，左对齐 */
     g_ui_mgr.handles.group1_weather.humidity_label = lv_label_create(parent);
@@ -955,28 +1009,17 @@ static lv_obj_t* create_digit_image(lv_obj_t *parent, int digit, lv_coord_t x_of
         return NULL;
     }
     
-    // 设置图片资源
-    lv_img_set_src(img, get_digit_image(digit));
-    
-    /* 极致优化1: 最大化图片容器尺寸 - 占用几乎全部显示区域 */
-    lv_coord_t img_width = (lv_coord_t)(SCREEN_WIDTH * 0.5f);    // 64像素，占满一半板块
-    lv_coord_t img_height = (lv_coord_t)(SCREEN_HEIGHT * 1.0f);  // 128像素，占满整个高度
-    lv_obj_set_size(img, img_width, img_height);
+    // 设置图片资源 - 构建时已按面板分辨率预缩放，原尺寸绘制，不做变换
+    const lv_image_dsc_t *src = get_digit_image(digit);
+    image_cache_set_src(img, src);
+    lv_obj_set_size(img, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     
-    // 设置位置 - 无边距，完全贴边
-    lv_obj_set_pos(img, x_offset, y_offset);
-    
-    /* 极致优化2: 激进缩放 - 在原有基础上再放大50% */
-    float max_scale = g_ui_mgr.scale_factor * 1.5f;  // 激进放大50%
-    
-    // 扩大缩放范围限制
-    if (max_scale < 0.8f) max_scale = 0.8f;
-    if (max_scale > 4.0f) max_scale = 4.0f;  // 允许更大的缩放
-    
-    lv_img_set_zoom(img, (int)(LV_IMG_ZOOM_NONE * max_scale));
-
-    lv_img_set_antialias(img, true);                    // 抗锯齿
-    lv_img_set_pivot(img, img_width/2, img_height/2);   // 居中缩放点
+    /* 每个数字占半块面板（64×128），图片在其中居中 */
+    lv_coord_t cell_width = SCREEN_WIDTH / 2;
+    lv_coord_t cell_height = SCREEN_HEIGHT;
+    lv_obj_set_pos(img,
+                   x_offset + (cell_width - (lv_coord_t)src->header.w) / 2,
+                   y_offset + (cell_height - (lv_coord_t)src->header.h) / 2);
     
     // 移除所有内边距和边框
     lv_obj_set_style_pad_all(img, 0, 0);
@@ -997,15 +1040,30 @@ static void update_digit_image(lv_obj_t *img_obj, int digit)
         return;
     }
     
-    lv_img_set_src(img_obj, get_digit_image(digit));
+    image_cache_set_src(img_obj, get_digit_image(digit));
+}
+
+/**
+ * 切换天气图标，当前图标固定在解码缓存中，上一个图标转为可淘汰
+ */
+static void set_weather_icon(lv_obj_t *icon_obj, const lv_image_dsc_t *icon)
+{
+    if (icon != g_pinned_weather_icon) {
+        if (g_pinned_weather_icon) {
+            image_cache_pin(g_pinned_weather_icon, false);
+        }
+        image_cache_pin(icon, true);
+        g_pinned_weather_icon = icon;
+    }
+    image_cache_set_src(icon_obj, icon);
 }
 
 /**
  * 构建L2数字时钟页面 - 纯图片数字时钟显示
  */
-static void build_l2_time_detail_page(void)
+static void build_l2_time_detail_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right)
 {
-    if (!g_ui_mgr.handles.left_panel || !g_ui_mgr.handles.middle_panel || !g_ui_mgr.handles.right_panel) {
+    if (!left || !middle || !right) {
         return;
     }
     
@@ -1023,14 +1081,14 @@ static void build_l2_time_detail_page(void)
     
     // === 左板块：小时显示 - 完全占满 ===
     g_ui_mgr.handles.l2_digital_clock.hour_tens = create_digit_image(
-        g_ui_mgr.handles.left_panel, 
+        left, 
         hour / 10,
         no_spacing,                   // X偏移：完全贴左边
         no_offset                     // Y偏移：完全贴顶部
     );
     
     g_ui_mgr.handles.l2_digital_clock.hour_units = create_digit_image(
-        g_ui_mgr.handles.left_panel,
+        left,
         hour % 10,
         SCREEN_WIDTH/2,              // X偏移：右半部分，无间距
         no_offset                    // Y偏移：完全贴顶部
@@ -1038,14 +1096,14 @@ static void build_l2_time_detail_page(void)
     
     // === 中板块：分钟显示 - 完全占满 ===
     g_ui_mgr.handles.l2_digital_clock.min_tens = create_digit_image(
-        g_ui_mgr.handles.middle_panel,
+        middle,
         min / 10,
         no_spacing,                  // X偏移：完全贴左边
         no_offset                    // Y偏移：完全贴顶部
     );
     
     g_ui_mgr.handles.l2_digital_clock.min_units = create_digit_image(
-        g_ui_mgr.handles.middle_panel,
+        middle,
         min % 10,
         SCREEN_WIDTH/2,              // X偏移：右半部分，无间距
         no_offset                    // Y偏移：完全贴顶部
@@ -1053,14 +1111,14 @@ static void build_l2_time_detail_page(void)
     
     // === 右板块：秒钟显示 - 完全占满 ===
     g_ui_mgr.handles.l2_digital_clock.sec_tens = create_digit_image(
-        g_ui_mgr.handles.right_panel,
+        right,
         sec / 10,
         no_spacing,                  // X偏移：完全贴左边
         no_offset                    // Y偏移：完全贴顶部
     );
     
     g_ui_mgr.handles.l2_digital_clock.sec_units = create_digit_image(
-        g_ui_mgr.handles.right_panel,
+        right,
         sec % 10,
         SCREEN_WIDTH/2,              // X偏移：右半部分，无间距
         no_offset                    // Y偏移：完全贴顶部
@@ -1120,38 +1178,38 @@ static int screen_ui_update_l2_digital_clock(void)
 /**
  * 构建媒体控制L2页面
  */
-static void build_l2_media_control_page(void)
+static void build_l2_media_control_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right)
 {
-    if (!g_ui_mgr.handles.left_panel || !g_ui_mgr.handles.middle_panel || !g_ui_mgr.handles.right_panel) return;
+    if (!left || !middle || !right) return;
     
-    lv_obj_t *vol_up_icon = create_entrance_icon(g_ui_mgr.handles.left_panel, get_volup_image());
+    lv_obj_t *vol_up_icon = create_entrance_icon(left, get_volup_image());
     if (vol_up_icon) {
         lv_obj_align(vol_up_icon, LV_ALIGN_CENTER, 0, -10);
     }
     
-    lv_obj_t *vol_up_hint = lv_label_create(g_ui_mgr.handles.left_panel);
+    lv_obj_t *vol_up_hint = lv_label_create(left);
     lv_label_set_text(vol_up_hint, "音量+");
     lv_obj_add_style(vol_up_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(vol_up_hint, lv_color_make(200, 200, 200), 0);
     lv_obj_align(vol_up_hint, LV_ALIGN_BOTTOM_MID, 0, -10);
     
-    lv_obj_t *vol_down_icon = create_entrance_icon(g_ui_mgr.handles.middle_panel, get_voldown_image());
+    lv_obj_t *vol_down_icon = create_entrance_icon(middle, get_voldown_image());
     if (vol_down_icon) {
         lv_obj_align(vol_down_icon, LV_ALIGN_CENTER, 0, -10);
     }
     
-    lv_obj_t *vol_down_hint = lv_label_create(g_ui_mgr.handles.middle_panel);
+    lv_obj_t *vol_down_hint = lv_label_create(middle);
     lv_label_set_text(vol_down_hint, "音量-");
     lv_obj_add_style(vol_down_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(vol_down_hint, lv_color_make(200, 200, 200), 0);
     lv_obj_align(vol_down_hint, LV_ALIGN_BOTTOM_MID, 0, -10);
     
-    lv_obj_t *play_pause_icon = create_entrance_icon(g_ui_mgr.handles.right_panel, get_play_image());
+    lv_obj_t *play_pause_icon = create_entrance_icon(right, get_play_image());
     if (play_pause_icon) {
         lv_obj_align(play_pause_icon, LV_ALIGN_CENTER, 0, -10);
     }
     
-    lv_obj_t *play_pause_hint = lv_label_create(g_ui_mgr.handles.right_panel);
+    lv_obj_t *play_pause_hint = lv_label_create(right);
     lv_label_set_text(play_pause_hint, "播放/暂停");
     lv_obj_add_style(play_pause_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(play_pause_hint, lv_color_make(200, 200, 200), 0);
@@ -1161,16 +1219,16 @@ static void build_l2_media_control_page(void)
 /**
  * 构建网页控制L2页面
  */
-static void build_l2_web_control_page(void)
+static void build_l2_web_control_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right)
 {
-    if (!g_ui_mgr.handles.left_panel || !g_ui_mgr.handles.middle_panel || !g_ui_mgr.handles.right_panel) return;
+    if (!left || !middle || !right) return;
     
-    lv_obj_t *page_up_icon = create_entrance_icon(g_ui_mgr.handles.left_panel, get_up_image());
+    lv_obj_t *page_up_icon = create_entrance_icon(left, get_up_image());
     if (page_up_icon) {
         lv_obj_align(page_up_icon, LV_ALIGN_CENTER, 0, -10);
     }
     
-    lv_obj_t *page_up_hint = lv_label_create(g_ui_mgr.handles.left_panel);
+    lv_obj_t *page_up_hint = lv_label_create(left);
     lv_label_set_text(page_up_hint, "上翻页");
     lv_obj_add_style(page_up_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(page_up_hint, lv_color_make(200, 200, 200), 0);
@@ -1178,24 +1236,24 @@ static void build_l2_web_control_page(void)
     
     /* 中屏：下翻页 */
 
-    lv_obj_t *page_down_icon = create_entrance_icon(g_ui_mgr.handles.middle_panel, get_down_image());
+    lv_obj_t *page_down_icon = create_entrance_icon(middle, get_down_image());
     if (page_down_icon) {
         lv_obj_align(page_down_icon, LV_ALIGN_CENTER, 0, -10);
     }
     
-    lv_obj_t *page_down_hint = lv_label_create(g_ui_mgr.handles.middle_panel);
+    lv_obj_t *page_down_hint = lv_label_create(middle);
     lv_label_set_text(page_down_hint, "下翻页");
     lv_obj_add_style(page_down_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(page_down_hint, lv_color_make(200, 200, 200), 0);
     lv_obj_align(page_down_hint, LV_ALIGN_BOTTOM_MID, 0, -10);
     
     /* 右屏：刷新 */
-    lv_obj_t *refresh_icon = create_entrance_icon(g_ui_mgr.handles.right_panel, get_fresh_image());
+    lv_obj_t *refresh_icon = create_entrance_icon(right, get_fresh_image());
     if (refresh_icon) {
         lv_obj_align(refresh_icon, LV_ALIGN_CENTER, 0, -10);
     }
     
-    lv_obj_t *refresh_hint = lv_label_create(g_ui_mgr.handles.right_panel);
+    lv_obj_t *refresh_hint = lv_label_create(right);
     lv_label_set_text(refresh_hint, "刷新F5");
     lv_obj_add_style(refresh_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(refresh_hint, lv_color_make(200, 200, 200), 0);
@@ -1205,47 +1263,351 @@ static void build_l2_web_control_page(void)
 /**
  * 构建快捷键控制L2页面
  */
-static void build_l2_shortcut_control_page(void)
+static void build_l2_shortcut_control_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right)
 {
-    if (!g_ui_mgr.handles.left_panel || !g_ui_mgr.handles.middle_panel || !g_ui_mgr.handles.right_panel) return;
+    if (!left || !middle || !right) return;
     
     /* 左屏：复制 */
-    lv_obj_t *copy_icon = create_entrance_icon(g_ui_mgr.handles.left_panel, get_ctrlc_image());
+    lv_obj_t *copy_icon = create_entrance_icon(left, get_ctrlc_image());
     if (copy_icon) {
         lv_obj_align(copy_icon, LV_ALIGN_CENTER, 0, -10);
     }
     
-    lv_obj_t *copy_hint = lv_label_create(g_ui_mgr.handles.left_panel);
+    lv_obj_t *copy_hint = lv_label_create(left);
     lv_label_set_text(copy_hint, "复制");
     lv_obj_add_style(copy_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(copy_hint, lv_color_make(200, 200, 200), 0);
     lv_obj_align(copy_hint, LV_ALIGN_BOTTOM_MID, 0, -10);
     
     /* 中屏：粘贴 */
-    lv_obj_t *paste_icon = create_entrance_icon(g_ui_mgr.handles.middle_panel, get_ctrlv_image());
+    lv_obj_t *paste_icon = create_entrance_icon(middle, get_ctrlv_image());
     if (paste_icon) {
         lv_obj_align(paste_icon, LV_ALIGN_CENTER, 0, -10);
     }
     
-    lv_obj_t *paste_hint = lv_label_create(g_ui_mgr.handles.middle_panel);
+    lv_obj_t *paste_hint = lv_label_create(middle);
     lv_label_set_text(paste_hint, "粘贴");
     lv_obj_add_style(paste_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(paste_hint, lv_color_make(200, 200, 200), 0);
     lv_obj_align(paste_hint, LV_ALIGN_BOTTOM_MID, 0, -10);
     
     /* 右屏：撤销 */
-    lv_obj_t *undo_icon = create_entrance_icon(g_ui_mgr.handles.right_panel, get_ctrlz_image());
+    lv_obj_t *undo_icon = create_entrance_icon(right, get_ctrlz_image());
     if (undo_icon) {
         lv_obj_align(undo_icon, LV_ALIGN_CENTER, 0, -10);
     }
     
-    lv_obj_t *undo_hint = lv_label_create(g_ui_mgr.handles.right_panel);
+    lv_obj_t *undo_hint = lv_label_create(right);
     lv_label_set_text(undo_hint, "撤销");
     lv_obj_add_style(undo_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(undo_hint, lv_color_make(200, 200, 200), 0);
     lv_obj_align(undo_hint, LV_ALIGN_BOTTOM_MID, 0, -10);
 }
 
+/*********************
+ *   RETAINED PAGES
+ *********************/
+
+/*
+ * 每个页面在左/中/右三个面板下各有一个全尺寸容器，首次访问时构建，之后常驻，
+ * 切换页面只是隐藏旧容器、显示新容器。LVGL在隐藏标志变化时自动标记区域失效，
+ * 一次刷新即可完成切换。常驻页面的内存超出预算时按LRU淘汰非当前页面，
+ * Group 1为开机首页，不参与淘汰。
+ */
+
+static void build_group1_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right)
+{
+    build_left_datetime_panel(left);
+    build_middle_weather_panel(middle);
+    build_right_stock_panel(right);
+}
+
+static void build_group2_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right)
+{
+    build_left_cpu_gpu_panel(left);
+    build_middle_memory_panel(middle);
+    build_right_network_panel(right);
+}
+
+static void build_group3_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right)
+{
+    build_left_media_panel(left);
+    build_middle_web_panel(middle);
+    build_right_shortcut_panel(right);
+}
+
+static const ui_page_builder_t g_page_builders[UI_PAGE_MAX] = {
+    [UI_PAGE_GROUP1]      = build_group1_page,
+    [UI_PAGE_GROUP2]      = build_group2_page,
+    [UI_PAGE_GROUP3]      = build_group3_page,
+    [UI_PAGE_GROUP4]      = build_group4_page,
+    [UI_PAGE_L2_TIME]     = build_l2_time_detail_page,
+    [UI_PAGE_L2_MEDIA]    = build_l2_media_control_page,
+    [UI_PAGE_L2_WEB]      = build_l2_web_control_page,
+    [UI_PAGE_L2_SHORTCUT] = build_l2_shortcut_control_page,
+    [UI_PAGE_L2_MUYU]     = build_l2_muyu_main_page,
+    [UI_PAGE_L2_TOMATO]   = build_l2_tomato_page,
+    [UI_PAGE_L2_GALLERY]  = build_l2_gallery_page,
+};
+
+static uint32_t ticks_to_ms(rt_tick_t ticks)
+{
+    return (uint32_t)((uint64_t)ticks * 1000 / RT_TICK_PER_SECOND);
+}
+
+static uint32_t lvgl_mem_used(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return (uint32_t)(mon.total_size - mon.free_size);
+}
+
+static uint32_t count_objs(lv_obj_t *obj)
+{
+    uint32_t count = 1;
+    uint32_t child_cnt = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < child_cnt; i++) {
+        count += count_objs(lv_obj_get_child(obj, (int32_t)i));
+    }
+    return count;
+}
+
+static lv_obj_t* create_page_container(lv_obj_t *panel)
+{
+    lv_obj_t *cont = lv_obj_create(panel);
+    if (!cont) {
+        return NULL;
+    }
+
+    /* 透明、无边距，子对象的对齐结果与直接挂在面板上相同 */
+    lv_obj_remove_style_all(cont);
+    lv_obj_set_size(cont, SCREEN_WIDTH, SCREEN_HEIGHT);
+    lv_obj_set_pos(cont, 0, 0);
+    lv_obj_add_flag(cont, LV_OBJ_FLAG_HIDDEN);
+    return cont;
+}
+
+/* 清空页面内组件的句柄，更新函数据此跳过已删除的对象 */
+static void clear_page_handles(screen_ui_page_id_t page)
+{
+    switch (page) {
+        case UI_PAGE_GROUP1:
+            memset(&g_ui_mgr.handles.group1_time, 0, sizeof(g_ui_mgr.handles.group1_time));
+            memset(&g_ui_mgr.handles.group1_weather, 0, sizeof(g_ui_mgr.handles.group1_weather));
+            memset(&g_ui_mgr.handles.group1_stock, 0, sizeof(g_ui_mgr.handles.group1_stock));
+            break;
+        case UI_PAGE_GROUP2:
+            memset(&g_ui_mgr.handles.group2_cpu_gpu, 0, sizeof(g_ui_mgr.handles.group2_cpu_gpu));
+            memset(&g_ui_mgr.handles.group2_memory, 0, sizeof(g_ui_mgr.handles.group2_memory));
+            memset(&g_ui_mgr.handles.group2_network, 0, sizeof(g_ui_mgr.handles.group2_network));
+            break;
+        case UI_PAGE_GROUP4:
+            memset(&g_ui_mgr.handles.group4_muyu, 0, sizeof(g_ui_mgr.handles.group4_muyu));
+            memset(&g_ui_mgr.handles.group4_tomato, 0, sizeof(g_ui_mgr.handles.group4_tomato));
+            memset(&g_ui_mgr.handles.group4_gallery, 0, sizeof(g_ui_mgr.handles.group4_gallery));
+            break;
+        case UI_PAGE_L2_TIME:
+            memset(&g_ui_mgr.handles.l2_digital_clock, 0, sizeof(g_ui_mgr.handles.l2_digital_clock));
+            break;
+        case UI_PAGE_L2_MUYU:
+            memset(&g_ui_mgr.handles.l2_muyu_main, 0, sizeof(g_ui_mgr.handles.l2_muyu_main));
+            break;
+        default:
+            break;
+    }
+}
+
+static void release_page(screen_ui_page_id_t page)
+{
+    screen_ui_page_t *slot = &g_ui_mgr.pages[page];
+
+    for (int i = 0; i < UI_PANEL_COUNT; i++) {
+        if (slot->containers[i] && lv_obj_is_valid(slot->containers[i])) {
+            lv_obj_del(slot->containers[i]);
+        }
+    }
+    clear_page_handles(page);
+
+    if (slot->built) {
+        g_ui_mgr.switch_stats.retained_bytes -= slot->mem_bytes;
+        g_ui_mgr.switch_stats.retained_pages--;
+    }
+    memset(slot, 0, sizeof(*slot));
+}
+
+static int build_page(screen_ui_page_id_t page)
+{
+    screen_ui_page_t *slot = &g_ui_mgr.pages[page];
+    lv_obj_t *panels[UI_PANEL_COUNT] = {
+        g_ui_mgr.handles.left_panel,
+        g_ui_mgr.handles.middle_panel,
+        g_ui_mgr.handles.right_panel
+    };
+    uint32_t mem_before = lvgl_mem_used();
+
+    for (int i = 0; i < UI_PANEL_COUNT; i++) {
+        slot->containers[i] = panels[i] ? create_page_container(panels[i]) : NULL;
+        if (!slot->containers[i]) {
+            release_page(page);
+            return -RT_ENOMEM;
+        }
+    }
+
+    g_page_builders[page](slot->containers[0], slot->containers[1], slot->containers[2]);
+
+    /* 优先用LVGL内存池的实际增量，分配器不提供统计时按对象数估算 */
+    uint32_t mem_after = lvgl_mem_used();
+    slot->mem_bytes = (mem_after > mem_before) ? (mem_after - mem_before) : 0;
+    if (slot->mem_bytes == 0) {
+        for (int i = 0; i < UI_PANEL_COUNT; i++) {
+            slot->mem_bytes += count_objs(slot->containers[i]) * UI_OBJ_MEM_ESTIMATE;
+        }
+    }
+
+    slot->built = true;
+    g_ui_mgr.switch_stats.retained_bytes += slot->mem_bytes;
+    g_ui_mgr.switch_stats.retained_pages++;
+    g_ui_mgr.switch_stats.build_count++;
+    return 0;
+}
+
+/* 超出预算时淘汰最久未使用的页面，当前页面和Group 1除外 */
+static void enforce_page_budget(void)
+{
+    while (g_ui_mgr.switch_stats.retained_bytes > SCREEN_UI_PAGE_BUDGET_KB * 1024u) {
+        int victim = -1;
+        for (int i = 0; i < UI_PAGE_MAX; i++) {
+            const screen_ui_page_t *slot = &g_ui_mgr.pages[i];
+            if (!slot->built || i == (int)g_ui_mgr.current_page || i == UI_PAGE_GROUP1) {
+                continue;
+            }
+            if (victim < 0 ||
+                (int32_t)(slot->last_used - g_ui_mgr.pages[victim].last_used) < 0) {
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            break;
+        }
+
+        rt_kprintf("[UI] evict page %d (%u bytes)\n", victim,
+                   (unsigned int)g_ui_mgr.pages[victim].mem_bytes);
+        release_page((screen_ui_page_id_t)victim);
+        g_ui_mgr.switch_stats.evict_count++;
+    }
+}
+
+static void set_page_hidden(screen_ui_page_id_t page, bool hidden)
+{
+    for (int i = 0; i < UI_PANEL_COUNT; i++) {
+        lv_obj_t *cont = g_ui_mgr.pages[page].containers[i];
+        if (!cont) {
+            continue;
+        }
+        if (hidden) {
+            lv_obj_add_flag(cont, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_clear_flag(cont, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+}
+
+/*
+ * 页面隐藏期间不接收数据更新，重新显示时按全量刷新一次，
+ * 刷新请求进入合并位图，在本轮消息处理中紧接着完成
+ */
+static void request_page_data(screen_ui_page_id_t page)
+{
+    switch (page) {
+        case UI_PAGE_GROUP1:
+            g_ui_mgr.pending_full_refresh |= UI_REFRESH_WEATHER | UI_REFRESH_STOCK;
+            screen_core_post_update_time();
+            screen_core_post_update_weather(NULL);
+            screen_core_post_update_stock(NULL);
+            break;
+        case UI_PAGE_GROUP2:
+            g_ui_mgr.pending_full_refresh |= UI_REFRESH_SYSTEM;
+            screen_core_post_update_system(NULL);
+            break;
+        case UI_PAGE_L2_TIME:
+        case UI_PAGE_L2_MUYU:
+            screen_core_post_update_time();
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * 切换到指定页面：未构建则先构建，之后只翻转隐藏标志
+ */
+static int show_page(screen_ui_page_id_t page)
+{
+    if (page >= UI_PAGE_MAX) {
+        return -RT_EINVAL;
+    }
+
+    rt_tick_t start = rt_tick_get();
+
+    if (!g_ui_mgr.pages[page].built) {
+        int ret = build_page(page);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
+    if (g_ui_mgr.current_page != page && g_ui_mgr.current_page < UI_PAGE_MAX) {
+        set_page_hidden(g_ui_mgr.current_page, true);
+    }
+    set_page_hidden(page, false);
+
+    g_ui_mgr.current_page = page;
+    g_ui_mgr.pages[page].last_used = start;
+
+    enforce_page_budget();
+    request_page_data(page);
+
+    g_ui_mgr.switch_stats.switch_count++;
+    g_ui_mgr.switch_stats.last_prepare_ms = ticks_to_ms(rt_tick_get() - start);
+    g_ui_mgr.switch_start_tick = start;
+    g_ui_mgr.switch_measuring = true;
+    return 0;
+}
+
+static int show_l1_page(screen_ui_page_id_t page, screen_group_t group)
+{
+    if (!g_ui_mgr.initialized) {
+        return -RT_ERROR;
+    }
+
+    int ret = show_page(page);
+    if (ret != 0) {
+        return ret;
+    }
+
+    g_ui_mgr.current_group = group;
+    g_ui_mgr.current_level = SCREEN_LEVEL_1;
+
+    /* 激活按键上下文 */
+    screen_context_activate_for_group(group);
+    return 0;
+}
+
+static int show_l2_page(screen_ui_page_id_t page)
+{
+    if (!g_ui_mgr.initialized) {
+        return -RT_ERROR;
+    }
+
+    int ret = show_page(page);
+    if (ret != 0) {
+        return ret;
+    }
+
+    g_ui_mgr.current_level = SCREEN_LEVEL_2;
+    return 0;
+}
+
 /*********************
  *   PUBLIC API
  *********************/
@@ -1270,8 +1632,15 @@ int screen_ui_manager_init(void)
         return -RT_ERROR;
     }
 
+    /* 时钟数字预先解码并常驻，走时只是切换已解码的图片 */
+    image_cache_init();
+    for (int i = 0; i < 10; i++) {
+        image_cache_pin(digit_images[i], true);
+    }
+
     g_ui_mgr.current_group = SCREEN_GROUP_1;
     g_ui_mgr.current_level = SCREEN_LEVEL_1;
+    g_ui_mgr.current_page = UI_PAGE_NONE;
     g_ui_mgr.initialized = true;
     return 0;
 }
@@ -1284,6 +1653,8 @@ int screen_ui_manager_deinit(void)
 
     cleanup_base_ui();
     cleanup_fonts();
+    image_cache_deinit();
+    g_pinned_weather_icon = NULL;
     
     memset(&g_ui_mgr, 0, sizeof(screen_ui_manager_t));
     return 0;
@@ -1291,145 +1662,54 @@ int screen_ui_manager_deinit(void)
 
 int screen_ui_build_group1(void)
 {
-    if (!g_ui_mgr.initialized) {
-        return -RT_ERROR;
-    }
-    
-    safe_cleanup_ui_objects();
-    
-    build_left_datetime_panel(g_ui_mgr.handles.left_panel);
-    build_middle_weather_panel(g_ui_mgr.handles.middle_panel);
-    build_right_stock_panel(g_ui_mgr.handles.right_panel);
-    
-    g_ui_mgr.current_group = SCREEN_GROUP_1;
-    g_ui_mgr.current_level = SCREEN_LEVEL_1;
-    
-    /* 激活按键上下文 */
-    screen_context_activate_for_group(SCREEN_GROUP_1);
-    
-    lv_obj_invalidate(lv_scr_act());
-    
-    return 0;
+    return show_l1_page(UI_PAGE_GROUP1, SCREEN_GROUP_1);
 }
 
 int screen_ui_build_group2(void)
 {
-    if (!g_ui_mgr.initialized) {
-        return -RT_ERROR;
-    }
-    
-    safe_cleanup_ui_objects();
-    
-    build_left_cpu_gpu_panel(g_ui_mgr.handles.left_panel);
-    build_middle_memory_panel(g_ui_mgr.handles.middle_panel);
-    build_right_network_panel(g_ui_mgr.handles.right_panel);
-    
-    g_ui_mgr.current_group = SCREEN_GROUP_2;
-    g_ui_mgr.current_level = SCREEN_LEVEL_1;
-    
-    /* 激活按键上下文 */
-    screen_context_activate_for_group(SCREEN_GROUP_2);
-    
-    lv_obj_invalidate(lv_scr_act());
-    
-    return 0;
+    return show_l1_page(UI_PAGE_GROUP2, SCREEN_GROUP_2);
 }
 
 int screen_ui_build_group3(void)
 {
-    if (!g_ui_mgr.initialized) {
-        return -RT_ERROR;
-    }
-
-    
-    safe_cleanup_ui_objects();
-    
-    build_left_media_panel(g_ui_mgr.handles.left_panel);
-    build_middle_web_panel(g_ui_mgr.handles.middle_panel);
-    build_right_shortcut_panel(g_ui_mgr.handles.right_panel);
-    
-    g_ui_mgr.current_group = SCREEN_GROUP_3;
-    g_ui_mgr.current_level = SCREEN_LEVEL_1;
-    
-    /* 激活按键上下文 */
-    screen_context_activate_for_group(SCREEN_GROUP_3);
-    
-    lv_obj_invalidate(lv_scr_act());
-    
-    return 0;
+    return show_l1_page(UI_PAGE_GROUP3, SCREEN_GROUP_3);
 }
 
 int screen_ui_build_l2_time(void)
 {
-    if (!g_ui_mgr.initialized) {
-        return -RT_ERROR;
+    int ret = show_l2_page(UI_PAGE_L2_TIME);
+    if (ret == 0) {
+        /* 激活L2按键上下文 */
+        screen_context_activate_for_level2(SCREEN_L2_TIME_GROUP);
     }
-
-    
-    safe_cleanup_ui_objects();
-    build_l2_time_detail_page();  // 使用新的数字时钟页面
-    
-    g_ui_mgr.current_level = SCREEN_LEVEL_2;
-    
-    /* 激活L2按键上下文 */
-    screen_context_activate_for_level2(SCREEN_L2_TIME_GROUP);
-    
-    lv_obj_invalidate(lv_scr_act());
-    return 0;
+    return ret;
 }
 
 int screen_ui_build_l2_media(void)
 {
-    if (!g_ui_mgr.initialized) {
-        return -RT_ERROR;
+    int ret = show_l2_page(UI_PAGE_L2_MEDIA);
+    if (ret == 0) {
+        screen_context_activate_for_level2(SCREEN_L2_MEDIA_GROUP);
     }
-
-    safe_cleanup_ui_objects();
-    build_l2_media_control_page();
-    
-    g_ui_mgr.current_level = SCREEN_LEVEL_2;
-    
-    /* 激活L2按键上下文 */
-    screen_context_activate_for_level2(SCREEN_L2_MEDIA_GROUP);
-    
-    lv_obj_invalidate(lv_scr_act());
-    return 0;
+    return ret;
 }
 
 int screen_ui_build_l2_web(void)
 {
-    if (!g_ui_mgr.initialized) {
-        return -RT_ERROR;
+    int ret = show_l2_page(UI_PAGE_L2_WEB);
+    if (ret == 0) {
+        screen_context_activate_for_level2(SCREEN_L2_WEB_GROUP);
     }
-
-    safe_cleanup_ui_objects();
-    build_l2_web_control_page();
-    
-    g_ui_mgr.current_level = SCREEN_LEVEL_2;
-    
-    /* 激活L2按键上下文 */
-    screen_context_activate_for_level2(SCREEN_L2_WEB_GROUP);
-    
-    lv_obj_invalidate(lv_scr_act());
-    return 0;
+    return ret;
 }
 
 int screen_ui_build_l2_shortcut(void)
 {
-    if (!g_ui_mgr.initialized) {
-        return -RT_ERROR;
+    int ret = show_l2_page(UI_PAGE_L2_SHORTCUT);
+    if (ret == 0) {
+        screen_context_activate_for_level2(SCREEN_L2_SHORTCUT_GROUP);
     }
-
-    safe_cleanup_ui_objects();
-    build_l2_shortcut_control_page();
-    
-    g_ui_mgr.current_level = SCREEN_LEVEL_2;
-    
-    /* 激活L2按键上下文 */
-    screen_context_activate_for_level2(SCREEN_L2_SHORTCUT_GROUP);
-    
-    lv_obj_invalidate(lv_scr_act());
-    return 0;
+    return ret;
 }
 
 int screen_ui_switch_to_group(screen_group_t target_group)
@@ -1497,19 +1777,18 @@ int screen_ui_update_time_display(void)
         return 0;
     }
     
-    if (g_ui_mgr.handles.l2_muyu_main.counter_label && 
-        lv_obj_is_valid(g_ui_mgr.handles.l2_muyu_main.counter_label)) {
+    /* 页面常驻后句柄一直有效，按当前显示的页面分派 */
+    if (g_ui_mgr.current_page == UI_PAGE_L2_MUYU) {
         // 在木鱼页面,调用木鱼更新函数
         return screen_ui_update_muyu_display();
     }
-    if (g_ui_mgr.handles.l2_digital_clock.hour_tens && 
-        lv_obj_is_valid(g_ui_mgr.handles.l2_digital_clock.hour_tens)) {
-        // 数字时钟UI存在，更新数字时钟
+    if (g_ui_mgr.current_page == UI_PAGE_L2_TIME) {
+        // 数字时钟页面，更新数字时钟
         return screen_ui_update_l2_digital_clock();
     }
     
     // L1层级的常规时间显示更新
-    if (g_ui_mgr.current_group != SCREEN_GROUP_1) {
+    if (g_ui_mgr.current_page != UI_PAGE_GROUP1) {
         return 0;
     }
     
@@ -1549,99 +1828,251 @@ int screen_ui_update_time_display(void)
     return 0;
 }
 
-int screen_ui_update_weather_display(const weather_data_t *data)
+/* 取出并清除组件重建标记，重建后首次更新按全量刷新 */
+static uint32_t resolve_dirty_mask(uint8_t refresh_bit, uint32_t dirty_mask, uint32_t all_mask)
+{
+    if (g_ui_mgr.pending_full_refresh & refresh_bit) {
+        g_ui_mgr.pending_full_refresh &= ~refresh_bit;
+        return all_mask;
+    }
+    return dirty_mask;
+}
+
+/* 数据过期时降低标签不透明度显示为灰色，恢复有效后还原；只在状态变化时设置样式 */
+static void set_objs_expired(lv_obj_t *const *objs, size_t count, bool expired)
+{
+    lv_opa_t opa = expired ? LV_OPA_40 : LV_OPA_COVER;
+    for (size_t i = 0; i < count; i++) {
+        if (objs[i] && lv_obj_is_valid(objs[i]) &&
+            lv_obj_get_style_opa(objs[i], LV_PART_MAIN) != opa) {
+            lv_obj_set_style_opa(objs[i], opa, LV_PART_MAIN);
+        }
+    }
+}
+
+/* 显示/隐藏"缓存"标记，标记在首次需要时才创建 */
+static void set_stale_badge(lv_obj_t **badge, lv_obj_t *anchor, lv_align_t align,
+                            int32_t x_ofs, int32_t y_ofs, bool stale)
+{
+    if (!anchor || !lv_obj_is_valid(anchor)) {
+        return;
+    }
+
+    if (!*badge || !lv_obj_is_valid(*badge)) {
+        if (!stale) {
+            return;
+        }
+        *badge = lv_label_create(lv_obj_get_parent(anchor));
+        lv_label_set_text(*badge, "缓存");
+        lv_obj_add_style(*badge, &g_ui_mgr.handles.style_xsmall, 0);
+        lv_obj_set_style_text_color(*badge, lv_color_make(140, 140, 140), 0);
+        if (align >= LV_ALIGN_OUT_TOP_LEFT) {
+            lv_obj_align_to(*badge, anchor, align, x_ofs, y_ofs);
+        } else {
+            lv_obj_align(*badge, align, x_ofs, y_ofs);
+        }
+    }
+
+    if (stale) {
+        lv_obj_clear_flag(*badge, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(*badge, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+int screen_ui_update_weather_display(const weather_data_t *data, uint32_t dirty_mask)
 {
-    if (!g_ui_mgr.initialized || g_ui_mgr.current_group != SCREEN_GROUP_1 || !data || !data->valid) {
+    if (!g_ui_mgr.initialized || g_ui_mgr.current_page != UI_PAGE_GROUP1 || !data) {
+        return 0;
+    }
+
+    dirty_mask = resolve_dirty_mask(UI_REFRESH_WEATHER, dirty_mask, WEATHER_FIELD_ALL);
+    if (dirty_mask == 0) {
+        return 0;
+    }
+
+    /* 过期数据保留最后的显示内容并灰显；板载传感器标签不受影响 */
+    lv_obj_t *const weather_objs[] = {
+        g_ui_mgr.handles.group1_weather.city_label,
+        g_ui_mgr.handles.group1_weather.weather_label,
+        g_ui_mgr.handles.group1_weather.temperature_label,
+        g_ui_mgr.handles.group1_weather.humidity_label,
+        g_ui_mgr.handles.group1_weather.pressure_label,
+        g_ui_mgr.handles.group1_weather.weather_icon,
+    };
+    set_objs_expired(weather_objs, sizeof(weather_objs) / sizeof(weather_objs[0]), !data->valid);
+    if (!data->valid) {
         return 0;
     }
 
     /* 更新城市名 */
-    if (g_ui_mgr.handles.group1_weather.city_label && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.city_label)) {
+    if ((dirty_mask & WEATHER_FIELD_CITY) &&
+        g_ui_mgr.handles.group1_weather.city_label && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.city_label)) {
         lv_label_set_text(g_ui_mgr.handles.group1_weather.city_label, data->city);
     }
 
     /* 更新温度 */
-    if (g_ui_mgr.handles.group1_weather.temperature_label && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.temperature_label)) {
+    if ((dirty_mask & WEATHER_FIELD_TEMPERATURE) &&
+        g_ui_mgr.handles.group1_weather.temperature_label && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.temperature_label)) {
         char temp_str[16];
         rt_snprintf(temp_str, sizeof(temp_str), "%.1f°C", data->temperature);
         lv_label_set_text(g_ui_mgr.handles.group1_weather.temperature_label, temp_str);
     }
 
     /* 更新天气描述和天气图标 */
-    if (g_ui_mgr.handles.group1_weather.weather_label && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.weather_label)) {
+    if ((dirty_mask & WEATHER_FIELD_WEATHER) &&
+        g_ui_mgr.handles.group1_weather.weather_label && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.weather_label)) {
         lv_label_set_text(g_ui_mgr.handles.group1_weather.weather_label, data->weather);
     }
-    if (g_ui_mgr.handles.group1_weather.weather_icon && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.weather_icon)) {
+    if ((dirty_mask & WEATHER_FIELD_CODE) &&
+        g_ui_mgr.handles.group1_weather.weather_icon && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.weather_icon)) {
         const lv_image_dsc_t* weather_icon = get_weather_icon_by_code(data->weather_code);
-        lv_img_set_src(g_ui_mgr.handles.group1_weather.weather_icon, weather_icon);
+        set_weather_icon(g_ui_mgr.handles.group1_weather.weather_icon, weather_icon);
     }
     /* 更新湿度 */
-    if (g_ui_mgr.handles.group1_weather.humidity_label && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.humidity_label)) {
+    if ((dirty_mask & WEATHER_FIELD_HUMIDITY) &&
+        g_ui_mgr.handles.group1_weather.humidity_label && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.humidity_label)) {
         char humidity_str[16];
         rt_snprintf(humidity_str, sizeof(humidity_str), "%.0f%%", data->humidity);
         lv_label_set_text(g_ui_mgr.handles.group1_weather.humidity_label, humidity_str);
     }
 
     /* 更新气压 */
-    if (g_ui_mgr.handles.group1_weather.pressure_label && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.pressure_label)) {
+    if ((dirty_mask & WEATHER_FIELD_PRESSURE) &&
+        g_ui_mgr.handles.group1_weather.pressure_label && lv_obj_is_valid(g_ui_mgr.handles.group1_weather.pressure_label)) {
         char pressure_str[16];
         rt_snprintf(pressure_str, sizeof(pressure_str), "%dhPa", data->pressure);
         lv_label_set_text(g_ui_mgr.handles.group1_weather.pressure_label, pressure_str);
     }
 
+    /* 快照数据标记 - 温度下方 */
+    if (dirty_mask & WEATHER_FIELD_STALE) {
+        set_stale_badge(&g_ui_mgr.handles.group1_weather.stale_badge,
+                        g_ui_mgr.handles.group1_weather.temperature_label,
+                        LV_ALIGN_OUT_BOTTOM_RIGHT, 0, 2, data->stale);
+    }
+
     return 0;
 }
 
-int screen_ui_update_stock_display(const stock_data_t *data)
+int screen_ui_update_stock_display(const stock_data_t *data, uint32_t dirty_mask)
 {
-    if (!g_ui_mgr.initialized || g_ui_mgr.current_group != SCREEN_GROUP_1 || !data || !data->valid) {
+    if (!g_ui_mgr.initialized || g_ui_mgr.current_page != UI_PAGE_GROUP1 || !data) {
+        return 0;
+    }
+
+    dirty_mask = resolve_dirty_mask(UI_REFRESH_STOCK, dirty_mask, STOCK_FIELD_ALL);
+    if (dirty_mask == 0) {
+        return 0;
+    }
+
+    lv_obj_t *const stock_objs[] = {
+        g_ui_mgr.handles.group1_stock.name_label,
+        g_ui_mgr.handles.group1_stock.price_label,
+        g_ui_mgr.handles.group1_stock.change_label,
+        g_ui_mgr.handles.group1_stock.update_time_label,
+    };
+    set_objs_expired(stock_objs, sizeof(stock_objs) / sizeof(stock_objs[0]), !data->valid);
+    if (!data->valid) {
         return 0;
     }
 
     /* 更新股票名称 */
-    if (g_ui_mgr.handles.group1_stock.name_label && lv_obj_is_valid(g_ui_mgr.handles.group1_stock.name_label)) {
-        lv_label_set_text(g_ui_mgr.handles.group1_stock.name_label, data->name);
+    if ((dirty_mask & STOCK_FIELD_NAME) &&
+        g_ui_mgr.handles.group1_stock.name_label && lv_obj_is_valid(g_ui_mgr.handles.group1_stock.name_label)) {
+        char name[STOCK_NAME_LEN];
+        stock_name_copy(data->name_id, name, sizeof(name));
+        lv_label_set_text(g_ui_mgr.handles.group1_stock.name_label, name);
     }
 
     /* 更新价格 */
-    if (g_ui_mgr.handles.group1_stock.price_label && lv_obj_is_valid(g_ui_mgr.handles.group1_stock.price_label)) {
+    if ((dirty_mask & STOCK_FIELD_PRICE) &&
+        g_ui_mgr.handles.group1_stock.price_label && lv_obj_is_valid(g_ui_mgr.handles.group1_stock.price_label)) {
         char price_str[16];
-        rt_snprintf(price_str, sizeof(price_str), "%.2f", data->current_price);
+        stock_format_x100(price_str, sizeof(price_str), data->price_x100, false);
         lv_label_set_text(g_ui_mgr.handles.group1_stock.price_label, price_str);
     }
 
     /* 更新涨跌幅 */
-    if (g_ui_mgr.handles.group1_stock.change_label && lv_obj_is_valid(g_ui_mgr.handles.group1_stock.change_label)) {
+    if ((dirty_mask & STOCK_FIELD_CHANGE) &&
+        g_ui_mgr.handles.group1_stock.change_label && lv_obj_is_valid(g_ui_mgr.handles.group1_stock.change_label)) {
+        char value_str[16];
+        char percent_str[16];
         char change_str[32];
-        rt_snprintf(change_str, sizeof(change_str), "%+.2f\n%+.2f%%", 
-                   data->change_value, data->change_percent);
+        stock_format_x100(value_str, sizeof(value_str), data->change_x100, true);
+        stock_format_x100(percent_str, sizeof(percent_str), stock_change_percent_x100(data), true);
+        rt_snprintf(change_str, sizeof(change_str), "%s\n%s%%", value_str, percent_str);
         lv_label_set_text(g_ui_mgr.handles.group1_stock.change_label, change_str);
         
         /* 根据涨跌设置颜色 */
-        lv_color_t color = (data->change_value >= 0) ? 
+        lv_color_t color = (data->change_x100 >= 0) ? 
                           lv_color_make(255, 80, 80) :   /* 红色上涨 */
                           lv_color_make(80, 255, 80);    /* 绿色下跌 */
         lv_obj_set_style_text_color(g_ui_mgr.handles.group1_stock.change_label, color, 0);
     }
 
-    /* 更新时间 */
-    if (g_ui_mgr.handles.group1_stock.update_time_label && lv_obj_is_valid(g_ui_mgr.handles.group1_stock.update_time_label)) {
-        lv_label_set_text(g_ui_mgr.handles.group1_stock.update_time_label, data->update_time);
+    /* 更新时间和自选股序号，时间戳在此处才格式化 */
+    if ((dirty_mask & (STOCK_FIELD_UPDATE_TIME | STOCK_FIELD_PAGE)) &&
+        g_ui_mgr.handles.group1_stock.update_time_label && lv_obj_is_valid(g_ui_mgr.handles.group1_stock.update_time_label)) {
+        char time_str[32] = "--:--:--";
+        time_t update_time = (time_t)data->update_time;
+        struct tm *tm_info = (data->update_time != 0) ? localtime(&update_time) : NULL;
+        if (tm_info) {
+            rt_snprintf(time_str, sizeof(time_str), "%02d:%02d:%02d",
+                       tm_info->tm_hour, tm_info->tm_min, tm_info->tm_sec);
+        }
+
+        uint8_t index = 0, count = 0;
+        data_manager_get_stock_position(&index, &count);
+        if (count > 1) {
+            size_t len = strlen(time_str);
+            rt_snprintf(time_str + len, sizeof(time_str) - len, "  %d/%d", index + 1, count);
+        }
+        lv_label_set_text(g_ui_mgr.handles.group1_stock.update_time_label, time_str);
+    }
+
+    /* 快照数据标记 - 右上角 */
+    if (dirty_mask & STOCK_FIELD_STALE) {
+        set_stale_badge(&g_ui_mgr.handles.group1_stock.stale_badge,
+                        g_ui_mgr.handles.group1_stock.name_label,
+                        LV_ALIGN_TOP_RIGHT, 0, 0, data->stale);
     }
 
     return 0;
 }
 
-int screen_ui_update_system_display(const system_monitor_data_t *data)
+int screen_ui_update_system_display(const system_monitor_data_t *data, uint32_t dirty_mask)
 {
-    if (!g_ui_mgr.initialized || g_ui_mgr.current_group != SCREEN_GROUP_2 || !data || !data->valid) {
+    if (!g_ui_mgr.initialized || g_ui_mgr.current_page != UI_PAGE_GROUP2 || !data) {
+        return 0;
+    }
+
+    /* 标签只在显示内容变化时刷新；柱状图按更新次数滚动，与是否变化无关 */
+    dirty_mask = resolve_dirty_mask(UI_REFRESH_SYSTEM, dirty_mask, SYS_FIELD_ALL);
+
+    /* 过期时灰显数值和图表，图表不再滚动 */
+    lv_obj_t *const system_objs[] = {
+        g_ui_mgr.handles.group2_cpu_gpu.cpu_usage,
+        g_ui_mgr.handles.group2_cpu_gpu.cpu_temp,
+        g_ui_mgr.handles.group2_cpu_gpu.cpu_chart,
+        g_ui_mgr.handles.group2_cpu_gpu.gpu_usage,
+        g_ui_mgr.handles.group2_cpu_gpu.gpu_temp,
+        g_ui_mgr.handles.group2_cpu_gpu.gpu_chart,
+        g_ui_mgr.handles.group2_memory.ram_usage,
+        g_ui_mgr.handles.group2_memory.ram_chart,
+        g_ui_mgr.handles.group2_network.net_upload,
+        g_ui_mgr.handles.group2_network.net_download,
+    };
+    set_objs_expired(system_objs, sizeof(system_objs) / sizeof(system_objs[0]), !data->valid);
+    if (!data->valid) {
         return 0;
     }
 
     /* ========== CPU 左屏更新 ========== */
     
     /* 更新CPU温度 */
-    if (g_ui_mgr.handles.group2_cpu_gpu.cpu_temp && lv_obj_is_valid(g_ui_mgr.handles.group2_cpu_gpu.cpu_temp)) {
+    if ((dirty_mask & SYS_FIELD_CPU_TEMP) &&
+        g_ui_mgr.handles.group2_cpu_gpu.cpu_temp && lv_obj_is_valid(g_ui_mgr.handles.group2_cpu_gpu.cpu_temp)) {
         char temp_str[16];
         rt_snprintf(temp_str, sizeof(temp_str), "%.1f°C", data->cpu_temp);
         lv_label_set_text(g_ui_mgr.handles.group2_cpu_gpu.cpu_temp, temp_str);
@@ -1649,9 +2080,11 @@ int screen_ui_update_system_display(const system_monitor_data_t *data)
 
     /* 更新CPU使用率 */
     if (g_ui_mgr.handles.group2_cpu_gpu.cpu_usage && lv_obj_is_valid(g_ui_mgr.handles.group2_cpu_gpu.cpu_usage)) {
-        char usage_str[16];
-        rt_snprintf(usage_str, sizeof(usage_str), "%.1f%%", data->cpu_usage);
-        lv_label_set_text(g_ui_mgr.handles.group2_cpu_gpu.cpu_usage, usage_str);
+        if (dirty_mask & SYS_FIELD_CPU_USAGE) {
+            char usage_str[16];
+            rt_snprintf(usage_str, sizeof(usage_str), "%.1f%%", data->cpu_usage);
+            lv_label_set_text(g_ui_mgr.handles.group2_cpu_gpu.cpu_usage, usage_str);
+        }
         
         /* ✅ 添加静态计数器，控制图表更新频率 */
         static uint8_t cpu_update_counter = 0;
@@ -1690,7 +2123,8 @@ int screen_ui_update_system_display(const system_monitor_data_t *data)
     /* ========== GPU 右屏更新 ========== */
     
     /* 更新GPU温度 */
-    if (g_ui_mgr.handles.group2_cpu_gpu.gpu_temp && lv_obj_is_valid(g_ui_mgr.handles.group2_cpu_gpu.gpu_temp)) {
+    if ((dirty_mask & SYS_FIELD_GPU_TEMP) &&
+        g_ui_mgr.handles.group2_cpu_gpu.gpu_temp && lv_obj_is_valid(g_ui_mgr.handles.group2_cpu_gpu.gpu_temp)) {
         char temp_str[16];
         rt_snprintf(temp_str, sizeof(temp_str), "%.1f°C", data->gpu_temp);
         lv_label_set_text(g_ui_mgr.handles.group2_cpu_gpu.gpu_temp, temp_str);
@@ -1698,9 +2132,11 @@ int screen_ui_update_system_display(const system_monitor_data_t *data)
 
     /* 更新GPU使用率 */
     if (g_ui_mgr.handles.group2_cpu_gpu.gpu_usage && lv_obj_is_valid(g_ui_mgr.handles.group2_cpu_gpu.gpu_usage)) {
-        char usage_str[16];
-        rt_snprintf(usage_str, sizeof(usage_str), "%.1f%%", data->gpu_usage);
-        lv_label_set_text(g_ui_mgr.handles.group2_cpu_gpu.gpu_usage, usage_str);
+        if (dirty_mask & SYS_FIELD_GPU_USAGE) {
+            char usage_str[16];
+            rt_snprintf(usage_str, sizeof(usage_str), "%.1f%%", data->gpu_usage);
+            lv_label_set_text(g_ui_mgr.handles.group2_cpu_gpu.gpu_usage, usage_str);
+        }
         
         /* ✅ GPU图表也添加节流 */
         static uint8_t gpu_update_counter = 0;
@@ -1736,12 +2172,21 @@ int screen_ui_update_system_display(const system_monitor_data_t *data)
         }
     }
 
+    /* 快照数据标记 - 中屏右上角 */
+    if (dirty_mask & SYS_FIELD_STALE) {
+        set_stale_badge(&g_ui_mgr.handles.group2_memory.stale_badge,
+                        g_ui_mgr.handles.group2_memory.ram_usage,
+                        LV_ALIGN_TOP_RIGHT, -5, 5, data->stale);
+    }
+
     /* 更新内存使用率 - 中屏左侧 */
     if (g_ui_mgr.handles.group2_memory.ram_usage && 
         lv_obj_is_valid(g_ui_mgr.handles.group2_memory.ram_usage)) {
-        char ram_str[16];
-        rt_snprintf(ram_str, sizeof(ram_str), "%.1f%%", data->ram_usage);
-        lv_label_set_text(g_ui_mgr.handles.group2_memory.ram_usage, ram_str);
+        if (dirty_mask & SYS_FIELD_RAM_USAGE) {
+            char ram_str[16];
+            rt_snprintf(ram_str, sizeof(ram_str), "%.1f%%", data->ram_usage);
+            lv_label_set_text(g_ui_mgr.handles.group2_memory.ram_usage, ram_str);
+        }
             /* 内存图表更新（节流处理，每5次更新一次） */
     static uint8_t mem_update_counter = 0;
     mem_update_counter++;
@@ -1778,7 +2223,8 @@ int screen_ui_update_system_display(const system_monitor_data_t *data)
 }
     
     /* 更新网络上传速度 - 中屏右侧 */
-    if (g_ui_mgr.handles.group2_network.net_upload && 
+    if ((dirty_mask & SYS_FIELD_NET_UPLOAD) &&
+        g_ui_mgr.handles.group2_network.net_upload && 
         lv_obj_is_valid(g_ui_mgr.handles.group2_network.net_upload)) {
         char upload_str[32];
         rt_snprintf(upload_str, sizeof(upload_str), "%.2fMB/s", data->net_upload_speed);
@@ -1786,7 +2232,8 @@ int screen_ui_update_system_display(const system_monitor_data_t *data)
     }
     
     /* 更新网络下载速度 - 中屏右侧 */
-    if (g_ui_mgr.handles.group2_network.net_download && 
+    if ((dirty_mask & SYS_FIELD_NET_DOWNLOAD) &&
+        g_ui_mgr.handles.group2_network.net_download && 
         lv_obj_is_valid(g_ui_mgr.handles.group2_network.net_download)) {
         char download_str[32];
         rt_snprintf(download_str, sizeof(download_str), "%.2fMB/s", data->net_download_speed);
@@ -1798,7 +2245,7 @@ int screen_ui_update_system_display(const system_monitor_data_t *data)
 
 int screen_ui_update_sensor_display(void)
 {
-    if (!g_ui_mgr.initialized || g_ui_mgr.current_group != SCREEN_GROUP_1) {
+    if (!g_ui_mgr.initialized || g_ui_mgr.current_page != UI_PAGE_GROUP1) {
         return 0;
     }
 
@@ -1807,19 +2254,20 @@ int screen_ui_update_sensor_display(void)
     }
 
     sht30_data_t data = {0};
-    if (sht30_controller_get_latest(&data) == RT_EOK && data.valid) {
-        rt_tick_t now = rt_tick_get();
-        if ((now - data.timestamp) <= rt_tick_from_millisecond(20000)) {
-            char sensor_str[32];
-            rt_snprintf(sensor_str, sizeof(sensor_str), "当前: %.1f°C %.0f%%",
-                      data.temperature_c, data.humidity_rh);
-            lv_label_set_text(g_ui_mgr.handles.group1_weather.sensor_label, sensor_str);
-        } else {
-            lv_label_set_text(g_ui_mgr.handles.group1_weather.sensor_label, "当前: --°C --%");
-        }
+    char sensor_str[32];
+    float temperature = 0.0f, humidity = 0.0f;
+    if (sht30_controller_get_latest(&data) == RT_EOK && data.valid &&
+        (rt_tick_get() - data.timestamp) <= rt_tick_from_millisecond(20000)) {
+        rt_snprintf(sensor_str, sizeof(sensor_str), "当前: %.1f°C %.0f%%",
+                  data.temperature_c, data.humidity_rh);
+    } else if (data_manager_get_last_known_sensor(&temperature, &humidity) == 0) {
+        /* 传感器暂无读数时显示快照中的值 */
+        rt_snprintf(sensor_str, sizeof(sensor_str), "缓存: %.1f°C %.0f%%",
+                  temperature, humidity);
     } else {
-        lv_label_set_text(g_ui_mgr.handles.group1_weather.sensor_label, "当前: --°C --%");
+        rt_snprintf(sensor_str, sizeof(sensor_str), "当前: --°C --%%");
     }
+    lv_label_set_text(g_ui_mgr.handles.group1_weather.sensor_label, sensor_str);
 
     return 0;
 }
@@ -1830,7 +2278,11 @@ int screen_ui_cleanup_current_group(void)
         return 0;
     }
 
-    safe_cleanup_ui_objects();
+    /* 销毁当前页面，下次进入时重新构建 */
+    if (g_ui_mgr.current_page < UI_PAGE_MAX) {
+        release_page(g_ui_mgr.current_page);
+        g_ui_mgr.current_page = UI_PAGE_NONE;
+    }
     return 0;
 }
 
@@ -1854,6 +2306,62 @@ bool screen_ui_is_initialized(void)
     return g_ui_mgr.initialized;
 }
 
+lv_obj_t *screen_ui_get_panel(int index)
+{
+    if (index < 0 || index >= LCD_PANEL_NUM) {
+        return NULL;
+    }
+    return g_ui_mgr.handles.panels[index];
+}
+
+int screen_ui_get_switch_stats(screen_ui_switch_stats_t *stats)
+{
+    if (!stats) {
+        return -RT_EINVAL;
+    }
+
+    /* 统计在GUI线程更新，shell读取时整体拷贝 */
+    rt_enter_critical();
+    *stats = g_ui_mgr.switch_stats;
+    rt_exit_critical();
+    return 0;
+}
+
+void screen_ui_note_frame_rendered(void)
+{
+    if (!g_ui_mgr.switch_measuring) {
+        return;
+    }
+    g_ui_mgr.switch_measuring = false;
+
+    screen_ui_switch_stats_t *st = &g_ui_mgr.switch_stats;
+    uint32_t ms = ticks_to_ms(rt_tick_get() - g_ui_mgr.switch_start_tick);
+
+    st->last_total_ms = ms;
+    if (ms > st->max_total_ms) {
+        st->max_total_ms = ms;
+    }
+    /* 1/8权重的滑动平均 */
+    st->avg_total_ms = (st->avg_total_ms == 0) ? ms : (st->avg_total_ms * 7 + ms) / 8;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void ui_switch(int argc, char **argv)
+{
+    screen_ui_switch_stats_t s;
+    screen_ui_get_switch_stats(&s);
+
+    rt_kprintf("switches %u, prepare last %u ms, to first frame last %u avg %u max %u ms\n",
+               s.switch_count, s.last_prepare_ms, s.last_total_ms, s.avg_total_ms, s.max_total_ms);
+    rt_kprintf("builds %u, evictions %u, retained %u pages %u / %u bytes\n",
+               s.build_count, s.evict_count, s.retained_pages,
+               s.retained_bytes, SCREEN_UI_PAGE_BUDGET_KB * 1024u);
+}
+MSH_CMD_EXPORT(ui_switch, screen group switch stats);
+#endif /* RT_USING_FINSH */
+
 
 /*********************
  *   GROUP 4 UI BUILD - 新增实用工具页面
@@ -1929,18 +2437,9 @@ static lv_obj_t* create_entrance_icon(lv_obj_t *parent, const lv_image_dsc_t *im
         return NULL;
     }
     
-    // 设置图片资源
-    lv_image_set_src(img, img_src);
-    
-    /* 入口图标使用较小尺寸 - 缩小50% */
-    lv_coord_t icon_size = (lv_coord_t)(SCREEN_WIDTH * 0.1f);  // 25%
-    lv_obj_set_size(img, icon_size, icon_size);
-    
-    // 适中的缩放比例 - 缩小50%
-    float scale = g_ui_mgr.scale_factor * 0.50f;
-    
-    lv_img_set_zoom(img, (int)(LV_IMG_ZOOM_NONE * scale));
-    lv_img_set_antialias(img, true);
+    // 设置图片资源 - 构建时已预缩放到入口图标尺寸，原尺寸绘制
+    image_cache_set_src(img, img_src);
+    lv_obj_set_size(img, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     
     // 移除所有边距和边框
     lv_obj_set_style_pad_all(img, 0, 0);
@@ -1956,22 +2455,13 @@ static lv_obj_t* create_fullsize_icon(lv_obj_t *parent, const lv_image_dsc_t *im
         return NULL;
     }
     
-    // 设置图片资源
-    lv_img_set_src(img, img_src);
-    
-    // 全板块尺寸 - 占满整个面板
-    lv_coord_t icon_size = SCREEN_WIDTH;
-    lv_obj_set_size(img, icon_size, icon_size);
+    // 设置图片资源 - 构建时已预缩放到整块面板尺寸，原尺寸绘制
+    image_cache_set_src(img, img_src);
+    lv_obj_set_size(img, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     
     // 居中显示
     lv_obj_align(img, LV_ALIGN_CENTER, 0, 0);
     
-    // 适中的缩放比例 - 根据实际图片大小调整
-    float scale = g_ui_mgr.scale_factor * 0.57f;  // 可根据需要调整
-    
-    lv_img_set_zoom(img, (int)(LV_IMG_ZOOM_NONE * scale));
-    lv_img_set_antialias(img, true);
-    
     // 移除所有边距和边框
     lv_obj_set_style_pad_all(img, 0, 0);
     lv_obj_set_style_border_width(img, 0, 0);
@@ -2012,6 +2502,11 @@ static const lv_image_dsc_t* get_muyu_image(void)
 {
     return &muyu;
 }
+//获取L2木鱼展示图片资源
+static const lv_image_dsc_t* get_muyu_l2_image(void)
+{
+    return &muyu_l2;
+}
 //获取番茄钟图片资源
 static const lv_image_dsc_t* get_tomato_image(void)
 {
@@ -2088,24 +2583,13 @@ static lv_obj_t* create_muyu_display_image(lv_obj_t *parent)
         return NULL;
     }
     
-    // 设置木鱼图片资源
-    lv_img_set_src(img, get_muyu_image());
-    
-    /* 复用入口图标的处理方式 - 合适的尺寸和缩放 */
-    lv_coord_t icon_size = (lv_coord_t)(SCREEN_WIDTH * 0.25f);  // 使用和入口一样的25%
-    lv_obj_set_size(img, icon_size, icon_size);
+    // 设置木鱼图片资源 - 构建时已预缩放到展示尺寸，原尺寸绘制
+    image_cache_set_src(img, get_muyu_l2_image());
+    lv_obj_set_size(img, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     
     // 设置位置 - 居中显示
     lv_obj_align(img, LV_ALIGN_CENTER, 0, 0);
     
-    // 适中的缩放比例 - 和入口图标一样
-    float scale = g_ui_mgr.scale_factor * 0.4f;  // 使用和入口一样的0.4f
-    if (scale < 0.3f) scale = 0.3f;
-    if (scale > 1.0f) scale = 1.0f;  // 最大缩放限制
-    
-    lv_img_set_zoom(img, (int)(LV_IMG_ZOOM_NONE * scale));
-    lv_img_set_antialias(img, true);
-    
     // 移除所有边距和边框
     lv_obj_set_style_pad_all(img, 0, 0);
     lv_obj_set_style_border_width(img, 0, 0);
@@ -2120,18 +2604,18 @@ static lv_obj_t* create_muyu_display_image(lv_obj_t *parent)
 /**
  * 构建L2赛博木鱼主界面
  */
-static void build_l2_muyu_main_page(void)
+static void build_l2_muyu_main_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right)
 {
     
-    if (!g_ui_mgr.handles.left_panel || !g_ui_mgr.handles.middle_panel || !g_ui_mgr.handles.right_panel) {
+    if (!left || !middle || !right) {
         return;
     }
     
     // === 左板块：木鱼图片（纯展示，KEY1触发） ===
-    g_ui_mgr.handles.l2_muyu_main.muyu_image = create_muyu_display_image(g_ui_mgr.handles.left_panel);
+    g_ui_mgr.handles.l2_muyu_main.muyu_image = create_muyu_display_image(left);
     
     // 添加按键提示文字
-    lv_obj_t *key_hint = lv_label_create(g_ui_mgr.handles.left_panel);
+    lv_obj_t *key_hint = lv_label_create(left);
     lv_label_set_text(key_hint, "按键1敲击");
     lv_obj_add_style(key_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(key_hint, lv_color_make(255, 215, 0), 0);
@@ -2139,21 +2623,21 @@ static void build_l2_muyu_main_page(void)
     
     // === 中板块：计数器显示 ===
     // 当前计数标题
-    lv_obj_t *counter_title = lv_label_create(g_ui_mgr.handles.middle_panel);
+    lv_obj_t *counter_title = lv_label_create(middle);
     lv_label_set_text(counter_title, "功德");
     lv_obj_add_style(counter_title, &g_ui_mgr.handles.style_large, 0);
     lv_obj_set_style_text_color(counter_title, lv_color_make(255, 215, 0), 0);
     lv_obj_align(counter_title, LV_ALIGN_TOP_MID, 0, 15);
     
     // 当前计数显示
-    g_ui_mgr.handles.l2_muyu_main.counter_label = lv_label_create(g_ui_mgr.handles.middle_panel);
+    g_ui_mgr.handles.l2_muyu_main.counter_label = lv_label_create(middle);
     lv_label_set_text(g_ui_mgr.handles.l2_muyu_main.counter_label, "0");
     lv_obj_add_style(g_ui_mgr.handles.l2_muyu_main.counter_label, &g_ui_mgr.handles.style_xxlarge, 0);
     lv_obj_set_style_text_color(g_ui_mgr.handles.l2_muyu_main.counter_label, lv_color_make(255, 215, 0), 0);
     lv_obj_align(g_ui_mgr.handles.l2_muyu_main.counter_label, LV_ALIGN_CENTER, 0, -10);
     
     // 当前会话提示
-    lv_obj_t *session_hint = lv_label_create(g_ui_mgr.handles.middle_panel);
+    lv_obj_t *session_hint = lv_label_create(middle);
     lv_label_set_text(session_hint, "本次");
     lv_obj_add_style(session_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(session_hint, lv_color_make(180, 180, 180), 0);
@@ -2161,28 +2645,28 @@ static void build_l2_muyu_main_page(void)
     
     // === 右板块：总计数和功德信息 ===
     // 总计数标题
-    lv_obj_t *total_title = lv_label_create(g_ui_mgr.handles.right_panel);
+    lv_obj_t *total_title = lv_label_create(right);
     lv_label_set_text(total_title, "总计");
     lv_obj_add_style(total_title, &g_ui_mgr.handles.style_medium, 0);
     lv_obj_set_style_text_color(total_title, lv_color_make(100, 200, 255), 0);
     lv_obj_align(total_title, LV_ALIGN_TOP_MID, 0, 10);
     
     // 总计数显示
-    g_ui_mgr.handles.l2_muyu_main.total_label = lv_label_create(g_ui_mgr.handles.right_panel);
+    g_ui_mgr.handles.l2_muyu_main.total_label = lv_label_create(right);
     lv_label_set_text(g_ui_mgr.handles.l2_muyu_main.total_label, "--");
     lv_obj_add_style(g_ui_mgr.handles.l2_muyu_main.total_label, &g_ui_mgr.handles.style_large, 0);
     lv_obj_set_style_text_color(g_ui_mgr.handles.l2_muyu_main.total_label, lv_color_white(), 0);
     lv_obj_align_to(g_ui_mgr.handles.l2_muyu_main.total_label, total_title, LV_ALIGN_OUT_BOTTOM_MID, 0, 5);
     
     // 功德等级显示
-    g_ui_mgr.handles.l2_muyu_main.merit_label = lv_label_create(g_ui_mgr.handles.right_panel);
+    g_ui_mgr.handles.l2_muyu_main.merit_label = lv_label_create(right);
     lv_label_set_text(g_ui_mgr.handles.l2_muyu_main.merit_label, "lv1");
     lv_obj_add_style(g_ui_mgr.handles.l2_muyu_main.merit_label, &g_ui_mgr.handles.style_medium, 0);
     lv_obj_set_style_text_color(g_ui_mgr.handles.l2_muyu_main.merit_label, lv_color_make(144, 238, 144), 0);
     lv_obj_align(g_ui_mgr.handles.l2_muyu_main.merit_label, LV_ALIGN_CENTER, 0, 10);
     
     // 重置提示
-    g_ui_mgr.handles.l2_muyu_main.reset_hint = lv_label_create(g_ui_mgr.handles.right_panel);
+    g_ui_mgr.handles.l2_muyu_main.reset_hint = lv_label_create(right);
     lv_label_set_text(g_ui_mgr.handles.l2_muyu_main.reset_hint, "按键2重置");
     lv_obj_add_style(g_ui_mgr.handles.l2_muyu_main.reset_hint, &g_ui_mgr.handles.style_small, 0);
     lv_obj_set_style_text_color(g_ui_mgr.handles.l2_muyu_main.reset_hint, lv_color_make(180, 180, 180), 0);
@@ -2197,89 +2681,63 @@ static void build_l2_muyu_main_page(void)
 }
 
 
+static void build_group4_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right)
+{
+    build_left_muyu_panel(left);
+    build_middle_tomato_panel(middle);
+    build_right_gallery_panel(right);
+}
+
+/**
+ * 临时显示"开发中"界面
+ */
+static void build_l2_placeholder_page(lv_obj_t *middle, const char *text)
+{
+    lv_obj_t *temp_label = lv_label_create(middle);
+    lv_label_set_text(temp_label, text);
+    lv_obj_add_style(temp_label, &g_ui_mgr.handles.style_xlarge, 0);
+    lv_obj_set_style_text_color(temp_label, lv_color_white(), 0);
+    lv_obj_align(temp_label, LV_ALIGN_CENTER, 0, 0);
+}
+
+static void build_l2_tomato_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right)
+{
+    (void)left;
+    (void)right;
+    build_l2_placeholder_page(middle, "番茄钟\n开发中...");
+}
+
+static void build_l2_gallery_page(lv_obj_t *left, lv_obj_t *middle, lv_obj_t *right)
+{
+    /* 预留全屏图片实现 */
+    (void)left;
+    (void)right;
+    build_l2_placeholder_page(middle, "全屏图片\n开发中...");
+}
+
 int screen_ui_build_group4(void)
 {
-    if (!g_ui_mgr.initialized) {
-        return -RT_ERROR;
-    }
-    
-    safe_cleanup_ui_objects();
-    
-    build_left_muyu_panel(g_ui_mgr.handles.left_panel);
-    build_middle_tomato_panel(g_ui_mgr.handles.middle_panel);
-    build_right_gallery_panel(g_ui_mgr.handles.right_panel);
-    
-    g_ui_mgr.current_group = SCREEN_GROUP_4;
-    g_ui_mgr.current_level = SCREEN_LEVEL_1;
-    
-    /* 激活按键上下文 */
-    screen_context_activate_for_group(SCREEN_GROUP_4);
-    
-    lv_obj_invalidate(lv_scr_act());
-    
-    return 0;
+    return show_l1_page(UI_PAGE_GROUP4, SCREEN_GROUP_4);
 }
 
 int screen_ui_build_l2_muyu(void)
 {
-    if (!g_ui_mgr.initialized) {
-        return -RT_ERROR;
+    int ret = show_l2_page(UI_PAGE_L2_MUYU);
+    if (ret == 0) {
+        /* 激活L2按键上下文 */
+        screen_context_activate_for_level2(SCREEN_L2_MUYU_GROUP);
     }
-    
-    safe_cleanup_ui_objects();
-    build_l2_muyu_main_page();
-    
-    g_ui_mgr.current_level = SCREEN_LEVEL_2;
-    
-    /* 激活L2按键上下文 */
-    screen_context_activate_for_level2(SCREEN_L2_MUYU_GROUP);
-    
-    lv_obj_invalidate(lv_scr_act());
-    return 0;
+    return ret;
 }
 
 int screen_ui_build_l2_tomato(void)
 {
-    if (!g_ui_mgr.initialized) {
-        return -RT_ERROR;
-    }
-
-    safe_cleanup_ui_objects();
-    
-    // 临时显示"开发中"界面
-    lv_obj_t *temp_label = lv_label_create(g_ui_mgr.handles.middle_panel);
-    lv_label_set_text(temp_label, "番茄钟\n开发中...");
-    lv_obj_add_style(temp_label, &g_ui_mgr.handles.style_xlarge, 0);
-    lv_obj_set_style_text_color(temp_label, lv_color_white(), 0);
-    lv_obj_align(temp_label, LV_ALIGN_CENTER, 0, 0);
-    
-    g_ui_mgr.current_level = SCREEN_LEVEL_2;
-    
-    lv_obj_invalidate(lv_scr_act());
-    return 0;
+    return show_l2_page(UI_PAGE_L2_TOMATO);
 }
 
 int screen_ui_build_l2_gallery(void)
 {
-    if (!g_ui_mgr.initialized) {
-        return -RT_ERROR;
-    }
-
-    // 预留全屏图片实现
-    
-    safe_cleanup_ui_objects();
-    
-    // 临时显示"开发中"界面
-    lv_obj_t *temp_label = lv_label_create(g_ui_mgr.handles.middle_panel);
-    lv_label_set_text(temp_label, "全屏图片\n开发中...");
-    lv_obj_add_style(temp_label, &g_ui_mgr.handles.style_xlarge, 0);
-    lv_obj_set_style_text_color(temp_label, lv_color_white(), 0);
-    lv_obj_align(temp_label, LV_ALIGN_CENTER, 0, 0);
-    
-    g_ui_mgr.current_level = SCREEN_LEVEL_2;
-    
-    lv_obj_invalidate(lv_scr_act());
-    return 0;
+    return show_l2_page(UI_PAGE_L2_GALLERY);
 }
 
 int screen_ui_update_muyu_display(void)
@@ -2289,7 +2747,8 @@ int screen_ui_update_muyu_display(void)
     }
     
     // 检查是否在木鱼L2页面
-    if (!g_ui_mgr.handles.l2_muyu_main.counter_label || 
+    if (g_ui_mgr.current_page != UI_PAGE_L2_MUYU ||
+        !g_ui_mgr.handles.l2_muyu_main.counter_label || 
         !lv_obj_is_valid(g_ui_mgr.handles.l2_muyu_main.counter_label)) {
         return 0; // 不在木鱼页面,不更新
     }
@@ -3,15 +3,79 @@
 
 #include "lvgl.h"
 #include "screen.h"
+#include "panel_grid.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifndef SCREEN_UI_PAGE_BUDGET_KB
+#define SCREEN_UI_PAGE_BUDGET_KB    24      /* 常驻页面的LVGL内存预算 */
+#endif
+
+/* 各字号TTF回退字体的字形缓存数，按font_stats统计的实际工作集调整 */
+#ifndef FONT_TTF_CACHE_CNT_XSMALL
+#define FONT_TTF_CACHE_CNT_XSMALL   32
+#endif
+#ifndef FONT_TTF_CACHE_CNT_SMALL
+#define FONT_TTF_CACHE_CNT_SMALL    32
+#endif
+#ifndef FONT_TTF_CACHE_CNT_MEDIUM
+#define FONT_TTF_CACHE_CNT_MEDIUM   16
+#endif
+#ifndef FONT_TTF_CACHE_CNT_LARGE
+#define FONT_TTF_CACHE_CNT_LARGE    16
+#endif
+#ifndef FONT_TTF_CACHE_CNT_XLARGE
+#define FONT_TTF_CACHE_CNT_XLARGE   8
+#endif
+#ifndef FONT_TTF_CACHE_CNT_XXLARGE
+#define FONT_TTF_CACHE_CNT_XXLARGE  8
+#endif
+
+/* UI页面：每个L1组和L2页面各一棵对象树，首次进入时构建后常驻 */
+typedef enum {
+    UI_PAGE_GROUP1 = 0,
+    UI_PAGE_GROUP2,
+    UI_PAGE_GROUP3,
+    UI_PAGE_GROUP4,
+    UI_PAGE_L2_TIME,
+    UI_PAGE_L2_MEDIA,
+    UI_PAGE_L2_WEB,
+    UI_PAGE_L2_SHORTCUT,
+    UI_PAGE_L2_MUYU,
+    UI_PAGE_L2_TOMATO,
+    UI_PAGE_L2_GALLERY,
+    UI_PAGE_MAX,
+    UI_PAGE_NONE = UI_PAGE_MAX
+} screen_ui_page_id_t;
+
+/* 常驻页面 */
+typedef struct {
+    lv_obj_t *containers[3];    /* 左/中/右面板下的页面容器 */
+    uint32_t mem_bytes;         /* 构建时的内存开销 */
+    uint32_t last_used;         /* 最近一次显示的tick，用于LRU淘汰 */
+    bool built;
+} screen_ui_page_t;
+
+/* 页面切换统计 */
+typedef struct {
+    uint32_t switch_count;
+    uint32_t build_count;       /* 需要构建对象树的次数（首次进入或被淘汰后） */
+    uint32_t evict_count;
+    uint32_t last_prepare_ms;   /* 最近一次切换对象树的耗时 */
+    uint32_t last_total_ms;     /* 最近一次从切换开始到首帧渲染完成 */
+    uint32_t max_total_ms;
+    uint32_t avg_total_ms;
+    uint32_t retained_bytes;
+    uint8_t retained_pages;
+} screen_ui_switch_stats_t;
+
 /* UI组件句柄结构 */
 typedef struct {
     /* 基础面板 */
     lv_obj_t *root;
+    lv_obj_t *panels[LCD_PANEL_NUM];    /* 按面板网格行优先排列 */
     lv_obj_t *left_panel;
     lv_obj_t *middle_panel; 
     lv_obj_t *right_panel;
@@ -32,6 +96,7 @@ typedef struct {
         lv_obj_t *pressure_label;
         lv_obj_t *sensor_label;
         lv_obj_t *weather_icon;
+        lv_obj_t *stale_badge;      /* 快照缓存标记，按需创建 */
     } group1_weather;
     
     struct {
@@ -39,6 +104,7 @@ typedef struct {
         lv_obj_t *price_label;
         lv_obj_t *change_label;
         lv_obj_t *update_time_label;
+        lv_obj_t *stale_badge;
     } group1_stock;
     
     /* Group 2 组件 */
@@ -57,6 +123,7 @@ typedef struct {
         lv_obj_t *ram_title;
         lv_obj_t *ram_usage;
         lv_obj_t *ram_chart;
+        lv_obj_t *stale_badge;
     } group2_memory;
     
     struct {
@@ -127,6 +194,13 @@ typedef struct {
     screen_level_t current_level;
     bool initialized;
     float scale_factor;
+    uint8_t pending_full_refresh;   /* 组件重建或重新显示后需全量刷新的数据类型 */
+
+    screen_ui_page_t pages[UI_PAGE_MAX];
+    screen_ui_page_id_t current_page;
+    screen_ui_switch_stats_t switch_stats;
+    uint32_t switch_start_tick;
+    bool switch_measuring;          /* 切换后的首帧尚未渲染 */
 
     muyu_data_t muyu_data;
 } screen_ui_manager_t;
@@ -164,11 +238,12 @@ int screen_ui_return_to_l1(screen_group_t l1_group);
 
 int screen_ui_update_time_display(void);
 
-int screen_ui_update_weather_display(const weather_data_t *data);
+/* dirty_mask为data_manager给出的*_FIELD_*组合，只刷新对应组件 */
+int screen_ui_update_weather_display(const weather_data_t *data, uint32_t dirty_mask);
 
-int screen_ui_update_stock_display(const stock_data_t *data);
+int screen_ui_update_stock_display(const stock_data_t *data, uint32_t dirty_mask);
 
-int screen_ui_update_system_display(const system_monitor_data_t *data);
+int screen_ui_update_system_display(const system_monitor_data_t *data, uint32_t dirty_mask);
 
 int screen_ui_update_sensor_display(void);
 
@@ -182,6 +257,15 @@ screen_group_t screen_ui_get_current_group(void);
 
 bool screen_ui_is_initialized(void);
 
+/* 第index块屏（行优先）的面板容器，未创建时返回NULL */
+lv_obj_t *screen_ui_get_panel(int index);
+
+/* 页面切换统计快照 */
+int screen_ui_get_switch_stats(screen_ui_switch_stats_t *stats);
+
+/* GUI线程每次立即渲染后调用，用于统计切换到首帧完成的耗时 */
+void screen_ui_note_frame_rendered(void);
+
 const muyu_data_t* screen_ui_get_muyu_data(void);
 
 int screen_ui_reset_muyu_counter(void);
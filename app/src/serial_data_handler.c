@@ -8,11 +8,15 @@
 #include <stdio.h>
 #include "hid_device.h"
 #include "event_bus.h"
+#include "stock_watchlist.h"
+#include "led_effects_manager.h"
+#include "led_timeline.h"
 
 #define SERIAL_RX_BUFFER_SIZE 1024
 #define SERIAL_DEVICE_NAME "uart1"
 #define SERIAL_TIMEOUT_MS (30000)
 #define WATCHDOG_CHECK_INTERVAL_MS (10000)
+#define SERIAL_VALUE_MAX_LEN 512
 
 static rt_device_t serial_device = RT_NULL;
 static rt_sem_t rx_sem = RT_NULL;
@@ -424,9 +428,9 @@ static struct {
     int city_code;
     bool weather_valid;
     
-    char stock_name[64];
-    float stock_price;
-    float stock_change;
+    char stock_name[64];        // 发布时再驻留，之前驻留的名称槽可能已被复用
+    int32_t stock_price_x100;
+    int32_t stock_change_x100;
     bool stock_valid;
     
     float cpu_usage;
@@ -594,46 +598,88 @@ static void handle_weather_data(const char *key, const char *value)
     }
 }
 
+static uint32_t current_unix_time(void)
+{
+    time_t now = time(NULL);
+    return (now == (time_t)-1) ? 0 : (uint32_t)now;
+}
+
 static void handle_stock_data(const char *key, const char *value)
 {
     if (strcmp(key, "stock_name") == 0) {
-        safe_strcpy(g_finsh_data.stock_name, value, sizeof(g_finsh_data.stock_name));
-        g_finsh_data.stock_valid = true;
+        strncpy(g_finsh_data.stock_name, value, sizeof(g_finsh_data.stock_name) - 1);
+        g_finsh_data.stock_name[sizeof(g_finsh_data.stock_name) - 1] = '\0';
+        g_finsh_data.stock_valid = (value[0] != '\0');
     }
     else if (strcmp(key, "stock_price") == 0) {
-        g_finsh_data.stock_price = atof(value);
+        stock_parse_x100(value, &g_finsh_data.stock_price_x100);
     }
     else if (strcmp(key, "stock_change") == 0) {
-        g_finsh_data.stock_change = atof(value);
+        stock_parse_x100(value, &g_finsh_data.stock_change_x100);
     }
     
     if (g_finsh_data.stock_valid) {
-        stock_data_t stock = {0};
+        event_data_stock_t stock_event = { .count = 1, .replace = false };
+        stock_data_t *stock = &stock_event.stocks[0];
         
-        safe_strcpy(stock.name, g_finsh_data.stock_name, sizeof(stock.name));
-        safe_strcpy(stock.symbol, "000001", sizeof(stock.symbol));
-        stock.current_price = g_finsh_data.stock_price;
-        stock.change_value = g_finsh_data.stock_change;
-        
-        if (stock.current_price > 0) {
-            float prev_price = stock.current_price - stock.change_value;
-            if (prev_price > 0) {
-                stock.change_percent = (stock.change_value / prev_price) * 100.0f;
-            }
+        stock->name_id = stock_name_intern(g_finsh_data.stock_name);
+        if (stock->name_id == STOCK_NAME_INVALID) {
+            return;
         }
+        stock->price_x100 = g_finsh_data.stock_price_x100;
+        stock->change_x100 = g_finsh_data.stock_change_x100;
+        stock->update_time = current_unix_time();
+        stock->valid = true;
         
-        stock.valid = true;
+        event_bus_publish(EVENT_DATA_STOCK_UPDATED, &stock_event, sizeof(stock_event),
+                         EVENT_PRIORITY_NORMAL, MODULE_ID_SERIAL_COMM);
+    }
+}
+
+/* 自选股批量帧：sys_set stocks "名称,价格,涨跌额;名称,价格,涨跌额;..."，整表替换 */
+static void handle_stock_batch(const char *value)
+{
+    event_data_stock_t stock_event = { .count = 0, .replace = true };
+    uint32_t update_time = current_unix_time();
+    const char *p = value;
+    
+    while (*p && stock_event.count < STOCK_WATCHLIST_SIZE) {
+        const char *end = strchr(p, ';');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
         
-        time_t now = time(NULL);
-        if (now != (time_t)-1) {
-            struct tm *tm_info = localtime(&now);
-            if (tm_info) {
-                snprintf(stock.update_time, sizeof(stock.update_time),
-                        "%02d:%02d:%02d", tm_info->tm_hour, tm_info->tm_min, tm_info->tm_sec);
+        char item[96];
+        char name[64] = {0};
+        char price[24] = {0};
+        char change[24] = {0};
+        
+        if (len > 0 && len < sizeof(item)) {
+            memcpy(item, p, len);
+            item[len] = '\0';
+            
+            if (sscanf(item, "%63[^,],%23[^,],%23s", name, price, change) == 3) {
+                stock_data_t *stock = &stock_event.stocks[stock_event.count];
+                if (stock_parse_x100(price, &stock->price_x100) == 0 &&
+                    stock_parse_x100(change, &stock->change_x100) == 0) {
+                    /* 驻留的引用随事件交给事件总线，分发完或丢弃时释放 */
+                    stock->name_id = stock_name_intern(name);
+                    if (stock->name_id != STOCK_NAME_INVALID) {
+                        stock->update_time = update_time;
+                        stock->valid = true;
+                        stock_event.count++;
+                    }
+                } else {
+                    g_serial_status.invalid_commands_count++;
+                }
+            } else {
+                g_serial_status.invalid_commands_count++;
             }
         }
         
-        event_data_stock_t stock_event = { .stock = stock };
+        if (!end) break;
+        p = end + 1;
+    }
+    
+    if (stock_event.count > 0) {
         event_bus_publish(EVENT_DATA_STOCK_UPDATED, &stock_event, sizeof(stock_event),
                          EVENT_PRIORITY_NORMAL, MODULE_ID_SERIAL_COMM);
     }
@@ -693,6 +739,48 @@ static void handle_system_data(const char *key, const char *value)
     }
 }
 
+/* LED时间线：led_tl "槽位:源文本"、led_tl_hex "槽位:字节码十六进制"、
+ * led_tl_play "槽位"、led_tl_fb "槽位"（-1恢复固定颜色反馈） */
+static void handle_led_timeline(const char *key, const char *value)
+{
+    char *end;
+    long slot = strtol(value, &end, 10);
+    int ret;
+    
+    if (strcmp(key, "led_tl_play") == 0) {
+        ret = (slot >= 0 && led_effects_play_timeline((uint8_t)slot, 0)) ? 0 : -RT_ERROR;
+    } else if (strcmp(key, "led_tl_fb") == 0) {
+        ret = led_timeline_set_feedback_slot((int)slot);
+    } else if (end == value || *end != ':' || slot < 0 || slot >= LED_TIMELINE_SLOTS) {
+        ret = -RT_EINVAL;
+    } else if (strcmp(key, "led_tl") == 0) {
+        ret = led_timeline_slot_compile((uint8_t)slot, end + 1);
+    } else if (strcmp(key, "led_tl_hex") == 0) {
+        uint8_t code[LED_TIMELINE_MAX_BYTES];
+        const char *hex = end + 1;
+        size_t len = strlen(hex) / 2;
+        
+        ret = (len > 0 && len <= sizeof(code) && strlen(hex) % 2 == 0) ? 0 : -RT_EINVAL;
+        for (size_t i = 0; ret == 0 && i < len; i++) {
+            char byte[3] = {hex[i * 2], hex[i * 2 + 1], '\0'};
+            code[i] = (uint8_t)strtoul(byte, &end, 16);
+            if (*end != '\0') {
+                ret = -RT_EINVAL;
+            }
+        }
+        if (ret == 0) {
+            ret = led_timeline_slot_load((uint8_t)slot, code, (uint32_t)len);
+        }
+    } else {
+        ret = -RT_EINVAL;
+    }
+    
+    if (ret != 0) {
+        g_serial_status.invalid_commands_count++;
+        rt_kprintf("[Finsh] %s failed: %d\n", key, ret);
+    }
+}
+
 static void handle_finsh_key_value(const char *key, const char *value)
 {
     if (!key || !value) return;
@@ -709,12 +797,19 @@ static void handle_finsh_key_value(const char *key, const char *value)
              strcmp(key, "stock_change") == 0) {
         handle_stock_data(key, value);
     }
+    else if (strcmp(key, "stocks") == 0) {
+        handle_stock_batch(value);
+    }
     else if (strcmp(key, "cpu") == 0 || strcmp(key, "cpu_temp") == 0 || 
              strcmp(key, "mem") == 0 || strcmp(key, "gpu") == 0 || 
              strcmp(key, "gpu_temp") == 0 || strcmp(key, "net_up") == 0 || 
              strcmp(key, "net_down") == 0) {
         handle_system_data(key, value);
     }
+    else if (strcmp(key, "led_tl") == 0 || strcmp(key, "led_tl_hex") == 0 ||
+             strcmp(key, "led_tl_play") == 0 || strcmp(key, "led_tl_fb") == 0) {
+        handle_led_timeline(key, value);
+    }
     else {
         rt_kprintf("[Finsh] Unknown key: %s = %s\n", key, value);
     }
@@ -732,14 +827,14 @@ static void process_finsh_command(const char *cmd_str)
     
     char command[16] = {0};
     char key[32] = {0};
-    char value[128] = {0};
+    char value[SERIAL_VALUE_MAX_LEN] = {0};
     
-    int parsed = sscanf(cmd_str, "%15s %31s %127[^\r\n]", command, key, value);
+    int parsed = sscanf(cmd_str, "%15s %31s %511[^\r\n]", command, key, value);
     
     if (parsed >= 3 && strcmp(command, "sys_set") == 0) {
         command[15] = '\0';
         key[31] = '\0';
-        value[127] = '\0';
+        value[SERIAL_VALUE_MAX_LEN - 1] = '\0';
         
         remove_quotes(value);
         
@@ -915,4 +1010,9 @@ int serial_data_handler_deinit(void)
         rx_sem = NULL;
     }
     return RT_EOK;
-}
\ No newline at end of file
+}
+
+bool serial_data_handler_is_connected(void)
+{
+    return g_serial_status.connection_alive;
+}
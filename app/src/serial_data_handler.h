@@ -2,8 +2,12 @@
 #define SERIAL_DATA_HANDLER_H
 
 #include <rtthread.h>
+#include <stdbool.h>
 
 int serial_data_handler_init(void);
 int serial_data_handler_deinit(void);
 
+/* 上位机连接状态，30秒没有收到数据时由串口看门狗置为断开 */
+bool serial_data_handler_is_connected(void);
+
 #endif
\ No newline at end of file
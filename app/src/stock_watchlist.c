@@ -0,0 +1,265 @@
+#include "stock_watchlist.h"
+#include <string.h>
+
+static struct {
+    char names[STOCK_NAME_MAX_IDS][STOCK_NAME_LEN];
+    uint32_t last_used[STOCK_NAME_MAX_IDS];     // 最近一次驻留时的序号，复用时选最小的
+    uint16_t refs[STOCK_NAME_MAX_IDS];          // 自选表条目和在途事件对该ID的引用数
+    uint8_t name_count;                         // 已发布的槽数，写入名称后release发布
+    uint32_t intern_seq;
+    rt_mutex_t lock;
+    bool initialized;
+} g_stock_names = {0};
+
+int stock_watchlist_init(void)
+{
+    if (g_stock_names.initialized) {
+        return 0;
+    }
+
+    g_stock_names.lock = rt_mutex_create("stock_names", RT_IPC_FLAG_PRIO);
+    if (!g_stock_names.lock) {
+        return -RT_ENOMEM;
+    }
+
+    g_stock_names.name_count = 0;
+    g_stock_names.intern_seq = 0;
+    g_stock_names.initialized = true;
+    return 0;
+}
+
+/* 截断到槽长度，不拆开UTF-8多字节字符 */
+static void stock_name_truncate(char *dest, const char *src)
+{
+    size_t len = strlen(src);
+    if (len >= STOCK_NAME_LEN) {
+        len = STOCK_NAME_LEN - 1;
+        while (len > 0 && ((uint8_t)src[len] & 0xC0) == 0x80) {
+            len--;
+        }
+    }
+    memcpy(dest, src, len);
+    dest[len] = '\0';
+}
+
+/* 没有任何引用、最久未驻留的槽 */
+static int stock_name_find_victim(void)
+{
+    int victim = -1;
+    uint32_t oldest_age = 0;
+    for (int i = 0; i < g_stock_names.name_count; i++) {
+        uint32_t age = g_stock_names.intern_seq - g_stock_names.last_used[i];
+        if (g_stock_names.refs[i] == 0 && (victim < 0 || age > oldest_age)) {
+            victim = i;
+            oldest_age = age;
+        }
+    }
+    return victim;
+}
+
+uint8_t stock_name_intern(const char *name)
+{
+    if (!name || !g_stock_names.initialized) {
+        return STOCK_NAME_INVALID;
+    }
+
+    char key[STOCK_NAME_LEN];
+    stock_name_truncate(key, name);
+
+    rt_mutex_take(g_stock_names.lock, RT_WAITING_FOREVER);
+
+    uint8_t count = g_stock_names.name_count;
+    uint8_t id = STOCK_NAME_INVALID;
+    for (uint8_t i = 0; i < count; i++) {
+        if (strcmp(g_stock_names.names[i], key) == 0) {
+            id = i;
+            break;
+        }
+    }
+
+    if (id == STOCK_NAME_INVALID) {
+        if (count < STOCK_NAME_MAX_IDS) {
+            id = count;
+            strcpy(g_stock_names.names[id], key);
+            /* 先写入字符串再发布槽数，lookup无需加锁 */
+            __atomic_store_n(&g_stock_names.name_count, (uint8_t)(count + 1), __ATOMIC_RELEASE);
+        } else {
+            int victim = stock_name_find_victim();
+            if (victim >= 0) {
+                id = (uint8_t)victim;
+                strcpy(g_stock_names.names[id], key);
+            } else {
+                rt_kprintf("[Stock] all name slots in use, drop: %s\n", name);
+            }
+        }
+    }
+
+    if (id != STOCK_NAME_INVALID) {
+        if (g_stock_names.refs[id] < UINT16_MAX) {
+            g_stock_names.refs[id]++;
+            g_stock_names.last_used[id] = ++g_stock_names.intern_seq;
+        } else {
+            id = STOCK_NAME_INVALID;
+        }
+    }
+
+    rt_mutex_release(g_stock_names.lock);
+    return id;
+}
+
+void stock_name_retain(uint8_t name_id)
+{
+    if (!g_stock_names.initialized) {
+        return;
+    }
+
+    rt_mutex_take(g_stock_names.lock, RT_WAITING_FOREVER);
+    if (name_id < g_stock_names.name_count && g_stock_names.refs[name_id] < UINT16_MAX) {
+        g_stock_names.refs[name_id]++;
+    }
+    rt_mutex_release(g_stock_names.lock);
+}
+
+void stock_name_release(uint8_t name_id)
+{
+    if (!g_stock_names.initialized) {
+        return;
+    }
+
+    rt_mutex_take(g_stock_names.lock, RT_WAITING_FOREVER);
+    if (name_id < g_stock_names.name_count && g_stock_names.refs[name_id] > 0) {
+        g_stock_names.refs[name_id]--;
+    }
+    rt_mutex_release(g_stock_names.lock);
+}
+
+void stock_name_release_list(const stock_data_t *list, uint8_t count)
+{
+    if (!list) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < count && i < STOCK_WATCHLIST_SIZE; i++) {
+        stock_name_release(list[i].name_id);
+    }
+}
+
+const char *stock_name_lookup(uint8_t name_id)
+{
+    if (name_id >= __atomic_load_n(&g_stock_names.name_count, __ATOMIC_ACQUIRE)) {
+        return "--";
+    }
+    return g_stock_names.names[name_id];
+}
+
+void stock_name_copy(uint8_t name_id, char *buf, size_t size)
+{
+    if (!buf || size == 0) {
+        return;
+    }
+
+    if (!g_stock_names.initialized) {
+        rt_snprintf(buf, size, "--");
+        return;
+    }
+
+    rt_mutex_take(g_stock_names.lock, RT_WAITING_FOREVER);
+    rt_snprintf(buf, size, "%s",
+                (name_id < g_stock_names.name_count) ? g_stock_names.names[name_id] : "--");
+    rt_mutex_release(g_stock_names.lock);
+}
+
+int stock_parse_x100(const char *str, int32_t *out)
+{
+    if (!str || !out) {
+        return -RT_EINVAL;
+    }
+
+    while (*str == ' ') str++;
+
+    bool negative = false;
+    if (*str == '-' || *str == '+') {
+        negative = (*str == '-');
+        str++;
+    }
+
+    if ((*str < '0' || *str > '9') && *str != '.') {
+        return -RT_EINVAL;
+    }
+
+    /* 整数部分不超过INT32_MAX/100，加上小数和进位也不会溢出 */
+    int32_t int_part = 0;
+    while (*str >= '0' && *str <= '9') {
+        int_part = int_part * 10 + (*str - '0');
+        if (int_part >= INT32_MAX / 100) {
+            return -RT_EINVAL;
+        }
+        str++;
+    }
+
+    int32_t frac = 0;
+    int digits = 0;
+    bool round_up = false;
+    if (*str == '.') {
+        str++;
+        while (*str >= '0' && *str <= '9') {
+            if (digits < 2) {
+                frac = frac * 10 + (*str - '0');
+            } else if (digits == 2) {
+                round_up = (*str >= '5');
+            }
+            digits++;
+            str++;
+        }
+    }
+    if (digits == 1) {
+        frac *= 10;
+    }
+
+    while (*str == ' ') str++;
+    if (*str != '\0') {
+        return -RT_EINVAL;
+    }
+
+    int32_t value = int_part * 100 + frac + (round_up ? 1 : 0);
+    *out = negative ? -value : value;
+    return 0;
+}
+
+int stock_format_x100(char *buf, size_t size, int32_t value_x100, bool with_sign)
+{
+    if (!buf || size == 0) {
+        return -RT_EINVAL;
+    }
+
+    const char *sign = "";
+    uint32_t abs_value = (uint32_t)value_x100;
+    if (value_x100 < 0) {
+        sign = "-";
+        abs_value = (uint32_t)(-(int64_t)value_x100);
+    } else if (with_sign) {
+        sign = "+";
+    }
+
+    rt_snprintf(buf, size, "%s%u.%02u", sign,
+                (unsigned int)(abs_value / 100), (unsigned int)(abs_value % 100));
+    return 0;
+}
+
+int32_t stock_change_percent_x100(const stock_data_t *stock)
+{
+    if (!stock) {
+        return 0;
+    }
+
+    int32_t prev_price = stock->price_x100 - stock->change_x100;
+    if (stock->price_x100 <= 0 || prev_price <= 0) {
+        return 0;
+    }
+
+    /* change/prev×100%，再×100保留两位小数，四舍五入 */
+    int64_t scaled = (int64_t)stock->change_x100 * 10000;
+    int64_t half = prev_price / 2;
+    scaled += (scaled >= 0) ? half : -half;
+    return (int32_t)(scaled / prev_price);
+}
@@ -0,0 +1,79 @@
+#ifndef STOCK_WATCHLIST_H
+#define STOCK_WATCHLIST_H
+
+#include <rtthread.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "screen_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STOCK_NAME_LEN          24      /* 每个名称槽的字节数（含结尾0），与快照中的名称长度一致 */
+/* 当前自选表、队列中的一帧和正在解析的一帧可同时驻留，另留几个给单只股票更新 */
+#define STOCK_NAME_MAX_IDS      (STOCK_WATCHLIST_SIZE * 3 + 4)
+#define STOCK_NAME_INVALID      0xFF
+
+#if STOCK_NAME_MAX_IDS >= STOCK_NAME_INVALID
+#error "STOCK_WATCHLIST_SIZE too large for 8-bit stock name IDs"
+#endif
+
+/**
+ * @brief 初始化名称池（data_manager_init中调用）
+ */
+int stock_watchlist_init(void);
+
+/**
+ * @brief 驻留股票名称，相同名称返回相同ID。超过STOCK_NAME_LEN-1字节的名称在UTF-8字符边界截断
+ * @return 名称ID，已替调用方引用一次；所有槽都被引用时返回STOCK_NAME_INVALID
+ * @note 放进EVENT_DATA_STOCK_UPDATED的ID由事件总线在分发完或丢弃时释放，
+ *       其余调用方用完后自行stock_name_release。只有无引用的槽会被复用
+ */
+uint8_t stock_name_intern(const char *name);
+
+/**
+ * @brief 引用/释放名称ID（自选表条目、在途事件各持一份），无效ID忽略
+ */
+void stock_name_retain(uint8_t name_id);
+void stock_name_release(uint8_t name_id);
+
+/**
+ * @brief 释放一组股票数据持有的名称ID
+ */
+void stock_name_release_list(const stock_data_t *list, uint8_t count);
+
+/**
+ * @brief 根据ID取名称，无效ID返回"--"
+ * @note 不加锁，只在调用方持有该ID的引用时使用；否则用stock_name_copy
+ */
+const char *stock_name_lookup(uint8_t name_id);
+
+/**
+ * @brief 在锁内拷贝名称，不会读到正在被复用改写的槽；无效ID拷贝"--"
+ */
+void stock_name_copy(uint8_t name_id, char *buf, size_t size);
+
+/**
+ * @brief 解析十进制字符串为×100定点数（"-12.345" -> -1235），不经过浮点
+ * @return 0成功，-RT_EINVAL格式错误、数字后有空格以外的字符或超出int32范围
+ */
+int stock_parse_x100(const char *str, int32_t *out);
+
+/**
+ * @brief 将×100定点数格式化为"%.2f"样式字符串
+ * @param with_sign 非负数是否带'+'
+ */
+int stock_format_x100(char *buf, size_t size, int32_t value_x100, bool with_sign);
+
+/**
+ * @brief 由价格和涨跌额计算涨跌幅（×100，即百分比两位小数）
+ */
+int32_t stock_change_percent_x100(const stock_data_t *stock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STOCK_WATCHLIST_H */
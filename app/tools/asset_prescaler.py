@@ -0,0 +1,297 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+图片预缩放工具
+
+把PNG缩放到屏幕上的实际显示尺寸，运行时以1:1绘制，省去每帧的
+变换和抗锯齿。只依赖标准库（zlib），构建环境无需额外安装图像库。
+
+缩放采用面积平均（预乘alpha），缩小时没有锯齿和透明边缘的黑边。
+输出已存在、比源文件新且尺寸一致时跳过，不重复处理。
+"""
+
+import os
+import sys
+import struct
+import zlib
+import argparse
+
+PNG_SIGNATURE = b'\x89PNG\r\n\x1a\n'
+
+# 颜色类型对应的通道数
+CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}
+
+
+def read_chunks(data):
+    pos = len(PNG_SIGNATURE)
+    while pos < len(data):
+        length, ctype = struct.unpack('>I4s', data[pos:pos + 8])
+        yield ctype, data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+
+
+def read_png_size(path):
+    with open(path, 'rb') as f:
+        head = f.read(24)
+    if head[:8] != PNG_SIGNATURE:
+        return None
+    return struct.unpack('>II', head[16:24])
+
+
+def unfilter(raw, width, height, bpp):
+    stride = width * bpp
+    out = bytearray(stride * height)
+    prev = bytearray(stride)
+    pos = 0
+    for y in range(height):
+        ftype = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        if ftype == 1:
+            for i in range(bpp, stride):
+                line[i] = (line[i] + line[i - bpp]) & 0xFF
+        elif ftype == 2:
+            for i in range(stride):
+                line[i] = (line[i] + prev[i]) & 0xFF
+        elif ftype == 3:
+            for i in range(stride):
+                left = line[i - bpp] if i >= bpp else 0
+                line[i] = (line[i] + ((left + prev[i]) >> 1)) & 0xFF
+        elif ftype == 4:
+            for i in range(stride):
+                a = line[i - bpp] if i >= bpp else 0
+                b = prev[i]
+                c = prev[i - bpp] if i >= bpp else 0
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                if pa <= pb and pa <= pc:
+                    pred = a
+                elif pb <= pc:
+                    pred = b
+                else:
+                    pred = c
+                line[i] = (line[i] + pred) & 0xFF
+        elif ftype != 0:
+            raise ValueError(f"未知的行过滤类型: {ftype}")
+        out[y * stride:(y + 1) * stride] = line
+        prev = line
+    return out
+
+
+def load_png_rgba(path):
+    """读取8位深度、非隔行的PNG，统一转换为RGBA"""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError(f"不是PNG文件: {path}")
+
+    idat = bytearray()
+    palette = None
+    trns = None
+    for ctype, body in read_chunks(data):
+        if ctype == b'IHDR':
+            width, height, depth, color, _, _, interlace = struct.unpack('>IIBBBBB', body)
+        elif ctype == b'PLTE':
+            palette = body
+        elif ctype == b'tRNS':
+            trns = body
+        elif ctype == b'IDAT':
+            idat += body
+        elif ctype == b'IEND':
+            break
+
+    if depth != 8 or interlace != 0 or color not in CHANNELS:
+        raise ValueError(f"不支持的PNG格式（仅支持8位非隔行）: {path}")
+
+    bpp = CHANNELS[color]
+    pixels = unfilter(zlib.decompress(bytes(idat)), width, height, bpp)
+
+    rgba = bytearray(width * height * 4)
+    for i in range(width * height):
+        if color == 6:
+            rgba[i * 4:i * 4 + 4] = pixels[i * 4:i * 4 + 4]
+            continue
+        if color == 2:
+            r, g, b = pixels[i * 3:i * 3 + 3]
+            a = 255
+        elif color == 3:
+            idx = pixels[i]
+            r, g, b = palette[idx * 3:idx * 3 + 3]
+            a = trns[idx] if trns and idx < len(trns) else 255
+        elif color == 4:
+            r = g = b = pixels[i * 2]
+            a = pixels[i * 2 + 1]
+        else:
+            r = g = b = pixels[i]
+            a = 255
+        rgba[i * 4:i * 4 + 4] = bytes((r, g, b, a))
+    return width, height, rgba
+
+
+def save_png_rgba(path, width, height, rgba):
+    def chunk(ctype, body):
+        crc = zlib.crc32(ctype + body) & 0xFFFFFFFF
+        return struct.pack('>I', len(body)) + ctype + body + struct.pack('>I', crc)
+
+    stride = width * 4
+    raw = bytearray()
+    for y in range(height):
+        raw.append(0)
+        raw += rgba[y * stride:(y + 1) * stride]
+
+    ihdr = struct.pack('>IIBBBBB', width, height, 8, 6, 0, 0, 0)
+    with open(path, 'wb') as f:
+        f.write(PNG_SIGNATURE)
+        f.write(chunk(b'IHDR', ihdr))
+        f.write(chunk(b'IDAT', zlib.compress(bytes(raw), 9)))
+        f.write(chunk(b'IEND', b''))
+
+
+def area_weights(src_len, dst_len):
+    """每个输出像素覆盖的源像素区间及各自权重"""
+    ratio = src_len / dst_len
+    table = []
+    for d in range(dst_len):
+        start = d * ratio
+        end = start + ratio
+        taps = []
+        s = int(start)
+        while s < end and s < src_len:
+            w = min(end, s + 1) - max(start, s)
+            if w > 0:
+                taps.append((s, w / ratio))
+            s += 1
+        table.append(taps)
+    return table
+
+
+def resize_rgba(width, height, rgba, dst_w, dst_h):
+    # 预乘alpha后做面积平均，避免透明像素的颜色渗入边缘
+    src = [0.0] * (width * height * 4)
+    for i in range(width * height):
+        a = rgba[i * 4 + 3] / 255.0
+        src[i * 4] = rgba[i * 4] * a
+        src[i * 4 + 1] = rgba[i * 4 + 1] * a
+        src[i * 4 + 2] = rgba[i * 4 + 2] * a
+        src[i * 4 + 3] = rgba[i * 4 + 3]
+
+    # 水平方向
+    wx = area_weights(width, dst_w)
+    tmp = [0.0] * (dst_w * height * 4)
+    for y in range(height):
+        row = y * width * 4
+        out = y * dst_w * 4
+        for x, taps in enumerate(wx):
+            acc = [0.0, 0.0, 0.0, 0.0]
+            for s, w in taps:
+                p = row + s * 4
+                acc[0] += src[p] * w
+                acc[1] += src[p + 1] * w
+                acc[2] += src[p + 2] * w
+                acc[3] += src[p + 3] * w
+            tmp[out + x * 4:out + x * 4 + 4] = acc
+
+    # 垂直方向并还原非预乘颜色
+    wy = area_weights(height, dst_h)
+    dst = bytearray(dst_w * dst_h * 4)
+    for y, taps in enumerate(wy):
+        for x in range(dst_w):
+            acc = [0.0, 0.0, 0.0, 0.0]
+            for s, w in taps:
+                p = (s * dst_w + x) * 4
+                acc[0] += tmp[p] * w
+                acc[1] += tmp[p + 1] * w
+                acc[2] += tmp[p + 2] * w
+                acc[3] += tmp[p + 3] * w
+            a = acc[3]
+            o = (y * dst_w + x) * 4
+            if a > 0.5:
+                k = 255.0 / a
+                dst[o] = min(255, int(acc[0] * k + 0.5))
+                dst[o + 1] = min(255, int(acc[1] * k + 0.5))
+                dst[o + 2] = min(255, int(acc[2] * k + 0.5))
+            dst[o + 3] = min(255, int(a + 0.5))
+    return dst
+
+
+# 与screen_ui_manager.c中get_scale_factor()的基准分辨率一致
+BASE_WIDTH = 390
+BASE_HEIGHT = 450
+
+ENTRANCE_ICONS = ['media', 'web', 'shortcut', 'muyu', 'tomatolock', 'calculagraph',
+                  'volup', 'voldown', 'play', 'ctrlc', 'ctrlv', 'ctrlz', 'up', 'down', 'fresh']
+FULLSIZE_ICONS = ['cpuicon', 'gpuicon', 'memicon']
+
+
+def clamp(v, lo, hi):
+    return max(lo, min(hi, v))
+
+
+def ui_scale(hor_res, ver_res):
+    return min(hor_res / BASE_WIDTH, ver_res / BASE_HEIGHT)
+
+
+def prescale_plan(asset_dir, scale):
+    """(源目录, 图片名, 缩放比例, 输出后缀)，比例与UI各创建函数的缩放系数一致"""
+    weather_icons = sorted(os.path.splitext(f)[0] for f in os.listdir(os.path.join(asset_dir, 'weather'))
+                           if f.endswith('.png') and not f.startswith('w8'))
+    return [
+        ('time_style1', ['t%d' % i for i in range(10)], clamp(scale * 1.5, 0.8, 4.0), ''),  # L2数字时钟
+        ('.', ENTRANCE_ICONS, scale * 0.5, ''),                                           # 入口图标
+        ('.', ['muyu'], clamp(scale * 0.4, 0.3, 1.0), '_l2'),                             # L2木鱼展示图
+        ('.', FULLSIZE_ICONS, scale * 0.57, ''),                                          # 整块面板图标
+        ('weather', weather_icons, scale * 0.4, ''),                                      # 天气图标
+    ]
+
+
+def scaled_size(width, height, zoom):
+    """与运行时lv_img_set_zoom的量化一致：缩放比先取整到1/256"""
+    zoom_q = int(256 * zoom)
+    return max(1, (width * zoom_q + 128) // 256), max(1, (height * zoom_q + 128) // 256)
+
+
+def prescale(src_path, dst_path, zoom):
+    size = read_png_size(src_path)
+    if size is None:
+        raise ValueError(f"不是PNG文件: {src_path}")
+    dst_w, dst_h = scaled_size(size[0], size[1], zoom)
+
+    if (os.path.exists(dst_path) and
+            os.path.getmtime(dst_path) >= os.path.getmtime(src_path) and
+            read_png_size(dst_path) == (dst_w, dst_h)):
+        return False
+
+    width, height, rgba = load_png_rgba(src_path)
+    if (dst_w, dst_h) == (width, height):
+        out = rgba
+    else:
+        out = resize_rgba(width, height, rgba, dst_w, dst_h)
+
+    os.makedirs(os.path.dirname(dst_path) or '.', exist_ok=True)
+    save_png_rgba(dst_path, dst_w, dst_h, out)
+    print(f"预缩放: {os.path.basename(src_path)} {width}x{height} -> "
+          f"{os.path.basename(dst_path)} {dst_w}x{dst_h}")
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(description='图片预缩放工具')
+    parser.add_argument('images', nargs='+', help='源PNG文件')
+    parser.add_argument('-z', '--zoom', type=float, required=True, help='缩放比例')
+    parser.add_argument('-o', '--out', required=True, help='输出目录')
+    parser.add_argument('-s', '--suffix', default='', help='输出文件名后缀（决定C符号名）')
+
+    args = parser.parse_args()
+
+    try:
+        for src in args.images:
+            name = os.path.splitext(os.path.basename(src))[0]
+            prescale(src, os.path.join(args.out, name + args.suffix + '.png'), args.zoom)
+    except Exception as e:
+        print(f"预缩放失败: {e}", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -1,63 +1,563 @@
 #!/usr/bin/env python3
 # -*- coding: utf-8 -*-
 
-import os
+"""
+字体转换工具
+
+两种输出：
+1. TTF原样转换为C数组，供运行时tiny_ttf使用（动态文本的回退字体）
+2. 预渲染位图字体：扫描源码字符串字面量收集实际用到的字符，按指定像素大小
+   光栅化为LVGL fmt_txt字体（4bpp），运行时无需光栅化
+
+光栅化只依赖标准库，度量与tiny_ttf（stb_truetype）一致：
+缩放 = 像素大小 / (ascent - descent)，字形框按glyf包围盒取整。
+"""
+
+import re
 import sys
+import math
+import struct
+import hashlib
 import argparse
 from pathlib import Path
 
-def font_to_c_array(font_file_path, array_name="xiaozhi_font"):
+def font_to_c_array(font_file_path, array_name="xiaozhi_font", output_path=None):
     font_path = Path(font_file_path)
-    
+
     if not font_path.exists():
         raise FileNotFoundError(f"字体文件不存在: {font_file_path}")
-    
-    # 输出文件路径：与字体文件同目录，命名为 {array_name}.c
-    output_path = font_path.parent / f"{array_name}.c"
-    
+
+    # 输出文件路径：默认与字体文件同目录，命名为 {array_name}.c
+    if output_path is None:
+        output_path = font_path.parent / f"{array_name}.c"
+
     # 读取字体文件
     with open(font_path, 'rb') as f:
         font_data = f.read()
-    
+
     font_size = len(font_data)
-    
+
     c_content = f" __attribute__((section(\".font_data\"))) const unsigned char {array_name}[{font_size}] = {{\n"
-    
+
     # 将字体数据转换为C数组格式，每行12个字节
     bytes_per_line = 12
     for i in range(0, font_size, bytes_per_line):
         line_data = font_data[i:i + bytes_per_line]
         hex_values = ', '.join(f'0x{b:02X}' for b in line_data)
-        
+
         if i + bytes_per_line < font_size:
             c_content += f"\t{hex_values},\n"
         else:
             c_content += f"\t{hex_values}\n"
-    
+
     c_content += "};\n\n\n"
     c_content += f"const int {array_name}_size = sizeof({array_name});\n"
-    
+
     # 写入C文件
     with open(output_path, 'w', encoding='utf-8') as f:
         f.write(c_content)
-    
+
     print(f"字体转换完成!")
     print(f"输入文件: {font_path}")
     print(f"输出文件: {output_path}")
     print(f"数组名称: {array_name}")
     print(f"文件大小: {font_size} bytes")
-    
+
     return output_path
 
+
+# ==================== 字符收集 ====================
+
+# 注释和字符串字面量一起匹配，只取字符串，注释里的字符不计入
+C_TOKEN_RE = re.compile(r'//[^\n]*|/\*.*?\*/|"((?:\\.|[^"\\\n])*)"', re.S)
+
+
+def collect_used_chars(src_dirs):
+    """收集源码字符串字面量中的字符，始终包含可打印ASCII"""
+    chars = set(chr(c) for c in range(0x20, 0x7F))
+    for src_dir in src_dirs:
+        for path in sorted(Path(src_dir).glob('*.[ch]')):
+            text = path.read_text(encoding='utf-8', errors='ignore')
+            for m in C_TOKEN_RE.finditer(text):
+                if m.group(1) is None:
+                    continue
+                literal = re.sub(r'\\.', '', m.group(1))
+                chars.update(ch for ch in literal if ord(ch) >= 0x20)
+    return sorted(chars, key=ord)
+
+
+# ==================== TrueType解析 ====================
+
+class TrueTypeFont:
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+
+        num_tables = struct.unpack_from('>H', self.data, 4)[0]
+        self.tables = {}
+        for i in range(num_tables):
+            tag, _, offset, length = struct.unpack_from('>4sIII', self.data, 12 + i * 16)
+            self.tables[tag.decode('latin-1')] = (offset, length)
+
+        head = self.tables['head'][0]
+        self.units_per_em = struct.unpack_from('>H', self.data, head + 18)[0]
+        self.loca_long = struct.unpack_from('>h', self.data, head + 50)[0] == 1
+
+        hhea = self.tables['hhea'][0]
+        self.ascent, self.descent, self.line_gap = struct.unpack_from('>hhh', self.data, hhea + 4)
+        self.num_hmetrics = struct.unpack_from('>H', self.data, hhea + 34)[0]
+
+        self.num_glyphs = struct.unpack_from('>H', self.data, self.tables['maxp'][0] + 4)[0]
+        self._init_cmap()
+
+    def _init_cmap(self):
+        base = self.tables['cmap'][0]
+        count = struct.unpack_from('>H', self.data, base + 2)[0]
+        best = None
+        for i in range(count):
+            platform, encoding, offset = struct.unpack_from('>HHI', self.data, base + 4 + i * 8)
+            fmt = struct.unpack_from('>H', self.data, base + offset)[0]
+            score = {12: 2, 4: 1}.get(fmt, 0)
+            if platform in (0, 3) and score and (best is None or score > best[0]):
+                best = (score, base + offset, fmt)
+        if best is None:
+            raise ValueError("字体缺少Unicode cmap")
+        self.cmap_offset, self.cmap_format = best[1], best[2]
+
+    def glyph_index(self, codepoint):
+        d = self.data
+        off = self.cmap_offset
+        if self.cmap_format == 12:
+            n_groups = struct.unpack_from('>I', d, off + 12)[0]
+            lo, hi = 0, n_groups - 1
+            while lo <= hi:
+                mid = (lo + hi) // 2
+                start, end, glyph = struct.unpack_from('>III', d, off + 16 + mid * 12)
+                if codepoint < start:
+                    hi = mid - 1
+                elif codepoint > end:
+                    lo = mid + 1
+                else:
+                    return glyph + codepoint - start
+            return 0
+
+        if codepoint > 0xFFFF:
+            return 0
+        seg_count = struct.unpack_from('>H', d, off + 6)[0] // 2
+        end_codes = off + 14
+        start_codes = end_codes + seg_count * 2 + 2
+        id_deltas = start_codes + seg_count * 2
+        id_range_offsets = id_deltas + seg_count * 2
+        for i in range(seg_count):
+            end = struct.unpack_from('>H', d, end_codes + i * 2)[0]
+            if codepoint > end:
+                continue
+            start = struct.unpack_from('>H', d, start_codes + i * 2)[0]
+            if codepoint < start:
+                return 0
+            delta = struct.unpack_from('>h', d, id_deltas + i * 2)[0]
+            range_offset = struct.unpack_from('>H', d, id_range_offsets + i * 2)[0]
+            if range_offset == 0:
+                return (codepoint + delta) & 0xFFFF
+            addr = id_range_offsets + i * 2 + range_offset + (codepoint - start) * 2
+            glyph = struct.unpack_from('>H', d, addr)[0]
+            return (glyph + delta) & 0xFFFF if glyph else 0
+        return 0
+
+    def advance_width(self, glyph):
+        hmtx = self.tables['hmtx'][0]
+        idx = min(glyph, self.num_hmetrics - 1)
+        return struct.unpack_from('>H', self.data, hmtx + idx * 4)[0]
+
+    def _glyph_offset(self, glyph):
+        loca = self.tables['loca'][0]
+        if self.loca_long:
+            start, end = struct.unpack_from('>II', self.data, loca + glyph * 4)
+        else:
+            start, end = (v * 2 for v in struct.unpack_from('>HH', self.data, loca + glyph * 2))
+        if start == end:
+            return None
+        return self.tables['glyf'][0] + start
+
+    def glyph_bbox(self, glyph):
+        off = self._glyph_offset(glyph)
+        if off is None:
+            return None
+        return struct.unpack_from('>hhhh', self.data, off + 2)
+
+    def glyph_contours(self, glyph, depth=0):
+        """返回轮廓列表，每个轮廓为[(x, y, on_curve), ...]（字体单位）"""
+        off = self._glyph_offset(glyph)
+        if off is None or depth > 8:
+            return []
+        d = self.data
+        n_contours = struct.unpack_from('>h', d, off)[0]
+        p = off + 10
+
+        if n_contours >= 0:
+            end_pts = struct.unpack_from('>%dH' % n_contours, d, p)
+            p += n_contours * 2
+            n_points = end_pts[-1] + 1 if n_contours else 0
+            p += 2 + struct.unpack_from('>H', d, p)[0]
+
+            flags = []
+            while len(flags) < n_points:
+                flag = d[p]
+                p += 1
+                flags.append(flag)
+                if flag & 0x08:
+                    flags.extend([flag] * d[p])
+                    p += 1
+
+            def read_coords(short_bit, same_bit):
+                nonlocal p
+                coords, value = [], 0
+                for flag in flags[:n_points]:
+                    if flag & short_bit:
+                        delta = d[p]
+                        p += 1
+                        value += delta if flag & same_bit else -delta
+                    elif not flag & same_bit:
+                        value += struct.unpack_from('>h', d, p)[0]
+                        p += 2
+                    coords.append(value)
+                return coords
+
+            xs = read_coords(0x02, 0x10)
+            ys = read_coords(0x04, 0x20)
+            contours, start = [], 0
+            for end in end_pts:
+                contours.append([(xs[i], ys[i], bool(flags[i] & 1)) for i in range(start, end + 1)])
+                start = end + 1
+            return contours
+
+        # 复合字形：按变换矩阵合并各组件
+        contours = []
+        while True:
+            flags, comp = struct.unpack_from('>HH', d, p)
+            p += 4
+            if flags & 0x0001:
+                dx, dy = struct.unpack_from('>hh', d, p)
+                p += 4
+            else:
+                dx, dy = struct.unpack_from('>bb', d, p)
+                p += 2
+            if not flags & 0x0002:
+                dx = dy = 0     # 按点对齐的组件不常见，忽略偏移
+            a, b, c, e = 1.0, 0.0, 0.0, 1.0
+            if flags & 0x0008:
+                a = e = struct.unpack_from('>h', d, p)[0] / 16384.0
+                p += 2
+            elif flags & 0x0040:
+                a, e = (v / 16384.0 for v in struct.unpack_from('>hh', d, p))
+                p += 4
+            elif flags & 0x0080:
+                a, b, c, e = (v / 16384.0 for v in struct.unpack_from('>hhhh', d, p))
+                p += 8
+            for contour in self.glyph_contours(comp, depth + 1):
+                contours.append([(x * a + y * c + dx, x * b + y * e + dy, on) for x, y, on in contour])
+            if not flags & 0x0020:
+                break
+        return contours
+
+
+# ==================== 光栅化 ====================
+
+SUBSAMPLES = 8      # 每像素行的采样扫描线数
+
+
+def flatten_contour(contour, scale):
+    """二次贝塞尔轮廓展开为折线（像素坐标，y向上）"""
+    pts = [(x * scale, y * scale, on) for x, y, on in contour]
+    n = len(pts)
+    if n == 0:
+        return []
+
+    # 起点取一个在曲线上的点，全为控制点时取前两点中点
+    start = next((i for i in range(n) if pts[i][2]), None)
+    if start is None:
+        x0 = (pts[0][0] + pts[1][0]) / 2
+        y0 = (pts[0][1] + pts[1][1]) / 2
+        pts.insert(0, (x0, y0, True))
+        n += 1
+        start = 0
+    pts = pts[start:] + pts[:start]
+
+    out = [(pts[0][0], pts[0][1])]
+    ctrl = None
+    for i in range(1, n + 1):
+        x, y, on = pts[i % n]
+        if on:
+            if ctrl is None:
+                out.append((x, y))
+            else:
+                quad_to(out, ctrl, (x, y))
+                ctrl = None
+        else:
+            if ctrl is not None:
+                mid = ((ctrl[0] + x) / 2, (ctrl[1] + y) / 2)
+                quad_to(out, ctrl, mid)
+            ctrl = (x, y)
+    return out
+
+
+def quad_to(out, ctrl, end):
+    x0, y0 = out[-1]
+    dist = abs(x0 - ctrl[0]) + abs(y0 - ctrl[1]) + abs(ctrl[0] - end[0]) + abs(ctrl[1] - end[1])
+    steps = max(1, min(16, int(dist / 2)))
+    for s in range(1, steps + 1):
+        t = s / steps
+        mt = 1 - t
+        out.append((mt * mt * x0 + 2 * mt * t * ctrl[0] + t * t * end[0],
+                    mt * mt * y0 + 2 * mt * t * ctrl[1] + t * t * end[1]))
+
+
+def rasterize(polys, x0, y1, width, height):
+    """非零环绕规则扫描线填充，返回逐行覆盖率（0~1）"""
+    edges = []
+    for poly in polys:
+        for i in range(len(poly) - 1):
+            (xa, ya), (xb, yb) = poly[i], poly[i + 1]
+            if ya == yb:
+                continue
+            if ya < yb:
+                edges.append((ya, yb, xa, (xb - xa) / (yb - ya), 1))
+            else:
+                edges.append((yb, ya, xb, (xa - xb) / (ya - yb), -1))
+
+    coverage = [[0.0] * width for _ in range(height)]
+    weight = 1.0 / SUBSAMPLES
+    for row in range(height):
+        acc = coverage[row]
+        for s in range(SUBSAMPLES):
+            y = y1 - row - (s + 0.5) / SUBSAMPLES
+            crossings = [(xs + (y - ys) * slope, w) for ys, ye, xs, slope, w in edges if ys <= y < ye]
+            if not crossings:
+                continue
+            crossings.sort()
+            winding = 0
+            for i in range(len(crossings) - 1):
+                winding += crossings[i][1]
+                if winding == 0:
+                    continue
+                add_span(acc, crossings[i][0] - x0, crossings[i + 1][0] - x0, weight, width)
+    return coverage
+
+
+def add_span(acc, sx, ex, weight, width):
+    sx = max(0.0, sx)
+    ex = min(float(width), ex)
+    if ex <= sx:
+        return
+    first, last = int(sx), int(ex)
+    if first == last:
+        acc[first] += (ex - sx) * weight
+        return
+    acc[first] += (first + 1 - sx) * weight
+    for x in range(first + 1, min(last, width)):
+        acc[x] += weight
+    if last < width:
+        acc[last] += (ex - last) * weight
+
+
+class BitmapFont:
+    def __init__(self, ttf, size):
+        self.ttf = ttf
+        self.size = size
+        self.scale = size / (ttf.ascent - ttf.descent)
+        self.line_height = int((ttf.ascent - ttf.descent + ttf.line_gap) * self.scale)
+        self.base_line = int(-ttf.descent * self.scale)
+        self.glyphs = []        # (codepoint, dsc, packed_bitmap)
+
+    def add_glyph(self, codepoint):
+        glyph = self.ttf.glyph_index(codepoint)
+        if glyph == 0 and codepoint != 0x20:
+            return False
+
+        adv_w = int(math.floor(self.ttf.advance_width(glyph) * self.scale + 0.5))
+        bbox = self.ttf.glyph_bbox(glyph)
+        if bbox is None:
+            self.glyphs.append((codepoint, (adv_w, 0, 0, 0, 0), b''))
+            return True
+
+        s = self.scale
+        x0, y0 = int(math.floor(bbox[0] * s)), int(math.floor(bbox[1] * s))
+        x1, y1 = int(math.ceil(bbox[2] * s)), int(math.ceil(bbox[3] * s))
+        width, height = max(0, x1 - x0), max(0, y1 - y0)
+        polys = [flatten_contour(c, s) for c in self.ttf.glyph_contours(glyph)]
+        coverage = rasterize(polys, x0, y1, width, height)
+
+        # 4bpp按行连续打包（不做行对齐），高4位在前，与LVGL PLAIN格式一致
+        nibbles = [min(15, int(v * 15 + 0.5)) for row in coverage for v in row]
+        if len(nibbles) % 2:
+            nibbles.append(0)
+        packed = bytes((nibbles[i] << 4) | nibbles[i + 1] for i in range(0, len(nibbles), 2))
+        self.glyphs.append((codepoint, (adv_w, width, height, x0, y0), packed))
+        return True
+
+
+def emit_font_c(font, name):
+    lines = []
+    lines.append(f"/* {name}: {font.size}px, {len(font.glyphs)} glyphs, 4bpp */")
+    lines.append(f"static LV_ATTRIBUTE_LARGE_CONST const uint8_t {name}_bitmap[] = {{")
+    offsets, pos = [], 0
+    for _, _, packed in font.glyphs:
+        offsets.append(pos)
+        pos += len(packed)
+        for i in range(0, len(packed), 16):
+            lines.append("    " + ", ".join(f"0x{b:02x}" for b in packed[i:i + 16]) + ",")
+    if pos == 0:
+        lines.append("    0x00")
+    lines.append("};")
+    lines.append("")
+
+    lines.append(f"static const lv_font_fmt_txt_glyph_dsc_t {name}_glyph_dsc[] = {{")
+    lines.append("    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0},")
+    for (cp, (adv_w, w, h, ox, oy), _), off in zip(font.glyphs, offsets):
+        lines.append(f"    {{.bitmap_index = {off}, .adv_w = {adv_w * 16}, .box_w = {w}, .box_h = {h}, "
+                     f".ofs_x = {ox}, .ofs_y = {oy}}},  /* U+{cp:04X} */")
+    lines.append("};")
+    lines.append("")
+
+    # 稀疏cmap：每段的码点偏移和range_length都必须放得进uint16
+    ranges, glyph_id = [], 1
+    cps = [g[0] for g in font.glyphs]
+    i = 0
+    while i < len(cps):
+        start = cps[i]
+        j = i
+        while j + 1 < len(cps) and cps[j + 1] - start < 0xFFFF:
+            j += 1
+        ranges.append((start, cps[i:j + 1], glyph_id))
+        glyph_id += j + 1 - i
+        i = j + 1
+
+    for r, (start, members, _) in enumerate(ranges):
+        lines.append(f"static const uint16_t {name}_unicode_list_{r}[] = {{")
+        for k in range(0, len(members), 12):
+            lines.append("    " + ", ".join(f"0x{cp - start:x}" for cp in members[k:k + 12]) + ",")
+        lines.append("};")
+        lines.append("")
+
+    lines.append(f"static const lv_font_fmt_txt_cmap_t {name}_cmaps[] = {{")
+    for r, (start, members, gid) in enumerate(ranges):
+        lines.append(f"    {{.range_start = {start}, .range_length = {members[-1] - start + 1}, "
+                     f".glyph_id_start = {gid}, .unicode_list = {name}_unicode_list_{r}, "
+                     f".glyph_id_ofs_list = NULL, .list_length = {len(members)}, "
+                     f".type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY}},")
+    lines.append("};")
+    lines.append("")
+
+    lines.append(f"static const lv_font_fmt_txt_dsc_t {name}_dsc = {{")
+    lines.append(f"    .glyph_bitmap = {name}_bitmap,")
+    lines.append(f"    .glyph_dsc = {name}_glyph_dsc,")
+    lines.append(f"    .cmaps = {name}_cmaps,")
+    lines.append("    .kern_dsc = NULL,")
+    lines.append("    .kern_scale = 0,")
+    lines.append(f"    .cmap_num = {len(ranges)},")
+    lines.append("    .bpp = 4,")
+    lines.append("    .kern_classes = 0,")
+    lines.append("    .bitmap_format = 0,")
+    lines.append("};")
+    lines.append("")
+
+    lines.append(f"static const lv_font_t {name} = {{")
+    lines.append("    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,")
+    lines.append("    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,")
+    lines.append(f"    .line_height = {font.line_height},")
+    lines.append(f"    .base_line = {font.base_line},")
+    lines.append("    .subpx = LV_FONT_SUBPX_NONE,")
+    lines.append(f"    .underline_position = {-max(1, font.size // 10)},")
+    lines.append(f"    .underline_thickness = {max(1, font.size // 16)},")
+    lines.append(f"    .dsc = &{name}_dsc,")
+    lines.append("    .fallback = NULL,")
+    lines.append("    .user_data = NULL,")
+    lines.append("};")
+    lines.append("")
+    return "\n".join(lines)
+
+
+def font_to_bitmap_c(font_file_path, sizes, src_dirs, array_name="xiaozhi_font", output_path=None):
+    font_path = Path(font_file_path)
+    if not font_path.exists():
+        raise FileNotFoundError(f"字体文件不存在: {font_file_path}")
+    if output_path is None:
+        output_path = font_path.parent / f"{array_name}_bitmap.c"
+    output_path = Path(output_path)
+
+    chars = collect_used_chars(src_dirs)
+    sizes = sorted(set(sizes))
+
+    # 字体、尺寸、字符集和本工具都未变化时跳过
+    digest = hashlib.sha1()
+    digest.update(font_path.read_bytes())
+    digest.update(Path(__file__).read_bytes())
+    digest.update(repr((sizes, ''.join(chars), SUBSAMPLES)).encode('utf-8'))
+    stamp = f"/* source-hash: {digest.hexdigest()} */"
+    if output_path.exists():
+        with open(output_path, encoding='utf-8') as f:
+            if f.readline().strip() == stamp:
+                print(f"位图字体已是最新: {output_path}")
+                return output_path
+
+    ttf = TrueTypeFont(font_path)
+    fonts, missing = [], set()
+    for size in sizes:
+        font = BitmapFont(ttf, size)
+        for ch in chars:
+            if not font.add_glyph(ord(ch)):
+                missing.add(ch)
+        fonts.append(font)
+    if missing:
+        print(f"Warning: 字体中缺少{len(missing)}个字符: {''.join(sorted(missing))}")
+
+    parts = [stamp,
+             "/* 由tools/font_converter.py生成，请勿手工修改 */",
+             "",
+             '#include "lvgl.h"',
+             ""]
+    names = []
+    for font in fonts:
+        name = f"{array_name}_{font.size}"
+        names.append(name)
+        parts.append(emit_font_c(font, name))
+
+    parts.append(f"const lv_font_t *const {array_name}_bitmap_fonts[] = {{")
+    parts.extend(f"    &{n}," for n in names)
+    parts.append("};")
+    parts.append("")
+    parts.append(f"const uint8_t {array_name}_bitmap_sizes[] = {{ {', '.join(str(s) for s in sizes)} }};")
+    parts.append("")
+    parts.append(f"const int {array_name}_bitmap_count = {len(sizes)};")
+    parts.append("")
+
+    with open(output_path, 'w', encoding='utf-8') as f:
+        f.write("\n".join(parts))
+
+    print(f"位图字体生成完成: {output_path}")
+    print(f"字号: {sizes}, 字符数: {len(chars) - len(missing)}")
+    return output_path
+
+
 def main():
     parser = argparse.ArgumentParser(description='字体文件转换工具')
     parser.add_argument('font_file', help='字体文件路径')
     parser.add_argument('-n', '--name', default='xiaozhi_font', help='C数组名称 (默认: xiaozhi_font)')
-    
+    parser.add_argument('--bitmap', action='store_true', help='生成预渲染位图字体而不是TTF数组')
+    parser.add_argument('--sizes', default='', help='位图字体像素大小，逗号分隔')
+    parser.add_argument('--scan', action='append', default=[], help='扫描字符串字面量的源码目录（可多次指定）')
+    parser.add_argument('-o', '--output', help='位图字体输出文件')
+
     args = parser.parse_args()
-    
+
     try:
-        font_to_c_array(args.font_file, args.name)
+        if args.bitmap:
+            sizes = [int(s) for s in args.sizes.split(',') if s.strip()]
+            if not sizes or not args.scan:
+                raise ValueError("--bitmap需要--sizes和--scan")
+            font_to_bitmap_c(args.font_file, sizes, args.scan, args.name, args.output)
+        else:
+            font_to_c_array(args.font_file, args.name)
         return 0
     except Exception as e:
         print(f"错误: {e}", file=sys.stderr)
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+主机构建的资源生成
+
+板上的图片由SDK的ezip工具打包、字体由font/SConscript生成，主机构建不依赖SDK，
+在这里生成等价的C源文件：
+1. 按asset_prescaler.prescale_plan()预缩放UI引用的图片，输出为ARGB8888的
+   lv_image_dsc_t（符号名与板上相同）
+2. 调用font_converter生成同样字号的预渲染位图字体，可选嵌入TTF回退
+"""
+
+import os
+import sys
+import argparse
+
+TOOLS_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+APP_DIR = os.path.dirname(TOOLS_DIR)
+sys.path.insert(0, TOOLS_DIR)
+
+from asset_prescaler import prescale, prescale_plan, ui_scale, load_png_rgba
+from font_converter import font_to_bitmap_c, font_to_c_array
+
+# 与screen_ui_manager.c中create_fonts()的基准字号一致
+BASE_FONT_SIZES = [20, 25, 30, 35, 43, 65]
+
+
+def emit_image(f, name, png_path):
+    width, height, rgba = load_png_rgba(png_path)
+
+    # LVGL的ARGB8888在内存中按B、G、R、A排列
+    data = bytearray(len(rgba))
+    data[0::4] = rgba[2::4]
+    data[1::4] = rgba[1::4]
+    data[2::4] = rgba[0::4]
+    data[3::4] = rgba[3::4]
+
+    f.write(f"static const uint8_t {name}_map[] = {{\n")
+    for i in range(0, len(data), 32):
+        f.write("    " + ",".join(str(b) for b in data[i:i + 32]) + ",\n")
+    f.write("};\n\n")
+    f.write(f"const lv_image_dsc_t {name} = {{\n")
+    f.write("    .header.magic = LV_IMAGE_HEADER_MAGIC,\n")
+    f.write("    .header.cf = LV_COLOR_FORMAT_ARGB8888,\n")
+    f.write(f"    .header.w = {width},\n")
+    f.write(f"    .header.h = {height},\n")
+    f.write(f"    .header.stride = {width * 4},\n")
+    f.write(f"    .data_size = sizeof({name}_map),\n")
+    f.write(f"    .data = {name}_map,\n")
+    f.write("};\n\n")
+
+
+def generate_assets(out_dir, scale):
+    asset_dir = os.path.join(APP_DIR, 'asset')
+    prescaled_dir = os.path.join(out_dir, 'prescaled')
+    output = os.path.join(out_dir, 'host_assets.c')
+
+    images = []
+    for subdir, names, zoom, suffix in prescale_plan(asset_dir, scale):
+        for n in names:
+            src = os.path.join(asset_dir, subdir, n + '.png')
+            dst = os.path.join(prescaled_dir, subdir, n + suffix + '.png')
+            prescale(src, dst, zoom)
+            images.append((n + suffix, dst))
+
+    # 预缩放结果未变化时不重写，避免重新编译
+    newest = max(os.path.getmtime(p) for _, p in images)
+    if os.path.exists(output) and os.path.getmtime(output) >= newest:
+        return
+
+    with open(output, 'w', encoding='utf-8') as f:
+        f.write("/* 由tools/host/gen_sources.py生成，请勿手工修改 */\n\n")
+        f.write('#include "lvgl.h"\n\n')
+        for name, path in images:
+            emit_image(f, name, path)
+    print(f"图片资源: {output} ({len(images)}张)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description='生成主机构建的图片和字体源文件')
+    parser.add_argument('out_dir', help='输出目录')
+    parser.add_argument('--hor-res', type=int, default=384, help='LCD_HOR_RES_MAX')
+    parser.add_argument('--ver-res', type=int, default=256, help='LCD_VER_RES_MAX')
+    parser.add_argument('--font', default=os.path.join(APP_DIR, 'font', 'DroidSansFallback.ttf'))
+    parser.add_argument('--ttf', action='store_true', help='同时嵌入TTF作为运行时回退')
+
+    args = parser.parse_args()
+    os.makedirs(args.out_dir, exist_ok=True)
+    scale = ui_scale(args.hor_res, args.ver_res)
+
+    try:
+        generate_assets(args.out_dir, scale)
+
+        sizes = sorted(set(int(base * scale + 0.5) for base in BASE_FONT_SIZES))
+        font_to_bitmap_c(args.font, sizes, [os.path.join(APP_DIR, 'src')], 'xiaozhi_font',
+                         os.path.join(args.out_dir, 'xiaozhi_font_bitmap.c'))
+
+        ttf_c = os.path.join(args.out_dir, 'xiaozhi_font.c')
+        if args.ttf and not os.path.exists(ttf_c):
+            font_to_c_array(args.font, 'xiaozhi_font', ttf_c)
+    except Exception as e:
+        print(f"资源生成失败: {e}", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,199 @@
+/**
+ * @file host_display.c
+ * @brief 主机构建的内存帧缓冲显示驱动和PNG输出
+ */
+
+#include "host_display.h"
+#include "lvgl.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef LCD_HOR_RES_MAX
+#define LCD_HOR_RES_MAX     384
+#endif
+#ifndef LCD_VER_RES_MAX
+#define LCD_VER_RES_MAX     256
+#endif
+#ifndef LV_FB_LINE_NUM
+#define LV_FB_LINE_NUM      152     /* 与板上配置一致，部分刷新的分块方式相同 */
+#endif
+
+static struct {
+    lv_display_t *disp;
+    uint16_t framebuffer[LCD_VER_RES_MAX][LCD_HOR_RES_MAX];
+    host_frame_cb_t frame_cb;
+    struct timespec refr_start;
+    uint32_t redraw_px;
+} g_host_disp;
+
+static uint8_t g_draw_buf[LCD_HOR_RES_MAX * LV_FB_LINE_NUM * 2] __attribute__((aligned(64)));
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    int32_t w = lv_area_get_width(area);
+    const uint16_t *src = (const uint16_t *)px_map;
+
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&g_host_disp.framebuffer[y][area->x1], src, w * sizeof(uint16_t));
+        src += w;
+    }
+
+    /* 只统计落在三块面板上的部分 */
+    int32_t x1 = LV_MAX(area->x1, 0), x2 = LV_MIN(area->x2, HOST_PANEL_WIDTH - 1);
+    int32_t y1 = LV_MAX(area->y1, 0), y2 = LV_MIN(area->y2, HOST_PANEL_HEIGHT - 1);
+    if (x2 >= x1 && y2 >= y1) {
+        g_host_disp.redraw_px += (uint32_t)((x2 - x1 + 1) * (y2 - y1 + 1));
+    }
+
+    lv_display_flush_ready(disp);
+}
+
+static void refr_event_cb(lv_event_t *e)
+{
+    struct timespec now;
+
+    if (lv_event_get_code(e) == LV_EVENT_REFR_START) {
+        g_host_disp.redraw_px = 0;
+        clock_gettime(CLOCK_MONOTONIC, &g_host_disp.refr_start);
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (g_host_disp.redraw_px > 0 && g_host_disp.frame_cb) {
+        uint64_t ns = (uint64_t)(now.tv_sec - g_host_disp.refr_start.tv_sec) * 1000000000ull +
+                      (uint64_t)(now.tv_nsec - g_host_disp.refr_start.tv_nsec);
+        g_host_disp.frame_cb(ns, g_host_disp.redraw_px);
+    }
+}
+
+int host_display_init(host_frame_cb_t frame_cb)
+{
+    g_host_disp.frame_cb = frame_cb;
+    g_host_disp.disp = lv_display_create(LCD_HOR_RES_MAX, LCD_VER_RES_MAX);
+    if (!g_host_disp.disp) {
+        return -1;
+    }
+
+    lv_display_set_color_format(g_host_disp.disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_flush_cb(g_host_disp.disp, flush_cb);
+    lv_display_set_buffers(g_host_disp.disp, g_draw_buf, NULL, sizeof(g_draw_buf),
+                           LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_add_event_cb(g_host_disp.disp, refr_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(g_host_disp.disp, refr_event_cb, LV_EVENT_REFR_READY, NULL);
+    return 0;
+}
+
+/*********************
+ *  PNG输出
+ *********************/
+
+static uint32_t g_crc_table[256];
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+    if (!g_crc_table[1]) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            g_crc_table[n] = c;
+        }
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = g_crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void put_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+static void write_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t len)
+{
+    uint8_t head[8];
+    uint8_t tail[4];
+
+    put_be32(head, len);
+    memcpy(head + 4, type, 4);
+    uint32_t crc = crc32_update(0, head + 4, 4);
+    crc = crc32_update(crc, data, len);
+    put_be32(tail, crc);
+
+    fwrite(head, 1, 8, f);
+    if (len) {
+        fwrite(data, 1, len, f);
+    }
+    fwrite(tail, 1, 4, f);
+}
+
+int host_display_write_png(const char *path)
+{
+    enum { ROW_BYTES = 1 + HOST_PANEL_WIDTH * 3 };
+    static uint8_t raw[HOST_PANEL_HEIGHT * ROW_BYTES];
+    /* 每行一个stored块（行长小于65535），外加zlib头和adler32 */
+    static uint8_t idat[2 + HOST_PANEL_HEIGHT * (5 + ROW_BYTES) + 4];
+
+    for (int y = 0; y < HOST_PANEL_HEIGHT; y++) {
+        uint8_t *row = &raw[y * ROW_BYTES];
+        row[0] = 0;     /* 不做行过滤 */
+        for (int x = 0; x < HOST_PANEL_WIDTH; x++) {
+            uint16_t c = g_host_disp.framebuffer[y][x];
+            uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+            row[1 + x * 3] = (uint8_t)((r << 3) | (r >> 2));
+            row[2 + x * 3] = (uint8_t)((g << 2) | (g >> 4));
+            row[3 + x * 3] = (uint8_t)((b << 3) | (b >> 2));
+        }
+    }
+
+    size_t pos = 0;
+    idat[pos++] = 0x78;
+    idat[pos++] = 0x01;
+    uint32_t a = 1, b = 0;
+    for (int y = 0; y < HOST_PANEL_HEIGHT; y++) {
+        const uint8_t *row = &raw[y * ROW_BYTES];
+        idat[pos++] = (y == HOST_PANEL_HEIGHT - 1) ? 1 : 0;
+        idat[pos++] = ROW_BYTES & 0xFF;
+        idat[pos++] = ROW_BYTES >> 8;
+        idat[pos++] = ~ROW_BYTES & 0xFF;
+        idat[pos++] = (~ROW_BYTES >> 8) & 0xFF;
+        memcpy(&idat[pos], row, ROW_BYTES);
+        pos += ROW_BYTES;
+        for (int i = 0; i < ROW_BYTES; i++) {
+            a = (a + row[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+    }
+    put_be32(&idat[pos], (b << 16) | a);
+    pos += 4;
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return -1;
+    }
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    uint8_t ihdr[13];
+    put_be32(ihdr, HOST_PANEL_WIDTH);
+    put_be32(ihdr + 4, HOST_PANEL_HEIGHT);
+    ihdr[8] = 8;        /* 位深 */
+    ihdr[9] = 2;        /* RGB */
+    ihdr[10] = 0;
+    ihdr[11] = 0;
+    ihdr[12] = 0;
+
+    fwrite(signature, 1, sizeof(signature), f);
+    write_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    write_chunk(f, "IDAT", idat, (uint32_t)pos);
+    write_chunk(f, "IEND", NULL, 0);
+    fclose(f);
+    return 0;
+}
@@ -0,0 +1,27 @@
+#ifndef HOST_DISPLAY_H
+#define HOST_DISPLAY_H
+
+/**
+ * @file host_display.h
+ * @brief 主机构建的内存帧缓冲显示驱动
+ *
+ * LVGL显示尺寸与板上一致（LCD_HOR_RES_MAX×LCD_VER_RES_MAX），保证缩放系数、
+ * 字号和预缩放图片相同；GC9107面板网格（panel_grid.h）对应其中左上角的
+ * 区域，截图和重绘面积只统计这一区域。
+ */
+
+#include <stdint.h>
+#include "panel_grid.h"
+
+#define HOST_PANEL_WIDTH    LCD_PANEL_GRID_WIDTH
+#define HOST_PANEL_HEIGHT   LCD_PANEL_GRID_HEIGHT
+
+/* 每次渲染完成后回调：渲染耗时和本帧重绘的可见像素数 */
+typedef void (*host_frame_cb_t)(uint64_t render_ns, uint32_t redraw_px);
+
+int host_display_init(host_frame_cb_t frame_cb);
+
+/* 把可见区域保存为PNG（RGB8，无压缩的deflate块，不依赖zlib） */
+int host_display_write_png(const char *path);
+
+#endif /* HOST_DISPLAY_H */
@@ -0,0 +1,249 @@
+/**
+ * @file host_fakes.c
+ * @brief 主机构建中硬件相关模块的替身
+ *
+ * 事件总线改为同步分发（按订阅顺序，股票名称ID同样在分发后释放），flash后台任务在post时同步执行，
+ * 其余HID/按键/LED/编码器/传感器接口只返回固定结果，保证UI路径与板上一致、
+ * 输出可复现。
+ */
+
+#include <rtthread.h>
+#include <string.h>
+#include "event_bus.h"
+#include "key_manager.h"
+#include "hid_device.h"
+#include "led_effects_manager.h"
+#include "encoder_controller.h"
+#include "sht30_controller.h"
+#include "flash_worker.h"
+#include "stock_watchlist.h"
+
+/*********************
+ *  事件总线（同步）
+ *********************/
+
+#define HOST_MAX_SUBSCRIPTIONS 48
+
+static event_subscription_t g_subs[HOST_MAX_SUBSCRIPTIONS];
+static int g_sub_count;
+
+int event_bus_subscribe(event_type_t event_type, event_handler_t handler,
+                        void *user_data, event_priority_t min_priority)
+{
+    if (!handler || g_sub_count >= HOST_MAX_SUBSCRIPTIONS) {
+        return -RT_ERROR;
+    }
+
+    event_subscription_t *sub = &g_subs[g_sub_count++];
+    sub->event_type = event_type;
+    sub->handler = handler;
+    sub->user_data = user_data;
+    sub->min_priority = min_priority;
+    sub->enabled = true;
+    return 0;
+}
+
+int event_bus_unsubscribe(event_type_t event_type, event_handler_t handler)
+{
+    for (int i = 0; i < g_sub_count; i++) {
+        if (g_subs[i].event_type == event_type && g_subs[i].handler == handler) {
+            memmove(&g_subs[i], &g_subs[i + 1], (g_sub_count - i - 1) * sizeof(g_subs[0]));
+            g_sub_count--;
+            return 0;
+        }
+    }
+    return -RT_ERROR;
+}
+
+int event_bus_publish(event_type_t type, const void *event_data, size_t data_size,
+                      event_priority_t priority, uint32_t source_module_id)
+{
+    if (data_size > sizeof(((event_t *)0)->data)) {
+        return -RT_EINVAL;
+    }
+
+    event_t event = {0};
+    event.type = type;
+    event.priority = priority;
+    event.timestamp = rt_tick_get();
+    event.source_module_id = source_module_id;
+    if (event_data && data_size > 0) {
+        memcpy(&event.data, event_data, data_size);
+    }
+
+    for (int i = 0; i < g_sub_count; i++) {
+        if (g_subs[i].enabled && g_subs[i].event_type == type &&
+            event.priority >= g_subs[i].min_priority) {
+            g_subs[i].handler(&event, g_subs[i].user_data);
+        }
+    }
+    if (type == EVENT_DATA_STOCK_UPDATED) {
+        stock_name_release_list(event.data.stock.stocks, event.data.stock.count);
+    }
+    return 0;
+}
+
+int event_bus_publish_led_feedback(int led_index, uint32_t color, uint32_t duration_ms)
+{
+    (void)led_index;
+    (void)color;
+    (void)duration_ms;
+    return 0;
+}
+
+/*********************
+ *  按键/HID/LED/编码器
+ *********************/
+
+int key_manager_register_context(const key_context_config_t *config)
+{
+    (void)config;
+    return 0;
+}
+
+int key_manager_unregister_context(key_context_id_t ctx_id)
+{
+    (void)ctx_id;
+    return 0;
+}
+
+int key_manager_activate_context(key_context_id_t ctx_id)
+{
+    (void)ctx_id;
+    return 0;
+}
+
+int key_manager_deactivate_context(key_context_id_t ctx_id)
+{
+    (void)ctx_id;
+    return 0;
+}
+
+const char *key_manager_get_context_name(key_context_id_t ctx_id)
+{
+    (void)ctx_id;
+    return "host";
+}
+
+void hid_kbd_send_combo(uint8_t modifier, uint8_t keycode)
+{
+    (void)modifier;
+    (void)keycode;
+}
+
+void hid_consumer_click(uint8_t bits)
+{
+    (void)bits;
+}
+
+bool hid_device_ready(void)
+{
+    return false;
+}
+
+led_effect_handle_t led_effects_breathing(uint32_t color, uint32_t period_ms,
+                                          uint8_t brightness, uint32_t duration_ms)
+{
+    (void)color;
+    (void)period_ms;
+    (void)brightness;
+    (void)duration_ms;
+    return NULL;
+}
+
+int led_effects_stop_effect(led_effect_handle_t handle)
+{
+    (void)handle;
+    return 0;
+}
+
+int led_effects_feedback(int led_index, uint32_t color, uint32_t duration_ms)
+{
+    (void)led_index;
+    (void)color;
+    (void)duration_ms;
+    return 0;
+}
+
+bool encoder_controller_is_ready(void)
+{
+    return false;
+}
+
+int encoder_controller_set_mode(encoder_mode_t mode)
+{
+    (void)mode;
+    return 0;
+}
+
+int encoder_controller_reset_count(void)
+{
+    return 0;
+}
+
+int encoder_controller_start_polling(void)
+{
+    return 0;
+}
+
+int encoder_controller_stop_polling(void)
+{
+    return 0;
+}
+
+int encoder_controller_set_sensitivity(uint8_t divider)
+{
+    (void)divider;
+    return 0;
+}
+
+/*********************
+ *  温湿度传感器：固定读数
+ *********************/
+
+int sht30_controller_get_latest(sht30_data_t *data)
+{
+    if (!data) {
+        return -RT_EINVAL;
+    }
+
+    memset(data, 0, sizeof(*data));
+    data->temperature_c = 23.5f;
+    data->temperature_k = 296.65f;
+    data->temperature_f = 74.3f;
+    data->humidity_rh = 45.0f;
+    data->timestamp = rt_tick_get();
+    data->sample_count = 1;
+    data->valid = true;
+    return RT_EOK;
+}
+
+/*********************
+ *  flash后台任务：同步执行，忽略延时
+ *********************/
+
+static flash_job_fn_t g_flash_jobs[FLASH_JOB_MAX];
+
+int flash_worker_init(void)
+{
+    return 0;
+}
+
+int flash_worker_register(flash_job_t job, flash_job_fn_t fn)
+{
+    if (job >= FLASH_JOB_MAX || !fn) {
+        return -RT_EINVAL;
+    }
+    g_flash_jobs[job] = fn;
+    return 0;
+}
+
+int flash_worker_post(flash_job_t job, uint32_t delay_ms)
+{
+    (void)delay_ms;
+    if (job >= FLASH_JOB_MAX || !g_flash_jobs[job]) {
+        return -RT_EINVAL;
+    }
+    g_flash_jobs[job]();
+    return 0;
+}
@@ -0,0 +1,359 @@
+/**
+ * @file host_main.c
+ * @brief 屏幕UI的主机无头运行：按脚本切换页面、推送模拟数据，
+ *        输出每步截图（用于黄金图比对）和逐帧渲染耗时/重绘面积
+ *
+ * 用法: superkey_ui_host [-o 输出目录] [-n 不输出PNG] [-v 打印日志]
+ */
+
+#include <rtthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "lvgl.h"
+#include "screen.h"
+#include "screen_context.h"
+#include "screen_ui_manager.h"
+#include "data_manager.h"
+#include "stock_watchlist.h"
+#include "event_bus.h"
+#include "image_cache.h"
+#include "flush_planner.h"
+#include "host_display.h"
+
+#define HOST_MAX_FRAMES     4096
+
+typedef struct {
+    uint16_t step;
+    uint32_t t_ms;          /* 虚拟时钟 */
+    uint32_t render_us;
+    uint32_t redraw_px;
+} host_frame_t;
+
+typedef struct {
+    const char *name;
+    void (*action)(void);
+    uint32_t settle_ms;     /* 动作后运行多久再截图 */
+} host_step_t;
+
+static struct {
+    host_frame_t frames[HOST_MAX_FRAMES];
+    uint32_t frame_count;
+    uint16_t current_step;
+    const char *out_dir;
+    bool write_png;
+} g_run = {0};
+
+static void on_frame(uint64_t render_ns, uint32_t redraw_px)
+{
+    if (g_run.frame_count >= HOST_MAX_FRAMES) {
+        return;
+    }
+
+    host_frame_t *f = &g_run.frames[g_run.frame_count++];
+    f->step = g_run.current_step;
+    f->t_ms = rt_tick_get() * 1000 / RT_TICK_PER_SECOND;
+    f->render_us = (uint32_t)(render_ns / 1000);
+    f->redraw_px = redraw_px;
+}
+
+/* 与main.c的GUI主循环相同，空闲时由虚拟时钟推进 */
+static void run_for(uint32_t ms)
+{
+    rt_tick_t end = rt_tick_get() + rt_tick_from_millisecond(ms);
+
+    while ((int32_t)(end - rt_tick_get()) > 0) {
+        int processed = screen_process_switch_request();
+        screen_context_process_background_restore();
+
+        if (processed > 0) {
+            lv_refr_now(NULL);
+            screen_notify_frame_rendered();
+        }
+
+        uint32_t next = lv_timer_handler();
+        uint32_t left = (end - rt_tick_get()) * 1000 / RT_TICK_PER_SECOND;
+        if (next > left) {
+            next = left;
+        }
+        screen_wait_for_work(next ? next : 1);
+    }
+}
+
+/*********************
+ *  模拟数据
+ *********************/
+
+static void push_weather(void)
+{
+    event_data_weather_t ev = {0};
+    weather_data_t *w = &ev.weather;
+
+    strcpy(w->city, "深圳");
+    strcpy(w->weather, "多云");
+    w->temperature = 26.5f;
+    w->humidity = 68.0f;
+    w->pressure = 1008;
+    strcpy(w->update_time, "09:30:00");
+    w->weather_code = 101;
+    w->city_code = 4;
+    w->valid = true;
+    event_bus_publish(EVENT_DATA_WEATHER_UPDATED, &ev, sizeof(ev),
+                      EVENT_PRIORITY_NORMAL, MODULE_ID_SERIAL_COMM);
+}
+
+static void push_stocks(void)
+{
+    static const struct {
+        const char *name;
+        int32_t price_x100;
+        int32_t change_x100;
+    } list[] = {
+        {"贵州茅台", 168800, 2350},
+        {"宁德时代", 21566, -412},
+        {"招商银行", 3521, 18},
+    };
+    event_data_stock_t ev = {0};
+
+    ev.replace = true;
+    for (size_t i = 0; i < sizeof(list) / sizeof(list[0]); i++) {
+        stock_data_t *s = &ev.stocks[ev.count++];
+        s->name_id = stock_name_intern(list[i].name);
+        s->price_x100 = list[i].price_x100;
+        s->change_x100 = list[i].change_x100;
+        s->update_time = (uint32_t)time(NULL);
+        s->valid = true;
+    }
+    event_bus_publish(EVENT_DATA_STOCK_UPDATED, &ev, sizeof(ev),
+                      EVENT_PRIORITY_NORMAL, MODULE_ID_SERIAL_COMM);
+}
+
+static void push_system(void)
+{
+    /* 每次推送略有变化，模拟上位机的周期上报 */
+    static uint32_t seq;
+    event_data_system_t ev = {0};
+    system_monitor_data_t *s = &ev.system;
+
+    seq++;
+    s->cpu_usage = 30.0f + (seq * 7) % 40;
+    s->cpu_temp = 52.0f + (seq % 5);
+    s->gpu_usage = 20.0f + (seq * 11) % 60;
+    s->gpu_temp = 45.0f + (seq % 7);
+    s->ram_usage = 63.2f;
+    s->net_upload_speed = 0.1f * (seq % 20);
+    s->net_download_speed = 0.5f * (seq % 30);
+    strcpy(s->update_time, "09:30:00");
+    s->valid = true;
+    event_bus_publish(EVENT_DATA_SYSTEM_UPDATED, &ev, sizeof(ev),
+                      EVENT_PRIORITY_NORMAL, MODULE_ID_SERIAL_COMM);
+}
+
+/*********************
+ *  场景动作
+ *********************/
+
+static void act_none(void) { }
+static void act_push_all(void) { push_weather(); push_stocks(); push_system(); }
+static void act_group1(void) { screen_switch_group(SCREEN_GROUP_1); }
+static void act_group2(void) { screen_switch_group(SCREEN_GROUP_2); }
+static void act_group3(void) { screen_switch_group(SCREEN_GROUP_3); }
+static void act_group4(void) { screen_switch_group(SCREEN_GROUP_4); }
+static void act_return(void) { screen_return_to_level1(); }
+static void act_l2_time(void) { screen_enter_level2(SCREEN_L2_TIME_GROUP, SCREEN_L2_TIME_DETAIL); }
+static void act_l2_media(void) { screen_enter_level2(SCREEN_L2_MEDIA_GROUP, SCREEN_L2_MEDIA_CONTROL); }
+static void act_l2_web(void) { screen_enter_level2(SCREEN_L2_WEB_GROUP, SCREEN_L2_WEB_CONTROL); }
+static void act_l2_shortcut(void) { screen_enter_level2(SCREEN_L2_SHORTCUT_GROUP, SCREEN_L2_SHORTCUT_CONTROL); }
+static void act_l2_muyu(void) { screen_enter_level2(SCREEN_L2_MUYU_GROUP, SCREEN_L2_MUYU_MAIN); }
+static void act_l2_tomato(void) { screen_enter_level2(SCREEN_L2_TOMATO_GROUP, SCREEN_L2_TOMATO_TIMER); }
+static void act_l2_gallery(void) { screen_enter_level2(SCREEN_L2_GALLERY_GROUP, SCREEN_L2_GALLERY_VIEW); }
+
+/* 稳态：每秒推送一次系统数据，持续一分钟 */
+static void act_steady(void)
+{
+    for (int i = 0; i < 60; i++) {
+        push_system();
+        run_for(1000);
+    }
+}
+
+static const host_step_t g_scenario[] = {
+    {"boot",          act_none,        500},
+    {"g1_data",       act_push_all,    500},
+    {"l2_time",       act_l2_time,     500},
+    {"g1_back",       act_return,      500},
+    {"g2",            act_group2,      500},
+    {"g3",            act_group3,      500},
+    {"l2_media",      act_l2_media,    500},
+    {"g3_back1",      act_return,      300},
+    {"l2_web",        act_l2_web,      500},
+    {"g3_back2",      act_return,      300},
+    {"l2_shortcut",   act_l2_shortcut, 500},
+    {"g3_back3",      act_return,      300},
+    {"g4",            act_group4,      500},
+    {"l2_muyu",       act_l2_muyu,     500},
+    {"g4_back1",      act_return,      300},
+    {"l2_tomato",     act_l2_tomato,   500},
+    {"g4_back2",      act_return,      300},
+    {"l2_gallery",    act_l2_gallery,  500},
+    {"g4_back3",      act_return,      300},
+    {"g2_revisit",    act_group2,      500},
+    {"g2_steady",     act_steady,      0},
+    {"g1_revisit",    act_group1,      500},
+    {"g1_expired",    act_none,        DATA_TIMEOUT_MS + 1000},
+};
+
+#define SCENARIO_STEPS  (sizeof(g_scenario) / sizeof(g_scenario[0]))
+
+/*********************
+ *  输出
+ *********************/
+
+static void dump_step(uint16_t index, const char *name)
+{
+    char path[512];
+
+    if (!g_run.write_png) {
+        return;
+    }
+    snprintf(path, sizeof(path), "%s/%02u_%s.png", g_run.out_dir, index, name);
+    if (host_display_write_png(path) != 0) {
+        fprintf(stderr, "cannot write %s\n", path);
+    }
+}
+
+static void write_frames_csv(void)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frames.csv", g_run.out_dir);
+
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return;
+    }
+    fprintf(f, "step,name,t_ms,render_us,redraw_px\n");
+    for (uint32_t i = 0; i < g_run.frame_count; i++) {
+        const host_frame_t *fr = &g_run.frames[i];
+        fprintf(f, "%u,%s,%u,%u,%u\n", fr->step, g_scenario[fr->step].name,
+                fr->t_ms, fr->render_us, fr->redraw_px);
+    }
+    fclose(f);
+}
+
+static void print_summary(void)
+{
+    const uint32_t panel_px = HOST_PANEL_WIDTH * HOST_PANEL_HEIGHT;
+    uint64_t all_us = 0;
+
+    printf("%-12s %6s %10s %10s %10s %8s\n",
+           "step", "frames", "avg_us", "max_us", "redraw_px", "redraw%");
+    for (uint16_t s = 0; s < SCENARIO_STEPS; s++) {
+        uint32_t count = 0, max_us = 0;
+        uint64_t sum_us = 0, sum_px = 0;
+
+        for (uint32_t i = 0; i < g_run.frame_count; i++) {
+            const host_frame_t *fr = &g_run.frames[i];
+            if (fr->step != s) {
+                continue;
+            }
+            count++;
+            sum_us += fr->render_us;
+            sum_px += fr->redraw_px;
+            if (fr->render_us > max_us) {
+                max_us = fr->render_us;
+            }
+        }
+        all_us += sum_us;
+        printf("%-12s %6u %10u %10u %10llu %7.1f%%\n", g_scenario[s].name, count,
+               count ? (uint32_t)(sum_us / count) : 0, max_us, (unsigned long long)sum_px,
+               count ? 100.0 * sum_px / ((double)panel_px * count) : 0.0);
+    }
+
+    screen_ui_switch_stats_t sw;
+    if (screen_ui_get_switch_stats(&sw) == 0) {
+        printf("page switches: %u, builds: %u, evictions: %u, avg %u ms, retained %u bytes in %u pages\n",
+               sw.switch_count, sw.build_count, sw.evict_count, sw.avg_total_ms,
+               sw.retained_bytes, sw.retained_pages);
+    }
+
+    image_cache_stats_t ic;
+    if (image_cache_get_stats(&ic) == 0) {
+        printf("image cache: %u hits, %u misses, %u evictions, %u bypasses, %u bytes\n",
+               ic.hits, ic.misses, ic.evictions, ic.bypasses, ic.bytes_used);
+    }
+
+    flush_planner_stats_t fp;
+    flush_planner_get_stats(&fp);
+    if (fp.frames) {
+        printf("flush plan: %u flushes, %.1f per frame, %llu bytes per frame, %u splits, %u merges, "
+               "%u off-panel, %u overflows\n",
+               fp.flushes, (double)fp.flushes / fp.frames, (unsigned long long)(fp.bytes / fp.frames),
+               fp.splits, fp.merges, fp.dropped, fp.overflows);
+    }
+
+    printf("frames: %u, total render %llu us\n", g_run.frame_count, (unsigned long long)all_us);
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    bool verbose = false;
+
+    g_run.out_dir = "host_out";
+    g_run.write_png = true;
+    while ((opt = getopt(argc, argv, "o:nv")) != -1) {
+        switch (opt) {
+        case 'o':
+            g_run.out_dir = optarg;
+            break;
+        case 'n':
+            g_run.write_png = false;
+            break;
+        case 'v':
+            verbose = true;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-o outdir] [-n] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+    mkdir(g_run.out_dir, 0755);
+
+    /* 时间显示按UTC，结果与宿主机时区无关 */
+    setenv("TZ", "UTC", 1);
+    tzset();
+    rt_host_set_quiet(!verbose);
+
+    lv_init();
+    lv_tick_set_cb(rt_tick_get);
+    if (host_display_init(on_frame) != 0) {
+        fprintf(stderr, "display init failed\n");
+        return 1;
+    }
+    flush_planner_init();
+
+    /* 与main.c相同的初始化顺序：数据管理器先于屏幕订阅事件 */
+    if (data_manager_init() != 0) {
+        fprintf(stderr, "data manager init failed\n");
+        return 1;
+    }
+    create_triple_screen_display();
+
+    for (uint16_t s = 0; s < SCENARIO_STEPS; s++) {
+        g_run.current_step = s;
+        g_scenario[s].action();
+        run_for(g_scenario[s].settle_ms);
+        dump_step(s, g_scenario[s].name);
+    }
+
+    write_frames_csv();
+    print_summary();
+
+    cleanup_triple_screen_display();
+    data_manager_deinit();
+    return 0;
+}
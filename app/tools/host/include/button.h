@@ -0,0 +1,13 @@
+#ifndef HOST_BUTTON_H
+#define HOST_BUTTON_H
+
+/* 主机构建：按键库只需要动作类型定义 */
+
+typedef enum {
+    BUTTON_PRESSED = 0,
+    BUTTON_RELEASED,
+    BUTTON_LONG_PRESSED,
+    BUTTON_CLICKED,
+} button_action_t;
+
+#endif /* HOST_BUTTON_H */
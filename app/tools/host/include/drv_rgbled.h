@@ -0,0 +1,22 @@
+#ifndef HOST_DRV_RGBLED_H
+#define HOST_DRV_RGBLED_H
+
+/* 主机构建：只保留LED头文件引用的颜色定义，不含驱动接口 */
+
+#include <rtthread.h>
+
+#define RGB_COLOR_BLACK     0x000000
+#define RGB_COLOR_WHITE     0xFFFFFF
+#define RGB_COLOR_RED       0xFF0000
+#define RGB_COLOR_GREEN     0x00FF00
+#define RGB_COLOR_BLUE      0x0000FF
+#define RGB_COLOR_YELLOW    0xFFFF00
+#define RGB_COLOR_CYAN      0x00FFFF
+#define RGB_COLOR_MAGENTA   0xFF00FF
+
+#define RGB_MAKE_COLOR(r, g, b) ((((uint32_t)(r)) << 16) | (((uint32_t)(g)) << 8) | ((uint32_t)(b)))
+#define RGB_GET_RED(c)          (((c) >> 16) & 0xFF)
+#define RGB_GET_GREEN(c)        (((c) >> 8) & 0xFF)
+#define RGB_GET_BLUE(c)         ((c) & 0xFF)
+
+#endif /* HOST_DRV_RGBLED_H */
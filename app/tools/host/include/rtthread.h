@@ -0,0 +1,129 @@
+#ifndef HOST_RTTHREAD_H
+#define HOST_RTTHREAD_H
+
+/**
+ * @file rtthread.h
+ * @brief 主机构建用的RT-Thread接口替身
+ *
+ * 只提供UI相关模块用到的那部分接口。单线程运行，系统节拍是虚拟时钟：
+ * 只有rt_thread_mdelay、带超时的rt_event_recv和rt_host_advance()推进时间，
+ * 到期的定时器在推进时按时间顺序回调，同一场景每次运行结果完全相同。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef long                rt_base_t;
+typedef unsigned long       rt_ubase_t;
+typedef rt_base_t           rt_err_t;
+typedef uint32_t            rt_tick_t;
+typedef size_t              rt_size_t;
+typedef int32_t             rt_int32_t;
+typedef uint32_t            rt_uint32_t;
+typedef uint16_t            rt_uint16_t;
+typedef uint8_t             rt_uint8_t;
+typedef int                 rt_bool_t;
+
+#define RT_NULL             NULL
+#define RT_TRUE             1
+#define RT_FALSE            0
+
+#define RT_EOK              0
+#define RT_ERROR            1
+#define RT_ETIMEOUT         2
+#define RT_EFULL            3
+#define RT_EEMPTY           4
+#define RT_ENOMEM           5
+#define RT_ENOSYS           6
+#define RT_EBUSY            7
+#define RT_EIO              8
+#define RT_EINTR            9
+#define RT_EINVAL           10
+
+#define RT_TICK_PER_SECOND  1000
+#define RT_WAITING_FOREVER  -1
+#define RT_WAITING_NO       0
+
+#define RT_IPC_FLAG_FIFO    0x00
+#define RT_IPC_FLAG_PRIO    0x01
+
+#define RT_EVENT_FLAG_AND   0x01
+#define RT_EVENT_FLAG_OR    0x02
+#define RT_EVENT_FLAG_CLEAR 0x04
+
+#define RT_TIMER_FLAG_ONE_SHOT      0x0
+#define RT_TIMER_FLAG_PERIODIC      0x2
+#define RT_TIMER_FLAG_HARD_TIMER    0x0
+#define RT_TIMER_FLAG_SOFT_TIMER    0x4
+
+#define RT_TIMER_CTRL_SET_TIME      0x0
+#define RT_TIMER_CTRL_GET_TIME      0x1
+#define RT_TIMER_CTRL_SET_ONESHOT   0x2
+#define RT_TIMER_CTRL_SET_PERIODIC  0x3
+
+#define RT_ASSERT(x)        do { if (!(x)) rt_host_assert(#x, __FILE__, __LINE__); } while (0)
+
+typedef struct rt_mutex *rt_mutex_t;
+typedef struct rt_event *rt_event_t;
+typedef struct rt_messagequeue *rt_mq_t;
+typedef struct rt_timer *rt_timer_t;
+
+/* 系统节拍和延时 */
+rt_tick_t rt_tick_get(void);
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms);
+rt_err_t rt_thread_mdelay(rt_int32_t ms);
+
+/* 中断和调度锁：单线程下为空操作 */
+rt_base_t rt_hw_interrupt_disable(void);
+void rt_hw_interrupt_enable(rt_base_t level);
+void rt_enter_critical(void);
+void rt_exit_critical(void);
+
+/* 内存和输出 */
+void *rt_malloc(rt_size_t size);
+void rt_free(void *ptr);
+int rt_kprintf(const char *fmt, ...);
+int rt_snprintf(char *buf, rt_size_t size, const char *fmt, ...);
+
+/* 互斥锁 */
+rt_mutex_t rt_mutex_create(const char *name, rt_uint8_t flag);
+rt_err_t rt_mutex_delete(rt_mutex_t mutex);
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout);
+rt_err_t rt_mutex_release(rt_mutex_t mutex);
+
+/* 事件集 */
+rt_event_t rt_event_create(const char *name, rt_uint8_t flag);
+rt_err_t rt_event_delete(rt_event_t event);
+rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set);
+rt_err_t rt_event_recv(rt_event_t event, rt_uint32_t set, rt_uint8_t opt,
+                       rt_int32_t timeout, rt_uint32_t *recved);
+
+/* 消息队列 */
+rt_mq_t rt_mq_create(const char *name, rt_size_t msg_size, rt_size_t max_msgs, rt_uint8_t flag);
+rt_err_t rt_mq_delete(rt_mq_t mq);
+rt_err_t rt_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size);
+rt_err_t rt_mq_recv(rt_mq_t mq, void *buffer, rt_size_t size, rt_int32_t timeout);
+
+/* 定时器 */
+rt_timer_t rt_timer_create(const char *name, void (*timeout)(void *parameter),
+                           void *parameter, rt_tick_t time, rt_uint8_t flag);
+rt_err_t rt_timer_delete(rt_timer_t timer);
+rt_err_t rt_timer_start(rt_timer_t timer);
+rt_err_t rt_timer_stop(rt_timer_t timer);
+rt_err_t rt_timer_control(rt_timer_t timer, int cmd, void *arg);
+
+/* 仅主机构建：推进虚拟时钟并回调到期定时器 */
+void rt_host_advance(rt_uint32_t ms);
+void rt_host_set_quiet(bool quiet);
+void rt_host_assert(const char *expr, const char *file, int line);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_RTTHREAD_H */
@@ -0,0 +1,229 @@
+/**
+ * @file led_bench.c
+ * @brief LED效果数学的主机微基准：旧的浮点实现与led_math定点/查表实现对比
+ *
+ * 每组内核跑相同的输入序列，输出每次调用的纳秒数和两者结果的最大偏差。
+ * 只链接led_math.c，不需要LVGL。
+ *
+ * x86主机上-O2的一次参考结果（倍数为旧/新耗时，随机器和编译器浮动）：
+ * breathing约7.2倍，hsv_to_rgb约3.5倍，brightness和lerp约1.2倍。
+ * 后两者的旧实现在主机上本来就只有几次乘除，收益主要来自前两者去掉的sinf和fmodf。
+ *
+ * 用法: led_bench [迭代次数，默认10000000]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "led_math.h"
+
+#define GET_R(c)    (((c) >> 16) & 0xFF)
+#define GET_G(c)    (((c) >> 8) & 0xFF)
+#define GET_B(c)    ((c) & 0xFF)
+#define MAKE_RGB(r, g, b) ((((uint32_t)(r)) << 16) | (((uint32_t)(g)) << 8) | ((uint32_t)(b)))
+
+static volatile uint32_t g_sink;
+
+/* ---- 旧内核：与改写前led_effects_manager.c中的实现一致 ---- */
+
+static uint32_t old_apply_brightness(uint32_t color, uint8_t brightness)
+{
+    if (brightness == 0) return 0;
+    if (brightness == 255) return color;
+
+    uint8_t r = GET_R(color) * brightness / 255;
+    uint8_t g = GET_G(color) * brightness / 255;
+    uint8_t b = GET_B(color) * brightness / 255;
+    return MAKE_RGB(r, g, b);
+}
+
+static uint32_t old_breathing(uint32_t tick, uint32_t period, uint32_t color, uint8_t brightness)
+{
+    uint32_t cycle_pos = tick % period;
+    float phase = (float)cycle_pos / period * 2.0f * 3.14159f;
+    uint8_t intensity = (uint8_t)((sin(phase) + 1.0f) * 127.5f);
+
+    color = old_apply_brightness(color, intensity);
+    return old_apply_brightness(color, brightness);
+}
+
+static uint32_t old_hsv_to_rgb(uint8_t h8, uint8_t s8, uint8_t v8)
+{
+    float h = h8 * 360.0f / 256.0f, s = s8 / 255.0f, v = v8 / 255.0f;
+    float c = v * s;
+    float x = c * (1.0f - fabsf(fmodf(h / 60.0f, 2.0f) - 1.0f));
+    float m = v - c;
+    float r, g, b;
+
+    if (h < 60)       { r = c; g = x; b = 0; }
+    else if (h < 120) { r = x; g = c; b = 0; }
+    else if (h < 180) { r = 0; g = c; b = x; }
+    else if (h < 240) { r = 0; g = x; b = c; }
+    else if (h < 300) { r = x; g = 0; b = c; }
+    else              { r = c; g = 0; b = x; }
+    return MAKE_RGB((uint8_t)((r + m) * 255.0f + 0.5f), (uint8_t)((g + m) * 255.0f + 0.5f),
+                    (uint8_t)((b + m) * 255.0f + 0.5f));
+}
+
+static uint32_t old_lerp(uint32_t c1, uint32_t c2, uint8_t ratio)
+{
+    float t = ratio / 255.0f;
+    uint8_t r = (uint8_t)(GET_R(c1) + (GET_R(c2) - (float)GET_R(c1)) * t);
+    uint8_t g = (uint8_t)(GET_G(c1) + (GET_G(c2) - (float)GET_G(c1)) * t);
+    uint8_t b = (uint8_t)(GET_B(c1) + (GET_B(c2) - (float)GET_B(c1)) * t);
+    return MAKE_RGB(r, g, b);
+}
+
+/* ---- 新内核 ---- */
+
+static uint32_t new_breathing(uint32_t phase, uint32_t color, uint8_t brightness)
+{
+    return led_color_scale(color, led_scale8(led_sin8(phase), brightness));
+}
+
+/* ---- 计时与比较 ---- */
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int channel_diff(uint32_t a, uint32_t b)
+{
+    int d = 0;
+    int dr = abs((int)GET_R(a) - (int)GET_R(b));
+    int dg = abs((int)GET_G(a) - (int)GET_G(b));
+    int db = abs((int)GET_B(a) - (int)GET_B(b));
+
+    d = dr > dg ? dr : dg;
+    return d > db ? d : db;
+}
+
+static void report(const char *name, uint64_t old_ns, uint64_t new_ns, uint32_t iters, int max_diff)
+{
+    double o = (double)old_ns / iters;
+    double n = (double)new_ns / iters;
+    printf("%-12s old %7.2f ns  new %7.2f ns  x%5.1f  max channel diff %d\n",
+           name, o, n, n > 0 ? o / n : 0.0, max_diff);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iters = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 10000000u;
+    const uint32_t period = 2000;
+    const uint32_t color = 0x40C0FF;
+    uint64_t t0, old_ns, new_ns;
+    uint32_t acc;
+    int max_diff;
+
+    if (iters == 0) {
+        iters = 1;
+    }
+    printf("led_bench: %u iterations per kernel\n", iters);
+
+    /* 呼吸：逐毫秒推进 */
+    acc = 0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += old_breathing(i, period, color, 200);
+    }
+    old_ns = now_ns() - t0;
+    g_sink = acc;
+
+    uint32_t step = led_phase_step(period), phase = 0;
+    acc = 0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += new_breathing(phase, color, 200);
+        phase += step;
+    }
+    new_ns = now_ns() - t0;
+    g_sink = acc;
+
+    max_diff = 0;
+    phase = 0;
+    for (uint32_t i = 0; i < period; i++, phase += step) {
+        int d = channel_diff(old_breathing(i, period, color, 200), new_breathing(phase, color, 200));
+        max_diff = d > max_diff ? d : max_diff;
+    }
+    report("breathing", old_ns, new_ns, iters, max_diff);
+
+    /* 亮度缩放 */
+    acc = 0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += old_apply_brightness(color ^ i, (uint8_t)(i | 1));
+    }
+    old_ns = now_ns() - t0;
+    g_sink = acc;
+
+    acc = 0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += led_color_scale(color ^ i, (uint8_t)(i | 1));
+    }
+    new_ns = now_ns() - t0;
+    g_sink = acc;
+
+    max_diff = 0;
+    for (uint32_t i = 0; i < 65536; i++) {
+        int d = channel_diff(old_apply_brightness(color ^ (i << 8), (uint8_t)i),
+                             led_color_scale(color ^ (i << 8), (uint8_t)i));
+        max_diff = d > max_diff ? d : max_diff;
+    }
+    report("brightness", old_ns, new_ns, iters, max_diff);
+
+    /* HSV转RGB */
+    acc = 0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += old_hsv_to_rgb((uint8_t)i, 255, 200);
+    }
+    old_ns = now_ns() - t0;
+    g_sink = acc;
+
+    acc = 0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += led_hsv_to_rgb((uint8_t)i, 255, 200);
+    }
+    new_ns = now_ns() - t0;
+    g_sink = acc;
+
+    max_diff = 0;
+    for (uint32_t h = 0; h < 256; h++) {
+        int d = channel_diff(old_hsv_to_rgb((uint8_t)h, 255, 200), led_hsv_to_rgb((uint8_t)h, 255, 200));
+        max_diff = d > max_diff ? d : max_diff;
+    }
+    report("hsv_to_rgb", old_ns, new_ns, iters, max_diff);
+
+    /* 颜色插值 */
+    acc = 0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += old_lerp(color, 0xFF2000, (uint8_t)i);
+    }
+    old_ns = now_ns() - t0;
+    g_sink = acc;
+
+    acc = 0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += led_color_lerp(color, 0xFF2000, (uint8_t)i);
+    }
+    new_ns = now_ns() - t0;
+    g_sink = acc;
+
+    max_diff = 0;
+    for (uint32_t r = 0; r < 256; r++) {
+        int d = channel_diff(old_lerp(color, 0xFF2000, (uint8_t)r), led_color_lerp(color, 0xFF2000, (uint8_t)r));
+        max_diff = d > max_diff ? d : max_diff;
+    }
+    report("lerp", old_ns, new_ns, iters, max_diff);
+
+    return 0;
+}
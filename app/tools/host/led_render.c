@@ -0,0 +1,523 @@
+/**
+ * @file led_render.c
+ * @brief LED效果引擎的主机驱动：把效果配置渲染成帧序列，做黄金帧比对和耗时测量
+ *
+ * 渲染按固件的调度方式进行：事件发生时和引擎给出的下一次输出变化时各渲染
+ * 一帧，得到的帧序列就是固件写给LED的帧（按1ms节拍）。也可以指定固定步长。
+ *
+ * 用法:
+ *   led_render check [目录]           渲染内置用例并与目录（默认led_golden）中的黄金帧比对
+ *   led_render update [目录]          重新生成黄金帧
+ *   led_render bench [LED数] [帧数]   每种效果每帧、每帧每LED的纳秒数
+ *   led_render run key=value ...      渲染任意效果配置，逐帧输出到stdout
+ *
+ * run的参数：type=static|breathing|flowing|blink|rainbow|wave|timeline，
+ * color=RRGGBB[,RRGGBB...]，period，duration，brightness，leds，start，count，
+ * reverse，layer，blend=replace|add|alpha|lighten，opacity，priority，mask，
+ * tl=时间线源文本，seconds（渲染时长，默认3），step（固定步长ms，0按调度）
+ */
+
+#include <rtthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "led_engine.h"
+#include "led_timeline.h"
+
+#define RENDER_MAX_FRAMES   8192
+#define RENDER_MAX_EVENTS   8
+#define RENDER_DEFAULT_DIR  "led_golden"
+
+typedef enum {
+    EV_START = 0,
+    EV_FEEDBACK,
+    EV_MANUAL,
+    EV_STOP_ALL,
+    EV_BRIGHTNESS
+} render_event_kind_t;
+
+typedef struct {
+    uint32_t at_ms;
+    render_event_kind_t kind;
+    led_effect_config_t config;     // EV_START
+    int led;                        // EV_FEEDBACK/EV_MANUAL，-1表示全部
+    uint32_t color;
+    uint32_t duration_ms;           // EV_FEEDBACK
+    uint8_t brightness;             // EV_BRIGHTNESS
+} render_event_t;
+
+typedef struct {
+    const char *name;
+    uint32_t led_count;
+    uint32_t duration_ms;
+    const char *timeline;           // 编译到槽位0，可为NULL
+    const char *feedback_timeline;  // 编译到槽位1并绑定为按键反馈，可为NULL
+    render_event_t events[RENDER_MAX_EVENTS];
+} render_case_t;
+
+typedef struct {
+    uint32_t t_ms;
+    uint32_t led[LED_MAX_COUNT];
+} render_frame_t;
+
+static struct {
+    led_engine_t engine;
+    render_frame_t frames[RENDER_MAX_FRAMES];
+    uint32_t frame_count;
+} g_render;
+
+#define START(t, ...)       { .at_ms = (t), .kind = EV_START, .config = { __VA_ARGS__ } }
+#define FEEDBACK(t, i, c, d) { .at_ms = (t), .kind = EV_FEEDBACK, .led = (i), .color = (c), .duration_ms = (d) }
+#define MANUAL(t, i, c)     { .at_ms = (t), .kind = EV_MANUAL, .led = (i), .color = (c) }
+#define STOP_ALL(t)         { .at_ms = (t), .kind = EV_STOP_ALL }
+#define BRIGHTNESS(t, b)    { .at_ms = (t), .kind = EV_BRIGHTNESS, .brightness = (b) }
+
+/* 黄金帧用例，每种效果至少一个，再加上分层合成和按键反馈。事件按时间排列 */
+static const render_case_t g_cases[] = {
+    { "static", 3, 1500, NULL, NULL, {
+        START(0, .type = LED_EFFECT_STATIC, .duration_ms = 1000, .brightness = 128,
+              .colors = {0xFFA040}, .color_count = 1),
+    } },
+    { "breathing", 3, 3000, NULL, NULL, {
+        START(0, .type = LED_EFFECT_BREATHING, .period_ms = 2000, .brightness = 255,
+              .colors = {0xFF2000}, .color_count = 1),
+    } },
+    { "flowing", 5, 2000, NULL, NULL, {
+        START(0, .type = LED_EFFECT_FLOWING, .period_ms = 900, .brightness = 200,
+              .colors = {0x00FF40}, .color_count = 1),
+    } },
+    { "flowing_reverse", 5, 2000, NULL, NULL, {
+        START(0, .type = LED_EFFECT_FLOWING, .period_ms = 700, .brightness = 255,
+              .colors = {0x4080FF}, .color_count = 1, .reverse = true, .led_start = 1, .led_count = 3),
+    } },
+    { "blink", 3, 2000, NULL, NULL, {
+        START(0, .type = LED_EFFECT_BLINK, .period_ms = 500, .duration_ms = 1600, .brightness = 255,
+              .colors = {0x0000FF}, .color_count = 1),
+    } },
+    { "rainbow", 6, 3000, NULL, NULL, {
+        START(0, .type = LED_EFFECT_RAINBOW, .period_ms = 3000, .brightness = 180),
+    } },
+    { "wave", 8, 2400, NULL, NULL, {
+        START(0, .type = LED_EFFECT_WAVE, .period_ms = 1200, .brightness = 255,
+              .colors = {0x00FFFF}, .color_count = 1),
+    } },
+    { "timeline", 3, 1500, "loop;0,0x1,FF0000;300,0x2,00FF00,out;600,0x7,000000,inout;900,0x4,FFFFFF,step", NULL, {
+        START(0, .type = LED_EFFECT_TIMELINE, .brightness = 255, .timeline = 0),
+    } },
+    { "layers", 3, 2000, NULL, NULL, {
+        START(0, .type = LED_EFFECT_RAINBOW, .period_ms = 4000, .brightness = 255),
+        START(0, .type = LED_EFFECT_BREATHING, .period_ms = 1000, .brightness = 255,
+              .colors = {0xFFFFFF}, .color_count = 1, .layer = LED_LAYER_EFFECT,
+              .blend = LED_BLEND_ALPHA, .opacity = 128, .led_mask = 0x6),
+        START(100, .type = LED_EFFECT_BLINK, .period_ms = 400, .brightness = 255,
+              .colors = {0x200000}, .color_count = 1, .layer = LED_LAYER_OVERLAY,
+              .blend = LED_BLEND_ADD),
+        MANUAL(400, 0, 0x00FF00),
+        FEEDBACK(800, 2, 0xFFFFFF, 200),
+        BRIGHTNESS(1200, 128),
+        STOP_ALL(1500),
+    } },
+    { "feedback_timeline", 3, 1200, NULL, "once;0,0x1,FFFFFF,step;300,0x1,000000,out", {
+        START(0, .type = LED_EFFECT_STATIC, .brightness = 64, .colors = {0x0000FF}, .color_count = 1),
+        FEEDBACK(100, 0, 0, 0),
+        FEEDBACK(250, 1, 0, 0),
+        FEEDBACK(300, 0, 0, 0),
+    } },
+};
+
+#define CASE_COUNT  (sizeof(g_cases) / sizeof(g_cases[0]))
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int render_setup(const render_case_t *rc)
+{
+    led_timeline_slot_clear(0);
+    led_timeline_slot_clear(1);
+    led_timeline_set_feedback_slot(-1);
+
+    if (rc->timeline && led_timeline_slot_compile(0, rc->timeline) != 0) {
+        fprintf(stderr, "%s: bad timeline \"%s\"\n", rc->name, rc->timeline);
+        return -1;
+    }
+    if (rc->feedback_timeline) {
+        if (led_timeline_slot_compile(1, rc->feedback_timeline) != 0) {
+            fprintf(stderr, "%s: bad timeline \"%s\"\n", rc->name, rc->feedback_timeline);
+            return -1;
+        }
+        led_timeline_set_feedback_slot(1);
+    }
+    led_engine_init(&g_render.engine, rc->led_count);
+    return 0;
+}
+
+static void render_apply(const render_event_t *ev)
+{
+    led_engine_t *engine = &g_render.engine;
+
+    switch (ev->kind) {
+        case EV_START:
+            if (led_engine_start(engine, &ev->config, ev->at_ms) < 0) {
+                fprintf(stderr, "effect pool full at %u ms\n", (unsigned)ev->at_ms);
+            }
+            break;
+        case EV_FEEDBACK:
+            led_engine_feedback(engine, ev->led, ev->color, ev->duration_ms, ev->at_ms);
+            break;
+        case EV_MANUAL:
+            if (ev->led < 0) {
+                led_engine_set_manual_all(engine, ev->color);
+            } else {
+                led_engine_set_manual(engine, (uint32_t)ev->led, ev->color);
+            }
+            break;
+        case EV_STOP_ALL:
+            led_engine_stop_all(engine);
+            break;
+        case EV_BRIGHTNESS:
+            led_engine_set_brightness(engine, ev->brightness);
+            break;
+    }
+}
+
+/**
+ * @brief 渲染用例的[0, duration_ms]，帧写入g_render.frames
+ * @param step_ms 0按引擎的调度渲染，否则按固定步长
+ * @return 帧数，用例有误时返回-1
+ */
+static int render_case(const render_case_t *rc, uint32_t step_ms)
+{
+    int ev_count = 0, next_ev = 0;
+    uint32_t t = 0;
+
+    if (render_setup(rc) != 0) {
+        return -1;
+    }
+    // 未用的事件槽全为0，即类型为NONE的EV_START
+    while (ev_count < RENDER_MAX_EVENTS &&
+           !(rc->events[ev_count].kind == EV_START && rc->events[ev_count].config.type == LED_EFFECT_NONE)) {
+        ev_count++;
+    }
+    g_render.frame_count = 0;
+
+    while (t <= rc->duration_ms && g_render.frame_count < RENDER_MAX_FRAMES) {
+        while (next_ev < ev_count && rc->events[next_ev].at_ms <= t) {
+            render_apply(&rc->events[next_ev++]);
+        }
+
+        render_frame_t *f = &g_render.frames[g_render.frame_count++];
+        f->t_ms = t;
+        led_engine_render(&g_render.engine, t, f->led);
+
+        uint32_t next = LED_NO_DEADLINE;
+        if (step_ms > 0) {
+            next = t + step_ms;
+        } else {
+            uint32_t change = led_engine_next_change_ms(&g_render.engine, t);
+            if (change != LED_NO_DEADLINE) {
+                next = t + change;
+            }
+        }
+        if (next_ev < ev_count && rc->events[next_ev].at_ms < next) {
+            next = rc->events[next_ev].at_ms;
+        }
+        if (next == LED_NO_DEADLINE) {
+            break;      // 空闲且没有后续事件，固件此时不再布置定时器
+        }
+        t = next;
+    }
+    return (int)g_render.frame_count;
+}
+
+static void write_frames(FILE *fp, const render_case_t *rc)
+{
+    fprintf(fp, "# %s: %u LEDs, %u ms\n", rc->name, (unsigned)rc->led_count, (unsigned)rc->duration_ms);
+    for (uint32_t k = 0; k < g_render.frame_count; k++) {
+        const render_frame_t *f = &g_render.frames[k];
+        fprintf(fp, "%u", (unsigned)f->t_ms);
+        for (uint32_t i = 0; i < rc->led_count; i++) {
+            fprintf(fp, " %06X", (unsigned)f->led[i]);
+        }
+        fputc('\n', fp);
+    }
+}
+
+static int golden_update(const char *dir)
+{
+    char path[256];
+
+    for (size_t c = 0; c < CASE_COUNT; c++) {
+        const render_case_t *rc = &g_cases[c];
+        if (render_case(rc, 0) < 0) {
+            return 1;
+        }
+        snprintf(path, sizeof(path), "%s/%s.txt", dir, rc->name);
+        FILE *fp = fopen(path, "w");
+        if (!fp) {
+            perror(path);
+            return 1;
+        }
+        write_frames(fp, rc);
+        fclose(fp);
+        printf("%-18s %4u frames -> %s\n", rc->name, (unsigned)g_render.frame_count, path);
+    }
+    return 0;
+}
+
+/* 逐行比对，报告第一处不同 */
+static int golden_check(const char *dir)
+{
+    char path[256], want[512], got[512];
+    int failed = 0;
+
+    for (size_t c = 0; c < CASE_COUNT; c++) {
+        const render_case_t *rc = &g_cases[c];
+        if (render_case(rc, 0) < 0) {
+            return 1;
+        }
+
+        snprintf(path, sizeof(path), "%s/%s.txt", dir, rc->name);
+        FILE *golden = fopen(path, "r");
+        if (!golden) {
+            printf("FAIL %-18s missing %s (run update)\n", rc->name, path);
+            failed++;
+            continue;
+        }
+        FILE *actual = tmpfile();
+        write_frames(actual, rc);
+        rewind(actual);
+
+        int line = 0;
+        bool same = true;
+        for (;;) {
+            char *w = fgets(want, sizeof(want), golden);
+            char *g = fgets(got, sizeof(got), actual);
+            line++;
+            if (!w && !g) {
+                break;
+            }
+            if (!w || !g || strcmp(w, g) != 0) {
+                printf("FAIL %-18s line %d\n  golden: %s  actual: %s", rc->name, line,
+                       w ? w : "<end>\n", g ? g : "<end>\n");
+                same = false;
+                break;
+            }
+        }
+        fclose(actual);
+        fclose(golden);
+
+        if (same) {
+            printf("ok   %-18s %4u frames\n", rc->name, (unsigned)g_render.frame_count);
+        } else {
+            failed++;
+        }
+    }
+    printf("%d/%u cases passed\n", (int)CASE_COUNT - failed, (unsigned)CASE_COUNT);
+    return failed ? 1 : 0;
+}
+
+/* 每种效果覆盖全部LED，按LED_SMOOTH_FRAME_MS步长连续渲染 */
+static int bench(uint32_t leds, uint32_t ticks)
+{
+    static const struct {
+        const char *name;
+        led_effect_config_t config;
+    } rows[] = {
+        { "static",    { .type = LED_EFFECT_STATIC, .brightness = 200, .colors = {0xFF8000}, .color_count = 1 } },
+        { "breathing", { .type = LED_EFFECT_BREATHING, .period_ms = 2000, .brightness = 200, .colors = {0xFF8000}, .color_count = 1 } },
+        { "flowing",   { .type = LED_EFFECT_FLOWING, .period_ms = 1000, .brightness = 200, .colors = {0xFF8000}, .color_count = 1 } },
+        { "blink",     { .type = LED_EFFECT_BLINK, .period_ms = 500, .brightness = 200, .colors = {0xFF8000}, .color_count = 1 } },
+        { "rainbow",   { .type = LED_EFFECT_RAINBOW, .period_ms = 3000, .brightness = 200 } },
+        { "wave",      { .type = LED_EFFECT_WAVE, .period_ms = 1200, .brightness = 200, .colors = {0xFF8000}, .color_count = 1 } },
+        { "timeline",  { .type = LED_EFFECT_TIMELINE, .brightness = 200, .timeline = 0 } },
+    };
+    static const render_case_t tl_case = {
+        "bench", 0, 0, "loop;0,0xFFFFFFFF,FF0000;500,0x55555555,00FF00,sine;1000,0xFFFFFFFF,0000FF,inout", NULL, {{0}}
+    };
+    static uint32_t out[LED_MAX_COUNT];
+    volatile uint32_t sink = 0;
+
+    if (render_setup(&tl_case) != 0) {
+        return 1;
+    }
+    led_engine_init(&g_render.engine, leds);
+    leds = g_render.engine.led_count;
+    printf("led_render bench: %u LEDs, %u ticks per effect, %u ms per tick\n",
+           (unsigned)leds, (unsigned)ticks, LED_SMOOTH_FRAME_MS);
+
+    for (size_t r = 0; r <= sizeof(rows) / sizeof(rows[0]); r++) {
+        const char *name;
+        led_engine_init(&g_render.engine, leds);
+        if (r < sizeof(rows) / sizeof(rows[0])) {
+            name = rows[r].name;
+            led_engine_start(&g_render.engine, &rows[r].config, 0);
+        } else {
+            // 四层叠加，接近按键反馈和提示同时出现时的最坏情况
+            name = "4 layers";
+            for (int k = 0; k < 4; k++) {
+                led_effect_config_t config = rows[1 + k].config;
+                config.layer = (led_layer_t)k;
+                config.blend = (led_blend_mode_t)k;
+                config.opacity = 128;
+                led_engine_start(&g_render.engine, &config, 0);
+            }
+        }
+
+        uint32_t t = 0;
+        uint64_t t0 = now_ns();
+        for (uint32_t k = 0; k < ticks; k++, t += LED_SMOOTH_FRAME_MS) {
+            led_engine_render(&g_render.engine, t, out);
+            sink += out[k % leds];
+        }
+        double per_tick = (double)(now_ns() - t0) / ticks;
+        printf("%-10s %9.1f ns/tick  %7.2f ns/tick/LED\n", name, per_tick, per_tick / leds);
+    }
+    (void)sink;
+    return 0;
+}
+
+/* 解析run的key=value参数，得到单个效果的用例 */
+static int run(int argc, char **argv)
+{
+    static render_case_t rc;
+    static char tl_src[256];
+    led_effect_config_t *config = &rc.events[0].config;
+    uint32_t step_ms = 0;
+
+    memset(&rc, 0, sizeof(rc));
+    rc.name = "run";
+    rc.led_count = 3;
+    rc.duration_ms = 3000;
+    config->type = LED_EFFECT_BREATHING;
+    config->period_ms = 2000;
+    config->brightness = 255;
+    config->colors[0] = 0xFFFFFF;
+    config->color_count = 1;
+
+    for (int i = 0; i < argc; i++) {
+        char *eq = strchr(argv[i], '=');
+        if (!eq) {
+            fprintf(stderr, "expected key=value: %s\n", argv[i]);
+            return 1;
+        }
+        *eq = '\0';
+        const char *key = argv[i], *val = eq + 1;
+        unsigned long n = strtoul(val, NULL, 0);
+
+        if (strcmp(key, "type") == 0) {
+            static const char *const types[] = {
+                [LED_EFFECT_STATIC] = "static", [LED_EFFECT_BREATHING] = "breathing",
+                [LED_EFFECT_FLOWING] = "flowing", [LED_EFFECT_RAINBOW] = "rainbow",
+                [LED_EFFECT_BLINK] = "blink", [LED_EFFECT_WAVE] = "wave",
+                [LED_EFFECT_TIMELINE] = "timeline",
+            };
+            config->type = LED_EFFECT_NONE;
+            for (int k = 0; k < LED_EFFECT_MAX; k++) {
+                if (types[k] && strcmp(types[k], val) == 0) {
+                    config->type = (led_effect_type_t)k;
+                }
+            }
+            if (config->type == LED_EFFECT_NONE) {
+                fprintf(stderr, "unknown effect type: %s\n", val);
+                return 1;
+            }
+        } else if (strcmp(key, "color") == 0) {
+            char *p = (char *)val;
+            config->color_count = 0;
+            while (*p && config->color_count < 4) {
+                config->colors[config->color_count++] = (uint32_t)strtoul(p, &p, 16);
+                if (*p == ',') {
+                    p++;
+                }
+            }
+        } else if (strcmp(key, "blend") == 0) {
+            static const char *const blends[] = { "replace", "add", "alpha", "lighten" };
+            for (int k = 0; k < LED_BLEND_MODE_MAX; k++) {
+                if (strcmp(blends[k], val) == 0) {
+                    config->blend = (led_blend_mode_t)k;
+                }
+            }
+        } else if (strcmp(key, "tl") == 0) {
+            snprintf(tl_src, sizeof(tl_src), "%s", val);
+            rc.timeline = tl_src;
+        } else if (strcmp(key, "period") == 0) {
+            config->period_ms = (uint32_t)n;
+        } else if (strcmp(key, "duration") == 0) {
+            config->duration_ms = (uint32_t)n;
+        } else if (strcmp(key, "brightness") == 0) {
+            config->brightness = (uint8_t)n;
+        } else if (strcmp(key, "leds") == 0) {
+            rc.led_count = (uint32_t)n;
+        } else if (strcmp(key, "start") == 0) {
+            config->led_start = (uint8_t)n;
+        } else if (strcmp(key, "count") == 0) {
+            config->led_count = (uint8_t)n;
+        } else if (strcmp(key, "reverse") == 0) {
+            config->reverse = n != 0;
+        } else if (strcmp(key, "layer") == 0) {
+            config->layer = (led_layer_t)n;
+        } else if (strcmp(key, "opacity") == 0) {
+            config->opacity = (uint8_t)n;
+        } else if (strcmp(key, "priority") == 0) {
+            config->priority = (int8_t)strtol(val, NULL, 0);
+        } else if (strcmp(key, "mask") == 0) {
+            config->led_mask = (uint32_t)n;
+        } else if (strcmp(key, "seconds") == 0) {
+            rc.duration_ms = (uint32_t)(strtod(val, NULL) * 1000);
+        } else if (strcmp(key, "step") == 0) {
+            step_ms = (uint32_t)n;
+        } else {
+            fprintf(stderr, "unknown key: %s\n", key);
+            return 1;
+        }
+    }
+    if (rc.led_count == 0 || rc.led_count > LED_MAX_COUNT) {
+        fprintf(stderr, "leds must be 1..%d\n", LED_MAX_COUNT);
+        return 1;
+    }
+
+    if (render_case(&rc, step_ms) < 0) {
+        return 1;
+    }
+    write_frames(stdout, &rc);
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: led_render check [dir]\n"
+            "       led_render update [dir]\n"
+            "       led_render bench [leds] [ticks]\n"
+            "       led_render run key=value ...\n");
+}
+
+int main(int argc, char **argv)
+{
+    rt_host_set_quiet(true);
+    if (led_timeline_slots_init() != 0) {
+        return 1;
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "check") == 0) {
+        return golden_check(argc > 2 ? argv[2] : RENDER_DEFAULT_DIR);
+    }
+    if (argc >= 2 && strcmp(argv[1], "update") == 0) {
+        return golden_update(argc > 2 ? argv[2] : RENDER_DEFAULT_DIR);
+    }
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        uint32_t leds = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : LED_MAX_COUNT;
+        uint32_t ticks = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 0) : 200000;
+        return bench(leds, ticks ? ticks : 1);
+    }
+    if (argc >= 2 && strcmp(argv[1], "run") == 0) {
+        return run(argc - 2, argv + 2);
+    }
+    usage();
+    return 2;
+}
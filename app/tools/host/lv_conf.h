@@ -0,0 +1,43 @@
+/**
+ * @file lv_conf.h
+ * @brief 主机构建的LVGL v9配置，渲染相关选项与板上保持一致
+ */
+
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+/* 颜色和刷新 */
+#define LV_COLOR_DEPTH              16
+#define LV_DEF_REFR_PERIOD          33
+#define LV_DPI_DEF                  130
+
+/* 内置内存池：lv_mem_monitor()可用，页面内存统计与板上口径相同 */
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_STRING        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF       LV_STDLIB_CLIB
+#define LV_MEM_SIZE                 (1024U * 1024U)
+
+/* 单线程运行 */
+#define LV_USE_OS                   LV_OS_NONE
+
+/* 软件渲染 */
+#define LV_USE_DRAW_SW              1
+#define LV_DRAW_SW_COMPLEX          1
+
+#define LV_USE_LOG                  0
+#define LV_USE_ASSERT_NULL          1
+#define LV_USE_ASSERT_MALLOC        1
+#define LV_USE_PERF_MONITOR         0
+#define LV_USE_SYSMON               0
+
+/* 字体：UI使用构建时生成的位图字体，TTF回退可选 */
+#define LV_FONT_MONTSERRAT_14       1
+#define LV_FONT_DEFAULT             &lv_font_montserrat_14
+#define LV_USE_TINY_TTF             1
+#define LV_TINY_TTF_FILE_SUPPORT    0
+
+/* 与板上一致：不使用默认主题 */
+#define LV_USE_THEME_DEFAULT        0
+#define LV_USE_THEME_SIMPLE         0
+
+#endif /* LV_CONF_H */
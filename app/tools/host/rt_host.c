@@ -0,0 +1,389 @@
+/**
+ * @file rt_host.c
+ * @brief RT-Thread接口替身的实现（单线程、虚拟时钟）
+ */
+
+#include <rtthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+/* 虚拟时钟起点：2025-01-01 09:30:00 UTC，保证时间显示可复现 */
+#define HOST_EPOCH_SECONDS  1735723800L
+
+struct rt_mutex {
+    int hold;
+};
+
+struct rt_event {
+    rt_uint32_t set;
+};
+
+struct rt_messagequeue {
+    rt_size_t msg_size;
+    rt_size_t max_msgs;
+    rt_size_t head;
+    rt_size_t count;
+    uint8_t *pool;
+};
+
+struct rt_timer {
+    void (*timeout)(void *parameter);
+    void *parameter;
+    rt_tick_t init_tick;
+    rt_tick_t timeout_tick;
+    rt_uint8_t flag;
+    bool active;
+    struct rt_timer *next;
+};
+
+static struct {
+    rt_tick_t tick;
+    struct rt_timer *timers;
+    bool firing;
+    bool quiet;
+} g_host = {0};
+
+/*********************
+ *  时钟与定时器
+ *********************/
+
+static struct rt_timer *next_due_timer(rt_tick_t until)
+{
+    struct rt_timer *due = NULL;
+
+    for (struct rt_timer *t = g_host.timers; t; t = t->next) {
+        if (!t->active || (int32_t)(t->timeout_tick - until) > 0) {
+            continue;
+        }
+        if (!due || (int32_t)(t->timeout_tick - due->timeout_tick) < 0) {
+            due = t;
+        }
+    }
+    return due;
+}
+
+void rt_host_advance(rt_uint32_t ms)
+{
+    rt_tick_t until = g_host.tick + rt_tick_from_millisecond(ms);
+
+    /* 定时器回调中的延时只推进时钟，不嵌套触发 */
+    if (g_host.firing) {
+        g_host.tick = until;
+        return;
+    }
+
+    g_host.firing = true;
+    struct rt_timer *t;
+    while ((t = next_due_timer(until)) != NULL) {
+        if ((int32_t)(t->timeout_tick - g_host.tick) > 0) {
+            g_host.tick = t->timeout_tick;
+        }
+        if (t->flag & RT_TIMER_FLAG_PERIODIC) {
+            t->timeout_tick += t->init_tick ? t->init_tick : 1;
+        } else {
+            t->active = false;
+        }
+        t->timeout(t->parameter);
+    }
+    g_host.tick = until;
+    g_host.firing = false;
+}
+
+rt_tick_t rt_tick_get(void)
+{
+    return g_host.tick;
+}
+
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms)
+{
+    return (rt_tick_t)((int64_t)ms * RT_TICK_PER_SECOND / 1000);
+}
+
+rt_err_t rt_thread_mdelay(rt_int32_t ms)
+{
+    if (ms > 0) {
+        rt_host_advance((rt_uint32_t)ms);
+    }
+    return RT_EOK;
+}
+
+/* 链接时用--wrap=time替换libc的time()，墙上时间跟随虚拟时钟 */
+time_t __wrap_time(time_t *out)
+{
+    time_t now = HOST_EPOCH_SECONDS + g_host.tick / RT_TICK_PER_SECOND;
+    if (out) {
+        *out = now;
+    }
+    return now;
+}
+
+rt_timer_t rt_timer_create(const char *name, void (*timeout)(void *parameter),
+                           void *parameter, rt_tick_t time, rt_uint8_t flag)
+{
+    (void)name;
+    struct rt_timer *t = calloc(1, sizeof(*t));
+    if (!t) {
+        return RT_NULL;
+    }
+    t->timeout = timeout;
+    t->parameter = parameter;
+    t->init_tick = time;
+    t->flag = flag;
+    t->next = g_host.timers;
+    g_host.timers = t;
+    return t;
+}
+
+rt_err_t rt_timer_delete(rt_timer_t timer)
+{
+    for (struct rt_timer **pp = &g_host.timers; *pp; pp = &(*pp)->next) {
+        if (*pp == timer) {
+            *pp = timer->next;
+            free(timer);
+            return RT_EOK;
+        }
+    }
+    return -RT_ERROR;
+}
+
+rt_err_t rt_timer_start(rt_timer_t timer)
+{
+    timer->timeout_tick = g_host.tick + timer->init_tick;
+    timer->active = true;
+    return RT_EOK;
+}
+
+rt_err_t rt_timer_stop(rt_timer_t timer)
+{
+    if (!timer->active) {
+        return -RT_ERROR;
+    }
+    timer->active = false;
+    return RT_EOK;
+}
+
+rt_err_t rt_timer_control(rt_timer_t timer, int cmd, void *arg)
+{
+    switch (cmd) {
+    case RT_TIMER_CTRL_SET_TIME:
+        timer->init_tick = *(rt_tick_t *)arg;
+        break;
+    case RT_TIMER_CTRL_GET_TIME:
+        *(rt_tick_t *)arg = timer->init_tick;
+        break;
+    case RT_TIMER_CTRL_SET_ONESHOT:
+        timer->flag &= ~RT_TIMER_FLAG_PERIODIC;
+        break;
+    case RT_TIMER_CTRL_SET_PERIODIC:
+        timer->flag |= RT_TIMER_FLAG_PERIODIC;
+        break;
+    default:
+        return -RT_EINVAL;
+    }
+    return RT_EOK;
+}
+
+/*********************
+ *  中断、内存、输出
+ *********************/
+
+rt_base_t rt_hw_interrupt_disable(void)
+{
+    return 0;
+}
+
+void rt_hw_interrupt_enable(rt_base_t level)
+{
+    (void)level;
+}
+
+void rt_enter_critical(void)
+{
+}
+
+void rt_exit_critical(void)
+{
+}
+
+void *rt_malloc(rt_size_t size)
+{
+    return malloc(size);
+}
+
+void rt_free(void *ptr)
+{
+    free(ptr);
+}
+
+void rt_host_set_quiet(bool quiet)
+{
+    g_host.quiet = quiet;
+}
+
+int rt_kprintf(const char *fmt, ...)
+{
+    if (g_host.quiet) {
+        return 0;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vfprintf(stderr, fmt, args);
+    va_end(args);
+    return n;
+}
+
+int rt_snprintf(char *buf, rt_size_t size, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, size, fmt, args);
+    va_end(args);
+    return n;
+}
+
+void rt_host_assert(const char *expr, const char *file, int line)
+{
+    fprintf(stderr, "assert failed: %s (%s:%d)\n", expr, file, line);
+    abort();
+}
+
+/*********************
+ *  IPC
+ *********************/
+
+rt_mutex_t rt_mutex_create(const char *name, rt_uint8_t flag)
+{
+    (void)name;
+    (void)flag;
+    return calloc(1, sizeof(struct rt_mutex));
+}
+
+rt_err_t rt_mutex_delete(rt_mutex_t mutex)
+{
+    free(mutex);
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout)
+{
+    (void)timeout;
+    mutex->hold++;
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_release(rt_mutex_t mutex)
+{
+    if (mutex->hold <= 0) {
+        return -RT_ERROR;
+    }
+    mutex->hold--;
+    return RT_EOK;
+}
+
+rt_event_t rt_event_create(const char *name, rt_uint8_t flag)
+{
+    (void)name;
+    (void)flag;
+    return calloc(1, sizeof(struct rt_event));
+}
+
+rt_err_t rt_event_delete(rt_event_t event)
+{
+    free(event);
+    return RT_EOK;
+}
+
+rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set)
+{
+    event->set |= set;
+    return RT_EOK;
+}
+
+static bool event_matched(rt_event_t event, rt_uint32_t set, rt_uint8_t opt)
+{
+    if (opt & RT_EVENT_FLAG_AND) {
+        return (event->set & set) == set;
+    }
+    return (event->set & set) != 0;
+}
+
+/* 等待期间逐毫秒推进虚拟时钟，定时器回调可能发送事件提前唤醒 */
+rt_err_t rt_event_recv(rt_event_t event, rt_uint32_t set, rt_uint8_t opt,
+                       rt_int32_t timeout, rt_uint32_t *recved)
+{
+    rt_int32_t waited = 0;
+
+    while (!event_matched(event, set, opt)) {
+        if (timeout == RT_WAITING_NO || (timeout != RT_WAITING_FOREVER && waited >= timeout)) {
+            return -RT_ETIMEOUT;
+        }
+        if (timeout == RT_WAITING_FOREVER && !next_due_timer(g_host.tick + 3600 * RT_TICK_PER_SECOND)) {
+            return -RT_ETIMEOUT;    /* 单线程下没有定时器就永远等不到 */
+        }
+        rt_host_advance(1);
+        waited++;
+    }
+
+    if (recved) {
+        *recved = event->set & set;
+    }
+    if (opt & RT_EVENT_FLAG_CLEAR) {
+        event->set &= ~set;
+    }
+    return RT_EOK;
+}
+
+rt_mq_t rt_mq_create(const char *name, rt_size_t msg_size, rt_size_t max_msgs, rt_uint8_t flag)
+{
+    (void)name;
+    (void)flag;
+    struct rt_messagequeue *mq = calloc(1, sizeof(*mq));
+    if (!mq) {
+        return RT_NULL;
+    }
+    mq->pool = calloc(max_msgs, msg_size);
+    if (!mq->pool) {
+        free(mq);
+        return RT_NULL;
+    }
+    mq->msg_size = msg_size;
+    mq->max_msgs = max_msgs;
+    return mq;
+}
+
+rt_err_t rt_mq_delete(rt_mq_t mq)
+{
+    free(mq->pool);
+    free(mq);
+    return RT_EOK;
+}
+
+rt_err_t rt_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    if (size > mq->msg_size) {
+        return -RT_ERROR;
+    }
+    if (mq->count >= mq->max_msgs) {
+        return -RT_EFULL;
+    }
+    rt_size_t slot = (mq->head + mq->count) % mq->max_msgs;
+    memcpy(mq->pool + slot * mq->msg_size, buffer, size);
+    mq->count++;
+    return RT_EOK;
+}
+
+rt_err_t rt_mq_recv(rt_mq_t mq, void *buffer, rt_size_t size, rt_int32_t timeout)
+{
+    (void)timeout;      /* 单线程下没有其他发送方，不等待 */
+    if (mq->count == 0) {
+        return -RT_ETIMEOUT;
+    }
+    memcpy(buffer, mq->pool + mq->head * mq->msg_size, size < mq->msg_size ? size : mq->msg_size);
+    mq->head = (mq->head + 1) % mq->max_msgs;
+    mq->count--;
+    return RT_EOK;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file snapshot_check.c
+ * @brief 快照存储区的主机检查：用文件模拟flash，经data_snapshot.c保存、重新打开并恢复
+ *
+ * 用例覆盖空存储区、每次保存后重新打开、写满一圈后回绕擦除、最新槽位损坏
+ * （掉电时写了一半）后回退到上一条记录，以及损坏之后继续保存。
+ *
+ * 用法:
+ *   snapshot_check [模拟flash文件]    默认build/snapshot_check.bin，每次运行前重建
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "data_snapshot.h"
+#include "snapshot_file_storage.h"
+
+#define CHECK_SECTOR_SIZE   4096
+#define CHECK_SECTOR_COUNT  2
+#define CHECK_DEFAULT_FILE  "build/snapshot_check.bin"
+
+static const char *g_path = CHECK_DEFAULT_FILE;
+static data_snapshot_store_t g_store;
+
+static int reopen(void)
+{
+    const data_snapshot_storage_t *storage =
+        snapshot_file_storage_open(g_path, CHECK_SECTOR_SIZE, CHECK_SECTOR_COUNT);
+    if (!storage) {
+        printf("cannot open %s\n", g_path);
+        return -1;
+    }
+    return data_snapshot_open(&g_store, storage);
+}
+
+/* 第n条记录的内容，恢复时按n核对 */
+static void fill_record(data_snapshot_t *snap, int n)
+{
+    memset(snap, 0, sizeof(*snap));
+    snap->valid_mask = DATA_SNAPSHOT_HAS_WEATHER | DATA_SNAPSHOT_HAS_STOCK;
+    snprintf(snap->weather.city, sizeof(snap->weather.city), "city-%d", n);
+    snap->weather.temperature_x10 = (int16_t)n;
+    snap->stock_count = 1;
+    snprintf(snap->stocks[0].name, sizeof(snap->stocks[0].name), "S%d", n);
+    snap->stocks[0].price_x100 = n * 100;
+    snap->saved_time = 1700000000u + (uint32_t)n;
+}
+
+static int save_record(int n)
+{
+    data_snapshot_t snap;
+    fill_record(&snap, n);
+    return data_snapshot_save(&g_store, &snap);
+}
+
+/* 重新打开存储区，最新记录应是第n条 */
+static bool restores(int n, const char **why)
+{
+    data_snapshot_t got, want;
+    snapshot_file_storage_close();
+    if (reopen() != DATA_SNAPSHOT_OK) {
+        *why = "reopen failed";
+        return false;
+    }
+    if (data_snapshot_load(&g_store, &got) != DATA_SNAPSHOT_OK) {
+        *why = "no record after reopen";
+        return false;
+    }
+    fill_record(&want, n);
+    if (data_snapshot_content_crc(&got) != data_snapshot_content_crc(&want) ||
+        got.saved_time != want.saved_time) {
+        *why = "restored record differs";
+        return false;
+    }
+    return true;
+}
+
+/* 把槽位中间的一段写成0，模拟编程到一半掉电 */
+static int tear_slot(uint32_t slot)
+{
+    uint32_t slots_per_sector = CHECK_SECTOR_SIZE / g_store.slot_size;
+    long offset = (long)((slot / slots_per_sector) * CHECK_SECTOR_SIZE +
+                         (slot % slots_per_sector) * g_store.slot_size);
+    static const uint8_t zeros[32] = {0};
+
+    snapshot_file_storage_close();
+    FILE *f = fopen(g_path, "r+b");
+    if (!f) {
+        return -1;
+    }
+    int ret = (fseek(f, offset + 64, SEEK_SET) == 0 &&
+               fwrite(zeros, 1, sizeof(zeros), f) == sizeof(zeros)) ? 0 : -1;
+    fclose(f);
+    return ret;
+}
+
+static bool case_empty(const char **why)
+{
+    data_snapshot_t snap;
+    if (data_snapshot_load(&g_store, &snap) != DATA_SNAPSHOT_ERR_EMPTY) {
+        *why = "blank storage returned a record";
+        return false;
+    }
+    return true;
+}
+
+/* 保存两圈多，每次都重新打开核对，回绕时旧扇区被擦除 */
+static bool case_wrap(const char **why)
+{
+    int total = (int)g_store.slot_count * 2 + 3;
+    for (int n = 1; n <= total; n++) {
+        if (save_record(n) != DATA_SNAPSHOT_OK) {
+            *why = "save failed";
+            return false;
+        }
+        if (!restores(n, why)) {
+            return false;
+        }
+    }
+    if (g_store.last_sequence != (uint32_t)total) {
+        *why = "sequence does not match the number of saves";
+        return false;
+    }
+    return true;
+}
+
+/* 最新槽位损坏时恢复上一条，之后的保存跳过损坏的槽位 */
+static bool case_corrupt(const char **why)
+{
+    int last = (int)g_store.last_sequence;
+    uint32_t newest = (g_store.next_slot + g_store.slot_count - 1) % g_store.slot_count;
+
+    if (tear_slot(newest) != 0) {
+        *why = "cannot write the flash file";
+        return false;
+    }
+    if (!restores(last - 1, why)) {
+        return false;
+    }
+    for (int n = last + 1; n <= last + 3; n++) {
+        if (save_record(n) != DATA_SNAPSHOT_OK) {
+            *why = "save after corruption failed";
+            return false;
+        }
+        if (!restores(n, why)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const struct {
+    const char *name;
+    bool (*run)(const char **why);
+} g_cases[] = {
+    { "empty",   case_empty },
+    { "wrap",    case_wrap },
+    { "corrupt", case_corrupt },
+};
+
+#define CASE_COUNT  (sizeof(g_cases) / sizeof(g_cases[0]))
+
+int main(int argc, char **argv)
+{
+    if (argc > 1) {
+        g_path = argv[1];
+    }
+    remove(g_path);
+    if (reopen() != DATA_SNAPSHOT_OK) {
+        return 1;
+    }
+    printf("%u slots of %u bytes in %d sectors\n", (unsigned)g_store.slot_count,
+           (unsigned)g_store.slot_size, CHECK_SECTOR_COUNT);
+
+    int failed = 0;
+    for (size_t c = 0; c < CASE_COUNT; c++) {
+        const char *why = "";
+        if (g_cases[c].run(&why)) {
+            printf("ok   %s\n", g_cases[c].name);
+        } else {
+            printf("FAIL %-8s %s\n", g_cases[c].name, why);
+            failed++;
+        }
+    }
+    snapshot_file_storage_close();
+
+    printf("%d/%d cases passed\n", (int)CASE_COUNT - failed, (int)CASE_COUNT);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,88 @@
+#include "snapshot_file_storage.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static FILE *g_file = NULL;
+static data_snapshot_storage_t g_storage;
+
+static int file_read(uint32_t offset, void *buf, uint32_t len)
+{
+    if (!g_file || fseek(g_file, (long)offset, SEEK_SET) != 0) {
+        return -1;
+    }
+    return (fread(buf, 1, len, g_file) == len) ? 0 : -1;
+}
+
+static int file_write(uint32_t offset, const void *buf, uint32_t len)
+{
+    uint8_t *merged = malloc(len);
+    if (!merged || file_read(offset, merged, len) != 0) {
+        free(merged);
+        return -1;
+    }
+
+    /* NOR flash只能把1写成0 */
+    const uint8_t *src = buf;
+    for (uint32_t i = 0; i < len; i++) {
+        merged[i] &= src[i];
+    }
+
+    int ret = -1;
+    if (fseek(g_file, (long)offset, SEEK_SET) == 0 &&
+        fwrite(merged, 1, len, g_file) == len) {
+        fflush(g_file);
+        ret = 0;
+    }
+    free(merged);
+    return ret;
+}
+
+static int file_erase(uint32_t offset, uint32_t len)
+{
+    if (!g_file || offset % g_storage.sector_size != 0 || fseek(g_file, (long)offset, SEEK_SET) != 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        if (fputc(0xFF, g_file) == EOF) {
+            return -1;
+        }
+    }
+    fflush(g_file);
+    return 0;
+}
+
+const data_snapshot_storage_t *snapshot_file_storage_open(const char *path,
+                                                          uint32_t sector_size,
+                                                          uint32_t sector_count)
+{
+    snapshot_file_storage_close();
+
+    g_file = fopen(path, "r+b");
+    if (!g_file) {
+        /* 新文件：整体初始化为擦除状态 */
+        g_file = fopen(path, "w+b");
+        if (!g_file) {
+            return NULL;
+        }
+        for (uint32_t i = 0; i < sector_size * sector_count; i++) {
+            fputc(0xFF, g_file);
+        }
+        fflush(g_file);
+    }
+
+    g_storage.read = file_read;
+    g_storage.write = file_write;
+    g_storage.erase = file_erase;
+    g_storage.sector_size = sector_size;
+    g_storage.sector_count = sector_count;
+    return &g_storage;
+}
+
+void snapshot_file_storage_close(void)
+{
+    if (g_file) {
+        fclose(g_file);
+        g_file = NULL;
+    }
+}
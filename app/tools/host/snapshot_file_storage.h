@@ -0,0 +1,34 @@
+#ifndef SNAPSHOT_FILE_STORAGE_H
+#define SNAPSHOT_FILE_STORAGE_H
+
+/**
+ * @file snapshot_file_storage.h
+ * @brief 主机端用文件模拟的快照flash后端
+ *
+ * 与设备上的data_snapshot_flash.c对应，供在PC上直接编译data_snapshot.c使用，
+ * make snapshot_check用它检查保存、回绕和损坏恢复。
+ * 擦除把扇区填为0xFF，写入按NOR flash语义只能把1写成0。
+ */
+
+#include <stdint.h>
+#include "data_snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 打开（不存在则创建）模拟flash文件
+ * @return 存储后端，失败返回NULL
+ */
+const data_snapshot_storage_t *snapshot_file_storage_open(const char *path,
+                                                          uint32_t sector_size,
+                                                          uint32_t sector_count);
+
+void snapshot_file_storage_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SNAPSHOT_FILE_STORAGE_H */